@@ -92,15 +92,68 @@ string Config::getHelpMenu() const throw() {
 
     part = "   -tp PLATFORM, --target-platform=PLATFORM\n"
         "      Specifies the target platform which will affect the kind of "
-        "code generated. Valid options are C and CUDA."
+        "code generated. Valid options are C, CUDA, C-multicore, "
+        "C-pipelined, and C-task-parallel."
         "\n\n";
     tools::breakLongLines(part, maximum_line_length, indents);
     str += part;
 
     part = "   -no-pc, --no-leaf-coalescing\n"
-        "      CUDA ONLY. Specifies that the tool should not coalesce "
-        "leafs, even "
-        "when it is possible to do so for the given input processnetwork."
+        "      CUDA AND C-MULTICORE ONLY. Specifies that the tool should not "
+        "coalesce leafs, even when it is possible to do so for the given "
+        "input processnetwork."
+        "\n\n";
+    tools::breakLongLines(part, maximum_line_length, indents);
+    str += part;
+
+    part = "   -no-zc, --no-zero-copy-views\n"
+        "      Specifies that the tool should copy the data of Unzipx and Zipx "
+        "leafs element by element, instead of letting their outputs and "
+        "inputs be views into the source and destination arrays."
+        "\n\n";
+    tools::breakLongLines(part, maximum_line_length, indents);
+    str += part;
+
+    part = "   -no-mp, --no-memory-planning\n"
+        "      Specifies that the tool should allocate each internal signal "
+        "array separately, instead of placing them in a single memory arena "
+        "where arrays that are never in use at the same time share memory."
+        "\n\n";
+    tools::breakLongLines(part, maximum_line_length, indents);
+    str += part;
+
+    part = "   -ls, --locality-aware-scheduling\n"
+        "      Specifies that the leaf schedule should place each leaf directly "
+        "after the leaf producing its input whenever possible, so that the "
+        "data is still in the cache when it is consumed. By default, the "
+        "leafs are scheduled level by level."
+        "\n\n";
+    tools::breakLongLines(part, maximum_line_length, indents);
+    str += part;
+
+    part = "   -re, --reentrant\n"
+        "      Specifies that the synthesized code should keep the delay state "
+        "in a caller-owned state struct, which is passed to the "
+        "processnetwork functions, instead of in static variables. This "
+        "allows several independent instances of the processnetwork to "
+        "execute at the same time."
+        "\n\n";
+    tools::breakLongLines(part, maximum_line_length, indents);
+    str += part;
+
+    part = "   -bench, --generate-benchmark\n"
+        "      Specifies that the tool should also generate a benchmark driver, "
+        "which feeds the synthesized code with pseudo-random data and prints "
+        "its throughput as JSON. The driver is written to a file with the "
+        "same name as the output file, suffixed with _bench."
+        "\n\n";
+    tools::breakLongLines(part, maximum_line_length, indents);
+    str += part;
+
+    part = "   -prof, --profile\n"
+        "      Specifies that the synthesized code should measure the number of "
+        "invocations of and the time spent in each leaf. The measurements are "
+        "printed by calling dumpProcessNetworkProfile()."
         "\n\n";
     tools::breakLongLines(part, maximum_line_length, indents);
     str += part;
@@ -112,6 +165,91 @@ string Config::getHelpMenu() const throw() {
     tools::breakLongLines(part, maximum_line_length, indents);
     str += part;
 
+    part = "   -ps KIND, --parallel-schedule=KIND\n"
+        "      C-MULTICORE ONLY. Specifies the OpenMP loop schedule used for "
+        "data parallel leafs. Valid options are static, dynamic, guided, auto, "
+        "and runtime. Default setting is static."
+        "\n\n";
+    tools::breakLongLines(part, maximum_line_length, indents);
+    str += part;
+
+    part = "   -pcs SIZE, --parallel-chunk-size=SIZE\n"
+        "      C-MULTICORE ONLY. Specifies the OpenMP loop chunk size used for "
+        "data parallel leafs. The chunk size is ignored for the auto and "
+        "runtime schedules. Default setting is 0, which leaves the chunk size "
+        "to the OpenMP implementation."
+        "\n\n";
+    tools::breakLongLines(part, maximum_line_length, indents);
+    str += part;
+
+    part = "   -nps NUM, --num-pipeline-stages=NUM\n"
+        "      C-PIPELINED ONLY. Specifies the number of pipeline stages into "
+        "which the leaf schedule is split. The stages are balanced according "
+        "to the leaf costs, and each stage is executed on a separate thread. "
+        "The synthesized code always contains the block-processing function, "
+        "which should be used to benefit from the pipelining. Default setting "
+        "is 4."
+        "\n\n";
+    tools::breakLongLines(part, maximum_line_length, indents);
+    str += part;
+
+    part = "   -nt NUM, --num-threads=NUM\n"
+        "      C-TASK-PARALLEL ONLY. Specifies the number of threads, including "
+        "the calling thread, which execute the leaf tasks. The synthesized "
+        "code always contains the block-processing function, and the number "
+        "can also be overridden when compiling by defining F2CC_NUM_THREADS. "
+        "Default setting is 4."
+        "\n\n";
+    tools::breakLongLines(part, maximum_line_length, indents);
+    str += part;
+
+    part = "   -j NUM, --jobs=NUM\n"
+        "      XML ONLY. Specifies the number of threads which parse the C "
+        "function files referenced by the model. Default setting is 1."
+        "\n\n";
+    tools::breakLongLines(part, maximum_line_length, indents);
+    str += part;
+
+    part = "   -xs, --xml-streaming\n"
+        "      XML ONLY. Specifies that the model files should be read one "
+        "element at a time instead of being loaded as a whole, which lowers "
+        "the memory use and parsing time for large models."
+        "\n\n";
+    tools::breakLongLines(part, maximum_line_length, indents);
+    str += part;
+
+    part = "   -bp, --block-processing\n"
+        "      Specifies that the synthesized code should also contain a "
+        "block-processing function, which executes the processnetwork once "
+        "for each token in a block of input tokens in a single call. Delay "
+        "state is carried across the tokens within the block."
+        "\n\n";
+    tools::breakLongLines(part, maximum_line_length, indents);
+    str += part;
+
+    part = "   -cd DIR, --cache-dir=DIR\n"
+        "      Specifies a directory in which the synthesized code is cached. "
+        "If the input files and the settings affecting the synthesis are "
+        "unchanged since a previous run with the same cache, the code from "
+        "that run is written again without parsing or synthesizing the "
+        "model. The C functions parsed from the function files of XML models "
+        "are cached as well, such that only changed function files are "
+        "parsed again. By default no cache is used."
+        "\n\n";
+    tools::breakLongLines(part, maximum_line_length, indents);
+    str += part;
+
+    part = "   -sm FILE, --save-model=FILE\n"
+        "      Specifies a file in which the model is saved in binary form once "
+        "it has been parsed. A saved model is given as input file with the "
+        "extension .f2ccpn, and is loaded much faster than the model files "
+        "from which it was parsed. Cached code (see -cd) is not used when "
+        "the model is saved, as the model must then be parsed. By default "
+        "the model is not saved."
+        "\n\n";
+    tools::breakLongLines(part, maximum_line_length, indents);
+    str += part;
+
     part = "   -lf FILE, --log-file=FILE\n"
         "      Specifies the path to the log file. Default setting is "
         "output.log."
@@ -127,6 +265,30 @@ string Config::getHelpMenu() const throw() {
     tools::breakLongLines(part, maximum_line_length, indents);
     str += part;
 
+    part = "   -la, --async-logging\n"
+        "      Specifies that log messages should be written in batches by a "
+        "background thread instead of by the logging code itself. ERROR and "
+        "CRITICAL messages are still written before the tool continues."
+        "\n\n";
+    tools::breakLongLines(part, maximum_line_length, indents);
+    str += part;
+
+    part = "   -lfp=POLICY, --log-flush-policy=POLICY\n"
+        "      Specifies when the log file is flushed. Valid options are "
+        "MESSAGE, which flushes after every message, and ERROR, which only "
+        "flushes after ERROR and CRITICAL messages and when the tool exits. "
+        "Default setting is MESSAGE."
+        "\n\n";
+    tools::breakLongLines(part, maximum_line_length, indents);
+    str += part;
+
+    part = "   -no-lc, --no-log-console\n"
+        "      Specifies that log messages should only be written to the log "
+        "file and not be printed to the console."
+        "\n\n";
+    tools::breakLongLines(part, maximum_line_length, indents);
+    str += part;
+
     part = "   -v, --version\n"
         "      Prints the version."
         "\n\n";
@@ -165,6 +327,11 @@ string Config::getImplementationOutputFile() const throw() {
     return output_file_;
 }
 
+string Config::getBenchmarkOutputFile() const throw() {
+    return tools::getFileName(output_file_) + "_bench."
+        + tools::getExtension(output_file_);
+}
+
 void Config::setOutputFile(string file) throw() {
     output_file_ = file;
 }
@@ -177,6 +344,22 @@ void Config::setLogFile(string file) throw() {
     log_file_ = file;
 }
 
+string Config::getCacheDirectory() const throw() {
+    return cache_directory_;
+}
+
+void Config::setCacheDirectory(string directory) throw() {
+    cache_directory_ = directory;
+}
+
+string Config::getModelSnapshotFile() const throw() {
+    return model_snapshot_file_;
+}
+
+void Config::setModelSnapshotFile(string file) throw() {
+    model_snapshot_file_ = file;
+}
+
 Logger::LogLevel Config::getLogLevel() const throw() {
     return log_level_;
 }
@@ -185,14 +368,56 @@ void Config::setLogLevel(Logger::LogLevel level) throw() {
     log_level_ = level;
 }
 
+bool Config::doAsyncLogging() const throw() {
+    return do_async_logging_;
+}
+
+void Config::setDoAsyncLogging(bool setting) throw() {
+    do_async_logging_ = setting;
+}
+
+Logger::FlushPolicy Config::getLogFlushPolicy() const throw() {
+    return log_flush_policy_;
+}
+
+void Config::setLogFlushPolicy(Logger::FlushPolicy policy) throw() {
+    log_flush_policy_ = policy;
+}
+
+bool Config::doLogToConsole() const throw() {
+    return do_log_to_console_;
+}
+
+void Config::setDoLogToConsole(bool setting) throw() {
+    do_log_to_console_ = setting;
+}
+
 void Config::setDefaults() throw() {
     do_print_help_ = false;
     do_print_version_ = false;
     log_file_ = "output.log";
+    cache_directory_ = "";
+    model_snapshot_file_ = "";
     log_level_ = Logger::INFO;
+    do_async_logging_ = false;
+    log_flush_policy_ = Logger::FLUSH_EVERY_MESSAGE;
+    do_log_to_console_ = true;
     do_data_parallel_leaf_coalescing_ = true;
+    do_zero_copy_views_ = true;
+    do_memory_planning_ = true;
+    do_locality_aware_scheduling_ = false;
+    do_reentrant_code_ = false;
+    do_generate_benchmark_ = false;
+    do_profiling_ = false;
     use_shared_memory_for_input_ = false;
     use_shared_memory_for_output_ = false;
+    do_block_processing_ = false;
+    parallel_schedule_ = "static";
+    parallel_chunk_size_ = 0;
+    num_pipeline_stages_ = 4;
+    num_threads_ = 4;
+    num_parser_threads_ = 1;
+    do_xml_streaming_ = false;
     target_platform_ = Config::CUDA;
     format_ = Config::XML;
 }
@@ -274,6 +499,34 @@ void Config::setFromCommandLine(int argc, const char** argv)
                                         ex.getMessage());
                     }
                 }
+                else if (option == "-cd" || option == "--cache-dir") {
+                    if (has_argument) {
+                        if (!isCompositeOption(option)) {
+                            argument = argv[index + 1];
+                            ++index;
+                        }
+                    }
+                    else {
+                        THROW_EXCEPTION(InvalidFormatException,
+                                        "No cache directory argument");
+                    }
+
+                    cache_directory_ = argument;
+                }
+                else if (option == "-sm" || option == "--save-model") {
+                    if (has_argument) {
+                        if (!isCompositeOption(option)) {
+                            argument = argv[index + 1];
+                            ++index;
+                        }
+                    }
+                    else {
+                        THROW_EXCEPTION(InvalidFormatException,
+                                        "No model file argument");
+                    }
+
+                    model_snapshot_file_ = argument;
+                }
                 else if (option == "-lf" || option == "--log-file") {
                     if (has_argument) {
                         if (!isCompositeOption(option)) {
@@ -288,6 +541,37 @@ void Config::setFromCommandLine(int argc, const char** argv)
 
                     log_file_ = argument;
                 }
+                else if (option == "-la" || option == "--async-logging") {
+                    do_async_logging_ = true;
+                }
+                else if (option == "-lfp" || option == "--log-flush-policy") {
+                    if (has_argument) {
+                        if (!isCompositeOption(option)) {
+                            argument = argv[index + 1];
+                            ++index;
+                        }
+                    }
+                    else {
+                        THROW_EXCEPTION(InvalidFormatException,
+                                        "No log flush policy argument");
+                    }
+
+                    tools::toUpperCase(argument);
+                    if (argument == "MESSAGE") {
+                        log_flush_policy_ = Logger::FLUSH_EVERY_MESSAGE;
+                    }
+                    else if (argument == "ERROR") {
+                        log_flush_policy_ = Logger::FLUSH_ON_ERROR;
+                    }
+                    else {
+                        THROW_EXCEPTION(InvalidFormatException,
+                                        string("Unrecognized log flush "
+                                               "policy \"") + argument + "\"");
+                    }
+                }
+                else if (option == "-no-lc" || option == "--no-log-console") {
+                    do_log_to_console_ = false;
+                }
                 else if (option == "-tp" || option == "--target-platform") {
                     if (has_argument) {
                         if (!isCompositeOption(option)) {
@@ -307,6 +591,15 @@ void Config::setFromCommandLine(int argc, const char** argv)
                     else if (argument == "cuda") {
                         target_platform_ = Config::CUDA;
                     }
+                    else if (argument == "c-multicore") {
+                        target_platform_ = Config::C_MULTICORE;
+                    }
+                    else if (argument == "c-pipelined") {
+                        target_platform_ = Config::C_PIPELINED;
+                    }
+                    else if (argument == "c-task-parallel") {
+                        target_platform_ = Config::C_TASK_PARALLEL;
+                    }
                     else {
                         THROW_EXCEPTION(InvalidFormatException,
                                         "Invalid target platform argument");
@@ -331,10 +624,156 @@ void Config::setFromCommandLine(int argc, const char** argv)
                          || option == "--no-leaf-coalescing") {
                     do_data_parallel_leaf_coalescing_ = false;
                 }
+                else if (option == "-no-zc"
+                         || option == "--no-zero-copy-views") {
+                    do_zero_copy_views_ = false;
+                }
+                else if (option == "-no-mp"
+                         || option == "--no-memory-planning") {
+                    do_memory_planning_ = false;
+                }
+                else if (option == "-ls"
+                         || option == "--locality-aware-scheduling") {
+                    do_locality_aware_scheduling_ = true;
+                }
+                else if (option == "-re" || option == "--reentrant") {
+                    do_reentrant_code_ = true;
+                }
+                else if (option == "-bench"
+                         || option == "--generate-benchmark") {
+                    do_generate_benchmark_ = true;
+                }
+                else if (option == "-prof" || option == "--profile") {
+                    do_profiling_ = true;
+                }
                 else if (option == "-use-sm-i" 
                          || option == "--use-shared-memory-for-input") {
                     use_shared_memory_for_input_ = true;
                 }
+                else if (option == "-ps"
+                         || option == "--parallel-schedule") {
+                    if (has_argument) {
+                        if (!isCompositeOption(option)) {
+                            argument = argv[index + 1];
+                            ++index;
+                        }
+                    }
+                    else {
+                        THROW_EXCEPTION(InvalidFormatException,
+                                        "No parallel schedule argument");
+                    }
+
+                    try {
+                        tools::toLowerCase(argument);
+                        setParallelSchedule(argument);
+                    }
+                    catch (InvalidArgumentException& ex) {
+                        THROW_EXCEPTION(InvalidFormatException,
+                                        ex.getMessage());
+                    }
+                }
+                else if (option == "-pcs"
+                         || option == "--parallel-chunk-size") {
+                    if (has_argument) {
+                        if (!isCompositeOption(option)) {
+                            argument = argv[index + 1];
+                            ++index;
+                        }
+                    }
+                    else {
+                        THROW_EXCEPTION(InvalidFormatException,
+                                        "No parallel chunk size argument");
+                    }
+
+                    if (!tools::isNumeric(argument)) {
+                        THROW_EXCEPTION(InvalidFormatException,
+                                        "Invalid parallel chunk size argument");
+                    }
+                    parallel_chunk_size_ = (size_t) tools::toInt(argument);
+                }
+                else if (option == "-nps"
+                         || option == "--num-pipeline-stages") {
+                    if (has_argument) {
+                        if (!isCompositeOption(option)) {
+                            argument = argv[index + 1];
+                            ++index;
+                        }
+                    }
+                    else {
+                        THROW_EXCEPTION(InvalidFormatException,
+                                        "No number of pipeline stages "
+                                        "argument");
+                    }
+
+                    if (!tools::isNumeric(argument)) {
+                        THROW_EXCEPTION(InvalidFormatException,
+                                        "Invalid number of pipeline stages "
+                                        "argument");
+                    }
+                    try {
+                        setNumPipelineStages(
+                            (size_t) tools::toInt(argument));
+                    }
+                    catch (InvalidArgumentException& ex) {
+                        THROW_EXCEPTION(InvalidFormatException,
+                                        ex.getMessage());
+                    }
+                }
+                else if (option == "-nt" || option == "--num-threads") {
+                    if (has_argument) {
+                        if (!isCompositeOption(option)) {
+                            argument = argv[index + 1];
+                            ++index;
+                        }
+                    }
+                    else {
+                        THROW_EXCEPTION(InvalidFormatException,
+                                        "No number of threads argument");
+                    }
+
+                    if (!tools::isNumeric(argument)) {
+                        THROW_EXCEPTION(InvalidFormatException,
+                                        "Invalid number of threads argument");
+                    }
+                    try {
+                        setNumThreads((size_t) tools::toInt(argument));
+                    }
+                    catch (InvalidArgumentException& ex) {
+                        THROW_EXCEPTION(InvalidFormatException,
+                                        ex.getMessage());
+                    }
+                }
+                else if (option == "-j" || option == "--jobs") {
+                    if (has_argument) {
+                        if (!isCompositeOption(option)) {
+                            argument = argv[index + 1];
+                            ++index;
+                        }
+                    }
+                    else {
+                        THROW_EXCEPTION(InvalidFormatException,
+                                        "No number of jobs argument");
+                    }
+
+                    if (!tools::isNumeric(argument)) {
+                        THROW_EXCEPTION(InvalidFormatException,
+                                        "Invalid number of jobs argument");
+                    }
+                    try {
+                        setNumParserThreads((size_t) tools::toInt(argument));
+                    }
+                    catch (InvalidArgumentException& ex) {
+                        THROW_EXCEPTION(InvalidFormatException,
+                                        ex.getMessage());
+                    }
+                }
+                else if (option == "-xs" || option == "--xml-streaming") {
+                    do_xml_streaming_ = true;
+                }
+                else if (option == "-bp"
+                         || option == "--block-processing") {
+                    do_block_processing_ = true;
+                }
                 /*
                  // Usage of shared memory for output data is not yet supported
                 else if (option == "-use-sm-o" 
@@ -364,11 +803,26 @@ void Config::setFromCommandLine(int argc, const char** argv)
                     output_file_ += ".cu";
                     break;
                 }
+                case C_MULTICORE: {
+                    output_file_ += ".c";
+                    break;
+                }
+
+                case C_PIPELINED: {
+                    output_file_ += ".c";
+                    break;
+                }
+
+                case C_TASK_PARALLEL: {
+                    output_file_ += ".c";
+                    break;
+                }
             }
         }
         std::string extension = tools::getExtension(input_file_);
         if (extension == "xml") format_ = XML;
         else if (extension == "graphml") format_ = GraphML;
+        else if (extension == "f2ccpn") format_ = Binary;
         else THROW_EXCEPTION(InvalidFormatException, "Input format not recognized");
     }
     catch(InvalidFormatException& ex) {
@@ -385,6 +839,54 @@ void Config::setDoDataParallelLeafCoalesing(bool setting) throw() {
     do_data_parallel_leaf_coalescing_ = setting;
 }
 
+bool Config::doZeroCopyViews() const throw() {
+    return do_zero_copy_views_;
+}
+
+void Config::setDoZeroCopyViews(bool setting) throw() {
+    do_zero_copy_views_ = setting;
+}
+
+bool Config::doMemoryPlanning() const throw() {
+    return do_memory_planning_;
+}
+
+void Config::setDoMemoryPlanning(bool setting) throw() {
+    do_memory_planning_ = setting;
+}
+
+bool Config::doLocalityAwareScheduling() const throw() {
+    return do_locality_aware_scheduling_;
+}
+
+void Config::setDoLocalityAwareScheduling(bool setting) throw() {
+    do_locality_aware_scheduling_ = setting;
+}
+
+bool Config::doReentrantCode() const throw() {
+    return do_reentrant_code_;
+}
+
+void Config::setDoReentrantCode(bool setting) throw() {
+    do_reentrant_code_ = setting;
+}
+
+bool Config::doGenerateBenchmark() const throw() {
+    return do_generate_benchmark_;
+}
+
+void Config::setDoGenerateBenchmark(bool setting) throw() {
+    do_generate_benchmark_ = setting;
+}
+
+bool Config::doProfiling() const throw() {
+    return do_profiling_;
+}
+
+void Config::setDoProfiling(bool setting) throw() {
+    do_profiling_ = setting;
+}
+
 bool Config::useSharedMemoryForInput() const throw() {
     return use_shared_memory_for_input_;
 }
@@ -401,6 +903,83 @@ void Config::setUseSharedMemoryForOutput(bool setting) throw() {
     use_shared_memory_for_output_ = setting;
 }
 
+bool Config::doBlockProcessing() const throw() {
+    return do_block_processing_;
+}
+
+void Config::setDoBlockProcessing(bool setting) throw() {
+    do_block_processing_ = setting;
+}
+
+string Config::getParallelSchedule() const throw() {
+    return parallel_schedule_;
+}
+
+void Config::setParallelSchedule(const string& schedule)
+    throw(InvalidArgumentException) {
+    if (schedule != "static" && schedule != "dynamic" && schedule != "guided"
+        && schedule != "auto" && schedule != "runtime") {
+        THROW_EXCEPTION(InvalidArgumentException, string("Invalid parallel ")
+                        + "schedule \"" + schedule + "\"");
+    }
+    parallel_schedule_ = schedule;
+}
+
+size_t Config::getParallelChunkSize() const throw() {
+    return parallel_chunk_size_;
+}
+
+void Config::setParallelChunkSize(size_t size) throw() {
+    parallel_chunk_size_ = size;
+}
+
+size_t Config::getNumPipelineStages() const throw() {
+    return num_pipeline_stages_;
+}
+
+void Config::setNumPipelineStages(size_t num_stages)
+    throw(InvalidArgumentException) {
+    if (num_stages == 0) {
+        THROW_EXCEPTION(InvalidArgumentException, "Number of pipeline stages "
+                        "must be at least 1");
+    }
+    num_pipeline_stages_ = num_stages;
+}
+
+size_t Config::getNumThreads() const throw() {
+    return num_threads_;
+}
+
+void Config::setNumThreads(size_t num_threads)
+    throw(InvalidArgumentException) {
+    if (num_threads == 0) {
+        THROW_EXCEPTION(InvalidArgumentException, "Number of threads must be "
+                        "at least 1");
+    }
+    num_threads_ = num_threads;
+}
+
+size_t Config::getNumParserThreads() const throw() {
+    return num_parser_threads_;
+}
+
+void Config::setNumParserThreads(size_t num_threads)
+    throw(InvalidArgumentException) {
+    if (num_threads == 0) {
+        THROW_EXCEPTION(InvalidArgumentException, "Number of parser threads "
+                        "must be at least 1");
+    }
+    num_parser_threads_ = num_threads;
+}
+
+bool Config::doXmlStreaming() const throw() {
+    return do_xml_streaming_;
+}
+
+void Config::setDoXmlStreaming(bool setting) throw() {
+    do_xml_streaming_ = setting;
+}
+
 Config::TargetPlatform Config::getTargetPlatform() const throw() {
     return target_platform_;
 }
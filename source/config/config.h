@@ -67,7 +67,28 @@ class Config {
          * Sequential C code annotaded with CUDA directives, where data parallel
          * leafs are executed in parallel.
          */
-        CUDA
+        CUDA,
+
+        /**
+         * C code where data parallel leafs are executed in parallel on
+         * multiple cores, using OpenMP or, when the code is compiled without
+         * OpenMP support, POSIX threads.
+         */
+        C_MULTICORE,
+
+        /**
+         * C code where the leaf schedule is split into pipeline stages, each
+         * executed on a separate POSIX thread.
+         */
+        C_PIPELINED,
+
+        /**
+         * C code where each leaf is a task which is started as soon as the
+         * leafs it depends on have finished, allowing independent branches of
+         * the process network to execute concurrently on a pool of POSIX
+         * threads.
+         */
+        C_TASK_PARALLEL
     };
 
     /**
@@ -83,7 +104,12 @@ class Config {
         /**
          * ForSyDe-Haskell intermediate GraphML representation.
          */
-        GraphML
+        GraphML,
+
+        /**
+         * Binary model file previously saved by f2cc.
+         */
+        Binary
     };
 
     /**
@@ -166,6 +192,15 @@ class Config {
      */
     std::string getImplementationOutputFile() const throw();
 
+    /**
+     * Gets the benchmark driver output file path. The file has the same name
+     * as the implementation output file, suffixed with \c _bench, and the
+     * same extension.
+     *
+     * @returns Benchmark driver output file path.
+     */
+    std::string getBenchmarkOutputFile() const throw();
+
     /**
      * Sets the output file path.
      *
@@ -189,6 +224,38 @@ class Config {
      */
     void setLogFile(std::string file) throw();
 
+    /**
+     * Gets the directory in which synthesized code is cached. Default setting
+     * is an empty path, which disables the cache.
+     *
+     * @returns Cache directory path.
+     */
+    std::string getCacheDirectory() const throw();
+
+    /**
+     * Sets the cache directory path.
+     *
+     * @param directory
+     *        Cache directory path, or an empty path to disable the cache.
+     */
+    void setCacheDirectory(std::string directory) throw();
+
+    /**
+     * Gets the file in which the parsed model is saved in binary form. Default
+     * setting is an empty path, which disables saving.
+     *
+     * @returns Model snapshot file path.
+     */
+    std::string getModelSnapshotFile() const throw();
+
+    /**
+     * Sets the model snapshot file path.
+     *
+     * @param file
+     *        Model snapshot file path, or an empty path to disable saving.
+     */
+    void setModelSnapshotFile(std::string file) throw();
+
     /**
      * Gets the log level. Default level is Logger::INFO.
      *
@@ -204,6 +271,54 @@ class Config {
      */
     void setLogLevel(Logger::LogLevel level) throw();
 
+    /**
+     * Gets whether log messages should be written by a background thread.
+     * Default setting is \b false.
+     *
+     * @returns \b true if logging is to be asynchronous.
+     */
+    bool doAsyncLogging() const throw();
+
+    /**
+     * Sets whether log messages should be written by a background thread.
+     *
+     * @param setting
+     *        New setting.
+     */
+    void setDoAsyncLogging(bool setting) throw();
+
+    /**
+     * Gets the log flush policy. Default policy is
+     * Logger::FLUSH_EVERY_MESSAGE.
+     *
+     * @returns Log flush policy.
+     */
+    Logger::FlushPolicy getLogFlushPolicy() const throw();
+
+    /**
+     * Sets the log flush policy.
+     *
+     * @param policy
+     *        Log flush policy.
+     */
+    void setLogFlushPolicy(Logger::FlushPolicy policy) throw();
+
+    /**
+     * Gets whether log messages should also be printed to the console.
+     * Default setting is \b true.
+     *
+     * @returns \b true if log messages are to be printed.
+     */
+    bool doLogToConsole() const throw();
+
+    /**
+     * Sets whether log messages should also be printed to the console.
+     *
+     * @param setting
+     *        New setting.
+     */
+    void setDoLogToConsole(bool setting) throw();
+
     /**
      * Gets whether data parallel leafs in the processnetwork should be coalesced.
      * Default setting is \b true.
@@ -220,6 +335,112 @@ class Config {
      */
     void setDoDataParallelLeafCoalesing(bool setting) throw();
 
+    /**
+     * Gets whether the outputs of \c Unzipx leafs and the inputs of \c Zipx
+     * leafs should, where possible, be synthesized as views into the
+     * corresponding input or output array instead of as separate arrays which
+     * are copied element by element. Default setting is \b true.
+     *
+     * @returns \b true if such views are to be used.
+     */
+    bool doZeroCopyViews() const throw();
+
+    /**
+     * Sets whether zero-copy views should be used for \c Unzipx and \c Zipx
+     * leafs.
+     *
+     * @param setting
+     *        New setting.
+     */
+    void setDoZeroCopyViews(bool setting) throw();
+
+    /**
+     * Gets whether the internal signal arrays should be placed in a single,
+     * preallocated memory arena where arrays whose lifetimes do not overlap
+     * share the same memory, instead of being allocated one by one. Default
+     * setting is \b true.
+     *
+     * @returns \b true if the signal memory is to be planned.
+     */
+    bool doMemoryPlanning() const throw();
+
+    /**
+     * Sets whether the internal signal arrays should be placed in a planned
+     * memory arena.
+     *
+     * @param setting
+     *        New setting.
+     */
+    void setDoMemoryPlanning(bool setting) throw();
+
+    /**
+     * Gets whether the leaf schedule should place each leaf directly after
+     * the leaf producing its input, when possible, instead of scheduling the
+     * leafs level by level. Default setting is \b false.
+     *
+     * @returns \b true if the schedule is to be locality-aware.
+     */
+    bool doLocalityAwareScheduling() const throw();
+
+    /**
+     * Sets whether the leaf schedule should be locality-aware.
+     *
+     * @param setting
+     *        New setting.
+     */
+    void setDoLocalityAwareScheduling(bool setting) throw();
+
+    /**
+     * Gets whether the synthesized code should be reentrant, i.e. keep the
+     * delay state in a caller-owned state struct which is passed to the
+     * processnetwork functions instead of in \c static variables. Default
+     * setting is \b false.
+     *
+     * @returns \b true if the code is to be reentrant.
+     */
+    bool doReentrantCode() const throw();
+
+    /**
+     * Sets whether the synthesized code should be reentrant.
+     *
+     * @param setting
+     *        New setting.
+     */
+    void setDoReentrantCode(bool setting) throw();
+
+    /**
+     * Gets whether a benchmark driver should be generated along with the
+     * synthesized code. Default setting is \b false.
+     *
+     * @returns \b true if a benchmark driver is to be generated.
+     */
+    bool doGenerateBenchmark() const throw();
+
+    /**
+     * Sets whether a benchmark driver should be generated.
+     *
+     * @param setting
+     *        New setting.
+     */
+    void setDoGenerateBenchmark(bool setting) throw();
+
+    /**
+     * Gets whether the synthesized code should be instrumented to measure the
+     * time spent in each leaf. Default setting is \b false.
+     *
+     * @returns \b true if the code is to be instrumented.
+     */
+    bool doProfiling() const throw();
+
+    /**
+     * Sets whether the synthesized code should be instrumented to measure the
+     * time spent in each leaf.
+     *
+     * @param setting
+     *        New setting.
+     */
+    void setDoProfiling(bool setting) throw();
+
     /**
      * Gets whether the shared memory on the device shall be used for input data
      * in the synthesized CUDA code. Default setting is \b false.
@@ -251,6 +472,134 @@ class Config {
      */
     void setUseSharedMemoryForOutput(bool setting) throw();
 
+    /**
+     * Gets whether the synthesized code should also provide a block-processing
+     * entry point, which executes the processnetwork over an entire block of
+     * input tokens in a single call. Default setting is \b false.
+     *
+     * @returns \b true if the block-processing function is to be generated.
+     */
+    bool doBlockProcessing() const throw();
+
+    /**
+     * Sets whether a block-processing entry point should be generated.
+     *
+     * @param setting
+     *        New setting.
+     */
+    void setDoBlockProcessing(bool setting) throw();
+
+    /**
+     * Gets the OpenMP loop schedule kind to use for data parallel leafs in
+     * the synthesized multi-core C code. Default setting is "static".
+     *
+     * @returns Loop schedule kind.
+     */
+    std::string getParallelSchedule() const throw();
+
+    /**
+     * Sets the OpenMP loop schedule kind.
+     *
+     * @param schedule
+     *        Loop schedule kind. Valid kinds are "static", "dynamic",
+     *        "guided", "auto", and "runtime".
+     * @throws InvalidArgumentException
+     *         When \c schedule is not a valid schedule kind.
+     */
+    void setParallelSchedule(const std::string& schedule)
+        throw(InvalidArgumentException);
+
+    /**
+     * Gets the OpenMP loop chunk size to use for data parallel leafs in the
+     * synthesized multi-core C code. A chunk size of 0 means that the chunk
+     * size is left to the OpenMP implementation. Default setting is 0.
+     *
+     * @returns Loop chunk size.
+     */
+    size_t getParallelChunkSize() const throw();
+
+    /**
+     * Sets the OpenMP loop chunk size.
+     *
+     * @param size
+     *        Loop chunk size.
+     */
+    void setParallelChunkSize(size_t size) throw();
+
+    /**
+     * Gets the number of pipeline stages into which the leaf schedule is split
+     * in the synthesized pipelined C code. Default setting is 4.
+     *
+     * @returns Number of pipeline stages.
+     */
+    size_t getNumPipelineStages() const throw();
+
+    /**
+     * Sets the number of pipeline stages.
+     *
+     * @param num_stages
+     *        Number of pipeline stages.
+     * @throws InvalidArgumentException
+     *         When \c num_stages is 0.
+     */
+    void setNumPipelineStages(size_t num_stages)
+        throw(InvalidArgumentException);
+
+    /**
+     * Gets the number of threads in the pool which executes the leaf tasks in
+     * the synthesized task-parallel C code. Default setting is 4.
+     *
+     * @returns Number of threads.
+     */
+    size_t getNumThreads() const throw();
+
+    /**
+     * Sets the number of threads.
+     *
+     * @param num_threads
+     *        Number of threads.
+     * @throws InvalidArgumentException
+     *         When \c num_threads is 0.
+     */
+    void setNumThreads(size_t num_threads)
+        throw(InvalidArgumentException);
+
+    /**
+     * Gets the number of threads which parse the C function files referenced
+     * by an XML model. Default setting is 1.
+     *
+     * @returns Number of parser threads.
+     */
+    size_t getNumParserThreads() const throw();
+
+    /**
+     * Sets the number of parser threads.
+     *
+     * @param num_threads
+     *        Number of parser threads.
+     * @throws InvalidArgumentException
+     *         When \c num_threads is 0.
+     */
+    void setNumParserThreads(size_t num_threads)
+        throw(InvalidArgumentException);
+
+    /**
+     * Gets whether XML models should be streamed, such that each file is read
+     * one element at a time instead of being loaded as a whole. Default
+     * setting is \b false.
+     *
+     * @returns \b true if XML models are to be streamed.
+     */
+    bool doXmlStreaming() const throw();
+
+    /**
+     * Sets whether XML models should be streamed.
+     *
+     * @param setting
+     *        New setting.
+     */
+    void setDoXmlStreaming(bool setting) throw();
+
     /**
      * Gets the target platform. Default platform is Config::CUDA.
      *
@@ -365,16 +714,71 @@ class Config {
      */
     std::string log_file_;
 
+    /**
+     * Specifies the cache directory path.
+     */
+    std::string cache_directory_;
+
+    /**
+     * Specifies the model snapshot file path.
+     */
+    std::string model_snapshot_file_;
+
     /**
      * Specifies the log level used in the logger.
      */
     Logger::LogLevel log_level_;
 
+    /**
+     * Specifies asynchronous logging setting.
+     */
+    bool do_async_logging_;
+
+    /**
+     * Specifies the log flush policy.
+     */
+    Logger::FlushPolicy log_flush_policy_;
+
+    /**
+     * Specifies console logging setting.
+     */
+    bool do_log_to_console_;
+
     /**
      * Specifies data parallel leaf coalescing setting.
      */
     bool do_data_parallel_leaf_coalescing_;
 
+    /**
+     * Specifies zero-copy view setting.
+     */
+    bool do_zero_copy_views_;
+
+    /**
+     * Specifies memory planning setting.
+     */
+    bool do_memory_planning_;
+
+    /**
+     * Specifies locality-aware scheduling setting.
+     */
+    bool do_locality_aware_scheduling_;
+
+    /**
+     * Specifies reentrant code setting.
+     */
+    bool do_reentrant_code_;
+
+    /**
+     * Specifies benchmark driver generation setting.
+     */
+    bool do_generate_benchmark_;
+
+    /**
+     * Specifies profiling instrumentation setting.
+     */
+    bool do_profiling_;
+
     /**
      * Specifies shared memory usage setting.
      */
@@ -385,6 +789,41 @@ class Config {
      */
     bool use_shared_memory_for_output_;
 
+    /**
+     * Specifies block-processing setting.
+     */
+    bool do_block_processing_;
+
+    /**
+     * Specifies the OpenMP loop schedule kind.
+     */
+    std::string parallel_schedule_;
+
+    /**
+     * Specifies the OpenMP loop chunk size.
+     */
+    size_t parallel_chunk_size_;
+
+    /**
+     * Specifies the number of pipeline stages.
+     */
+    size_t num_pipeline_stages_;
+
+    /**
+     * Specifies the number of threads in the task pool.
+     */
+    size_t num_threads_;
+
+    /**
+     * Specifies the number of threads which parse C function files.
+     */
+    size_t num_parser_threads_;
+
+    /**
+     * Specifies XML streaming setting.
+     */
+    bool do_xml_streaming_;
+
     /**
      * Specifies the target platform.
      */
@@ -44,10 +44,13 @@
 #include "frontend/frontend.h"
 #include "frontend/graphmlparser.h"
 #include "frontend/xmlparser.h"
+#include "frontend/binaryloader.h"
+#include "frontend/binarydumper.h"
 #include "forsyde/processnetwork.h"
 #include "forsyde/leaf.h"
 #include "forsyde/modelmodifier.h"
 #include "synthesizer/synthesizer.h"
+#include "synthesizer/synthesiscache.h"
 #include "exceptions/exception.h"
 #include "exceptions/ioexception.h"
 #include "exceptions/filenotfoundexception.h"
@@ -120,6 +123,9 @@ int main(int argc, const char* argv[]) {
     // Prepare logger
     Logger logger;
     logger.setLogLevel(config.getLogLevel());
+    logger.setFlushPolicy(config.getLogFlushPolicy());
+    logger.setConsoleEcho(config.doLogToConsole());
+    logger.setAsynchronous(config.doAsyncLogging());
     try {
         logger.open(config.getLogFile());
     }
@@ -132,28 +138,64 @@ int main(int argc, const char* argv[]) {
     // Execute
     try {
         try {
-        	Frontend* parser;
-            switch (config.getInputFormat()) {
-                case Config::XML: {
-                	logger.logInfoMessage(string("New XML format assumed.")
-                			+ " The execution will follow the path from v0.2...");
-                	parser = new (std::nothrow) XmlParser(logger);
-                    break;
+            SynthesisCache cache(config, logger);
+            if (cache.isEnabled()) {
+                logger.logInfoMessage(string("CACHE DIRECTORY: ")
+                                      + config.getCacheDirectory());
+                // Saving the model requires it to be parsed, so the cached
+                // code cannot be used on its own
+                if (!config.getModelSnapshotFile().empty()) {
+                    logger.logInfoMessage("Model is to be saved, ignoring "
+                                          "cached code");
                 }
-
-                case Config::CUDA: {
-                	logger.logInfoMessage(string("Old GraphML format assumed.")
-                	        + " The execution will follow the path from v0.1...");
-                	parser = new (std::nothrow) GraphmlParser(logger);
-                    break;
+                else if (cache.restore()) {
+                    logger.logInfoMessage("MODEL SYNTHESIS COMPLETE");
+                    logger.logDebugMessage("Closing logger...");
+                    logger.close();
+                    return 0;
                 }
             }
-            if (!parser) THROW_EXCEPTION(OutOfMemoryException);
+
             logger.logInfoMessage(string("MODEL INPUT FILE: ")
                                   + config.getInputFile());
-            logger.logInfoMessage("Parsing input file...");
-            ProcessNetwork* processnetwork = parser->parse(config.getInputFile());
-            delete parser;
+            ProcessNetwork* processnetwork;
+            set<string> input_files;
+            if (config.getInputFormat() == Config::Binary) {
+                // A binary model has already been checked and fixed by the
+                // frontend which created it
+                logger.logInfoMessage("Binary model assumed.");
+                logger.logInfoMessage("Loading input file...");
+                BinaryLoader loader(logger);
+                processnetwork = loader.load(config.getInputFile());
+                input_files.insert(config.getInputFile());
+            }
+            else {
+                Frontend* parser;
+                if (config.getInputFormat() == Config::XML) {
+                    logger.logInfoMessage(string("New XML format assumed.")
+                            + " The execution will follow the path from v0.2...");
+                    parser = new (std::nothrow) XmlParser(logger,
+                            config.getNumParserThreads(),
+                            config.doXmlStreaming(),
+                            config.getCacheDirectory());
+                }
+                else {
+                    logger.logInfoMessage(string("Old GraphML format assumed.")
+                            + " The execution will follow the path from v0.1...");
+                    parser = new (std::nothrow) GraphmlParser(logger);
+                }
+                if (!parser) THROW_EXCEPTION(OutOfMemoryException);
+                logger.logInfoMessage("Parsing input file...");
+                processnetwork = parser->parse(config.getInputFile());
+                input_files = parser->getInputFiles();
+                delete parser;
+            }
+
+            if (!config.getModelSnapshotFile().empty()) {
+                logger.logInfoMessage("Saving model...");
+                BinaryDumper dumper(logger);
+                dumper.dump(processnetwork, config.getModelSnapshotFile());
+            }
 
             string processnetwork_info_message("MODEL INFO:\n");
             processnetwork_info_message += getProcessNetworkInfo(processnetwork);
@@ -170,6 +212,21 @@ int main(int argc, const char* argv[]) {
                     target_platform_message += "CUDA";
                     break;
                 }
+
+                case Config::C_MULTICORE: {
+                    target_platform_message += "C-MULTICORE";
+                    break;
+                }
+
+                case Config::C_PIPELINED: {
+                    target_platform_message += "C-PIPELINED";
+                    break;
+                }
+
+                case Config::C_TASK_PARALLEL: {
+                    target_platform_message += "C-TASK-PARALLEL";
+                    break;
+                }
             }
             logger.logInfoMessage(target_platform_message);
 
@@ -180,7 +237,8 @@ int main(int argc, const char* argv[]) {
             logger.logInfoMessage("Converting Comb leafs "
                               "with one in port to Comb leafs...");
             modifier.convertZipWith1ToMap();
-            if (config.getTargetPlatform() == Config::CUDA) {
+            if (config.getTargetPlatform() == Config::CUDA
+                || config.getTargetPlatform() == Config::C_MULTICORE) {
                 string leaf_coalescing_message("DATA PARALLEL PROCESS "
                                                   "COALESCING: ");
                 if (config.doDataParallelLeafCoalesing()) {
@@ -219,23 +277,34 @@ int main(int argc, const char* argv[]) {
 
             // Generate code and write to file
             Synthesizer synthesizer(processnetwork, logger, config);
-            Synthesizer::CodeSet code;
             switch (config.getTargetPlatform()) {
                 case Config::C: {
-                    code = synthesizer.generateCCode();
+                    synthesizer.generateCCode();
                     break;
                 }
 
                 case Config::CUDA: {
-                    code = synthesizer.generateCudaCCode();
+                    synthesizer.generateCudaCCode();
+                    break;
+                }
+
+                case Config::C_MULTICORE: {
+                    synthesizer.generateMulticoreCCode();
+                    break;
+                }
+
+                case Config::C_PIPELINED: {
+                    synthesizer.generatePipelinedCCode();
+                    break;
+                }
+
+                case Config::C_TASK_PARALLEL: {
+                    synthesizer.generateTaskParallelCCode();
                     break;
                 }
             }
 
-            logger.logInfoMessage("Writing code to output files...");
-            tools::writeFile(config.getHeaderOutputFile(), code.header);
-            tools::writeFile(config.getImplementationOutputFile(),
-                             code.implementation);
+            cache.store(input_files);
 
             logger.logInfoMessage("MODEL SYNTHESIS COMPLETE");
 
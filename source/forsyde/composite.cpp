@@ -465,6 +465,16 @@ Process::Interface* Composite::IOPort::getConnectedPortInside() const throw() {
     return connected_port_inside_;
 }
 
+void Composite::IOPort::setConnectionOutside(Process::Interface* interface)
+    throw() {
+    connected_port_outside_ = interface;
+}
+
+void Composite::IOPort::setConnectionInside(Process::Interface* interface)
+    throw() {
+    connected_port_inside_ = interface;
+}
+
 
 bool Composite::IOPort::isConnectedToLeafOutside() const throw() {
     if (connected_port_outside_) {
@@ -512,6 +512,28 @@ public:
          */
 		Leaf::Port* getConnectedLeafPortInside() const throw(CastException);
 
+        /**
+         * Sets the immediate adjacent \c Process::Interface outside this
+         * \c IOPort's parent process. Unlike the connect(Interface*) method,
+         * this one does not check for the validity of the given interface, nor
+         * does it connect the interface back to this \c IOPort. It is not
+         * advisable to use this method from outside f2cc::Forsyde namespace.
+         *
+         * @param interface
+         *        Interface to connect, or \c NULL.
+         */
+		void setConnectionOutside(Interface* interface) throw();
+
+        /**
+         * Sets the immediate adjacent \c Process::Interface inside this
+         * \c IOPort's parent process. Like setConnectionOutside(Interface*),
+         * it is not advisable to use this method from outside f2cc::Forsyde
+         * namespace.
+         *
+         * @param interface
+         *        Interface to connect, or \c NULL.
+         */
+		void setConnectionInside(Interface* interface) throw();
 
       private:
         /**
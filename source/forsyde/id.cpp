@@ -26,20 +26,109 @@
  */
 
 #include "id.h"
+#include <vector>
+#include <cstdlib>
+#include <pthread.h>
 
 using namespace f2cc::Forsyde;
 using std::string;
+using std::vector;
 
-Id::Id(const string& id) throw() : id_(id) {}
+namespace {
+
+/**
+ * Number of bits of a symbol which select the string within a chunk.
+ */
+const unsigned int kChunkBits = 12;
+
+/**
+ * Number of strings per chunk.
+ */
+const unsigned int kChunkSize = 1u << kChunkBits;
+
+/**
+ * Maximum number of chunks, which limits the table to 2^28 strings.
+ */
+const unsigned int kMaxChunks = 1u << 16;
+
+/**
+ * @brief Table which maps ID strings to symbols.
+ *
+ * The strings are stored in fixed-size chunks which are never moved or freed
+ * while the program runs, so a string can be looked up by its symbol without
+ * taking the lock even while other threads add new strings. Symbols are
+ * looked up through a chained hash table whose number of buckets is always a
+ * power of 2.
+ */
+struct InternTable {
+    string* chunks[kMaxChunks];
+    unsigned int size;
+    vector< vector<unsigned int> > buckets;
+
+    InternTable() : size(0), buckets(1024) {
+        for (unsigned int i = 0; i < kMaxChunks; ++i) chunks[i] = NULL;
+    }
+
+    ~InternTable() {
+        for (unsigned int i = 0; i < kMaxChunks && chunks[i]; ++i) {
+            delete[] chunks[i];
+        }
+    }
+
+    const string& at(unsigned int symbol) const {
+        return chunks[symbol >> kChunkBits][symbol & (kChunkSize - 1)];
+    }
+};
+
+/**
+ * Guards all modifications of the intern table.
+ */
+pthread_mutex_t intern_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+InternTable& getInternTable() {
+    static InternTable table;
+    return table;
+}
+
+unsigned int hashString(const string& str) {
+    // FNV-1a
+    unsigned int hash = 2166136261u;
+    for (string::const_iterator it = str.begin(); it != str.end(); ++it) {
+        hash ^= static_cast<unsigned char>(*it);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void rehash(InternTable& table) {
+    vector< vector<unsigned int> > buckets(table.buckets.size() * 2);
+    size_t mask = buckets.size() - 1;
+    for (unsigned int symbol = 0; symbol < table.size; ++symbol) {
+        buckets[hashString(table.at(symbol)) & mask].push_back(symbol);
+    }
+    table.buckets.swap(buckets);
+}
+
+}
+
+Id::Id(const string& id) throw() : symbol_(intern(id)) {}
 
 Id::~Id() throw() {}
 
 string Id::getString() const throw() {
-    return id_;
+    return lookup(symbol_);
+}
+
+unsigned int Id::getSymbol() const throw() {
+    return symbol_;
+}
+
+unsigned int Id::hash() const throw() {
+    return symbol_;
 }
 
 bool Id::operator==(const Id& rhs) const throw() {
-    return id_ == rhs.id_;
+    return symbol_ == rhs.symbol_;
 }
 
 bool Id::operator!=(const Id& rhs) const throw() {
@@ -47,10 +136,44 @@ bool Id::operator!=(const Id& rhs) const throw() {
 }
 
 bool Id::operator<(const Id& rhs) const throw() {
-    return id_.compare(rhs.id_) < 0;
+    if (symbol_ == rhs.symbol_) return false;
+    return lookup(symbol_).compare(lookup(rhs.symbol_)) < 0;
+}
+
+unsigned int Id::intern(const string& str) throw() {
+    InternTable& table = getInternTable();
+    unsigned int hash = hashString(str);
+    pthread_mutex_lock(&intern_mutex);
+    vector<unsigned int>& bucket =
+        table.buckets[hash & (table.buckets.size() - 1)];
+    for (vector<unsigned int>::const_iterator it = bucket.begin();
+         it != bucket.end(); ++it) {
+        if (table.at(*it) == str) {
+            unsigned int symbol = *it;
+            pthread_mutex_unlock(&intern_mutex);
+            return symbol;
+        }
+    }
+
+    unsigned int symbol = table.size;
+    if ((symbol >> kChunkBits) >= kMaxChunks) std::abort();
+    string*& chunk = table.chunks[symbol >> kChunkBits];
+    if (!chunk) chunk = new string[kChunkSize];
+    chunk[symbol & (kChunkSize - 1)] = str;
+    ++table.size;
+    bucket.push_back(symbol);
+    if (table.size > table.buckets.size()) {
+        rehash(table);
+    }
+    pthread_mutex_unlock(&intern_mutex);
+    return symbol;
+}
+
+const string& Id::lookup(unsigned int symbol) throw() {
+    return getInternTable().at(symbol);
 }
 
 std::ostream& f2cc::Forsyde::operator<<(std::ostream& stream, const Id& id) {
-    stream << id.getString();
+    stream << Id::lookup(id.symbol_);
     return stream;
 }
@@ -46,10 +46,18 @@ namespace Forsyde {
  * @brief A class used for identifying elements in the ForSyDe processnetwork.
  *
  * The \c Id class is used to represent IDs in the internal
- * representation of ForSyDe models. Although the ID itself is actually just a
- * string, wrapping it inside a class allows the class to be improved in case
- * the performance suffers for very large models due to working with string
- * comparison (which is not very efficient).
+ * representation of ForSyDe models. Every ID string is interned in a global
+ * table which assigns it a unique 32-bit symbol. Equality checks and hashing
+ * therefore only need to work on the symbol, and copying an ID does not
+ * require any string allocation. Interned strings are kept until the program
+ * exits. The ordering of IDs is still that of their strings, so ordered
+ * containers keyed by IDs iterate in the same order as before.
+ *
+ * IDs may be created, copied and compared from multiple threads at once.
+ * Adding a string to the interning table is guarded by a mutex, whereas
+ * getting the string of an existing ID takes no lock since interned strings
+ * are never moved. A single \c Id object, like any other value, must not be
+ * assigned to by one thread while being used by another.
  */
 class Id {
   public:
@@ -73,6 +81,22 @@ class Id {
      */
     std::string getString() const throw();
 
+    /**
+     * Gets the symbol assigned to this ID by the interning table. Two IDs have
+     * the same symbol if and only if their strings are identical.
+     *
+     * @returns ID symbol.
+     */
+    unsigned int getSymbol() const throw();
+
+    /**
+     * Gets a hash value for this ID. As the symbols are unique, this is
+     * simply the symbol itself.
+     *
+     * @returns Hash value.
+     */
+    unsigned int hash() const throw();
+
     /**
      * Checks for equality between this ID and another.
      *
@@ -105,9 +129,31 @@ class Id {
 
   private:
     /**
-     * ID string.
+     * Interns a string and gets its symbol. If the string has not been seen
+     * before, it is added to the interning table and assigned a new symbol.
+     * Safe to call from multiple threads.
+     *
+     * @param str
+     *        String to intern.
+     * @returns Symbol of the string.
+     */
+    static unsigned int intern(const std::string& str) throw();
+
+    /**
+     * Gets the string of an interned symbol. Takes no lock; the symbol must
+     * have been obtained through intern(), possibly by another thread.
+     *
+     * @param symbol
+     *        Symbol.
+     * @returns Reference to the interned string.
+     */
+    static const std::string& lookup(unsigned int symbol) throw();
+
+  private:
+    /**
+     * ID symbol.
      */
-    std::string id_;
+    unsigned int symbol_;
 };
 
 /**
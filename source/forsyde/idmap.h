@@ -0,0 +1,309 @@
+/*
+ * Copyright (c) 2011-2013
+ *     Gabriel Hjort Blindell <ghb@kth.se>
+ *     George Ungureanu <ugeorge@kth.se>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OF THIS SOFTWARE NOR THE
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef F2CC_SOURCE_FORSYDE_IDMAP_H_
+#define F2CC_SOURCE_FORSYDE_IDMAP_H_
+
+/**
+ * @file
+ * @version 0.1
+ *
+ * @brief Defines hash containers keyed by ForSyDe IDs.
+ */
+
+#include "id.h"
+#include <vector>
+#include <cstddef>
+
+namespace f2cc {
+namespace Forsyde {
+
+/**
+ * @brief A hash map keyed by \c Id symbols.
+ *
+ * As ID symbols are unique and handed out sequentially, they are used directly
+ * as hash values and no string is ever touched during a lookup. Entries are
+ * stored in a single array using linear probing, which is kept at most half
+ * full. The array is not allocated until the first entry is inserted, so empty
+ * maps are cheap. The iteration order is unspecified; use an ordered container
+ * where a deterministic order is required.
+ *
+ * The value type must be default-constructible and assignable.
+ */
+template <typename T>
+class IdMap {
+  private:
+    /**
+     * Entry in the probing array. Unused slots have \c EMPTY as symbol.
+     */
+    struct Slot {
+        unsigned int symbol;
+        T value;
+
+        Slot() : symbol(EMPTY), value() {}
+    };
+
+    /**
+     * Symbol marking an unused slot. This can never be handed out by the
+     * interning table.
+     */
+    static const unsigned int EMPTY = ~0u;
+
+  public:
+    /**
+     * Creates an empty map.
+     *
+     * @param initial_capacity
+     *        Number of slots to allocate on first insertion. Must be a power
+     *        of 2.
+     */
+    explicit IdMap(size_t initial_capacity = 16) throw()
+            : initial_capacity_(initial_capacity), size_(0) {}
+
+    /**
+     * Destroys this map.
+     */
+    ~IdMap() throw() {}
+
+    /**
+     * Inserts a value into this map. If the map already contains an entry for
+     * the ID, the entry is left untouched.
+     *
+     * @param id
+     *        Key.
+     * @param value
+     *        Value.
+     * @returns \b true if the value was inserted.
+     */
+    bool insert(const Id& id, const T& value) throw() {
+        if (2 * (size_ + 1) > slots_.size()) {
+            resize(slots_.empty() ? initial_capacity_ : 2 * slots_.size());
+        }
+        Slot& slot = getSlot(id.getSymbol());
+        if (slot.symbol != EMPTY) return false;
+        slot.symbol = id.getSymbol();
+        slot.value = value;
+        ++size_;
+        return true;
+    }
+
+    /**
+     * Finds the value of an ID.
+     *
+     * @param id
+     *        Key.
+     * @returns Pointer to the value, or \c NULL if the map does not contain
+     *          the ID.
+     */
+    T* find(const Id& id) throw() {
+        if (size_ == 0) return NULL;
+        Slot& slot = getSlot(id.getSymbol());
+        return slot.symbol != EMPTY ? &slot.value : NULL;
+    }
+
+    /**
+     * \copydoc find(const Id&)
+     */
+    const T* find(const Id& id) const throw() {
+        return const_cast<IdMap*>(this)->find(id);
+    }
+
+    /**
+     * Checks whether this map contains an ID.
+     *
+     * @param id
+     *        Key.
+     * @returns \b true if found.
+     */
+    bool contains(const Id& id) const throw() {
+        return find(id) != NULL;
+    }
+
+    /**
+     * Removes the entry of an ID.
+     *
+     * @param id
+     *        Key.
+     * @returns \b true if an entry was removed.
+     */
+    bool erase(const Id& id) throw() {
+        if (size_ == 0) return false;
+        size_t mask = slots_.size() - 1;
+        size_t hole = &getSlot(id.getSymbol()) - &slots_[0];
+        if (slots_[hole].symbol == EMPTY) return false;
+
+        // Shift back any following entries which would otherwise become
+        // unreachable from their home slot
+        for (size_t i = (hole + 1) & mask; slots_[i].symbol != EMPTY;
+             i = (i + 1) & mask) {
+            size_t home = slots_[i].symbol & mask;
+            bool movable = hole <= i ? (home <= hole || home > i)
+                                     : (home <= hole && home > i);
+            if (movable) {
+                slots_[hole] = slots_[i];
+                hole = i;
+            }
+        }
+        slots_[hole] = Slot();
+        --size_;
+        return true;
+    }
+
+    /**
+     * Removes all entries.
+     */
+    void clear() throw() {
+        slots_.clear();
+        size_ = 0;
+    }
+
+    /**
+     * Gets the number of entries.
+     *
+     * @returns Number of entries.
+     */
+    size_t size() const throw() {
+        return size_;
+    }
+
+  private:
+    /**
+     * Gets the slot which either holds a symbol or is the unused slot where
+     * it would be inserted. The probing array must not be empty.
+     *
+     * @param symbol
+     *        Symbol.
+     * @returns Slot.
+     */
+    Slot& getSlot(unsigned int symbol) throw() {
+        size_t mask = slots_.size() - 1;
+        size_t i = symbol & mask;
+        while (slots_[i].symbol != EMPTY && slots_[i].symbol != symbol) {
+            i = (i + 1) & mask;
+        }
+        return slots_[i];
+    }
+
+    /**
+     * Reallocates the probing array and reinserts all entries.
+     *
+     * @param capacity
+     *        New number of slots. Must be a power of 2.
+     */
+    void resize(size_t capacity) throw() {
+        std::vector<Slot> slots(capacity);
+        slots_.swap(slots);
+        for (typename std::vector<Slot>::iterator it = slots.begin();
+             it != slots.end(); ++it) {
+            if (it->symbol != EMPTY) getSlot(it->symbol) = *it;
+        }
+    }
+
+  private:
+    /**
+     * Probing array.
+     */
+    std::vector<Slot> slots_;
+
+    /**
+     * Number of slots allocated on first insertion.
+     */
+    size_t initial_capacity_;
+
+    /**
+     * Number of entries.
+     */
+    size_t size_;
+};
+
+/**
+ * @brief A hash set of \c Id symbols.
+ *
+ * Typically used for tracking visited elements during model traversals.
+ */
+class IdSet {
+  public:
+    /**
+     * Inserts an ID into this set.
+     *
+     * @param id
+     *        ID.
+     * @returns \b true if the ID was not already in the set.
+     */
+    bool insert(const Id& id) throw() {
+        return ids_.insert(id, true);
+    }
+
+    /**
+     * Checks whether this set contains an ID.
+     *
+     * @param id
+     *        ID.
+     * @returns \b true if found.
+     */
+    bool contains(const Id& id) const throw() {
+        return ids_.contains(id);
+    }
+
+    /**
+     * Removes an ID from this set.
+     *
+     * @param id
+     *        ID.
+     * @returns \b true if the ID was removed.
+     */
+    bool erase(const Id& id) throw() {
+        return ids_.erase(id);
+    }
+
+    /**
+     * Removes all IDs.
+     */
+    void clear() throw() {
+        ids_.clear();
+    }
+
+    /**
+     * Gets the number of IDs.
+     *
+     * @returns Number of IDs.
+     */
+    size_t size() const throw() {
+        return ids_.size();
+    }
+
+  private:
+    /**
+     * Underlying map.
+     */
+    IdMap<bool> ids_;
+};
+
+}
+}
+
+#endif
@@ -28,6 +28,7 @@
 #include "leaf.h"
 #include "composite.h"
 #include "../tools/tools.h"
+#include <algorithm>
 #include <new>
 #include <vector>
 
@@ -37,11 +38,13 @@ using std::list;
 using std::bad_alloc;
 using std::vector;
 
-Leaf::Leaf(const Id& id) throw() : Process(id) {}
+Leaf::Leaf(const Id& id) throw()
+        : Process(id), in_port_index_(4), out_port_index_(4), cost_(0) {}
 
 Leaf::Leaf(const Forsyde::Id& id, Forsyde::Hierarchy hierarchy,
  		const std::string moc, int cost) throw() :
-		Process(id, hierarchy), moc_(moc), cost_(cost){}
+		Process(id, hierarchy), in_port_index_(4), out_port_index_(4),
+		moc_(moc), cost_(cost){}
 
 Leaf::~Leaf() throw() {
     destroyAllPorts(in_ports_);
@@ -62,12 +65,10 @@ void  Leaf::setCost(int& cost) throw(){
 }
 
 bool Leaf::addInPort(const Id& id) throw(OutOfMemoryException) {
-    if (findPort(id, in_ports_) != in_ports_.end()) return false;
+    if (in_port_index_.contains(id)) return false;
 
     try {
-        Port* new_port = new Port(id, this);
-        in_ports_.push_back(new_port);
-        return true;
+        return addPort(new Port(id, this), in_ports_, in_port_index_);
     }
     catch (bad_alloc&) {
         THROW_EXCEPTION(OutOfMemoryException);
@@ -75,12 +76,11 @@ bool Leaf::addInPort(const Id& id) throw(OutOfMemoryException) {
 }
 
 bool Leaf::addInPort(const Id& id, CDataType datatype) throw(OutOfMemoryException) {
-    if (findPort(id, in_ports_) != in_ports_.end()) return false;
+    if (in_port_index_.contains(id)) return false;
 
     try {
-        Port* new_port = new Port(id, this, datatype);
-        in_ports_.push_back(new_port);
-        return true;
+        return addPort(new Port(id, this, datatype), in_ports_,
+                       in_port_index_);
     }
     catch (bad_alloc&) {
         THROW_EXCEPTION(OutOfMemoryException);
@@ -89,12 +89,10 @@ bool Leaf::addInPort(const Id& id, CDataType datatype) throw(OutOfMemoryExceptio
 
 
 bool Leaf::addInPort(Port& port) throw(OutOfMemoryException) {
-    if (findPort(*port.getId(), in_ports_) != in_ports_.end()) return false;
+    if (in_port_index_.contains(*port.getId())) return false;
 
     try {
-        Port* new_port = new Port(port, this);
-        in_ports_.push_back(new_port);
-        return true;
+        return addPort(new Port(port, this), in_ports_, in_port_index_);
     }
     catch (bad_alloc&) {
         THROW_EXCEPTION(OutOfMemoryException);
@@ -102,16 +100,7 @@ bool Leaf::addInPort(Port& port) throw(OutOfMemoryException) {
 }
 
 bool Leaf::deleteInPort(const Id& id) throw() {
-    list<Port*>::iterator it = findPort(id, in_ports_);
-    if (it != in_ports_.end()) {
-        Port* removed_port = *it;
-        in_ports_.erase(it);
-        delete removed_port;
-        return true;
-    }
-    else {
-        return false;
-    }
+    return deletePort(id, in_ports_, in_port_index_);
 }
 
 size_t Leaf::getNumInPorts() const throw() {
@@ -119,26 +108,23 @@ size_t Leaf::getNumInPorts() const throw() {
 }
 
 Leaf::Port* Leaf::getInPort(const Id& id) throw() {
-    list<Port*>::iterator it = findPort(id, in_ports_);
-    if (it != in_ports_.end()) {
-        return *it;
-    }
-    else {
-        return NULL;
-    }
+    Port** port = in_port_index_.find(id);
+    return port ? *port : NULL;
 }
 
 list<Leaf::Port*> Leaf::getInPorts() throw() {
+    return list<Port*>(in_ports_.begin(), in_ports_.end());
+}
+
+const Leaf::PortVector& Leaf::getInPortRange() const throw() {
     return in_ports_;
 }
 
 bool Leaf::addOutPort(const Id& id) throw(OutOfMemoryException) {
-    if (findPort(id, out_ports_) != out_ports_.end()) return false;
+    if (out_port_index_.contains(id)) return false;
 
     try {
-        Port* new_port = new Port(id, this);
-        out_ports_.push_back(new_port);
-        return true;
+        return addPort(new Port(id, this), out_ports_, out_port_index_);
     }
     catch (bad_alloc&) {
         THROW_EXCEPTION(OutOfMemoryException);
@@ -146,12 +132,11 @@ bool Leaf::addOutPort(const Id& id) throw(OutOfMemoryException) {
 }
 
 bool Leaf::addOutPort(const Id& id, CDataType datatype) throw(OutOfMemoryException) {
-    if (findPort(id, out_ports_) != out_ports_.end()) return false;
+    if (out_port_index_.contains(id)) return false;
 
     try {
-        Port* new_port = new Port(id, this, datatype);
-        out_ports_.push_back(new_port);
-        return true;
+        return addPort(new Port(id, this, datatype), out_ports_,
+                       out_port_index_);
     }
     catch (bad_alloc&) {
         THROW_EXCEPTION(OutOfMemoryException);
@@ -160,12 +145,10 @@ bool Leaf::addOutPort(const Id& id, CDataType datatype) throw(OutOfMemoryExcepti
 
 
 bool Leaf::addOutPort(Port& port) throw(OutOfMemoryException) {
-    if (findPort(*port.getId(), out_ports_) != out_ports_.end()) return false;
+    if (out_port_index_.contains(*port.getId())) return false;
 
     try {
-        Port* new_port = new Port(port, this);
-        out_ports_.push_back(new_port);
-        return true;
+        return addPort(new Port(port, this), out_ports_, out_port_index_);
     }
     catch (bad_alloc&) {
         THROW_EXCEPTION(OutOfMemoryException);
@@ -173,16 +156,7 @@ bool Leaf::addOutPort(Port& port) throw(OutOfMemoryException) {
 }
 
 bool Leaf::deleteOutPort(const Id& id) throw() {
-    list<Port*>::iterator it = findPort(id, out_ports_);
-    if (it != out_ports_.end()) {
-        Port* removed_port = *it;
-        out_ports_.erase(it);
-        delete removed_port;
-        return true;
-    }
-    else {
-        return false;
-    }
+    return deletePort(id, out_ports_, out_port_index_);
 }
 
 size_t Leaf::getNumOutPorts() const throw() {
@@ -190,16 +164,15 @@ size_t Leaf::getNumOutPorts() const throw() {
 }
 
 Leaf::Port* Leaf::getOutPort(const Id& id) throw() {
-    list<Port*>::iterator it = findPort(id, out_ports_);
-    if (it != out_ports_.end()) {
-        return *it;
-    }
-    else {
-        return NULL;
-    }
+    Port** port = out_port_index_.find(id);
+    return port ? *port : NULL;
 }
 
 list<Leaf::Port*> Leaf::getOutPorts() throw() {
+    return list<Port*>(out_ports_.begin(), out_ports_.end());
+}
+
+const Leaf::PortVector& Leaf::getOutPortRange() const throw() {
     return out_ports_;
 }
 
@@ -244,25 +217,37 @@ string Leaf::moreToString() const throw() {
     return "";
 }
 
-list<Leaf::Port*>::iterator Leaf::findPort(
-    const Id& id, list<Port*>& ports) const throw() {
-    list<Port*>::iterator it;
-    for (it = ports.begin(); it != ports.end(); ++it) {
-        if (*(*it)->getId() == id) {
-            return it;
-        }
+bool Leaf::addPort(Port* port, PortVector& ports, IdMap<Port*>& index)
+    throw(OutOfMemoryException) {
+    try {
+        ports.push_back(port);
     }
+    catch (bad_alloc&) {
+        delete port;
+        THROW_EXCEPTION(OutOfMemoryException);
+    }
+    index.insert(*port->getId(), port);
+    return true;
+}
 
-    // No such port was found
-    return it;
+bool Leaf::deletePort(const Id& id, PortVector& ports, IdMap<Port*>& index)
+    throw() {
+    Port** found = index.find(id);
+    if (!found) return false;
+
+    Port* removed_port = *found;
+    index.erase(id);
+    ports.erase(std::find(ports.begin(), ports.end(), removed_port));
+    delete removed_port;
+    return true;
 }
 
-string Leaf::portsToString(const list<Port*> ports) const throw() {
+string Leaf::portsToString(const PortVector& ports) const throw() {
     string str;
     if (ports.size() > 0) {
         str += "\n";
         bool first = true;
-        for (list<Leaf::Port*>::const_iterator it = ports.begin();
+        for (PortVector::const_iterator it = ports.begin();
              it != ports.end(); ++it) {
             if (!first) {
                 str += ",\n";
@@ -291,12 +276,11 @@ string Leaf::portsToString(const list<Port*> ports) const throw() {
     return str;
 }
 
-void Leaf::destroyAllPorts(list<Port*>& ports) throw() {
-    while (ports.size() > 0) {
-        Port* port = ports.front();
-        ports.pop_front();
-        delete port;
+void Leaf::destroyAllPorts(PortVector& ports) throw() {
+    for (PortVector::iterator it = ports.begin(); it != ports.end(); ++it) {
+        delete *it;
     }
+    ports.clear();
 }
 
 bool Leaf::operator==(const Leaf& rhs) const throw() {
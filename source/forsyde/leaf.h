@@ -38,6 +38,7 @@
  */
 
 #include "id.h"
+#include "idmap.h"
 #include "hierarchy.h"
 #include "process.h"
 #include "../language/cdatatype.h"
@@ -48,6 +49,7 @@
 #include "../exceptions/invalidformatexception.h"
 #include "../exceptions/invalidargumentexception.h"
 #include <list>
+#include <vector>
 
 namespace f2cc {
 namespace Forsyde {
@@ -64,6 +66,11 @@ class Leaf : public Process{
   public:
     class Port;
 
+    /**
+     * Contiguous storage of ports.
+     */
+    typedef std::vector<Port*> PortVector;
+
   public:
     /**
      * Creates a leaf node.
@@ -197,6 +204,15 @@ class Leaf : public Process{
      */
     std::list<Port*> getInPorts() throw();
 
+    /**
+     * Gets the in ports belonging to this leaf without copying them. This is
+     * the preferred way of iterating over the ports in graph algorithms. The
+     * reference is invalidated when a port is added or deleted.
+     *
+     * @returns In ports.
+     */
+    const PortVector& getInPortRange() const throw();
+
     /**
      * Same as addIn Port(const Forsyde::Id&) but for out ports.
      *
@@ -269,6 +285,13 @@ class Leaf : public Process{
      */
     std::list<Port*> getOutPorts() throw();
 
+    /**
+     * Same as getInPortRange() but for out ports.
+     *
+     * @returns Out ports.
+     */
+    const PortVector& getOutPortRange() const throw();
+
 
     /**
      * Converts this leaf into a string representation. The resultant string
@@ -341,19 +364,35 @@ class Leaf : public Process{
   private:
 
     /**
-     * Attempts to find a port with a given ID from a list of ports. If the list
-     * is not empty and such a port is found, an iterator pointing to that port
-     * is returned; otherwise the list's \c end() iterator is returned.
+     * Adds a new port to a port vector and its index. If the port cannot be
+     * added, it is destroyed.
+     *
+     * @param port
+     *        Port to add.
+     * @param ports
+     *        Port vector.
+     * @param index
+     *        Index of the port vector.
+     * @returns \b true if the port was added.
+     * @throws OutOfMemoryException
+     *         When the port cannot be added due to memory shortage.
+     */
+    bool addPort(Port* port, PortVector& ports, IdMap<Port*>& index)
+        throw(OutOfMemoryException);
+
+    /**
+     * Removes and destroys a port from a port vector and its index.
      *
      * @param id
      *        Port ID.
      * @param ports
-     *        List of ports.
-     * @returns Iterator pointing either at the found port, or an iterator equal
-     *          to the list's \c end() iterator.
+     *        Port vector.
+     * @param index
+     *        Index of the port vector.
+     * @returns \b true if such a port was found and deleted.
      */
-    std::list<Port*>::iterator findPort(const Forsyde::Id& id,
-                                        std::list<Port*>& ports) const throw();
+    bool deletePort(const Forsyde::Id& id, PortVector& ports,
+                    IdMap<Port*>& index) throw();
 
     /**
      * Takes a list of ports and converts it into a string representation. Each
@@ -367,26 +406,36 @@ class Leaf : public Process{
      *        Port list.
      * @returns String representation.
      */
-    std::string portsToString(const std::list<Port*> ports) const throw();
+    std::string portsToString(const PortVector& ports) const throw();
 
     /**
-     * Destroys all ports in a given list.
+     * Destroys all ports in a given vector.
      *
      * @param ports
-     *        List of ports to destroy.
+     *        Vector of ports to destroy.
      */
-    void destroyAllPorts(std::list<Port*>& ports) throw();
+    void destroyAllPorts(PortVector& ports) throw();
 
   protected:
     /**
-     * List of in ports.
+     * In ports, in the order they were added.
+     */
+    PortVector in_ports_;
+
+    /**
+     * Out ports, in the order they were added.
+     */
+    PortVector out_ports_;
+
+    /**
+     * Index of \c in_ports_ by port ID.
      */
-    std::list<Port*> in_ports_;
+    IdMap<Port*> in_port_index_;
 
     /**
-     * List of out ports.
+     * Index of \c out_ports_ by port ID.
      */
-    std::list<Port*> out_ports_;
+    IdMap<Port*> out_port_index_;
 
     /**
 	 * Process MoC.
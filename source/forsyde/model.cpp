@@ -54,11 +54,11 @@ bool Model::addProcess(Leaf* leaf)
     }
 
     try {
-        pair<map<const Id, Leaf*>::iterator, bool>
-            result = leafs_.insert(
-                pair<const Id, Leaf*>(
-                    *leaf->getId(), leaf));
-        return result.second;
+        if (leaf_index_.contains(*leaf->getId())) return false;
+        map<const Id, Leaf*>::iterator it = leafs_.insert(
+            pair<const Id, Leaf*>(*leaf->getId(), leaf)).first;
+        leaf_index_.insert(*leaf->getId(), it);
+        return true;
     }
     catch(bad_alloc&) {
         THROW_EXCEPTION(OutOfMemoryException);
@@ -68,7 +68,11 @@ bool Model::addProcess(Leaf* leaf)
 void Model::addProcesses(map<const Id, Leaf*> leafes)
     throw(OutOfMemoryException) {
     try {
-        leafs_.insert(leafes.begin(), leafes.end());
+        map<const Id, Leaf*>::iterator it;
+        for (it = leafes.begin(); it != leafes.end(); ++it) {
+            if (leaf_index_.contains(it->first)) continue;
+            leaf_index_.insert(it->first, leafs_.insert(*it).first);
+        }
     }
     catch(bad_alloc&) {
         THROW_EXCEPTION(OutOfMemoryException);
@@ -97,6 +101,7 @@ bool Model::deleteProcess(const Id& id) throw() {
     map<const Id, Leaf*>::iterator it = findProcess(id);
     if (it != leafs_.end()) {
     	Leaf* removed_leaf = it->second;
+        leaf_index_.erase(it->first);
         leafs_.erase(it);
         delete removed_leaf;
         return true;
@@ -112,10 +117,7 @@ Id Model::getUniqueProcessId() const throw() {
 }
 
 Id Model::getUniqueProcessId(const string& prefix) const throw() {
-    for (int i = 1; ; ++i) {
-        Id new_id = Id(prefix + tools::toString(i));
-        if (leafs_.find(new_id) == leafs_.end()) return new_id;
-    }
+    return getUniqueId(prefix, leaf_index_, next_process_numbers_);
 }
 
 void Model::destroyAllProcesses() throw() {
@@ -123,10 +125,13 @@ void Model::destroyAllProcesses() throw() {
     for (it=leafs_.begin(); it != leafs_.end(); ++it) {
         delete it->second;
     }
+    leafs_.clear();
+    leaf_index_.clear();
 }
 
 map<const Id, Leaf*>::iterator Model::findProcess(const Id& id) throw() {
-    return leafs_.find(id);
+    map<const Id, Leaf*>::iterator* it = leaf_index_.find(id);
+    return it ? *it : leafs_.end();
 }
 
 ///////////////////////////////////////////
@@ -139,11 +144,11 @@ bool Model::addComposite(Composite* composite)
     }
 
     try {
-        pair<map<const Id, Composite*>::iterator, bool>
-            result = composites_.insert(
-                pair<const Id, Composite*>(
-                    *composite->getId(), composite));
-        return result.second;
+        if (composite_index_.contains(*composite->getId())) return false;
+        map<const Id, Composite*>::iterator it = composites_.insert(
+            pair<const Id, Composite*>(*composite->getId(), composite)).first;
+        composite_index_.insert(*composite->getId(), it);
+        return true;
     }
     catch(bad_alloc&) {
         THROW_EXCEPTION(OutOfMemoryException);
@@ -153,7 +158,11 @@ bool Model::addComposite(Composite* composite)
 void Model::addComposites(map<const Id, Composite*> compositees)
     throw(OutOfMemoryException) {
     try {
-        composites_.insert(compositees.begin(), compositees.end());
+        map<const Id, Composite*>::iterator it;
+        for (it = compositees.begin(); it != compositees.end(); ++it) {
+            if (composite_index_.contains(it->first)) continue;
+            composite_index_.insert(it->first, composites_.insert(*it).first);
+        }
     }
     catch(bad_alloc&) {
         THROW_EXCEPTION(OutOfMemoryException);
@@ -182,6 +191,7 @@ bool Model::deleteComposite(const Id& id) throw() {
     map<const Id, Composite*>::iterator it = findComposite(id);
     if (it != composites_.end()) {
     	Composite* removed_composite = it->second;
+        composite_index_.erase(it->first);
         composites_.erase(it);
         delete removed_composite;
         return true;
@@ -197,10 +207,7 @@ Id Model::getUniqueCompositeId() const throw() {
 }
 
 Id Model::getUniqueCompositeId(const string& prefix) const throw() {
-    for (int i = 1; ; ++i) {
-        Id new_id = Id(prefix + tools::toString(i));
-        if (composites_.find(new_id) == composites_.end()) return new_id;
-    }
+    return getUniqueId(prefix, composite_index_, next_composite_numbers_);
 }
 
 void Model::destroyAllComposites() throw() {
@@ -208,11 +215,32 @@ void Model::destroyAllComposites() throw() {
     for (it=composites_.begin(); it != composites_.end(); ++it) {
         delete it->second;
     }
+    composites_.clear();
+    composite_index_.clear();
 }
 
 map<const Id, Composite*>::iterator Model::findComposite(const Id& id) throw() {
-    return composites_.find(id);
+    map<const Id, Composite*>::iterator* it = composite_index_.find(id);
+    return it ? *it : composites_.end();
 }
 
+template <typename T>
+Id Model::getUniqueId(const string& prefix, const IdMap<T>& index,
+                      IdMap<int>& next_numbers) throw() {
+    Id prefix_id(prefix);
+    int* next = next_numbers.find(prefix_id);
+    if (!next) {
+        next_numbers.insert(prefix_id, 1);
+        next = next_numbers.find(prefix_id);
+    }
 
-
+    // IDs may also have been added by other means than this method, so the
+    // counter only marks where the search starts
+    for (;; ++*next) {
+        Id new_id = Id(prefix + tools::toString(*next));
+        if (!index.contains(new_id)) {
+            ++*next;
+            return new_id;
+        }
+    }
+}
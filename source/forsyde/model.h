@@ -38,6 +38,7 @@
  */
 
 #include "id.h"
+#include "idmap.h"
 #include "leaf.h"
 #include "../exceptions/outofmemoryexception.h"
 #include "../exceptions/illegalstateexception.h"
@@ -131,6 +132,9 @@ class Model {
 
     /**
      * Gets a new process ID which is not currently in use within this model.
+     * A counter is kept for each prefix so that consecutive calls run in
+     * amortized constant time rather than probing from 1 every time. IDs
+     * of deleted processes are not handed out again.
      *
      * @returns A unique process ID.
      */
@@ -207,6 +211,9 @@ class Model {
 
     /**
      * Gets a new composite ID which is not currently in use within this model.
+     * A counter is kept for each prefix so that consecutive calls run in
+     * amortized constant time rather than probing from 1 every time. IDs
+     * of deleted composites are not handed out again.
      *
      * @returns A unique composite ID.
      */
@@ -267,6 +274,45 @@ class Model {
      * Combset of composites.
      */
     std::map<const Id, Composite*> composites_;
+
+    /**
+     * Hash index into \c leafs_, used for finding processes without any
+     * string comparisons.
+     */
+    IdMap<std::map<const Id, Leaf*>::iterator> leaf_index_;
+
+    /**
+     * Hash index into \c composites_.
+     */
+    IdMap<std::map<const Id, Composite*>::iterator> composite_index_;
+
+    /**
+     * Next number to try for each prefix when generating unique process IDs.
+     */
+    mutable IdMap<int> next_process_numbers_;
+
+    /**
+     * Next number to try for each prefix when generating unique composite IDs.
+     */
+    mutable IdMap<int> next_composite_numbers_;
+
+  private:
+    /**
+     * Gets a new ID which is not in use within an index.
+     *
+     * @tparam T
+     *         Index value type.
+     * @param prefix
+     *        ID prefix.
+     * @param index
+     *        Index of IDs in use.
+     * @param next_numbers
+     *        Counter registry of the index.
+     * @returns A unique ID.
+     */
+    template <typename T>
+    static Id getUniqueId(const std::string& prefix, const IdMap<T>& index,
+                          IdMap<int>& next_numbers) throw();
 };
 
 }
@@ -34,8 +34,11 @@
 #include "../language/cfunction.h"
 #include "../language/cdatatype.h"
 #include "../tools/tools.h"
+#include "../tools/arena.h"
 #include "../exceptions/castexception.h"
 #include "../exceptions/indexoutofboundsexception.h"
+#include <algorithm>
+#include <map>
 #include <set>
 #include <string>
 #include <new>
@@ -47,6 +50,7 @@ using namespace f2cc::Forsyde::SY;
 using std::string;
 using std::list;
 using std::set;
+using std::map;
 using std::vector;
 using std::bad_alloc;
 using std::pair;
@@ -62,6 +66,7 @@ ModelModifier::~ModelModifier() throw() {}
 
 void ModelModifier::coalesceDataParallelLeafs()
     throw(IOException, RuntimeException) {
+    tools::Arena::Scope arena_scope(processnetwork_->getArena());
     list<ContainedSection> sections = findDataParallelSections();
     list<ContainedSection>::iterator it;
     for (it = sections.begin(); it != sections.end(); ++it) {
@@ -88,6 +93,7 @@ void ModelModifier::coalesceDataParallelLeafs()
 
 void ModelModifier::coalesceParallelMapSyLeafs()
     throw(IOException, RuntimeException) {
+    tools::Arena::Scope arena_scope(processnetwork_->getArena());
     list< list<ParallelMap*> > chains = findParallelMapSyChains();
     if (chains.size() == 0) {
         logger_.logMessage(Logger::INFO, "No ParallelMap chains found");
@@ -105,6 +111,7 @@ void ModelModifier::coalesceParallelMapSyLeafs()
 
 void ModelModifier::splitDataParallelSegments()
     throw(IOException, RuntimeException) {
+    tools::Arena::Scope arena_scope(processnetwork_->getArena());
     list<ContainedSection> sections = findDataParallelSections();
     list<ContainedSection>::iterator it;
     for (it = sections.begin(); it != sections.end(); ++it) {
@@ -135,6 +142,7 @@ void ModelModifier::splitDataParallelSegments()
 
 void ModelModifier::fuseUnzipMapZipLeafs()
     throw(IOException, RuntimeException) {
+    tools::Arena::Scope arena_scope(processnetwork_->getArena());
     list<ContainedSection> sections = findDataParallelSections();
     list<ContainedSection>::iterator it;
     for (it = sections.begin(); it != sections.end(); ++it) {
@@ -143,12 +151,12 @@ void ModelModifier::fuseUnzipMapZipLeafs()
                            + section.toString() + "...");
 
         // Get function arguments of mapSY or coalescedmapSY leafs
-        if (getProcessChain(section.start->getOutPorts().front(),
+        if (getProcessChain(section.start->getOutPortRange().front(),
                             section.end).size() != 1) {
             THROW_EXCEPTION(IllegalStateException, "Leaf chain is not of "
                             "length 1");
         }
-        Leaf* data_leaf = dynamic_cast<Leaf*>(section.start->getOutPorts().front()
+        Leaf* data_leaf = dynamic_cast<Leaf*>(section.start->getOutPortRange().front()
             ->getConnectedPort()->getProcess());
         list<CFunction> functions;
         CoalescedMap* cmapsy_leaf =
@@ -168,13 +176,13 @@ void ModelModifier::fuseUnzipMapZipLeafs()
         }
 
         // Create new parallelmapSY leaf to replace the data parallel section
-        int num_leafs = section.start->getOutPorts().size();
+        int num_leafs = section.start->getOutPortRange().size();
         ParallelMap* new_leaf = new (std::nothrow) ParallelMap(
             processnetwork_->getUniqueProcessId("_parallelmapSY_"), num_leafs,
             functions);
         if (!new_leaf) THROW_EXCEPTION(OutOfMemoryException);
-        logger_.logMessage(Logger::DEBUG, string("New ParallelMap leaf \"")
-                           + new_leaf->getId()->getString() + "\" created");
+        LOG_DEBUG(logger_, string("New ParallelMap leaf \"")
+                  + new_leaf->getId()->getString() + "\" created");
 
         redirectDataFlow(section.start, section.end, new_leaf, new_leaf);
 
@@ -193,28 +201,29 @@ void ModelModifier::fuseUnzipMapZipLeafs()
         }
 
         // Destroy and delete the section from the processnetwork
-        logger_.logMessage(Logger::DEBUG, string("Destroying section \"")
-                           + section.toString() + "...");
+        LOG_DEBUG(logger_, string("Destroying section \"")
+                  + section.toString() + "...");
         destroyLeafChain(section.start);
     }
 }
 
 void ModelModifier::convertZipWith1ToMap()
     throw(IOException, RuntimeException) {
+    tools::Arena::Scope arena_scope(processnetwork_->getArena());
     list<Leaf*> leafs = processnetwork_->getProcesses();
     list<Leaf*>::iterator it;
     for (it = leafs.begin(); it != leafs.end(); ++it) {
-        logger_.logMessage(Logger::DEBUG, string("Analyzing leaf \"")
-                           + (*it)->getId()->getString() + "\"...");
+        LOG_DEBUG(logger_, string("Analyzing leaf \"")
+                  + (*it)->getId()->getString() + "\"...");
 
         ZipWithNSY* leaf = dynamic_cast<ZipWithNSY*>(*it);
         if (leaf && leaf->getNumInPorts() == 1) {
             Map* new_leaf = new (std::nothrow) Map(
                 processnetwork_->getUniqueProcessId("_mapSY_"), *leaf->getFunction());
             if (!new_leaf) THROW_EXCEPTION(OutOfMemoryException);
-            logger_.logMessage(Logger::DEBUG, string("New Map leaf \"")
-                               + new_leaf->getId()->getString()
-                               + "\" created");
+            LOG_DEBUG(logger_, string("New Map leaf \"")
+                      + new_leaf->getId()->getString()
+                      + "\" created");
 
             redirectDataFlow(leaf, leaf, new_leaf, new_leaf);
 
@@ -233,8 +242,8 @@ void ModelModifier::convertZipWith1ToMap()
             }
 
             // Destroy and delete the old leaf from the processnetwork
-            logger_.logMessage(Logger::DEBUG, string("Destroying leaf \"")
-                               + leaf->getId()->getString() + "...");
+            LOG_DEBUG(logger_, string("Destroying leaf \"")
+                      + leaf->getId()->getString() + "...");
             processnetwork_->deleteProcess(*leaf->getId());
         }
     }
@@ -246,8 +255,8 @@ void ModelModifier::removeRedundantLeafs()
     list<Leaf*>::iterator it;
     for (it = leafs.begin(); it != leafs.end(); ++it) {
         Leaf* leaf = *it;
-        logger_.logMessage(Logger::DEBUG, string("Analyzing leaf \"")
-                           + leaf->getId()->getString() + "\"...");
+        LOG_DEBUG(logger_, string("Analyzing leaf \"")
+                  + leaf->getId()->getString() + "\"...");
 
         // Remove Zipx and Unzipx leafs which have only one in and out
         // port
@@ -261,9 +270,9 @@ void ModelModifier::removeRedundantLeafs()
                 // Redirect the leaf' in and out ports to unconnect it from
                 // the network
                 Leaf::Port* in_port = 
-                    leaf->getInPorts().front();
+                    leaf->getInPortRange().front();
                 Leaf::Port* out_port = 
-                    leaf->getOutPorts().front();
+                    leaf->getOutPortRange().front();
                 Leaf::Port* other_end_at_in_port =
                 	dynamic_cast<Leaf::Port*>(in_port->getConnectedPort());
                 Leaf::Port* other_end_at_out_port =
@@ -273,8 +282,8 @@ void ModelModifier::removeRedundantLeafs()
                 }
 
                 // Update processnetwork in- and ouputs, if necessary
-                logger_.logMessage(Logger::DEBUG, "Updating processnetwork in- and "
-                                   "outputs...");
+                LOG_DEBUG(logger_, "Updating processnetwork in- and "
+                          "outputs...");
                 if (other_end_at_in_port == NULL) {
                     replaceProcessNetworkInput(in_port,
                                       other_end_at_out_port);
@@ -351,12 +360,13 @@ list<ModelModifier::ContainedSection> ModelModifier::findDataParallelSections()
 list<ModelModifier::ContainedSection>
 ModelModifier::findContainedSections() throw(IOException, RuntimeException) {
     list<ContainedSection> sections;
-    set<Id> visited;
+    analyzeDataFlow();
+    IdSet visited;
     list<Process::Interface*> output_ports = processnetwork_->getOutputs();
     list<Process::Interface*>::iterator it;
     for (it = output_ports.begin(); it != output_ports.end(); ++it) {
-        logger_.logMessage(Logger::DEBUG, string("Entering at output port \"")
-                           + (*it)->toString() + "\"");
+        LOG_DEBUG(logger_, string("Entering at output port \"")
+                  + (*it)->toString() + "\"");
         tools::append<ContainedSection>(sections, findContainedSections(
         		dynamic_cast<Leaf*>((*it)->getProcess()), visited));
     }
@@ -364,55 +374,55 @@ ModelModifier::findContainedSections() throw(IOException, RuntimeException) {
 }
 
 list<ModelModifier::ContainedSection>
-ModelModifier::findContainedSections(Leaf* begin, set<Id> visited)
+ModelModifier::findContainedSections(Leaf* begin, IdSet& visited)
     throw(IOException, RuntimeException) {
     list<ContainedSection> sections;
-    bool not_already_visited = visited.insert(*begin->getId()).second;
+    bool not_already_visited = visited.insert(*begin->getId());
     if (not_already_visited) {
-        logger_.logMessage(Logger::DEBUG, string("Analyzing leaf \"")
-                           + begin->getId()->getString() + "\"...");
+        LOG_DEBUG(logger_, string("Analyzing leaf \"")
+                  + begin->getId()->getString() + "\"...");
         Zipx* converge_point = dynamic_cast<Zipx*>(begin);
         if (converge_point) {
-            logger_.logMessage(Logger::DEBUG, string("Discovered ZipxSY ")
-                               + "leaf \""
-                               + converge_point->getId()->getString() + "\"");
-            logger_.logMessage(Logger::DEBUG, "Searching for nearest UnzipxSY "
-                               "leaf...");
+            LOG_DEBUG(logger_, string("Discovered ZipxSY ")
+                      + "leaf \""
+                      + converge_point->getId()->getString() + "\"");
+            LOG_DEBUG(logger_, "Searching for nearest UnzipxSY "
+                      "leaf...");
             Unzipx* diverge_point =
                 findNearestUnzipxLeaf(converge_point);
             if (diverge_point) {
-                logger_.logMessage(Logger::DEBUG, string("Found nearest ")
-                                   + "UnzipxSY leaf \""
-                                   + diverge_point->getId()->getString()
-                                   + "\"");
+                LOG_DEBUG(logger_, string("Found nearest ")
+                          + "UnzipxSY leaf \""
+                          + diverge_point->getId()->getString()
+                          + "\"");
             }
             else {
-                logger_.logMessage(Logger::DEBUG, "No UnzipxSY leaf found");
+                LOG_DEBUG(logger_, "No UnzipxSY leaf found");
                 // Return empty list
                 return sections;
             }
-            logger_.logMessage(Logger::DEBUG, string("Checking that the data ")
-                               + "flow between leafs \""
-                               + diverge_point->getId()->getString()
-                               + "\" and \""
-                               + converge_point->getId()->getString()
-                               + "\" is contained...");
+            LOG_DEBUG(logger_, string("Checking that the data ")
+                      + "flow between leafs \""
+                      + diverge_point->getId()->getString()
+                      + "\" and \""
+                      + converge_point->getId()->getString()
+                      + "\" is contained...");
             if (!isAContainedSection(diverge_point, converge_point)) {
-                logger_.logMessage(Logger::DEBUG, string("Section between ")
-                                   + "leafs \""
-                                   + diverge_point->getId()->getString()
-                                   + "\" and \""
-                                   + converge_point->getId()->getString()
-                                   + "\" is not contained");
+                LOG_DEBUG(logger_, string("Section between ")
+                          + "leafs \""
+                          + diverge_point->getId()->getString()
+                          + "\" and \""
+                          + converge_point->getId()->getString()
+                          + "\" is not contained");
                 goto continue_search;
             }
 
-            logger_.logMessage(Logger::DEBUG, string("Found contained section ")
-                               + "between leafs \""
-                               + diverge_point->getId()->getString()
-                               + "\" and \""
-                               + converge_point->getId()->getString()
-                               + "\"");
+            LOG_DEBUG(logger_, string("Found contained section ")
+                      + "between leafs \""
+                      + diverge_point->getId()->getString()
+                      + "\" and \""
+                      + converge_point->getId()->getString()
+                      + "\"");
             sections.push_back(ContainedSection(diverge_point,
                                                 converge_point));
             // The converge point need not be set as visited since it is only
@@ -423,8 +433,8 @@ ModelModifier::findContainedSections(Leaf* begin, set<Id> visited)
         }
 
       continue_search:
-        list<Leaf::Port*> in_ports = begin->getInPorts();
-        list<Leaf::Port*>::iterator it;
+        const Leaf::PortVector& in_ports = begin->getInPortRange();
+        Leaf::PortVector::const_iterator it;
         for (it = in_ports.begin(); it != in_ports.end(); ++it) {
             if ((*it)->isConnected()) {
                 Leaf* next_leaf = dynamic_cast<Leaf*>((*it)->getConnectedPort()->getProcess());
@@ -445,77 +455,53 @@ bool ModelModifier::isAContainedSection(Leaf* start, Leaf* end)
         THROW_EXCEPTION(InvalidArgumentException, "\"end\" must not be NULL");
     }
 
-    if (!checkDataFlowConvergence(start, end, true)) {
-        logger_.logMessage(Logger::DEBUG, string("All flow from leaf \"")
-                           + start->getId()->getString() + "\" does not "
-                           "converge to leaf \""
-                           + end->getId()->getString() + "\"");
+    if (leaf_indices_.find(start) == leaf_indices_.end()
+        || leaf_indices_.find(end) == leaf_indices_.end()) {
+        analyzeDataFlow();
+    }
+    size_t start_index = leaf_indices_[start];
+    size_t end_index = leaf_indices_[end];
+
+    if (!post_dominators_.dominates(end_index, start_index)) {
+        LOG_DEBUG(logger_, string("All flow from leaf \"")
+                  + start->getId()->getString() + "\" does not "
+                  "converge to leaf \""
+                  + end->getId()->getString() + "\"");
         return false;
     }
-    if (!checkDataFlowConvergence(start, end, false)) {
-        logger_.logMessage(Logger::DEBUG, string("All flow to leaf \"")
-                           + end->getId()->getString() + "\" does not "
-                           "diverge from leaf \""
-                           + start->getId()->getString() + "\"");
+    if (!dominators_.dominates(start_index, end_index)) {
+        LOG_DEBUG(logger_, string("All flow to leaf \"")
+                  + end->getId()->getString() + "\" does not "
+                  "diverge from leaf \""
+                  + start->getId()->getString() + "\"");
         return false;
     }
     return true;
 }
 
-bool ModelModifier::checkDataFlowConvergence(Leaf* start, Leaf* end,
-                                             bool forward)
+Unzipx* ModelModifier::findNearestUnzipxLeaf(Forsyde::Leaf* begin)
     throw(IOException, RuntimeException) {
-    if (start == end) return true;
-
-    if (forward) {
-        logger_.logMessage(Logger::DEBUG, string("Analyzing leaf \"")
-                           + start->getId()->getString() + "\"...");
-
-        // Check data flow from start to end
-        list<Leaf::Port*> out_ports = start->getOutPorts();
-        list<Leaf::Port*>::iterator it;
-        for (it = out_ports.begin(); it != out_ports.end(); ++it) {
-            if (!(*it)->isConnected()) return false;
-            if (!checkDataFlowConvergence(dynamic_cast<Leaf*>((*it)->getConnectedPort()
-                                          ->getProcess()), end, true)) {
-                return false;
-            }
-        }
-    }
-    else {
-        logger_.logMessage(Logger::DEBUG, string("Analyzing leaf \"")
-                           + end->getId()->getString() + "\"...");
-
-        // Check data flow from end to start
-        list<Leaf::Port*> in_ports = end->getInPorts();
-        list<Leaf::Port*>::iterator it;
-        for (it = in_ports.begin(); it != in_ports.end(); ++it) {
-            if (!(*it)->isConnected()) return false;
-            if (!checkDataFlowConvergence(start, dynamic_cast<Leaf*>((*it)->getConnectedPort()
-                                          ->getProcess()), false)) {
-                return false;
-            }
-        }
-    }
-
-    return true;
+    set<const Leaf*> visited;
+    return findNearestUnzipxLeaf(begin, visited);
 }
 
-Unzipx* ModelModifier::findNearestUnzipxLeaf(Forsyde::Leaf* begin)
+Unzipx* ModelModifier::findNearestUnzipxLeaf(Forsyde::Leaf* begin,
+                                             set<const Leaf*>& visited)
     throw(IOException, RuntimeException) {
     if (!begin) return NULL;
+    if (!visited.insert(begin).second) return NULL;
 
-    logger_.logMessage(Logger::DEBUG, string("Analyzing leaf \"")
-                       + begin->getId()->getString() + "\"...");
+    LOG_DEBUG(logger_, string("Analyzing leaf \"")
+              + begin->getId()->getString() + "\"...");
     Unzipx* sought_leaf = dynamic_cast<Unzipx*>(begin);
     if (sought_leaf) return sought_leaf;
 
-    list<Leaf::Port*> in_ports = begin->getInPorts();
-    list<Leaf::Port*>::iterator it;
+    const Leaf::PortVector& in_ports = begin->getInPortRange();
+    Leaf::PortVector::const_iterator it;
     for (it = in_ports.begin(); it != in_ports.end(); ++it) {
         if ((*it)->isConnected()) {
             Leaf* next_leaf = dynamic_cast<Leaf*>((*it)->getConnectedPort()->getProcess());
-            sought_leaf = findNearestUnzipxLeaf(next_leaf);
+            sought_leaf = findNearestUnzipxLeaf(next_leaf, visited);
             if (sought_leaf) return sought_leaf;
         }
     }
@@ -523,37 +509,97 @@ Unzipx* ModelModifier::findNearestUnzipxLeaf(Forsyde::Leaf* begin)
     return NULL;
 }
 
+void ModelModifier::analyzeDataFlow() throw(IOException, RuntimeException) {
+    leaf_indices_.clear();
+    list<Leaf*> leafs = processnetwork_->getProcesses();
+    list<Leaf*>::iterator it;
+    for (it = leafs.begin(); it != leafs.end(); ++it) {
+        size_t index = leaf_indices_.size();
+        leaf_indices_[*it] = index;
+    }
+
+    // The virtual entry and exit points come after the leafs
+    size_t entry = leafs.size();
+    size_t exit = leafs.size() + 1;
+    vector< vector<size_t> > successors(leafs.size() + 2);
+    vector< vector<size_t> > predecessors(leafs.size() + 2);
+    for (it = leafs.begin(); it != leafs.end(); ++it) {
+        size_t index = leaf_indices_[*it];
+        const Leaf::PortVector& in_ports = (*it)->getInPortRange();
+        Leaf::PortVector::const_iterator port_it;
+        bool has_external_input = in_ports.empty();
+        for (port_it = in_ports.begin(); port_it != in_ports.end(); ++port_it) {
+            if (!(*port_it)->isConnected()) has_external_input = true;
+        }
+        if (has_external_input) {
+            successors[entry].push_back(index);
+            predecessors[index].push_back(entry);
+        }
+
+        const Leaf::PortVector& out_ports = (*it)->getOutPortRange();
+        bool has_external_output = out_ports.empty();
+        for (port_it = out_ports.begin(); port_it != out_ports.end();
+             ++port_it) {
+            if (!(*port_it)->isConnected()) {
+                has_external_output = true;
+                continue;
+            }
+            map<const Leaf*, size_t>::iterator index_it =
+                leaf_indices_.find(dynamic_cast<Leaf*>(
+                                       (*port_it)->getConnectedPort()
+                                       ->getProcess()));
+            if (index_it == leaf_indices_.end()) {
+                THROW_EXCEPTION(IllegalStateException, string("Leaf \"")
+                                + (*it)->getId()->getString() + "\" is "
+                                "connected to a leaf outside the "
+                                "processnetwork");
+            }
+            successors[index].push_back(index_it->second);
+            predecessors[index_it->second].push_back(index);
+        }
+        if (has_external_output) {
+            successors[index].push_back(exit);
+            predecessors[exit].push_back(index);
+        }
+    }
+
+    dominators_ = DominatorTree(successors, entry);
+    post_dominators_ = DominatorTree(predecessors, exit);
+    LOG_DEBUG(logger_, string("Built dominator trees for ")
+              + tools::toString(leafs.size()) + " leaf(s)");
+}
+
 bool ModelModifier::isContainedSectionDataParallel(
     const ContainedSection& section) throw(IOException, RuntimeException) {
-    list<Leaf::Port*> ports = section.start->getOutPorts();
-    list<Leaf::Port*>::iterator port_it;
+    const Leaf::PortVector& ports = section.start->getOutPortRange();
+    Leaf::PortVector::const_iterator port_it;
     bool first = true;
     list<Leaf*> first_chain;
     for (port_it = ports.begin(); port_it != ports.end(); ++port_it) {
         list<Leaf*> current_chain = getProcessChain(*port_it, section.end);
         if (!hasOnlyMapSys(current_chain)) {
-            logger_.logMessage(Logger::DEBUG,
-                               string("Contained section ")
-                               + section.toString() + " does not consist of "
-                               + "only Map leafs");
+            LOG_DEBUG(logger_,
+                      string("Contained section ")
+                      + section.toString() + " does not consist of "
+                      + "only Map leafs");
             return false;
         }
         if (first) {
             if (current_chain.size() == 0) {
-                logger_.logMessage(Logger::DEBUG,
-                                   string("No leafs within the contained ")
-                                   + "section " + section.toString());
+                LOG_DEBUG(logger_,
+                          string("No leafs within the contained ")
+                          + "section " + section.toString());
                 return false;
             }
             first_chain = current_chain;
             first = false;
         }
         else {
-            logger_.logMessage(Logger::DEBUG,
-                               string("Comparing leaf chains ")
-                               + leafChainToString(first_chain) 
-                               + " and "
-                               + leafChainToString(current_chain) + "...");
+            LOG_DEBUG(logger_,
+                      string("Comparing leaf chains ")
+                      + leafChainToString(first_chain) 
+                      + " and "
+                      + leafChainToString(current_chain) + "...");
             if (!areLeafChainsEqual(first_chain, current_chain)) {
                 return false;
             }
@@ -613,7 +659,7 @@ list<Leaf*> ModelModifier::getProcessChain(Leaf::Port* start,
             Leaf* next_leaf = dynamic_cast<Leaf*>(port->getConnectedPort()->getProcess());
             if (next_leaf == end) break;
             chain.push_back(next_leaf);
-            port = next_leaf->getOutPorts().front();
+            port = next_leaf->getOutPortRange().front();
         }
 
         return chain;
@@ -626,12 +672,12 @@ list<Leaf*> ModelModifier::getProcessChain(Leaf::Port* start,
 list< list<ParallelMap*> > ModelModifier::findParallelMapSyChains()
     throw(IOException, RuntimeException) {
     list< list<ParallelMap*> > chains;
-    set<Id> visited;
+    IdSet visited;
     list<Process::Interface*> output_ports = processnetwork_->getOutputs();
     list<Process::Interface*>::iterator it;
     for (it = output_ports.begin(); it != output_ports.end(); ++it) {
-        logger_.logMessage(Logger::DEBUG, string("Entering at output port \"")
-                           + (*it)->toString() + "\"");
+        LOG_DEBUG(logger_, string("Entering at output port \"")
+                  + (*it)->toString() + "\"");
         tools::append< list<ParallelMap*> >(
             chains, findParallelMapSyChains(dynamic_cast<Leaf*>((*it)->getProcess()), visited));
     }
@@ -639,20 +685,20 @@ list< list<ParallelMap*> > ModelModifier::findParallelMapSyChains()
 }
 
 list< list<ParallelMap*> > ModelModifier::findParallelMapSyChains(
-    Leaf* begin, set<Id> visited) throw(IOException, RuntimeException) {
+    Leaf* begin, IdSet visited) throw(IOException, RuntimeException) {
     list< list<ParallelMap*> > chains;
-    bool not_already_visited = visited.insert(*begin->getId()).second;
+    bool not_already_visited = visited.insert(*begin->getId());
     if (not_already_visited) {
-        logger_.logMessage(Logger::DEBUG, string("Analyzing leaf \"")
-                           + begin->getId()->getString() + "\"...");
+        LOG_DEBUG(logger_, string("Analyzing leaf \"")
+                  + begin->getId()->getString() + "\"...");
 
         // If this is a beginning of a chain, find the entire chain
         Leaf* continuation_point = begin;
         ParallelMap* parallelmapsy = dynamic_cast<ParallelMap*>(begin);
         if (parallelmapsy) {
-            logger_.logMessage(Logger::DEBUG, string("Found begin of chain at ")
-                               + "leafs \""
-                               + begin->getId()->getString() + "\"");
+            LOG_DEBUG(logger_, string("Found begin of chain at ")
+                      + "leafs \""
+                      + begin->getId()->getString() + "\"");
 
             list<ParallelMap*> chain;
             while (parallelmapsy) {
@@ -661,24 +707,25 @@ list< list<ParallelMap*> > ModelModifier::findParallelMapSyChains(
                 // chain from being reversed
                 chain.push_front(parallelmapsy);
                 continuation_point = parallelmapsy;
-                Leaf::Port* out_port = parallelmapsy->getInPorts().front();
+                Leaf::Port* out_port = parallelmapsy->getInPortRange().front();
                 if (!out_port->isConnected()) break;
                 Leaf* next_leaf = dynamic_cast<Leaf*>(out_port->getConnectedPort()
                     ->getProcess());
                 parallelmapsy = dynamic_cast<ParallelMap*>(next_leaf);
             }
-            logger_.logMessage(Logger::DEBUG, string("Chain ended at leaf ")
-                               + "\"" + chain.back()->getId()->getString()
-                               + "\"");
+            LOG_DEBUG(logger_, string("Chain ended at leaf ")
+                      + "\"" + chain.back()->getId()->getString()
+                      + "\"");
             chains.push_back(chain);
 
-            logger_.logMessage(Logger::DEBUG, string("ParallelMap leaf ")
-                               + "chain found: " + leafChainToString(chain));
+            LOG_DEBUG(logger_, string("ParallelMap leaf ")
+                      + "chain found: " + leafChainToString(chain));
         }
 
         // Continue the search
-        list<Leaf::Port*> in_ports = continuation_point->getInPorts();
-        list<Leaf::Port*>::iterator it;
+        const Leaf::PortVector& in_ports =
+            continuation_point->getInPortRange();
+        Leaf::PortVector::const_iterator it;
         for (it = in_ports.begin(); it != in_ports.end(); ++it) {
             if ((*it)->isConnected()) {
                 Leaf* next_leaf = dynamic_cast<Leaf*>((*it)->getConnectedPort()->getProcess());
@@ -723,8 +770,8 @@ void ModelModifier::coalesceLeafChain(list<Leaf*> chain)
     }
 
     // Destroy and delete the section from the processnetwork
-    logger_.logMessage(Logger::DEBUG, string("Destroying leaf chain ")
-                       + leafChainToString(chain) + "...");
+    LOG_DEBUG(logger_, string("Destroying leaf chain ")
+              + leafChainToString(chain) + "...");
     destroyLeafChain(chain.front());
 }
 
@@ -821,8 +868,8 @@ void ModelModifier::coalesceParallelMapSyChain(list<ParallelMap*> chain)
     }
 
     // Destroy and delete the section from the processnetwork
-    logger_.logMessage(Logger::DEBUG, string("Destroying leaf chain ")
-                       + leafChainToString(chain) + "...");
+    LOG_DEBUG(logger_, string("Destroying leaf chain ")
+              + leafChainToString(chain) + "...");
     destroyLeafChain(chain.front());
 }
 
@@ -880,15 +927,15 @@ void ModelModifier::splitDataParallelSegments(
             Zipx* new_ZipxSY = new (std::nothrow) Zipx(
                 processnetwork_->getUniqueProcessId("_ZipxSY_"));
             if (!new_ZipxSY) THROW_EXCEPTION(OutOfMemoryException);
-            logger_.logMessage(Logger::DEBUG, string("New Zipx leaf \"")
-                               + new_ZipxSY->getId()->getString()
-                               + "\" created");
+            LOG_DEBUG(logger_, string("New Zipx leaf \"")
+                      + new_ZipxSY->getId()->getString()
+                      + "\" created");
             Unzipx* new_UnzipxSY = new (std::nothrow) Unzipx(
                 processnetwork_->getUniqueProcessId("_UnzipxSY_"));
             if (!new_UnzipxSY) THROW_EXCEPTION(OutOfMemoryException);
-            logger_.logMessage(Logger::DEBUG, string("New Unzipx leaf \"")
-                               + new_ZipxSY->getId()->getString()
-                               + "\" created");
+            LOG_DEBUG(logger_, string("New Unzipx leaf \"")
+                      + new_ZipxSY->getId()->getString()
+                      + "\" created");
 
             // Connect the ZipxSY to the UnzipxSY
             if (!new_ZipxSY->addOutPort(Id("out"))) {
@@ -899,7 +946,7 @@ void ModelModifier::splitDataParallelSegments(
             }
             new_ZipxSY->getOutPort(Id("out"))->connect(
                 new_UnzipxSY->getInPort(Id("in")));
-            logger_.logMessage(Logger::DEBUG, "Ports added");
+            LOG_DEBUG(logger_, "Ports added");
 
             // Insert the ZipxSY and UnzipxSY leaf in between the current
             // data parallel segment
@@ -912,12 +959,12 @@ void ModelModifier::splitDataParallelSegments(
                                     "port");
                 }
                 Leaf::Port* left_mapSY_out_port = 
-                    chains[i][current_segment - 1]->getOutPorts().front();
-                Leaf::Port* ZipxSY_in_port = new_ZipxSY->getInPorts().back();
-                logger_.logMessage(Logger::DEBUG, string("Connecting \"")
-                                   + left_mapSY_out_port->toString()
-                                   + "\" with \""
-                                   + ZipxSY_in_port->toString() + "\"...");
+                    chains[i][current_segment - 1]->getOutPortRange().front();
+                Leaf::Port* ZipxSY_in_port = new_ZipxSY->getInPortRange().back();
+                LOG_DEBUG(logger_, string("Connecting \"")
+                          + left_mapSY_out_port->toString()
+                          + "\" with \""
+                          + ZipxSY_in_port->toString() + "\"...");
                 left_mapSY_out_port->connect(ZipxSY_in_port);
 
                 // Connect right mapSY with UnzipxSY
@@ -926,13 +973,13 @@ void ModelModifier::splitDataParallelSegments(
                                     "port");
                 }
                 Leaf::Port* right_mapSY_in_port = 
-                    chains[i][current_segment]->getInPorts().front();
+                    chains[i][current_segment]->getInPortRange().front();
                 Leaf::Port* UnzipxSY_out_port = 
-                    new_UnzipxSY->getOutPorts().back();
-                logger_.logMessage(Logger::DEBUG, string("Connecting \"")
-                                   + right_mapSY_in_port->toString()
-                                   + "\" with \""
-                                   + UnzipxSY_out_port->toString() + "\"...");
+                    new_UnzipxSY->getOutPortRange().back();
+                LOG_DEBUG(logger_, string("Connecting \"")
+                          + right_mapSY_in_port->toString()
+                          + "\" with \""
+                          + UnzipxSY_out_port->toString() + "\"...");
                 right_mapSY_in_port->connect(UnzipxSY_out_port);
             }
 
@@ -950,11 +997,11 @@ void ModelModifier::splitDataParallelSegments(
                                 + "\" already existed");
             }
 
-            logger_.logMessage(Logger::DEBUG, string("New leafs \"")
-                               + new_ZipxSY->getId()->getString()
-                               + "\" and \""
-                               + new_UnzipxSY->getId()->getString()
-                               + "\" added to the processnetwork");
+            LOG_DEBUG(logger_, string("New leafs \"")
+                      + new_ZipxSY->getId()->getString()
+                      + "\" and \""
+                      + new_UnzipxSY->getId()->getString()
+                      + "\" added to the processnetwork");
         }
     }
     catch (std::out_of_range&) {
@@ -977,6 +1024,123 @@ string ModelModifier::ContainedSection::toString() const throw() {
         end->getId()->getString() + "\"";
 }
 
+ModelModifier::DominatorTree::DominatorTree() throw() {}
+
+ModelModifier::DominatorTree::DominatorTree(
+    const vector< vector<size_t> >& successors, size_t root) throw()
+        : enter_order_(successors.size(), 0),
+          leave_order_(successors.size(), 0),
+          is_reachable_(successors.size(), false) {
+    const size_t num_nodes = successors.size();
+    const size_t undefined = num_nodes;
+
+    // Number the nodes in postorder using an explicit stack, as the graph
+    // may be too deep for recursion
+    vector<size_t> postorder_numbers(num_nodes, undefined);
+    vector<size_t> reverse_postorder;
+    vector< pair<size_t, size_t> > stack;
+    stack.push_back(pair<size_t, size_t>(root, 0));
+    is_reachable_[root] = true;
+    while (!stack.empty()) {
+        size_t node = stack.back().first;
+        size_t& next_successor = stack.back().second;
+        if (next_successor < successors[node].size()) {
+            size_t successor = successors[node][next_successor++];
+            if (!is_reachable_[successor]) {
+                is_reachable_[successor] = true;
+                stack.push_back(pair<size_t, size_t>(successor, 0));
+            }
+        }
+        else {
+            postorder_numbers[node] = reverse_postorder.size();
+            reverse_postorder.push_back(node);
+            stack.pop_back();
+        }
+    }
+    std::reverse(reverse_postorder.begin(), reverse_postorder.end());
+
+    vector< vector<size_t> > predecessors(num_nodes);
+    for (size_t node = 0; node < num_nodes; ++node) {
+        if (!is_reachable_[node]) continue;
+        for (size_t i = 0; i < successors[node].size(); ++i) {
+            predecessors[successors[node][i]].push_back(node);
+        }
+    }
+
+    // Find the immediate dominators
+    vector<size_t> idoms(num_nodes, undefined);
+    idoms[root] = root;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = 1; i < reverse_postorder.size(); ++i) {
+            size_t node = reverse_postorder[i];
+            size_t new_idom = undefined;
+            for (size_t k = 0; k < predecessors[node].size(); ++k) {
+                size_t predecessor = predecessors[node][k];
+                if (idoms[predecessor] == undefined) continue;
+                if (new_idom == undefined) {
+                    new_idom = predecessor;
+                    continue;
+                }
+                size_t finger1 = predecessor;
+                size_t finger2 = new_idom;
+                while (finger1 != finger2) {
+                    while (postorder_numbers[finger1]
+                           < postorder_numbers[finger2]) {
+                        finger1 = idoms[finger1];
+                    }
+                    while (postorder_numbers[finger2]
+                           < postorder_numbers[finger1]) {
+                        finger2 = idoms[finger2];
+                    }
+                }
+                new_idom = finger1;
+            }
+            if (idoms[node] != new_idom) {
+                idoms[node] = new_idom;
+                changed = true;
+            }
+        }
+    }
+
+    // Number the nodes in the order they are entered and left in a traversal
+    // of the dominator tree
+    vector< vector<size_t> > children(num_nodes);
+    for (size_t i = 1; i < reverse_postorder.size(); ++i) {
+        size_t node = reverse_postorder[i];
+        children[idoms[node]].push_back(node);
+    }
+    size_t counter = 0;
+    stack.clear();
+    stack.push_back(pair<size_t, size_t>(root, 0));
+    enter_order_[root] = counter++;
+    while (!stack.empty()) {
+        size_t node = stack.back().first;
+        size_t& next_child = stack.back().second;
+        if (next_child < children[node].size()) {
+            size_t child = children[node][next_child++];
+            enter_order_[child] = counter++;
+            stack.push_back(pair<size_t, size_t>(child, 0));
+        }
+        else {
+            leave_order_[node] = counter++;
+            stack.pop_back();
+        }
+    }
+}
+
+bool ModelModifier::DominatorTree::dominates(size_t dominator, size_t node)
+    const throw() {
+    if (dominator == node) return true;
+    if (node >= is_reachable_.size() || dominator >= is_reachable_.size()) {
+        return false;
+    }
+    if (!is_reachable_[dominator] || !is_reachable_[node]) return false;
+    return enter_order_[dominator] <= enter_order_[node]
+        && leave_order_[node] <= leave_order_[dominator];
+}
+
 void ModelModifier::redirectDataFlow(Leaf* old_start, Leaf* old_end,
                                      Leaf* new_start, Leaf* new_end)
     throw(InvalidArgumentException, IOException, RuntimeException) {
@@ -1016,9 +1180,9 @@ void ModelModifier::redirectDataFlow(Leaf* old_start, Leaf* old_end,
     logger_.logMessage(Logger::INFO, message);
 
     // Add in ports of old_start to the new_start
-    logger_.logMessage(Logger::DEBUG, string("Adding in ports from leaf \"")
-                       + old_start->getId()->getString() + "\" to leaf \""
-                       + new_start->getId()->getString() + "\"");
+    LOG_DEBUG(logger_, string("Adding in ports from leaf \"")
+              + old_start->getId()->getString() + "\" to leaf \""
+              + new_start->getId()->getString() + "\"");
     list<Leaf::Port*> in_ports = old_start->getInPorts();
     list<Leaf::Port*>::iterator it;
     for (it = in_ports.begin(); it != in_ports.end(); ++it) {
@@ -1028,13 +1192,13 @@ void ModelModifier::redirectDataFlow(Leaf* old_start, Leaf* old_end,
                             + "leaf \"" + new_start->getId()->getString()
                             + "\"");
         }
-        replaceProcessNetworkInput(*it, new_start->getInPorts().back());
+        replaceProcessNetworkInput(*it, new_start->getInPortRange().back());
     }
 
     // Add out ports of old_end to the new_end
-    logger_.logMessage(Logger::DEBUG, string("Adding out ports from leaf \"")
-                       + old_end->getId()->getString() + "\" to leaf \""
-                       + new_end->getId()->getString() + "\"");
+    LOG_DEBUG(logger_, string("Adding out ports from leaf \"")
+              + old_end->getId()->getString() + "\" to leaf \""
+              + new_end->getId()->getString() + "\"");
     list<Leaf::Port*> out_ports = old_end->getOutPorts();
     for (it = out_ports.begin(); it != out_ports.end(); ++it) {
         if (!new_end->addOutPort(**it)) {
@@ -1043,7 +1207,7 @@ void ModelModifier::redirectDataFlow(Leaf* old_start, Leaf* old_end,
                             + "leaf \"" + new_start->getId()->getString()
                             + "\"");
         }
-        replaceProcessNetworkOutput(*it, new_end->getOutPorts().back());
+        replaceProcessNetworkOutput(*it, new_end->getOutPortRange().back());
     }
 }
 
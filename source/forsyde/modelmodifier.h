@@ -37,6 +37,7 @@
  */
 
 #include "id.h"
+#include "idmap.h"
 #include "processnetwork.h"
 #include "leaf.h"
 #include "SY/mapsy.h"
@@ -48,6 +49,7 @@
 #include "../exceptions/invalidargumentexception.h"
 #include "../exceptions/outofmemoryexception.h"
 #include <list>
+#include <map>
 #include <set>
 #include <vector>
 
@@ -67,6 +69,7 @@ namespace Forsyde {
 class ModelModifier {
   private:
     class ContainedSection;
+    class DominatorTree;
 
   public:
     /**
@@ -217,7 +220,9 @@ class ModelModifier {
      *   - all data flow converging to the end point diverges from the starting
      *     point.
      * This method cannot handle nested levels of containment and thus only
-     * finds the closest layer of containment.
+     * finds the closest layer of containment. The data flow is analyzed once
+     * (see analyzeDataFlow()) before the search, which visits each leaf at
+     * most once.
      *
      * @returns List of contained sections.
      * @throws IOException
@@ -232,7 +237,8 @@ class ModelModifier {
     /**
      * Same as findContainedSections() but accepts a leaf to start the
      * search from and a set of visited leafs to avoid redundant search and
-     * infinite loops.
+     * infinite loops. The set is shared by the entire search, so that a leaf
+     * reachable through several paths is only analyzed once.
      *
      * @param begin
      *        Leaf to begin the search from.
@@ -246,7 +252,7 @@ class ModelModifier {
      *         bug.
      */
     std::list<ContainedSection> findContainedSections(
-        Forsyde::Leaf* begin, std::set<Forsyde::Id> visited)
+        Forsyde::Leaf* begin, Forsyde::IdSet& visited)
         throw(IOException, RuntimeException);
     
     /**
@@ -266,47 +272,63 @@ class ModelModifier {
     throw(IOException, RuntimeException);
 
     /**
-     * Checks whether a section is contained, i.e. that all branching paths from
-     * a starting point converge at an end point.
+     * Same as findNearestUnzipxLeaf(Forsyde::Leaf*) but accepts a set of
+     * visited leafs, which are not searched again as no \c Unzipx leaf was
+     * found through them.
      *
-     * @param start
-     *        Starting point.
-     * @param end
-     *        End point.
-     * @returns \b true if the paths are contained within the same start and 
-     *          end points.
-     * @throws InvalidArgumentException
-     *         When either \c start or \c end is \c NULL.
+     * @param begin
+     *        Leaf to begin from.
+     * @param visited
+     *        Set of visited leafs.
+     * @returns A Zipx leaf, if found; otherwise \c NULL.
      * @throws IOException
      *         When access to the log file failed.
      * @throws RuntimeException
      *         When a program error has occurred. This most likely indicates a
      *         bug.
      */
-    bool isAContainedSection(Leaf* start, Leaf* end)
-        throw(InvalidArgumentException, IOException, RuntimeException);
+    Forsyde::SY::Unzipx* findNearestUnzipxLeaf(
+        Forsyde::Leaf* begin, std::set<const Forsyde::Leaf*>& visited)
+    throw(IOException, RuntimeException);
 
     /**
-     * Checks that the data flow originating from a starting point converges at
-     * an end point. The flow can be checked in either forward or backward
-     * direction.
+     * Analyzes the data flow of the processnetwork by building its dominator
+     * and post-dominator trees. Data flow entering the processnetwork
+     * originates from a virtual entry point, and data flow leaving it ends at
+     * a virtual exit point. The trees must be rebuilt whenever the
+     * processnetwork has been modified.
+     *
+     * @throws IOException
+     *         When access to the log file failed.
+     * @throws RuntimeException
+     *         When a program error has occurred. This most likely indicates a
+     *         bug.
+     */
+    void analyzeDataFlow() throw(IOException, RuntimeException);
+
+    /**
+     * Checks whether a section is contained, i.e. that all branching paths from
+     * a starting point converge at an end point. This is the case when the
+     * end point post-dominates the starting point and the starting point
+     * dominates the end point. The data flow is analyzed first if either
+     * leaf is not part of the last analysis.
      *
      * @param start
-     *        Leaf to start the check from.
+     *        Starting point.
      * @param end
-     *        Expected end point.
-     * @param forward
-     *        Set to \b true for forward data flow check (from start to end),
-     *        and \b false for backward data flow check (from end to start).
-     * @returns \b true if the check is passed.
+     *        End point.
+     * @returns \b true if the paths are contained within the same start and 
+     *          end points.
+     * @throws InvalidArgumentException
+     *         When either \c start or \c end is \c NULL.
      * @throws IOException
      *         When access to the log file failed.
      * @throws RuntimeException
      *         When a program error has occurred. This most likely indicates a
      *         bug.
      */
-    bool checkDataFlowConvergence(Leaf* start, Leaf* end, bool forward)
-        throw(IOException, RuntimeException);
+    bool isAContainedSection(Leaf* start, Leaf* end)
+        throw(InvalidArgumentException, IOException, RuntimeException);
 
     /**
      * Checks if a contained section is data parallel. A data parallel section
@@ -438,7 +460,7 @@ class ModelModifier {
      *         bug.
      */
     std::list< std::list<SY::ParallelMap*> > findParallelMapSyChains(
-        Forsyde::Leaf* begin, std::set<Forsyde::Id> visited)
+        Forsyde::Leaf* begin, Forsyde::IdSet visited)
         throw(IOException, RuntimeException);
 
     /**
@@ -583,6 +605,64 @@ class ModelModifier {
         std::string toString() const throw();
     };
 
+    /**
+     * @brief Defines the dominator tree of a directed graph.
+     *
+     * The tree is built with the iterative algorithm by Cooper, Harvey, and
+     * Kennedy, and each node is numbered in the order it is entered and left
+     * during a traversal of the tree. Whether a node dominates another is then
+     * answered in constant time.
+     */
+    class DominatorTree {
+      public:
+        /**
+         * Creates an empty dominator tree.
+         */
+        DominatorTree() throw();
+
+        /**
+         * Creates the dominator tree of a graph.
+         *
+         * @param successors
+         *        Successors of each node in the graph.
+         * @param root
+         *        Node from which all paths start.
+         */
+        DominatorTree(const std::vector< std::vector<size_t> >& successors,
+                      size_t root) throw();
+
+        /**
+         * Checks whether a node dominates another, i.e. whether all paths
+         * from the root to the latter node pass through the former. A node
+         * always dominates itself. Nodes not reachable from the root are
+         * dominated by no other node.
+         *
+         * @param dominator
+         *        Dominating node.
+         * @param node
+         *        Dominated node.
+         * @returns \b true if \c dominator dominates \c node.
+         */
+        bool dominates(size_t dominator, size_t node) const throw();
+
+      private:
+        /**
+         * Number of each node in the order it is entered in the tree
+         * traversal.
+         */
+        std::vector<size_t> enter_order_;
+
+        /**
+         * Number of each node in the order it is left in the tree traversal.
+         */
+        std::vector<size_t> leave_order_;
+
+        /**
+         * Whether each node is reachable from the root.
+         */
+        std::vector<bool> is_reachable_;
+    };
+
   private:
     /**
      * ForSyDe processnetwork.
@@ -593,6 +673,21 @@ class ModelModifier {
      * Logger.
      */
     Logger& logger_;
+
+    /**
+     * Index of each leaf in the last data flow analysis.
+     */
+    std::map<const Forsyde::Leaf*, size_t> leaf_indices_;
+
+    /**
+     * Dominator tree of the data flow, rooted at the virtual entry point.
+     */
+    DominatorTree dominators_;
+
+    /**
+     * Post-dominator tree of the data flow, rooted at the virtual exit point.
+     */
+    DominatorTree post_dominators_;
 };
 
 }
@@ -39,6 +39,7 @@
 
 #include "id.h"
 #include "hierarchy.h"
+#include "../tools/arena.h"
 #include "../exceptions/outofmemoryexception.h"
 #include "../exceptions/notsupportedexception.h"
 #include "../exceptions/invalidprocessexception.h"
@@ -58,7 +59,7 @@ namespace Forsyde {
  * of ForSyDe models. It provides functionality common for all processes such as
  * ID and hierarchy management.
  */
-class Process{
+class Process : public tools::ArenaObject {
   public:
     class Port;
 
@@ -158,7 +159,7 @@ class Process{
      * @see \c Leaf::Port
      * @see \c Composite::IOPort
      */
-    class Interface {
+    class Interface : public tools::ArenaObject {
       public:
         /**
          * Creates a interface belonging to no process.
@@ -40,10 +40,14 @@ using std::pair;
 using std::bad_alloc;
 
 ProcessNetwork::ProcessNetwork() throw() :
-	Model() {}
+	Model(), arena_(new (std::nothrow) tools::Arena()) {}
 
 ProcessNetwork::~ProcessNetwork() throw() {
 	destroyAllFunctions();
+	// All arena-allocated objects must be destroyed before the arena is freed
+	destroyAllProcesses();
+	destroyAllComposites();
+	delete arena_;
 }
 
 bool ProcessNetwork::addInput(Process::Interface* port)
@@ -137,10 +141,12 @@ bool ProcessNetwork::addFunction(CFunction* function)
                         "NULL");
     }
     try {
-        pair<map<const Id, CFunction*>::iterator, bool>
-            result = functions_.insert(pair<const Id, CFunction*>(
-                    Id(function->getName()), function));
-        return result.second;
+        Id id(function->getName());
+        if (function_index_.contains(id)) return false;
+        function_index_.insert(id, functions_.insert(
+                                   pair<const Id, CFunction*>(id, function))
+                               .first);
+        return true;
     }
     catch(bad_alloc&) {
         THROW_EXCEPTION(OutOfMemoryException);
@@ -150,13 +156,21 @@ bool ProcessNetwork::addFunction(CFunction* function)
 void ProcessNetwork::addFunctions(map<const Id, CFunction*> functions)
     throw(OutOfMemoryException) {
     try {
-        functions_.insert(functions.begin(), functions.end());
+        map<const Id, CFunction*>::iterator it;
+        for (it = functions.begin(); it != functions.end(); ++it) {
+            if (function_index_.contains(it->first)) continue;
+            function_index_.insert(it->first, functions_.insert(*it).first);
+        }
     }
     catch(bad_alloc&) {
         THROW_EXCEPTION(OutOfMemoryException);
     }
 }
 
+tools::Arena* ProcessNetwork::getArena() throw() {
+    return arena_;
+}
+
 CFunction* ProcessNetwork::getFunction(const Id& id) throw() {
     map<const Id, CFunction*>::iterator it = findFunction(id);
     return it != functions_.end() ? it->second : NULL;
@@ -179,6 +193,7 @@ bool ProcessNetwork::deleteFunction(const Id& id) throw() {
     map<const Id, CFunction*>::iterator it = findFunction(id);
     if (it != functions_.end()) {
     	CFunction* removed_function = it->second;
+        function_index_.erase(it->first);
         functions_.erase(it);
         delete removed_function;
         return true;
@@ -268,8 +283,11 @@ void ProcessNetwork::destroyAllFunctions() throw() {
     for (it=functions_.begin(); it != functions_.end(); ++it) {
         delete it->second;
     }
+    functions_.clear();
+    function_index_.clear();
 }
 
 map<const Id, CFunction*>::iterator ProcessNetwork::findFunction(const Id& id) throw() {
-    return functions_.find(id);
+    map<const Id, CFunction*>::iterator* it = function_index_.find(id);
+    return it ? *it : functions_.end();
 }
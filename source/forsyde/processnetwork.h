@@ -37,9 +37,11 @@
  */
 
 #include "id.h"
+#include "idmap.h"
 #include "model.h"
 #include "process.h"
 #include "../language/cfunction.h"
+#include "../tools/arena.h"
 #include "../exceptions/outofmemoryexception.h"
 #include "../exceptions/illegalstateexception.h"
 #include "../exceptions/invalidargumentexception.h"
@@ -66,7 +68,8 @@ class ProcessNetwork: public Model {
 	ProcessNetwork() throw();
 
     /**
-     * Destroys this process network. This also destroys all processs.
+     * Destroys this process network. This also destroys all processes,
+     * composites and functions, and frees the arena.
      */
     virtual ~ProcessNetwork() throw();
 
@@ -220,6 +223,16 @@ class ProcessNetwork: public Model {
      */
     bool deleteFunction(const Id& id) throw();
 
+    /**
+     * Gets the arena from which the objects of this process network should be
+     * allocated. Activate it with a \c tools::Arena::Scope while building or
+     * modifying the network. The arena is freed in one step once all
+     * processes and functions of the network have been destroyed.
+     *
+     * @returns Arena, or \c NULL if none could be created.
+     */
+    tools::Arena* getArena() throw();
+
   private:
 
     /**
@@ -320,6 +333,16 @@ class ProcessNetwork: public Model {
      * Combset of functions.
      */
     std::map<const Id, CFunction*> functions_;
+
+    /**
+     * Hash index into \c functions_.
+     */
+    IdMap<std::map<const Id, CFunction*>::iterator> function_index_;
+
+    /**
+     * Arena owned by this process network.
+     */
+    tools::Arena* arena_;
 };
 
 }
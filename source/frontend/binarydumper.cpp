@@ -0,0 +1,512 @@
+/*
+ * Copyright (c) 2011-2013
+ *     Gabriel Hjort Blindell <ghb@kth.se>
+ *     George Ungureanu <ugeorge@kth.se>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OF THIS SOFTWARE NOR THE
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "binarydumper.h"
+#include "../tools/tools.h"
+#include "../forsyde/id.h"
+#include "../forsyde/hierarchy.h"
+#include "../forsyde/SY/combsy.h"
+#include "../forsyde/SY/mapsy.h"
+#include "../forsyde/SY/coalescedmapsy.h"
+#include "../forsyde/SY/parallelmapsy.h"
+#include "../forsyde/SY/zipxsy.h"
+#include "../forsyde/SY/unzipxsy.h"
+#include "../forsyde/SY/delaysy.h"
+#include "../forsyde/SY/inport.h"
+#include "../forsyde/SY/outport.h"
+#include "../forsyde/SY/fanoutsy.h"
+#include "../forsyde/SY/zipwithnsy.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace f2cc;
+using namespace f2cc::Forsyde;
+using namespace f2cc::BinaryModel;
+using std::string;
+using std::vector;
+using std::map;
+using std::list;
+using std::pair;
+
+namespace {
+
+/**
+ * Orders composites such that parents come before their children.
+ */
+bool hasLowerDepth(Composite* lhs, Composite* rhs) {
+    return lhs->getHierarchy().getHierarchy().size()
+        < rhs->getHierarchy().getHierarchy().size();
+}
+
+}
+
+BinaryDumper::BinaryDumper(Logger& logger) throw() : logger_(logger) {}
+
+BinaryDumper::~BinaryDumper() throw() {}
+
+void BinaryDumper::dump(ProcessNetwork* pn, const string& file)
+    throw(InvalidArgumentException, IOException, InvalidModelException,
+          RuntimeException) {
+    if (file.length() == 0) {
+        THROW_EXCEPTION(InvalidArgumentException, "\"file\" must not be empty "
+                        "string");
+    }
+    if (!pn) {
+        THROW_EXCEPTION(InvalidArgumentException, "\"processnetwork\" must not "
+                        "be NULL");
+    }
+
+    logger_.logMessage(Logger::INFO, "Building binary model from internal "
+                       "Process Network...");
+    clear();
+
+    // Collect all processes, such that connections and hierarchies can be
+    // dumped as indices
+    list<Composite*> composites = pn->getComposites();
+    for (list<Composite*>::iterator it = composites.begin();
+         it != composites.end(); ++it) {
+        collectComposite(*it);
+    }
+    list<Leaf*> leafs = pn->getProcesses();
+    for (list<Leaf*>::iterator it = leafs.begin(); it != leafs.end(); ++it) {
+        collectLeaf(*it);
+    }
+    std::stable_sort(composites_.begin(), composites_.end(), hasLowerDepth);
+    for (size_t i = 0; i < composites_.size(); ++i) {
+        composite_indices_[composites_[i]] = i;
+    }
+    for (size_t i = 0; i < leafs_.size(); ++i) {
+        leaf_indices_[leafs_[i]] = i;
+    }
+
+    // Number the interfaces in the order in which their records are created
+    uint32_t interface_index = 0;
+    for (size_t i = 0; i < composites_.size(); ++i) {
+        list<Composite::IOPort*> ports = composites_[i]->getInIOPorts();
+        list<Composite::IOPort*> out_ports = composites_[i]->getOutIOPorts();
+        ports.splice(ports.end(), out_ports);
+        for (list<Composite::IOPort*>::iterator it = ports.begin();
+             it != ports.end(); ++it) {
+            interface_indices_[*it] = interface_index++;
+        }
+    }
+    for (size_t i = 0; i < leafs_.size(); ++i) {
+        const Leaf::PortVector& in_ports = leafs_[i]->getInPortRange();
+        for (size_t j = 0; j < in_ports.size(); ++j) {
+            interface_indices_[in_ports[j]] = interface_index++;
+        }
+        const Leaf::PortVector& out_ports = leafs_[i]->getOutPortRange();
+        for (size_t j = 0; j < out_ports.size(); ++j) {
+            interface_indices_[out_ports[j]] = interface_index++;
+        }
+    }
+
+    // The functions of the process network come first, such that their
+    // variables are the ones the ports refer to
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    vector<uint32_t> indices;
+    list<CFunction*> functions = pn->getFunctions();
+    for (list<CFunction*>::iterator it = functions.begin();
+         it != functions.end(); ++it) {
+        indices.push_back(dumpFunction(*it));
+    }
+    header.functions = dumpIndices(indices);
+
+    for (size_t i = 0; i < composites_.size(); ++i) {
+        dumpComposite(composites_[i]);
+    }
+    for (size_t i = 0; i < leafs_.size(); ++i) {
+        dumpLeaf(leafs_[i]);
+    }
+    if (interfaces_.size() != interface_index) {
+        THROW_EXCEPTION(RuntimeException, "Interface records do not match "
+                        "the interface indices");
+    }
+
+    indices.clear();
+    for (list<Leaf*>::iterator it = leafs.begin(); it != leafs.end(); ++it) {
+        indices.push_back(leaf_indices_[*it]);
+    }
+    header.leafs = dumpIndices(indices);
+    indices.clear();
+    for (list<Composite*>::iterator it = composites.begin();
+         it != composites.end(); ++it) {
+        indices.push_back(composite_indices_[*it]);
+    }
+    header.composites = dumpIndices(indices);
+    header.inputs = dumpNetworkPorts(pn->getInputs());
+    header.outputs = dumpNetworkPorts(pn->getOutputs());
+
+    // Lay out the file
+    string data(sizeof(Header), '\0');
+    appendSection(data, strings_.empty() ? NULL : &strings_[0],
+                  strings_.size(), sizeof(StringRecord),
+                  header.sections[STRINGS]);
+    appendSection(data, indices_.empty() ? NULL : &indices_[0],
+                  indices_.size(), sizeof(uint32_t), header.sections[INDICES]);
+    appendSection(data, nodes_.empty() ? NULL : &nodes_[0], nodes_.size(),
+                  sizeof(uint32_t), header.sections[HIERARCHY_NODES]);
+    appendSection(data, variables_.empty() ? NULL : &variables_[0],
+                  variables_.size(), sizeof(VariableRecord),
+                  header.sections[VARIABLES]);
+    appendSection(data, functions_.empty() ? NULL : &functions_[0],
+                  functions_.size(), sizeof(FunctionRecord),
+                  header.sections[FUNCTIONS]);
+    appendSection(data,
+                  composite_records_.empty() ? NULL : &composite_records_[0],
+                  composite_records_.size(), sizeof(CompositeRecord),
+                  header.sections[COMPOSITES]);
+    appendSection(data, leaf_records_.empty() ? NULL : &leaf_records_[0],
+                  leaf_records_.size(), sizeof(LeafRecord),
+                  header.sections[LEAFS]);
+    appendSection(data, interfaces_.empty() ? NULL : &interfaces_[0],
+                  interfaces_.size(), sizeof(InterfaceRecord),
+                  header.sections[INTERFACES]);
+    appendSection(data, string_data_.data(), string_data_.size(), 1,
+                  header.sections[STRING_DATA]);
+
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.byte_order = kByteOrderMark;
+    header.file_size = data.size();
+    data.replace(0, sizeof(Header), reinterpret_cast<const char*>(&header),
+                 sizeof(Header));
+
+    logger_.logMessage(Logger::INFO, string() + "Dumping the process network "
+                       "into binary model file \"" + file + "\"...");
+    tools::writeFile(file, data);
+    clear();
+}
+
+void BinaryDumper::clear() throw() {
+    composites_.clear();
+    leafs_.clear();
+    composite_indices_.clear();
+    leaf_indices_.clear();
+    interface_indices_.clear();
+    function_indices_.clear();
+    variable_indices_.clear();
+    node_indices_.clear();
+    string_indices_.clear();
+    strings_.clear();
+    string_data_.clear();
+    indices_.clear();
+    nodes_.clear();
+    variables_.clear();
+    functions_.clear();
+    composite_records_.clear();
+    leaf_records_.clear();
+    interfaces_.clear();
+}
+
+void BinaryDumper::collectComposite(Composite* composite) throw() {
+    if (!composite_indices_.insert(
+            pair<const Composite*, uint32_t>(composite, 0)).second) {
+        return;
+    }
+    composites_.push_back(composite);
+
+    list<Composite*> composites = composite->getComposites();
+    for (list<Composite*>::iterator it = composites.begin();
+         it != composites.end(); ++it) {
+        collectComposite(*it);
+    }
+    list<Leaf*> leafs = composite->getProcesses();
+    for (list<Leaf*>::iterator it = leafs.begin(); it != leafs.end(); ++it) {
+        collectLeaf(*it);
+    }
+}
+
+void BinaryDumper::collectLeaf(Leaf* leaf) throw() {
+    if (leaf_indices_.insert(pair<const Leaf*, uint32_t>(leaf, 0)).second) {
+        leafs_.push_back(leaf);
+    }
+}
+
+void BinaryDumper::dumpComposite(Composite* composite) throw() {
+    CompositeRecord record;
+    record.hierarchy = dumpHierarchy(composite);
+    record.name = dumpString(composite->getName().getString());
+
+    vector<uint32_t> indices;
+    list<Leaf*> leafs = composite->getProcesses();
+    for (list<Leaf*>::iterator it = leafs.begin(); it != leafs.end(); ++it) {
+        indices.push_back(leaf_indices_[*it]);
+    }
+    record.leafs = dumpIndices(indices);
+    indices.clear();
+    list<Composite*> composites = composite->getComposites();
+    for (list<Composite*>::iterator it = composites.begin();
+         it != composites.end(); ++it) {
+        indices.push_back(composite_indices_[*it]);
+    }
+    record.composites = dumpIndices(indices);
+
+    record.in_ports = dumpIOPorts(composite->getInIOPorts());
+    record.out_ports = dumpIOPorts(composite->getOutIOPorts());
+    composite_records_.push_back(record);
+}
+
+void BinaryDumper::dumpLeaf(Leaf* leaf)
+    throw(InvalidModelException, IOException) {
+    LeafRecord record;
+    record.hierarchy = dumpHierarchy(leaf);
+    record.moc = dumpString(leaf->getMoc());
+    record.cost = leaf->getCost();
+    record.argument = kNone;
+
+    // Most derived types first, as e.g. a ParallelMap is also a Map
+    list<CFunction*> functions;
+    if (SY::ParallelMap* parallel_map_leaf = dynamic_cast<SY::ParallelMap*>(leaf)) {
+        record.type = PARALLEL_MAP;
+        record.argument = parallel_map_leaf->getNumProcesses();
+        functions = parallel_map_leaf->getFunctions();
+    }
+    else if (SY::CoalescedMap* coalesced_map_leaf =
+             dynamic_cast<SY::CoalescedMap*>(leaf)) {
+        record.type = COALESCED_MAP;
+        functions = coalesced_map_leaf->getFunctions();
+    }
+    else if (SY::Map* map_leaf = dynamic_cast<SY::Map*>(leaf)) {
+        record.type = MAP;
+        functions.push_back(map_leaf->getFunction());
+    }
+    else if (ZipWithNSY* zip_with_n_leaf = dynamic_cast<ZipWithNSY*>(leaf)) {
+        record.type = ZIP_WITH_N;
+        functions.push_back(zip_with_n_leaf->getFunction());
+    }
+    else if (SY::Comb* comb_leaf = dynamic_cast<SY::Comb*>(leaf)) {
+        record.type = COMB;
+        functions.push_back(comb_leaf->getFunction());
+    }
+    else if (SY::delay* delay_leaf = dynamic_cast<SY::delay*>(leaf)) {
+        record.type = DELAY;
+        record.argument = dumpString(delay_leaf->getInitialValue());
+    }
+    else if (dynamic_cast<SY::Fanout*>(leaf)) record.type = FANOUT;
+    else if (dynamic_cast<SY::Unzipx*>(leaf)) record.type = UNZIPX;
+    else if (dynamic_cast<SY::Zipx*>(leaf)) record.type = ZIPX;
+    else if (dynamic_cast<InPort*>(leaf)) record.type = IN_PORT;
+    else if (dynamic_cast<OutPort*>(leaf)) record.type = OUT_PORT;
+    else {
+        THROW_EXCEPTION(InvalidModelException, string("Leaf \"")
+                        + leaf->getId()->getString() + "\" of type \""
+                        + leaf->type() + "\" cannot be dumped");
+    }
+
+    vector<uint32_t> indices;
+    for (list<CFunction*>::iterator it = functions.begin();
+         it != functions.end(); ++it) {
+        indices.push_back(dumpFunction(*it));
+    }
+    record.functions = dumpIndices(indices);
+
+    record.in_ports = dumpPorts(leaf->getInPortRange());
+    record.out_ports = dumpPorts(leaf->getOutPortRange());
+    leaf_records_.push_back(record);
+}
+
+Range BinaryDumper::dumpPorts(const Leaf::PortVector& ports)
+    throw(IOException) {
+    Range range;
+    range.first = interfaces_.size();
+    range.count = ports.size();
+    for (size_t i = 0; i < ports.size(); ++i) {
+        Leaf::Port* port = ports[i];
+        InterfaceRecord record;
+        record.id = dumpString(port->getId()->getString());
+        record.type = toRecord(port->getDataType());
+        record.variable = kNone;
+        if (port->getVariable()) {
+            map<const CVariable*, uint32_t>::iterator variable =
+                variable_indices_.find(port->getVariable());
+            if (variable != variable_indices_.end()) {
+                record.variable = variable->second;
+            }
+            else {
+                logger_.logMessage(Logger::WARNING, string("Variable of port "
+                                   "\"") + port->toString() + "\" is not a "
+                                   "parameter of a function in the process "
+                                   "network and is not dumped");
+            }
+        }
+        record.connection = getInterfaceIndex(port->getConnectedPort());
+        record.outside_connection = kNone;
+        interfaces_.push_back(record);
+    }
+    return range;
+}
+
+Range BinaryDumper::dumpIOPorts(const list<Composite::IOPort*>& ports)
+    throw() {
+    Range range;
+    range.first = interfaces_.size();
+    range.count = ports.size();
+    for (list<Composite::IOPort*>::const_iterator it = ports.begin();
+         it != ports.end(); ++it) {
+        InterfaceRecord record;
+        record.id = dumpString((*it)->getId()->getString());
+        record.type = toRecord(CDataType());
+        record.variable = kNone;
+        record.connection = getInterfaceIndex((*it)->getConnectedPortInside());
+        record.outside_connection =
+            getInterfaceIndex((*it)->getConnectedPortOutside());
+        interfaces_.push_back(record);
+    }
+    return range;
+}
+
+Range BinaryDumper::dumpNetworkPorts(const list<Process::Interface*>& ports)
+    throw(IOException) {
+    vector<uint32_t> indices;
+    for (list<Process::Interface*>::const_iterator it = ports.begin();
+         it != ports.end(); ++it) {
+        uint32_t index = getInterfaceIndex(*it);
+        if (index != kNone) {
+            indices.push_back(index);
+        }
+        else {
+            logger_.logMessage(Logger::WARNING, string("Port \"")
+                               + (*it)->toString() + "\" does not belong to "
+                               "a process in the process network and is not "
+                               "dumped");
+        }
+    }
+    return dumpIndices(indices);
+}
+
+uint32_t BinaryDumper::dumpFunction(CFunction* function) throw() {
+    map<const CFunction*, uint32_t>::iterator it =
+        function_indices_.find(function);
+    if (it != function_indices_.end()) return it->second;
+
+    FunctionRecord record;
+    record.name = dumpString(function->getName());
+    record.body = dumpString(function->getBody());
+    record.prefix = dumpString(function->getDeclarationPrefix());
+    record.return_type = toRecord(*function->getReturnDataType());
+    list<CVariable*> parameters = function->getInputParameters();
+    record.input_parameters.first = variables_.size();
+    record.input_parameters.count = parameters.size();
+    for (list<CVariable*>::iterator param_it = parameters.begin();
+         param_it != parameters.end(); ++param_it) {
+        dumpVariable(*param_it);
+    }
+    record.output_parameter = function->getOutputParameter()
+        ? dumpVariable(function->getOutputParameter()) : kNone;
+
+    uint32_t index = functions_.size();
+    functions_.push_back(record);
+    function_indices_[function] = index;
+    return index;
+}
+
+uint32_t BinaryDumper::dumpVariable(CVariable* variable) throw() {
+    VariableRecord record;
+    record.name = dumpString(variable->getReferenceString());
+    record.type = toRecord(*variable->getDataType());
+
+    uint32_t index = variables_.size();
+    variables_.push_back(record);
+    variable_indices_[variable] = index;
+    return index;
+}
+
+Range BinaryDumper::dumpHierarchy(const Process* process) throw() {
+    list<Id*> hierarchy = process->getHierarchy().getHierarchy();
+    vector<uint32_t> indices;
+    for (list<Id*>::iterator it = hierarchy.begin(); it != hierarchy.end();
+         ++it) {
+        // Nodes are shared by pointer, as that is how hierarchies are
+        // compared
+        map<const Id*, uint32_t>::iterator node = node_indices_.find(*it);
+        if (node != node_indices_.end()) {
+            indices.push_back(node->second);
+        }
+        else {
+            uint32_t index = nodes_.size();
+            nodes_.push_back(dumpString((*it)->getString()));
+            node_indices_[*it] = index;
+            indices.push_back(index);
+        }
+    }
+    return dumpIndices(indices);
+}
+
+uint32_t BinaryDumper::dumpString(const string& str) throw() {
+    map<string, uint32_t>::iterator it = string_indices_.find(str);
+    if (it != string_indices_.end()) return it->second;
+
+    StringRecord record;
+    record.offset = string_data_.size();
+    record.length = str.length();
+    string_data_ += str;
+
+    uint32_t index = strings_.size();
+    strings_.push_back(record);
+    string_indices_.insert(pair<string, uint32_t>(str, index));
+    return index;
+}
+
+Range BinaryDumper::dumpIndices(const vector<uint32_t>& indices) throw() {
+    Range range;
+    range.first = indices_.size();
+    range.count = indices.size();
+    indices_.insert(indices_.end(), indices.begin(), indices.end());
+    return range;
+}
+
+uint32_t BinaryDumper::getInterfaceIndex(const Process::Interface* interface)
+    const throw() {
+    if (!interface) return kNone;
+    map<const Process::Interface*, uint32_t>::const_iterator it =
+        interface_indices_.find(interface);
+    return it != interface_indices_.end() ? it->second : kNone;
+}
+
+DataTypeRecord BinaryDumper::toRecord(const CDataType& type) throw() {
+    DataTypeRecord record;
+    record.type = type.getType();
+    record.flags = (type.isArray() ? IS_ARRAY : 0)
+        | (type.hasArraySize() ? HAS_ARRAY_SIZE : 0)
+        | (type.isPointer() ? IS_POINTER : 0)
+        | (type.isConst() ? IS_CONST : 0);
+    record.array_size = type.hasArraySize() ? type.getArraySize() : 0;
+    return record;
+}
+
+void BinaryDumper::appendSection(string& data, const void* records,
+                                 size_t count, size_t size, Section& section)
+    throw() {
+    data.append((4 - data.size() % 4) % 4, '\0');
+    section.offset = data.size();
+    section.count = count;
+    if (count > 0) {
+        data.append(static_cast<const char*>(records), count * size);
+    }
+}
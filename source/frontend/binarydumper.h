@@ -0,0 +1,371 @@
+/*
+ * Copyright (c) 2011-2013
+ *     Gabriel Hjort Blindell <ghb@kth.se>
+ *     George Ungureanu <ugeorge@kth.se>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OF THIS SOFTWARE NOR THE
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef F2CC_SOURCE_FRONTEND_BINARYDUMPER_H_
+#define F2CC_SOURCE_FRONTEND_BINARYDUMPER_H_
+
+/**
+ * @file
+ * @version 0.1
+ *
+ * @brief Defines the \c BinaryDumper class.
+ */
+
+#include "binarymodel.h"
+#include "../logger/logger.h"
+#include "../forsyde/processnetwork.h"
+#include "../forsyde/composite.h"
+#include "../forsyde/leaf.h"
+#include "../language/cfunction.h"
+#include "../language/cvariable.h"
+#include "../language/cdatatype.h"
+#include "../exceptions/invalidargumentexception.h"
+#include "../exceptions/invalidmodelexception.h"
+#include "../exceptions/ioexception.h"
+#include "../exceptions/runtimeexception.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <list>
+
+namespace f2cc {
+
+/**
+ * @brief A dumper of the internal \c Forsyde model into a binary model file.
+ *
+ * The \c BinaryDumper class writes a \c Forsyde::ProcessNetwork, including
+ * its composites, leafs, ports, connections, functions and hierarchies, into
+ * a binary model file. Unlike the file written by \c XmlDumper, the binary
+ * model file holds the entire model and is loaded back by \c BinaryLoader
+ * without any text parsing, which makes it suitable for snapshots of a model
+ * between the stages of the tool.
+ *
+ * @see binarymodel.h
+ */
+class BinaryDumper {
+  public:
+    /**
+     * Creates a dumper.
+     *
+     * @param logger
+     *        Reference to the logger.
+     */
+    BinaryDumper(Logger& logger) throw();
+
+    /**
+     * Destroys this dumper. The logger remains open.
+     */
+    ~BinaryDumper() throw();
+
+    /**
+     * Dumps a \c Forsyde::ProcessNetwork into a binary model file.
+     *
+     * @param pn
+     *        The \c Forsyde::ProcessNetwork that needs to be dumped.
+     * @param file
+     *        Output file.
+     * @throws InvalidArgumentException
+     *         When \c file is an empty string or \c pn is \c NULL.
+     * @throws IOException
+     *         When the file cannot be written or the log file cannot be
+     *         written.
+     * @throws InvalidModelException
+     *         When the process network contains a leaf of unknown type.
+     * @throws RuntimeException
+     *         When something unexpected occurs. This is most likely due to a
+     *         bug.
+     */
+    void dump(Forsyde::ProcessNetwork* pn, const std::string& file)
+        throw(InvalidArgumentException, IOException, InvalidModelException,
+              RuntimeException);
+
+  private:
+    /**
+     * Clears all records from a previous dump.
+     */
+    void clear() throw();
+
+    /**
+     * Adds a composite, and recursively all composites and leafs it contains,
+     * to the processes to dump.
+     *
+     * @param composite
+     *        Composite to add.
+     */
+    void collectComposite(Forsyde::Composite* composite) throw();
+
+    /**
+     * Adds a leaf to the processes to dump.
+     *
+     * @param leaf
+     *        Leaf to add.
+     */
+    void collectLeaf(Forsyde::Leaf* leaf) throw();
+
+    /**
+     * Creates the record of a composite.
+     *
+     * @param composite
+     *        Composite to dump.
+     */
+    void dumpComposite(Forsyde::Composite* composite) throw();
+
+    /**
+     * Creates the record of a leaf, and of its functions.
+     *
+     * @param leaf
+     *        Leaf to dump.
+     * @throws InvalidModelException
+     *         When the leaf is of unknown type.
+     * @throws IOException
+     *         When the log file cannot be written.
+     */
+    void dumpLeaf(Forsyde::Leaf* leaf)
+        throw(InvalidModelException, IOException);
+
+    /**
+     * Creates the records of the ports of a leaf.
+     *
+     * @param ports
+     *        Ports to dump.
+     * @returns Range of the port records.
+     * @throws IOException
+     *         When the log file cannot be written.
+     */
+    BinaryModel::Range dumpPorts(const Forsyde::Leaf::PortVector& ports)
+        throw(IOException);
+
+    /**
+     * Creates the records of IOPorts of a composite.
+     *
+     * @param ports
+     *        IOPorts to dump.
+     * @returns Range of the IOPort records.
+     */
+    BinaryModel::Range dumpIOPorts(
+        const std::list<Forsyde::Composite::IOPort*>& ports) throw();
+
+    /**
+     * Adds the inputs or outputs of the process network to the indices.
+     *
+     * @param ports
+     *        Inputs or outputs.
+     * @returns Range of the interface indices.
+     * @throws IOException
+     *         When the log file cannot be written.
+     */
+    BinaryModel::Range dumpNetworkPorts(
+        const std::list<Forsyde::Process::Interface*>& ports)
+        throw(IOException);
+
+    /**
+     * Gets the index of a function, and creates its record if it has none.
+     *
+     * @param function
+     *        Function.
+     * @returns Function index.
+     */
+    uint32_t dumpFunction(CFunction* function) throw();
+
+    /**
+     * Creates the record of a variable.
+     *
+     * @param variable
+     *        Variable.
+     * @returns Variable index.
+     */
+    uint32_t dumpVariable(CVariable* variable) throw();
+
+    /**
+     * Adds the hierarchy of a process to the indices.
+     *
+     * @param process
+     *        Process.
+     * @returns Range of the hierarchy node indices.
+     */
+    BinaryModel::Range dumpHierarchy(const Forsyde::Process* process) throw();
+
+    /**
+     * Gets the index of a string, and adds it to the string table if it has
+     * none.
+     *
+     * @param str
+     *        String.
+     * @returns String index.
+     */
+    uint32_t dumpString(const std::string& str) throw();
+
+    /**
+     * Appends a list of indices to the indices.
+     *
+     * @param indices
+     *        Indices to append.
+     * @returns Range of the appended indices.
+     */
+    BinaryModel::Range dumpIndices(const std::vector<uint32_t>& indices)
+        throw();
+
+    /**
+     * Gets the index of an interface.
+     *
+     * @param interface
+     *        Interface, or \c NULL.
+     * @returns Interface index, or \c BinaryModel::kNone if \c interface is
+     *          \c NULL or is not part of the dumped processes.
+     */
+    uint32_t getInterfaceIndex(const Forsyde::Process::Interface* interface)
+        const throw();
+
+    /**
+     * Converts a data type into a record.
+     *
+     * @param type
+     *        Data type.
+     * @returns Data type record.
+     */
+    static BinaryModel::DataTypeRecord toRecord(const CDataType& type)
+        throw();
+
+    /**
+     * Appends a section to the file data, preceded by padding such that it
+     * starts at a 4-byte aligned offset.
+     *
+     * @param data
+     *        File data.
+     * @param records
+     *        First record, if any.
+     * @param count
+     *        Number of records.
+     * @param size
+     *        Size of a record.
+     * @param section
+     *        Section to store the location of the appended records in.
+     */
+    static void appendSection(std::string& data, const void* records,
+                              size_t count, size_t size,
+                              BinaryModel::Section& section) throw();
+
+  private:
+    /**
+     * Logger.
+     */
+    Logger& logger_;
+
+    /**
+     * Composites to dump, with parents before their children.
+     */
+    std::vector<Forsyde::Composite*> composites_;
+
+    /**
+     * Leafs to dump.
+     */
+    std::vector<Forsyde::Leaf*> leafs_;
+
+    /**
+     * Maps each composite to its index.
+     */
+    std::map<const Forsyde::Composite*, uint32_t> composite_indices_;
+
+    /**
+     * Maps each leaf to its index.
+     */
+    std::map<const Forsyde::Leaf*, uint32_t> leaf_indices_;
+
+    /**
+     * Maps each interface to its index.
+     */
+    std::map<const Forsyde::Process::Interface*, uint32_t> interface_indices_;
+
+    /**
+     * Maps each function to its index.
+     */
+    std::map<const CFunction*, uint32_t> function_indices_;
+
+    /**
+     * Maps each variable to its index.
+     */
+    std::map<const CVariable*, uint32_t> variable_indices_;
+
+    /**
+     * Maps each hierarchy node to its index.
+     */
+    std::map<const Forsyde::Id*, uint32_t> node_indices_;
+
+    /**
+     * Maps each string to its index.
+     */
+    std::map<std::string, uint32_t> string_indices_;
+
+    /**
+     * String records.
+     */
+    std::vector<BinaryModel::StringRecord> strings_;
+
+    /**
+     * String characters.
+     */
+    std::string string_data_;
+
+    /**
+     * Indices.
+     */
+    std::vector<uint32_t> indices_;
+
+    /**
+     * Hierarchy nodes.
+     */
+    std::vector<uint32_t> nodes_;
+
+    /**
+     * Variable records.
+     */
+    std::vector<BinaryModel::VariableRecord> variables_;
+
+    /**
+     * Function records.
+     */
+    std::vector<BinaryModel::FunctionRecord> functions_;
+
+    /**
+     * Composite records.
+     */
+    std::vector<BinaryModel::CompositeRecord> composite_records_;
+
+    /**
+     * Leaf records.
+     */
+    std::vector<BinaryModel::LeafRecord> leaf_records_;
+
+    /**
+     * Interface records.
+     */
+    std::vector<BinaryModel::InterfaceRecord> interfaces_;
+};
+
+}
+
+#endif
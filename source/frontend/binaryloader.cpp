@@ -0,0 +1,728 @@
+/*
+ * Copyright (c) 2011-2013
+ *     Gabriel Hjort Blindell <ghb@kth.se>
+ *     George Ungureanu <ugeorge@kth.se>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OF THIS SOFTWARE NOR THE
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "binaryloader.h"
+#include "../tools/tools.h"
+#include "../tools/arena.h"
+#include "../tools/fileview.h"
+#include "../forsyde/hierarchy.h"
+#include "../forsyde/SY/combsy.h"
+#include "../forsyde/SY/mapsy.h"
+#include "../forsyde/SY/coalescedmapsy.h"
+#include "../forsyde/SY/parallelmapsy.h"
+#include "../forsyde/SY/zipxsy.h"
+#include "../forsyde/SY/unzipxsy.h"
+#include "../forsyde/SY/delaysy.h"
+#include "../forsyde/SY/inport.h"
+#include "../forsyde/SY/outport.h"
+#include "../forsyde/SY/fanoutsy.h"
+#include "../forsyde/SY/zipwithnsy.h"
+#include "../exceptions/invalidformatexception.h"
+#include <cstring>
+#include <new>
+
+using namespace f2cc;
+using namespace f2cc::Forsyde;
+using namespace f2cc::BinaryModel;
+using std::string;
+using std::vector;
+using std::list;
+using std::bad_alloc;
+
+BinaryLoader::BinaryLoader(Logger& logger) throw()
+        : logger_(logger), data_(NULL), header_(NULL), processnetwork_(NULL) {}
+
+BinaryLoader::~BinaryLoader() throw() {}
+
+ProcessNetwork* BinaryLoader::load(const string& file)
+    throw(InvalidArgumentException, FileNotFoundException, IOException,
+          ParseException, RuntimeException) {
+    if (file.length() == 0) {
+        THROW_EXCEPTION(InvalidArgumentException, "\"file\" must not be empty "
+                        "string");
+    }
+
+    file_ = file;
+    logger_.logMessage(Logger::INFO, string("Reading binary model file \"")
+                       + file + "\"...");
+    tools::FileView view(file);
+    readHeader(view.getData(), view.getSize());
+
+    logger_.logMessage(Logger::INFO, "Generating internal process network...");
+    processnetwork_ = new (std::nothrow) ProcessNetwork();
+    if (!processnetwork_) THROW_EXCEPTION(OutOfMemoryException);
+    tools::Arena::Scope arena_scope(processnetwork_->getArena());
+
+    try {
+        nodes_.assign(getCount(HIERARCHY_NODES), NULL);
+        variables_.assign(getCount(VARIABLES), NULL);
+        composites_.assign(getCount(COMPOSITES), NULL);
+        leafs_.assign(getCount(LEAFS), NULL);
+        ports_.assign(getCount(INTERFACES), NULL);
+        io_ports_.assign(getCount(INTERFACES), NULL);
+        is_function_shared_.assign(getCount(FUNCTIONS), false);
+    }
+    catch (bad_alloc&) {
+        THROW_EXCEPTION(OutOfMemoryException);
+    }
+
+    createFunctions();
+    for (uint32_t i = 0; i < composites_.size(); ++i) {
+        createComposite(i);
+    }
+    for (uint32_t i = 0; i < leafs_.size(); ++i) {
+        createLeaf(i);
+    }
+
+    // Replace all indices with pointers
+    const CompositeRecord* composite_records =
+        getRecords<CompositeRecord>(COMPOSITES);
+    for (uint32_t i = 0; i < composites_.size(); ++i) {
+        const CompositeRecord& record = composite_records[i];
+        checkRange(record.leafs, INDICES);
+        for (uint32_t j = 0; j < record.leafs.count; ++j) {
+            Leaf* leaf = leafs_[getIndex(record.leafs, j, leafs_.size())];
+            if (!composites_[i]->addProcess(leaf)) {
+                THROW_EXCEPTION(ParseException, file_,
+                                string("Multiple processes with ID \"")
+                                + leaf->getId()->getString() + "\"");
+            }
+        }
+        checkRange(record.composites, INDICES);
+        for (uint32_t j = 0; j < record.composites.count; ++j) {
+            Composite* composite = composites_[getIndex(record.composites, j,
+                                                        composites_.size())];
+            if (!composites_[i]->addComposite(composite)) {
+                THROW_EXCEPTION(ParseException, file_,
+                                string("Multiple processes with ID \"")
+                                + composite->getId()->getString() + "\"");
+            }
+        }
+    }
+    connectInterfaces();
+
+    checkRange(header_->leafs, INDICES);
+    for (uint32_t i = 0; i < header_->leafs.count; ++i) {
+        Leaf* leaf = leafs_[getIndex(header_->leafs, i, leafs_.size())];
+        if (!processnetwork_->addProcess(leaf)) {
+            THROW_EXCEPTION(ParseException, file_,
+                            string("Multiple processes with ID \"")
+                            + leaf->getId()->getString() + "\"");
+        }
+    }
+    checkRange(header_->composites, INDICES);
+    for (uint32_t i = 0; i < header_->composites.count; ++i) {
+        Composite* composite = composites_[getIndex(header_->composites, i,
+                                                    composites_.size())];
+        if (!processnetwork_->addComposite(composite)) {
+            THROW_EXCEPTION(ParseException, file_,
+                            string("Multiple processes with ID \"")
+                            + composite->getId()->getString() + "\"");
+        }
+    }
+    checkRange(header_->inputs, INDICES);
+    for (uint32_t i = 0; i < header_->inputs.count; ++i) {
+        processnetwork_->addInput(getInterface(
+            getIndex(header_->inputs, i, ports_.size())));
+    }
+    checkRange(header_->outputs, INDICES);
+    for (uint32_t i = 0; i < header_->outputs.count; ++i) {
+        processnetwork_->addOutput(getInterface(
+            getIndex(header_->outputs, i, ports_.size())));
+    }
+
+    // Functions which are neither part of the process network nor used by a
+    // Comb leaf have been copied by their leafs
+    vector<bool> is_function_used(is_function_shared_);
+    checkRange(header_->functions, INDICES);
+    for (uint32_t i = 0; i < header_->functions.count; ++i) {
+        uint32_t index = getIndex(header_->functions, i, functions_.size());
+        if (!processnetwork_->addFunction(functions_[index])) {
+            THROW_EXCEPTION(ParseException, file_,
+                            string("Multiple functions with ID \"")
+                            + functions_[index]->getName() + "\"");
+        }
+        is_function_used[index] = true;
+    }
+    for (size_t i = 0; i < functions_.size(); ++i) {
+        if (!is_function_used[i]) delete functions_[i];
+    }
+
+    ProcessNetwork* processnetwork = processnetwork_;
+    data_ = NULL;
+    header_ = NULL;
+    processnetwork_ = NULL;
+    nodes_.clear();
+    functions_.clear();
+    variables_.clear();
+    composites_.clear();
+    leafs_.clear();
+    ports_.clear();
+    io_ports_.clear();
+    is_function_shared_.clear();
+    return processnetwork;
+}
+
+void BinaryLoader::readHeader(const char* data, size_t size)
+    throw(ParseException) {
+    if (size < sizeof(Header)
+        || std::memcmp(data, kMagic, sizeof(kMagic)) != 0) {
+        THROW_EXCEPTION(ParseException, file_,
+                        "Not a binary model file");
+    }
+    const Header* header = reinterpret_cast<const Header*>(data);
+    if (header->byte_order != kByteOrderMark) {
+        THROW_EXCEPTION(ParseException, file_,
+                        "Binary model file was written on a machine with "
+                        "another byte order");
+    }
+    if (header->version != kVersion) {
+        THROW_EXCEPTION(ParseException, file_,
+                        string("Unsupported binary model version ")
+                        + tools::toString(header->version) + " (expected "
+                        + tools::toString(kVersion) + ")");
+    }
+    if (header->file_size != size) {
+        THROW_EXCEPTION(ParseException, file_,
+                        "Binary model file is truncated");
+    }
+
+    const size_t record_sizes[NUM_SECTIONS] = {
+        sizeof(StringRecord),
+        1,
+        sizeof(uint32_t),
+        sizeof(uint32_t),
+        sizeof(VariableRecord),
+        sizeof(FunctionRecord),
+        sizeof(CompositeRecord),
+        sizeof(LeafRecord),
+        sizeof(InterfaceRecord)
+    };
+    for (int i = 0; i < NUM_SECTIONS; ++i) {
+        const Section& section = header->sections[i];
+        if (section.offset % 4 != 0 || section.offset > size
+            || section.count > (size - section.offset) / record_sizes[i]) {
+            THROW_EXCEPTION(ParseException, file_,
+                            string("Section ") + tools::toString(i)
+                            + " lies outside the file");
+        }
+    }
+    data_ = data;
+    header_ = header;
+}
+
+void BinaryLoader::createFunctions() throw(ParseException, RuntimeException) {
+    const FunctionRecord* records = getRecords<FunctionRecord>(FUNCTIONS);
+    uint32_t num_functions = getCount(FUNCTIONS);
+    try {
+        functions_.assign(num_functions, NULL);
+        for (uint32_t i = 0; i < num_functions; ++i) {
+            const FunctionRecord& record = records[i];
+            checkRange(record.input_parameters, VARIABLES);
+            list<CVariable> parameters;
+            for (uint32_t j = 0; j < record.input_parameters.count; ++j) {
+                parameters.push_back(
+                    toVariable(record.input_parameters.first + j));
+            }
+            try {
+                functions_[i] = new CFunction(getString(record.name),
+                                              toDataType(record.return_type),
+                                              parameters,
+                                              getString(record.body),
+                                              getString(record.prefix));
+            }
+            catch (InvalidFormatException& ex) {
+                THROW_EXCEPTION(ParseException, file_,
+                                ex.getMessage());
+            }
+            if (record.output_parameter != kNone) {
+                if (record.output_parameter >= getCount(VARIABLES)) {
+                    THROW_EXCEPTION(ParseException, file_,
+                                    "Output parameter out of range");
+                }
+                functions_[i]->setOutputParameter(
+                    toVariable(record.output_parameter));
+            }
+        }
+    }
+    catch (bad_alloc&) {
+        THROW_EXCEPTION(OutOfMemoryException);
+    }
+}
+
+void BinaryLoader::createComposite(uint32_t index)
+    throw(ParseException, RuntimeException) {
+    const CompositeRecord& record = getRecords<CompositeRecord>(COMPOSITES)
+        [index];
+    try {
+        Hierarchy parent = getParentHierarchy(record.hierarchy);
+        Composite* composite = new Composite(
+            Id(getProcessId(record.hierarchy)), parent,
+            Id(getString(record.name)));
+        composites_[index] = composite;
+        setProcessNode(record.hierarchy, composite);
+
+        const InterfaceRecord* interfaces =
+            getRecords<InterfaceRecord>(INTERFACES);
+        checkRange(record.in_ports, INTERFACES);
+        checkRange(record.out_ports, INTERFACES);
+        for (uint32_t i = 0; i < record.in_ports.count; ++i) {
+            uint32_t port_index = record.in_ports.first + i;
+            Id id(getString(interfaces[port_index].id));
+            if (ports_[port_index] || io_ports_[port_index]
+                || !composite->addInIOPort(id)) {
+                THROW_EXCEPTION(ParseException, file_,
+                                string("Invalid in IOPort \"")
+                                + id.getString() + "\" of composite \""
+                                + composite->getId()->getString() + "\"");
+            }
+            io_ports_[port_index] = composite->getInIOPort(id);
+        }
+        for (uint32_t i = 0; i < record.out_ports.count; ++i) {
+            uint32_t port_index = record.out_ports.first + i;
+            Id id(getString(interfaces[port_index].id));
+            if (ports_[port_index] || io_ports_[port_index]
+                || !composite->addOutIOPort(id)) {
+                THROW_EXCEPTION(ParseException, file_,
+                                string("Invalid out IOPort \"")
+                                + id.getString() + "\" of composite \""
+                                + composite->getId()->getString() + "\"");
+            }
+            io_ports_[port_index] = composite->getOutIOPort(id);
+        }
+    }
+    catch (bad_alloc&) {
+        THROW_EXCEPTION(OutOfMemoryException);
+    }
+}
+
+void BinaryLoader::createLeaf(uint32_t index)
+    throw(ParseException, RuntimeException) {
+    const LeafRecord& record = getRecords<LeafRecord>(LEAFS)[index];
+    try {
+        Hierarchy parent = getParentHierarchy(record.hierarchy);
+        Leaf* leaf = newLeaf(record, Id(getProcessId(record.hierarchy)),
+                             parent);
+        leafs_[index] = leaf;
+        setProcessNode(record.hierarchy, leaf);
+
+        const InterfaceRecord* interfaces =
+            getRecords<InterfaceRecord>(INTERFACES);
+        checkRange(record.in_ports, INTERFACES);
+        checkRange(record.out_ports, INTERFACES);
+        for (uint32_t i = 0; i < record.in_ports.count; ++i) {
+            uint32_t port_index = record.in_ports.first + i;
+            const InterfaceRecord& port_record = interfaces[port_index];
+            Id id(getString(port_record.id));
+            if (ports_[port_index] || io_ports_[port_index]
+                || !leaf->addInPort(id, toDataType(port_record.type))) {
+                THROW_EXCEPTION(ParseException, file_,
+                                string("Invalid in port \"") + id.getString()
+                                + "\" of leaf \"" + leaf->getId()->getString()
+                                + "\"");
+            }
+            ports_[port_index] = leaf->getInPortRange().back();
+        }
+        for (uint32_t i = 0; i < record.out_ports.count; ++i) {
+            uint32_t port_index = record.out_ports.first + i;
+            const InterfaceRecord& port_record = interfaces[port_index];
+            Id id(getString(port_record.id));
+            if (ports_[port_index] || io_ports_[port_index]
+                || !leaf->addOutPort(id, toDataType(port_record.type))) {
+                THROW_EXCEPTION(ParseException, file_,
+                                string("Invalid out port \"") + id.getString()
+                                + "\" of leaf \"" + leaf->getId()->getString()
+                                + "\"");
+            }
+            ports_[port_index] = leaf->getOutPortRange().back();
+        }
+
+        // Associate the ports with the variables of the functions the leaf
+        // actually uses
+        list<CFunction*> functions;
+        if (SY::CoalescedMap* coalesced_map_leaf =
+            dynamic_cast<SY::CoalescedMap*>(leaf)) {
+            functions = coalesced_map_leaf->getFunctions();
+        }
+        else if (SY::Map* map_leaf = dynamic_cast<SY::Map*>(leaf)) {
+            functions.push_back(map_leaf->getFunction());
+        }
+        else if (ZipWithNSY* zip_with_n_leaf =
+                 dynamic_cast<ZipWithNSY*>(leaf)) {
+            functions.push_back(zip_with_n_leaf->getFunction());
+        }
+        else if (SY::Comb* comb_leaf = dynamic_cast<SY::Comb*>(leaf)) {
+            functions.push_back(comb_leaf->getFunction());
+        }
+        mapVariables(record, functions);
+        Range ports;
+        ports.first = record.in_ports.first;
+        ports.count = record.in_ports.count;
+        for (int direction = 0; direction < 2; ++direction) {
+            for (uint32_t i = 0; i < ports.count; ++i) {
+                uint32_t port_index = ports.first + i;
+                uint32_t variable = interfaces[port_index].variable;
+                if (variable == kNone) continue;
+                if (variable >= variables_.size() || !variables_[variable]) {
+                    THROW_EXCEPTION(ParseException, file_,
+                                    string("Variable of port \"")
+                                    + ports_[port_index]->toString()
+                                    + "\" is not a parameter of its leaf's "
+                                    "functions");
+                }
+                ports_[port_index]->setVariable(variables_[variable]);
+            }
+            ports = record.out_ports;
+        }
+        unmapVariables(record);
+    }
+    catch (bad_alloc&) {
+        THROW_EXCEPTION(OutOfMemoryException);
+    }
+}
+
+Leaf* BinaryLoader::newLeaf(const LeafRecord& record, const Id& id,
+                            Hierarchy& parent)
+    throw(ParseException, RuntimeException) {
+    // Leafs created by the XML frontend have an MoC and a hierarchy, whereas
+    // those created by the GraphML frontend and the model modifier have
+    // neither and are given their hierarchy afterwards
+    bool has_moc = !getString(record.moc).empty();
+    checkRange(record.functions, INDICES);
+    if ((record.type == COMB || record.type == MAP
+         || record.type == ZIP_WITH_N) && record.functions.count != 1) {
+        THROW_EXCEPTION(ParseException, file_,
+                        string("Leaf \"") + id.getString()
+                        + "\" must have exactly one function");
+    }
+
+    Leaf* leaf;
+    bool has_hierarchy = false;
+    try {
+        switch (record.type) {
+            case COMB: {
+                uint32_t function = getIndex(record.functions, 0,
+                                             functions_.size());
+                leaf = new SY::Comb(id, parent, record.cost,
+                                    functions_[function]);
+                is_function_shared_[function] = true;
+                has_hierarchy = true;
+                break;
+            }
+
+            case DELAY: {
+                string initial_value = getString(record.argument);
+                if (has_moc) {
+                    leaf = new SY::delay(id, parent, record.cost,
+                                         initial_value);
+                    has_hierarchy = true;
+                }
+                else {
+                    leaf = new SY::delay(id, initial_value);
+                }
+                break;
+            }
+
+            case FANOUT: {
+                if (has_moc) {
+                    leaf = new SY::Fanout(id, parent, record.cost);
+                    has_hierarchy = true;
+                }
+                else {
+                    leaf = new SY::Fanout(id);
+                }
+                break;
+            }
+
+            case UNZIPX: {
+                if (has_moc) {
+                    leaf = new SY::Unzipx(id, parent, record.cost);
+                    has_hierarchy = true;
+                }
+                else {
+                    leaf = new SY::Unzipx(id);
+                }
+                break;
+            }
+
+            case ZIPX: {
+                if (has_moc) {
+                    leaf = new SY::Zipx(id, parent, record.cost);
+                    has_hierarchy = true;
+                }
+                else {
+                    leaf = new SY::Zipx(id);
+                }
+                break;
+            }
+
+            case MAP: {
+                leaf = new SY::Map(id, *functions_[getIndex(
+                                       record.functions, 0,
+                                       functions_.size())]);
+                break;
+            }
+
+            case COALESCED_MAP:
+            case PARALLEL_MAP: {
+                list<CFunction> functions;
+                for (uint32_t i = 0; i < record.functions.count; ++i) {
+                    functions.push_back(*functions_[getIndex(
+                                            record.functions, i,
+                                            functions_.size())]);
+                }
+                if (record.type == COALESCED_MAP) {
+                    leaf = new SY::CoalescedMap(id, functions);
+                }
+                else {
+                    leaf = new SY::ParallelMap(id, record.argument,
+                                               functions);
+                }
+                break;
+            }
+
+            case ZIP_WITH_N: {
+                leaf = new ZipWithNSY(id, *functions_[getIndex(
+                                          record.functions, 0,
+                                          functions_.size())]);
+                break;
+            }
+
+            case IN_PORT: {
+                leaf = new InPort(id);
+                break;
+            }
+
+            case OUT_PORT: {
+                leaf = new OutPort(id);
+                break;
+            }
+
+            default: {
+                THROW_EXCEPTION(ParseException, file_,
+                                string("Unknown type of leaf \"")
+                                + id.getString() + "\"");
+            }
+        }
+    }
+    catch (InvalidArgumentException& ex) {
+        THROW_EXCEPTION(ParseException, file_,
+                        ex.getMessage());
+    }
+
+    if (!has_hierarchy) {
+        leaf->setHierarchy(parent);
+        int cost = record.cost;
+        leaf->setCost(cost);
+    }
+    return leaf;
+}
+
+void BinaryLoader::mapVariables(const LeafRecord& record,
+                                const list<CFunction*>& functions)
+    throw(ParseException) {
+    if (functions.size() != record.functions.count) {
+        THROW_EXCEPTION(ParseException, file_,
+                        "Number of functions does not match the leaf type");
+    }
+    const FunctionRecord* function_records =
+        getRecords<FunctionRecord>(FUNCTIONS);
+    list<CFunction*>::const_iterator it = functions.begin();
+    for (uint32_t i = 0; i < record.functions.count; ++i, ++it) {
+        const FunctionRecord& function_record = function_records[
+            getIndex(record.functions, i, functions_.size())];
+        list<CVariable*> parameters = (*it)->getInputParameters();
+        list<CVariable*>::iterator param_it = parameters.begin();
+        for (uint32_t j = 0; j < function_record.input_parameters.count;
+             ++j, ++param_it) {
+            variables_[function_record.input_parameters.first + j] =
+                *param_it;
+        }
+        if (function_record.output_parameter != kNone) {
+            variables_[function_record.output_parameter] =
+                (*it)->getOutputParameter();
+        }
+    }
+}
+
+void BinaryLoader::unmapVariables(const LeafRecord& record)
+    throw(ParseException) {
+    const FunctionRecord* function_records =
+        getRecords<FunctionRecord>(FUNCTIONS);
+    for (uint32_t i = 0; i < record.functions.count; ++i) {
+        const FunctionRecord& function_record = function_records[
+            getIndex(record.functions, i, functions_.size())];
+        for (uint32_t j = 0; j < function_record.input_parameters.count;
+             ++j) {
+            variables_[function_record.input_parameters.first + j] = NULL;
+        }
+        if (function_record.output_parameter != kNone) {
+            variables_[function_record.output_parameter] = NULL;
+        }
+    }
+}
+
+void BinaryLoader::connectInterfaces() throw(ParseException) {
+    const InterfaceRecord* records = getRecords<InterfaceRecord>(INTERFACES);
+    for (uint32_t i = 0; i < ports_.size(); ++i) {
+        const InterfaceRecord& record = records[i];
+        if (ports_[i]) {
+            ports_[i]->setConnection(getInterface(record.connection));
+        }
+        else if (io_ports_[i]) {
+            io_ports_[i]->setConnectionInside(getInterface(record.connection));
+            io_ports_[i]->setConnectionOutside(
+                getInterface(record.outside_connection));
+        }
+        else {
+            THROW_EXCEPTION(ParseException, file_,
+                            string("Port \"") + getString(record.id)
+                            + "\" does not belong to any process");
+        }
+    }
+}
+
+Process::Interface* BinaryLoader::getInterface(uint32_t index)
+    throw(ParseException) {
+    if (index == kNone) return NULL;
+    if (index >= ports_.size()) {
+        THROW_EXCEPTION(ParseException, file_,
+                        "Port index out of range");
+    }
+    if (ports_[index]) return ports_[index];
+    if (io_ports_[index]) return io_ports_[index];
+    THROW_EXCEPTION(ParseException, file_,
+                    string("Port \"")
+                    + getString(getRecords<InterfaceRecord>(INTERFACES)
+                                [index].id)
+                    + "\" does not belong to any process");
+}
+
+Hierarchy BinaryLoader::getParentHierarchy(const Range& range)
+    throw(ParseException) {
+    checkRange(range, INDICES);
+    if (range.count < 2) {
+        THROW_EXCEPTION(ParseException, file_,
+                        "Process hierarchy is too short");
+    }
+    const uint32_t* node_strings = getRecords<uint32_t>(HIERARCHY_NODES);
+    list<Id*> nodes;
+    for (uint32_t i = 0; i < range.count - 1; ++i) {
+        uint32_t node = getIndex(range, i, nodes_.size());
+        if (!nodes_[node]) nodes_[node] = new Id(getString(node_strings[node]));
+        nodes.push_back(nodes_[node]);
+    }
+    return Hierarchy(nodes);
+}
+
+string BinaryLoader::getProcessId(const Range& range) throw(ParseException) {
+    uint32_t node = getIndex(range, range.count - 1, nodes_.size());
+    return getString(getRecords<uint32_t>(HIERARCHY_NODES)[node]);
+}
+
+void BinaryLoader::setProcessNode(const Range& range, Process* process)
+    throw() {
+    // Processes share the node of their parent's ID, as hierarchies are
+    // compared by pointer
+    uint32_t node = getRecords<uint32_t>(INDICES)[range.first + range.count
+                                                  - 1];
+    nodes_[node] = const_cast<Id*>(process->getId());
+}
+
+string BinaryLoader::getString(uint32_t index) throw(ParseException) {
+    if (index >= getCount(STRINGS)) {
+        THROW_EXCEPTION(ParseException, file_,
+                        "String index out of range");
+    }
+    const StringRecord& record = getRecords<StringRecord>(STRINGS)[index];
+    uint32_t size = getCount(STRING_DATA);
+    if (record.offset > size || record.length > size - record.offset) {
+        THROW_EXCEPTION(ParseException, file_,
+                        "String lies outside the string data");
+    }
+    return string(getRecords<char>(STRING_DATA) + record.offset,
+                  record.length);
+}
+
+uint32_t BinaryLoader::getIndex(const Range& range, uint32_t i,
+                                uint32_t limit) throw(ParseException) {
+    if (i >= range.count || range.first > getCount(INDICES)
+        || i >= getCount(INDICES) - range.first) {
+        THROW_EXCEPTION(ParseException, file_,
+                        "Index out of range");
+    }
+    uint32_t index = getRecords<uint32_t>(INDICES)[range.first + i];
+    if (index >= limit) {
+        THROW_EXCEPTION(ParseException, file_,
+                        "Index out of range");
+    }
+    return index;
+}
+
+void BinaryLoader::checkRange(const Range& range, SectionType section)
+    throw(ParseException) {
+    uint32_t count = getCount(section);
+    if (range.first > count || range.count > count - range.first) {
+        THROW_EXCEPTION(ParseException, file_,
+                        "Range out of range");
+    }
+}
+
+CDataType BinaryLoader::toDataType(const DataTypeRecord& record)
+    throw(ParseException) {
+    if (record.type > CDataType::VOID) {
+        THROW_EXCEPTION(ParseException, file_,
+                        "Unknown data type");
+    }
+    try {
+        return CDataType(static_cast<CDataType::Type>(record.type),
+                         (record.flags & IS_ARRAY) != 0,
+                         (record.flags & HAS_ARRAY_SIZE) != 0,
+                         record.array_size,
+                         (record.flags & IS_POINTER) != 0,
+                         (record.flags & IS_CONST) != 0);
+    }
+    catch (InvalidArgumentException& ex) {
+        THROW_EXCEPTION(ParseException, file_,
+                        ex.getMessage());
+    }
+}
+
+CVariable BinaryLoader::toVariable(uint32_t index) throw(ParseException) {
+    const VariableRecord& record = getRecords<VariableRecord>(VARIABLES)[index];
+    try {
+        return CVariable(getString(record.name), toDataType(record.type));
+    }
+    catch (InvalidArgumentException& ex) {
+        THROW_EXCEPTION(ParseException, file_,
+                        ex.getMessage());
+    }
+}
+
+uint32_t BinaryLoader::getCount(SectionType section) const throw() {
+    return header_->sections[section].count;
+}
@@ -0,0 +1,426 @@
+/*
+ * Copyright (c) 2011-2013
+ *     Gabriel Hjort Blindell <ghb@kth.se>
+ *     George Ungureanu <ugeorge@kth.se>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OF THIS SOFTWARE NOR THE
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef F2CC_SOURCE_FRONTEND_BINARYLOADER_H_
+#define F2CC_SOURCE_FRONTEND_BINARYLOADER_H_
+
+/**
+ * @file
+ * @version 0.1
+ *
+ * @brief Defines a loader of binary model files.
+ */
+
+#include "binarymodel.h"
+#include "../logger/logger.h"
+#include "../forsyde/id.h"
+#include "../forsyde/processnetwork.h"
+#include "../forsyde/composite.h"
+#include "../forsyde/leaf.h"
+#include "../language/cfunction.h"
+#include "../language/cvariable.h"
+#include "../language/cdatatype.h"
+#include "../exceptions/filenotfoundexception.h"
+#include "../exceptions/parseexception.h"
+#include "../exceptions/invalidargumentexception.h"
+#include "../exceptions/ioexception.h"
+#include "../exceptions/runtimeexception.h"
+#include <string>
+#include <vector>
+#include <list>
+
+namespace f2cc {
+
+/**
+ * @brief A loader of binary model files written by \c BinaryDumper.
+ *
+ * The \c BinaryLoader maps a binary model file into memory and creates the
+ * processes, ports and functions directly from its records. As the records
+ * refer to each other by index, the only work besides creating the objects is
+ * to replace the indices with pointers to the created objects.
+ *
+ * Unlike a \c Frontend, the loader neither checks nor fixes the model, as a
+ * binary model file holds a model which has already been checked and fixed by
+ * the frontend which created it.
+ *
+ * @see binarymodel.h
+ */
+class BinaryLoader {
+  public:
+    /**
+     * Creates a loader.
+     *
+     * @param logger
+     *        Reference to the logger.
+     */
+    BinaryLoader(Logger& logger) throw();
+
+    /**
+     * Destroys this loader. The logger remains open.
+     */
+    ~BinaryLoader() throw();
+
+    /**
+     * Loads a binary model file into an internal ForSyDe process network. The
+     * caller is responsible for deleting the process network.
+     *
+     * @param file
+     *        Binary model file.
+     * @returns Internal process network.
+     * @throws InvalidArgumentException
+     *         When \c file is an empty string.
+     * @throws FileNotFoundException
+     *         When the file cannot be found.
+     * @throws IOException
+     *         When the file cannot be read or the log file cannot be written.
+     * @throws ParseException
+     *         When the file is not a valid binary model file.
+     * @throws RuntimeException
+     *         When something unexpected occurs. This is most likely due to a
+     *         bug.
+     */
+    Forsyde::ProcessNetwork* load(const std::string& file)
+        throw(InvalidArgumentException, FileNotFoundException, IOException,
+              ParseException, RuntimeException);
+
+  private:
+
+    /**
+     * Checks the header of the file and locates its sections.
+     *
+     * @param data
+     *        File data.
+     * @param size
+     *        File size.
+     * @throws ParseException
+     *         When the file is not a binary model file of this version, or
+     *         when a section lies outside the file.
+     */
+    void readHeader(const char* data, size_t size) throw(ParseException);
+
+    /**
+     * Creates the functions.
+     *
+     * @throws ParseException
+     *         When a record is malformed.
+     * @throws RuntimeException
+     *         When something unexpected occurs. This is most likely due to a
+     *         bug.
+     */
+    void createFunctions() throw(ParseException, RuntimeException);
+
+    /**
+     * Creates a composite, its IOPorts, and the hierarchy node of its ID.
+     *
+     * @param index
+     *        Composite index.
+     * @throws ParseException
+     *         When the record is malformed.
+     * @throws RuntimeException
+     *         When something unexpected occurs. This is most likely due to a
+     *         bug.
+     */
+    void createComposite(uint32_t index)
+        throw(ParseException, RuntimeException);
+
+    /**
+     * Creates a leaf, its ports, and the hierarchy node of its ID.
+     *
+     * @param index
+     *        Leaf index.
+     * @throws ParseException
+     *         When the record is malformed.
+     * @throws RuntimeException
+     *         When something unexpected occurs. This is most likely due to a
+     *         bug.
+     */
+    void createLeaf(uint32_t index) throw(ParseException, RuntimeException);
+
+    /**
+     * Creates a leaf of the type given in its record.
+     *
+     * @param record
+     *        Leaf record.
+     * @param id
+     *        Leaf ID.
+     * @param parent
+     *        Hierarchy of the parent of the leaf.
+     * @returns Created leaf.
+     * @throws ParseException
+     *         When the record is malformed.
+     * @throws RuntimeException
+     *         When something unexpected occurs. This is most likely due to a
+     *         bug.
+     */
+    Forsyde::Leaf* newLeaf(const BinaryModel::LeafRecord& record,
+                           const Forsyde::Id& id,
+                           Forsyde::Hierarchy& parent)
+        throw(ParseException, RuntimeException);
+
+    /**
+     * Maps the variables of functions in the file to the variables of the
+     * functions a leaf actually uses, which may be copies.
+     *
+     * @param record
+     *        Leaf record.
+     * @param functions
+     *        Functions of the leaf.
+     * @throws ParseException
+     *         When the record is malformed.
+     */
+    void mapVariables(const BinaryModel::LeafRecord& record,
+                      const std::list<CFunction*>& functions)
+        throw(ParseException);
+
+    /**
+     * Forgets the variables mapped by
+     * mapVariables(const BinaryModel::LeafRecord&, const std::list<CFunction*>&),
+     * such that the ports of other leafs cannot refer to them.
+     *
+     * @param record
+     *        Leaf record.
+     * @throws ParseException
+     *         When the record is malformed.
+     */
+    void unmapVariables(const BinaryModel::LeafRecord& record)
+        throw(ParseException);
+
+    /**
+     * Connects all ports.
+     *
+     * @throws ParseException
+     *         When a record is malformed.
+     */
+    void connectInterfaces() throw(ParseException);
+
+    /**
+     * Gets a created interface.
+     *
+     * @param index
+     *        Interface index, or \c BinaryModel::kNone.
+     * @returns Interface, or \c NULL if \c index is \c BinaryModel::kNone.
+     * @throws ParseException
+     *         When the index is out of range or the interface does not belong
+     *         to any process.
+     */
+    Forsyde::Process::Interface* getInterface(uint32_t index)
+        throw(ParseException);
+
+    /**
+     * Gets the hierarchy of the parent of a process, creating the nodes which
+     * do not yet exist.
+     *
+     * @param range
+     *        Hierarchy range of the process.
+     * @returns Parent hierarchy.
+     * @throws ParseException
+     *         When the range is malformed.
+     */
+    Forsyde::Hierarchy getParentHierarchy(const BinaryModel::Range& range)
+        throw(ParseException);
+
+    /**
+     * Gets the string of the last node of a hierarchy.
+     *
+     * @param range
+     *        Hierarchy range of the process.
+     * @returns Process ID.
+     * @throws ParseException
+     *         When the range is malformed.
+     */
+    std::string getProcessId(const BinaryModel::Range& range)
+        throw(ParseException);
+
+    /**
+     * Records the hierarchy node of the ID of a newly created process.
+     *
+     * @param range
+     *        Hierarchy range of the process.
+     * @param process
+     *        Created process.
+     */
+    void setProcessNode(const BinaryModel::Range& range,
+                        Forsyde::Process* process) throw();
+
+    /**
+     * Gets a string.
+     *
+     * @param index
+     *        String index.
+     * @returns String.
+     * @throws ParseException
+     *         When the index is out of range.
+     */
+    std::string getString(uint32_t index) throw(ParseException);
+
+    /**
+     * Gets an index from a range of indices.
+     *
+     * @param range
+     *        Range of indices.
+     * @param i
+     *        Position within the range.
+     * @param limit
+     *        Number of records which the index may refer to.
+     * @returns Index.
+     * @throws ParseException
+     *         When the index or the range is out of range.
+     */
+    uint32_t getIndex(const BinaryModel::Range& range, uint32_t i,
+                      uint32_t limit) throw(ParseException);
+
+    /**
+     * Checks that a range lies within a section.
+     *
+     * @param range
+     *        Range to check.
+     * @param section
+     *        Section type.
+     * @throws ParseException
+     *         When the range is out of range.
+     */
+    void checkRange(const BinaryModel::Range& range,
+                    BinaryModel::SectionType section) throw(ParseException);
+
+    /**
+     * Converts a record into a data type.
+     *
+     * @param record
+     *        Data type record.
+     * @returns Data type.
+     * @throws ParseException
+     *         When the record is malformed.
+     */
+    CDataType toDataType(const BinaryModel::DataTypeRecord& record)
+        throw(ParseException);
+
+    /**
+     * Converts a record into a variable.
+     *
+     * @param index
+     *        Variable index.
+     * @returns Variable.
+     * @throws ParseException
+     *         When the record is malformed.
+     */
+    CVariable toVariable(uint32_t index) throw(ParseException);
+
+    /**
+     * Gets the records of a section.
+     *
+     * @tparam T
+     *         Record type.
+     * @param section
+     *        Section type.
+     * @returns First record.
+     */
+    template <typename T>
+    const T* getRecords(BinaryModel::SectionType section) const throw() {
+        return reinterpret_cast<const T*>(data_ + header_->sections[section]
+                                          .offset);
+    }
+
+    /**
+     * Gets the number of records of a section.
+     *
+     * @param section
+     *        Section type.
+     * @returns Number of records.
+     */
+    uint32_t getCount(BinaryModel::SectionType section) const throw();
+
+  private:
+    /**
+     * Logger.
+     */
+    Logger& logger_;
+
+    /**
+     * Current file.
+     */
+    std::string file_;
+
+    /**
+     * Data of the current file.
+     */
+    const char* data_;
+
+    /**
+     * Header of the current file.
+     */
+    const BinaryModel::Header* header_;
+
+    /**
+     * Process network under construction.
+     */
+    Forsyde::ProcessNetwork* processnetwork_;
+
+    /**
+     * Created hierarchy nodes, or \c NULL for nodes not yet created.
+     */
+    std::vector<Forsyde::Id*> nodes_;
+
+    /**
+     * Created functions.
+     */
+    std::vector<CFunction*> functions_;
+
+    /**
+     * Variables of the functions of the leaf being created.
+     */
+    std::vector<CVariable*> variables_;
+
+    /**
+     * Created composites.
+     */
+    std::vector<Forsyde::Composite*> composites_;
+
+    /**
+     * Created leafs.
+     */
+    std::vector<Forsyde::Leaf*> leafs_;
+
+    /**
+     * Created leaf ports, or \c NULL for IOPorts.
+     */
+    std::vector<Forsyde::Leaf::Port*> ports_;
+
+    /**
+     * Created IOPorts, or \c NULL for leaf ports.
+     */
+    std::vector<Forsyde::Composite::IOPort*> io_ports_;
+
+    /**
+     * Whether a function is used by a \c Forsyde::SY::Comb leaf, which refers
+     * to the function instead of copying it.
+     */
+    std::vector<bool> is_function_shared_;
+};
+
+}
+
+#endif
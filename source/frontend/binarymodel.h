@@ -0,0 +1,454 @@
+/*
+ * Copyright (c) 2011-2013
+ *     Gabriel Hjort Blindell <ghb@kth.se>
+ *     George Ungureanu <ugeorge@kth.se>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OF THIS SOFTWARE NOR THE
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef F2CC_SOURCE_FRONTEND_BINARYMODEL_H_
+#define F2CC_SOURCE_FRONTEND_BINARYMODEL_H_
+
+/**
+ * @file
+ * @version 0.1
+ *
+ * @brief Defines the records of the binary model format.
+ *
+ * A binary model file stores a \c Forsyde::ProcessNetwork such that it can be
+ * mapped into memory and read in place. The file begins with a \c Header,
+ * which is followed by a number of sections. Each section is an array of
+ * records of the same type, starts at a 4-byte aligned offset and is
+ * described by a \c Section in the header.
+ *
+ * All fields are 32-bit integers in the byte order of the machine which wrote
+ * the file. Records never contain pointers; instead they refer to each other
+ * by their index within a section. Strings are stored only once in the string
+ * data section and are referred to by their index in the string section.
+ * Lists of references, such as the hierarchy of a process or the children of
+ * a composite, are stored as consecutive entries in the index section and
+ * referred to by a \c Range.
+ *
+ * The hierarchy of a process is a list of hierarchy nodes. Each node is an
+ * \c Forsyde::Id which may be shared by the hierarchies of several processes,
+ * as a process shares the node of each of its parents. The last node of a
+ * hierarchy is the ID of the process itself. Composites are stored before
+ * their children, such that the nodes of the parents exist when a process is
+ * created.
+ */
+
+#include <stdint.h>
+
+namespace f2cc {
+namespace BinaryModel {
+
+/**
+ * Identifies a binary model file.
+ */
+const char kMagic[8] = { 'F', '2', 'C', 'C', 'P', 'N', 'B', '\0' };
+
+/**
+ * Version of the format. Increase it whenever the records change.
+ */
+const uint32_t kVersion = 1;
+
+/**
+ * Written as is, to detect files written on a machine with another byte
+ * order.
+ */
+const uint32_t kByteOrderMark = 0x01020304;
+
+/**
+ * Denotes a missing reference.
+ */
+const uint32_t kNone = 0xffffffff;
+
+/**
+ * Location of a section within the file.
+ */
+struct Section {
+    /**
+     * Offset of the first record from the start of the file.
+     */
+    uint32_t offset;
+
+    /**
+     * Number of records.
+     */
+    uint32_t count;
+};
+
+/**
+ * Consecutive records within a section.
+ */
+struct Range {
+    /**
+     * Index of the first record.
+     */
+    uint32_t first;
+
+    /**
+     * Number of records.
+     */
+    uint32_t count;
+};
+
+/**
+ * Identifies the sections of a file.
+ */
+enum SectionType {
+    /**
+     * \c StringRecord records.
+     */
+    STRINGS,
+
+    /**
+     * String characters. Each record is a single byte.
+     */
+    STRING_DATA,
+
+    /**
+     * Section indices, each of which is an \c uint32_t.
+     */
+    INDICES,
+
+    /**
+     * Hierarchy nodes, each of which is the string index of an ID.
+     */
+    HIERARCHY_NODES,
+
+    /**
+     * \c VariableRecord records.
+     */
+    VARIABLES,
+
+    /**
+     * \c FunctionRecord records.
+     */
+    FUNCTIONS,
+
+    /**
+     * \c CompositeRecord records.
+     */
+    COMPOSITES,
+
+    /**
+     * \c LeafRecord records.
+     */
+    LEAFS,
+
+    /**
+     * \c InterfaceRecord records.
+     */
+    INTERFACES,
+
+    /**
+     * Number of section types.
+     */
+    NUM_SECTIONS
+};
+
+/**
+ * Identifies the type of a leaf.
+ */
+enum LeafType {
+    COMB,
+    DELAY,
+    FANOUT,
+    UNZIPX,
+    ZIPX,
+    MAP,
+    COALESCED_MAP,
+    PARALLEL_MAP,
+    ZIP_WITH_N,
+    IN_PORT,
+    OUT_PORT
+};
+
+/**
+ * Flags of a \c DataTypeRecord.
+ */
+enum DataTypeFlags {
+    IS_ARRAY = 1,
+    HAS_ARRAY_SIZE = 2,
+    IS_POINTER = 4,
+    IS_CONST = 8
+};
+
+/**
+ * Start of a binary model file.
+ */
+struct Header {
+    /**
+     * Equal to \c kMagic.
+     */
+    char magic[8];
+
+    /**
+     * Equal to \c kVersion.
+     */
+    uint32_t version;
+
+    /**
+     * Equal to \c kByteOrderMark.
+     */
+    uint32_t byte_order;
+
+    /**
+     * Size of the entire file.
+     */
+    uint32_t file_size;
+
+    /**
+     * Sections, indexed by \c SectionType.
+     */
+    Section sections[NUM_SECTIONS];
+
+    /**
+     * Leafs of the process network, as indices of \c LEAFS.
+     */
+    Range leafs;
+
+    /**
+     * Composites of the process network, as indices of \c COMPOSITES.
+     */
+    Range composites;
+
+    /**
+     * Inputs of the process network, as indices of \c INTERFACES.
+     */
+    Range inputs;
+
+    /**
+     * Outputs of the process network, as indices of \c INTERFACES.
+     */
+    Range outputs;
+
+    /**
+     * Functions of the process network, as indices of \c FUNCTIONS.
+     */
+    Range functions;
+};
+
+/**
+ * String within the string data section.
+ */
+struct StringRecord {
+    /**
+     * Offset of the first character within the string data section.
+     */
+    uint32_t offset;
+
+    /**
+     * Number of characters.
+     */
+    uint32_t length;
+};
+
+/**
+ * A \c CDataType.
+ */
+struct DataTypeRecord {
+    /**
+     * A \c CDataType::Type.
+     */
+    uint32_t type;
+
+    /**
+     * A combination of \c DataTypeFlags.
+     */
+    uint32_t flags;
+
+    /**
+     * Array size, if any.
+     */
+    uint32_t array_size;
+};
+
+/**
+ * A \c CVariable.
+ */
+struct VariableRecord {
+    /**
+     * Variable name, as string index.
+     */
+    uint32_t name;
+
+    /**
+     * Variable data type.
+     */
+    DataTypeRecord type;
+};
+
+/**
+ * A \c CFunction.
+ */
+struct FunctionRecord {
+    /**
+     * Function name, as string index.
+     */
+    uint32_t name;
+
+    /**
+     * Function body, as string index.
+     */
+    uint32_t body;
+
+    /**
+     * Declaration prefix, as string index.
+     */
+    uint32_t prefix;
+
+    /**
+     * Return data type.
+     */
+    DataTypeRecord return_type;
+
+    /**
+     * Input parameters, in \c VARIABLES.
+     */
+    Range input_parameters;
+
+    /**
+     * Output parameter, as index of \c VARIABLES, or \c kNone.
+     */
+    uint32_t output_parameter;
+};
+
+/**
+ * A \c Forsyde::Composite.
+ */
+struct CompositeRecord {
+    /**
+     * Hierarchy, as indices of \c HIERARCHY_NODES within \c INDICES.
+     */
+    Range hierarchy;
+
+    /**
+     * Composite name, as string index.
+     */
+    uint32_t name;
+
+    /**
+     * Contained leafs, as indices of \c LEAFS within \c INDICES.
+     */
+    Range leafs;
+
+    /**
+     * Contained composites, as indices of \c COMPOSITES within \c INDICES.
+     */
+    Range composites;
+
+    /**
+     * In IOPorts, in \c INTERFACES.
+     */
+    Range in_ports;
+
+    /**
+     * Out IOPorts, in \c INTERFACES.
+     */
+    Range out_ports;
+};
+
+/**
+ * A \c Forsyde::Leaf.
+ */
+struct LeafRecord {
+    /**
+     * A \c LeafType.
+     */
+    uint32_t type;
+
+    /**
+     * Hierarchy, as indices of \c HIERARCHY_NODES within \c INDICES.
+     */
+    Range hierarchy;
+
+    /**
+     * MoC, as string index.
+     */
+    uint32_t moc;
+
+    /**
+     * Cost parameter.
+     */
+    int32_t cost;
+
+    /**
+     * Initial value of a delay leaf, as string index, or the number of
+     * processes of a ParallelMap leaf.
+     */
+    uint32_t argument;
+
+    /**
+     * Functions, as indices of \c FUNCTIONS within \c INDICES.
+     */
+    Range functions;
+
+    /**
+     * In ports, in \c INTERFACES.
+     */
+    Range in_ports;
+
+    /**
+     * Out ports, in \c INTERFACES.
+     */
+    Range out_ports;
+};
+
+/**
+ * A \c Forsyde::Leaf::Port or a \c Forsyde::Composite::IOPort.
+ */
+struct InterfaceRecord {
+    /**
+     * Port ID, as string index.
+     */
+    uint32_t id;
+
+    /**
+     * Data type of a leaf port.
+     */
+    DataTypeRecord type;
+
+    /**
+     * Associated variable of a leaf port, as index of \c VARIABLES, or
+     * \c kNone.
+     */
+    uint32_t variable;
+
+    /**
+     * Connected port of a leaf port, or the port connected inside an IOPort,
+     * as index of \c INTERFACES, or \c kNone.
+     */
+    uint32_t connection;
+
+    /**
+     * Port connected outside an IOPort, as index of \c INTERFACES, or
+     * \c kNone.
+     */
+    uint32_t outside_connection;
+};
+
+}
+}
+
+#endif
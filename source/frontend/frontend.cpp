@@ -27,12 +27,14 @@
 
 #include "frontend.h"
 #include "dumper.h"
+#include "../tools/arena.h"
 #include <list>
 
 using namespace f2cc;
 using namespace f2cc::Forsyde;
 using std::string;
 using std::list;
+using std::set;
 
 Frontend::Frontend(Logger& logger) throw() : logger_(logger) {}
 
@@ -46,7 +48,10 @@ ProcessNetwork* Frontend::parse(const string& file)
                         "string");
     }
 
+    input_files_.clear();
+    input_files_.insert(file);
     ProcessNetwork* processnetwork = createProcessNetwork(file);
+    tools::Arena::Scope arena_scope(processnetwork->getArena());
 
     XmlDumper* dumper;
     dumper = new (std::nothrow) XmlDumper(logger_);
@@ -62,6 +67,14 @@ ProcessNetwork* Frontend::parse(const string& file)
     return processnetwork;
 }
 
+set<string> Frontend::getInputFiles() const throw() {
+    return input_files_;
+}
+
+void Frontend::addInputFile(const string& file) throw() {
+    input_files_.insert(file);
+}
+
 void Frontend::checkProcessNetwork(ProcessNetwork* processnetwork)
     throw(InvalidArgumentException, InvalidModelException, IOException,
           RuntimeException) {
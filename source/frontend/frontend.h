@@ -43,6 +43,7 @@
 #include "../exceptions/invalidmodelexception.h"
 #include "../exceptions/runtimeexception.h"
 #include <string>
+#include <set>
 
 namespace f2cc {
 
@@ -103,7 +104,25 @@ class Frontend {
         throw(InvalidArgumentException, FileNotFoundException, IOException,
               ParseException, InvalidModelException, RuntimeException);
 
+    /**
+     * Gets the files which were read by the last call to
+     * parse(const std::string&), including the input file itself. The
+     * generated code depends on the content of these files only.
+     *
+     * @returns Input files.
+     */
+    std::set<std::string> getInputFiles() const throw();
+
   protected:
+    /**
+     * Records a file which the processnetwork is built from, other than the
+     * input file given to parse(const std::string&).
+     *
+     * @param file
+     *        File path.
+     */
+    void addInputFile(const std::string& file) throw();
+
     /**
      * Creates a new ForSyDe processnetwork by parsing a given input file. This method is
      * responsible of dynamically allocating and returning a new \c
@@ -222,6 +241,12 @@ class Frontend {
      * Logger.
      */
     Logger& logger_;
+
+  private:
+    /**
+     * Files read by the last parse.
+     */
+    std::set<std::string> input_files_;
 };
 
 }
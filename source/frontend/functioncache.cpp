@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2011-2013
+ *     Gabriel Hjort Blindell <ghb@kth.se>
+ *     George Ungureanu <ugeorge@kth.se>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OF THIS SOFTWARE NOR THE
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "functioncache.h"
+#include "../tools/tools.h"
+#include "../tools/fileview.h"
+#include "../language/cvariable.h"
+#include <list>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include <pthread.h>
+
+using namespace f2cc;
+using std::string;
+using std::list;
+
+namespace {
+
+/**
+ * Identifies the format of the entry files. Increase the version whenever the
+ * format, or the way in which function files are parsed, changes.
+ */
+const char kEntryMagic[] = "F2CC-FUNCTION 1\n";
+
+/**
+ * Appends a number to an entry.
+ */
+void appendNumber(string& entry, size_t number) {
+    entry += f2cc::tools::toString(number) + ";";
+}
+
+/**
+ * Appends a string, preceded by its length, to an entry.
+ */
+void appendString(string& entry, const string& str) {
+    entry += f2cc::tools::toString(str.length()) + ":";
+    entry += str;
+}
+
+/**
+ * Reads a number, which ends with a given character, from an entry and
+ * advances past it.
+ *
+ * @returns \b false if the entry is malformed.
+ */
+bool readNumber(const char* data, size_t size, size_t& pos, char end,
+                size_t& number) {
+    size_t start = pos;
+    while (pos < size && data[pos] >= '0' && data[pos] <= '9') ++pos;
+    if (pos == start || pos >= size || data[pos] != end) return false;
+    number = std::strtoul(data + start, NULL, 10);
+    ++pos;
+    return true;
+}
+
+/**
+ * Reads a string from an entry and advances past it.
+ *
+ * @returns \b false if the entry is malformed.
+ */
+bool readString(const char* data, size_t size, size_t& pos, string& str) {
+    size_t length;
+    if (!readNumber(data, size, pos, ':', length)) return false;
+    if (length > size - pos) return false;
+    str.assign(data + pos, length);
+    pos += length;
+    return true;
+}
+
+}
+
+FunctionCache::FunctionCache(const string& directory, Logger& logger) throw()
+        : directory_(directory), logger_(logger) {}
+
+FunctionCache::~FunctionCache() throw() {}
+
+bool FunctionCache::isEnabled() const throw() {
+    return !directory_.empty();
+}
+
+CFunction* FunctionCache::load(const string& file, const string& name)
+    throw(IOException) {
+    if (!isEnabled()) return NULL;
+
+    tools::FileView entry;
+    string entry_file;
+    try {
+        entry_file = getEntryFile(file, name);
+        entry.open(entry_file);
+    }
+    catch (IOException&) {
+        return NULL;
+    }
+
+    const char* data = entry.getData();
+    size_t size = entry.getSize();
+    size_t magic_length = sizeof(kEntryMagic) - 1;
+    size_t pos = magic_length;
+    if (size < magic_length
+        || std::memcmp(data, kEntryMagic, magic_length) != 0) {
+        return NULL;
+    }
+
+    CFunction* function = new CFunction(name, file);
+    string body;
+    string prefix;
+    size_t num_parameters;
+    size_t has_output_parameter;
+    bool is_valid = readString(data, size, pos, body)
+        && readString(data, size, pos, prefix)
+        && readDataType(data, size, pos, *function->getReturnDataType())
+        && readNumber(data, size, pos, ';', num_parameters);
+    for (size_t i = 0; is_valid && i < num_parameters; ++i) {
+        string parameter_name;
+        CDataType parameter_type;
+        is_valid = readString(data, size, pos, parameter_name)
+            && readDataType(data, size, pos, parameter_type);
+        if (is_valid) {
+            try {
+                function->addInputParameter(CVariable(parameter_name,
+                                                      parameter_type));
+            }
+            catch (InvalidArgumentException&) {
+                is_valid = false;
+            }
+        }
+    }
+    is_valid = is_valid
+        && readNumber(data, size, pos, ';', has_output_parameter);
+    if (is_valid && has_output_parameter) {
+        string parameter_name;
+        CDataType parameter_type;
+        is_valid = readString(data, size, pos, parameter_name)
+            && readDataType(data, size, pos, parameter_type);
+        if (is_valid) {
+            try {
+                function->setOutputParameter(CVariable(parameter_name,
+                                                       parameter_type));
+            }
+            catch (InvalidArgumentException&) {
+                is_valid = false;
+            }
+        }
+    }
+    if (!is_valid || pos != size) {
+        delete function;
+        logger_.logMessage(Logger::WARNING, string("Ignoring malformed cache "
+                           "entry \"") + entry_file + "\"");
+        return NULL;
+    }
+    function->setBody(body);
+    function->setDeclarationPrefix(prefix);
+    return function;
+}
+
+void FunctionCache::store(const string& file, CFunction& function)
+    throw(IOException) {
+    if (!isEnabled()) return;
+
+    try {
+        string entry_file = getEntryFile(file, function.getName());
+
+        string entry(kEntryMagic);
+        appendString(entry, function.getBody());
+        appendString(entry, function.getDeclarationPrefix());
+        appendDataType(entry, *function.getReturnDataType());
+        list<CVariable*> parameters = function.getInputParameters();
+        appendNumber(entry, parameters.size());
+        for (list<CVariable*>::iterator it = parameters.begin();
+             it != parameters.end(); ++it) {
+            appendString(entry, (*it)->getReferenceString());
+            appendDataType(entry, *(*it)->getDataType());
+        }
+        CVariable* output_parameter = function.getOutputParameter();
+        appendNumber(entry, output_parameter ? 1 : 0);
+        if (output_parameter) {
+            appendString(entry, output_parameter->getReferenceString());
+            appendDataType(entry, *output_parameter->getDataType());
+        }
+
+        // Write to a temporary file first such that concurrent runs and
+        // threads never see a partial entry
+        tools::createDirectory(directory_);
+        string temp_file = entry_file + ".tmp"
+            + tools::toString(static_cast<long>(getpid())) + "_"
+            + tools::toString(static_cast<unsigned long>(pthread_self()));
+        tools::writeFile(temp_file, entry);
+        if (std::rename(temp_file.c_str(), entry_file.c_str()) != 0) {
+            std::remove(temp_file.c_str());
+        }
+    }
+    catch (IOException&) {
+        // Ignore
+    }
+}
+
+string FunctionCache::getEntryFile(const string& file, const string& name)
+    const throw(FileNotFoundException, IOException) {
+    uint64_t key = tools::hash(name, tools::hashFile(file));
+
+    string directory = directory_;
+    if (directory[directory.length() - 1] != '/') directory += "/";
+    return directory + tools::toHexString(key) + ".function";
+}
+
+void FunctionCache::appendDataType(string& entry, const CDataType& type)
+    throw() {
+    appendNumber(entry, type.getType());
+    appendNumber(entry, type.isArray());
+    appendNumber(entry, type.hasArraySize());
+    appendNumber(entry, type.hasArraySize() ? type.getArraySize() : 0);
+    appendNumber(entry, type.isPointer());
+    appendNumber(entry, type.isConst());
+}
+
+bool FunctionCache::readDataType(const char* data, size_t size, size_t& pos,
+                                 CDataType& type) throw() {
+    size_t fields[6];
+    for (size_t i = 0; i < 6; ++i) {
+        if (!readNumber(data, size, pos, ';', fields[i])) return false;
+    }
+    if (fields[0] > CDataType::VOID) return false;
+    try {
+        type = CDataType(static_cast<CDataType::Type>(fields[0]),
+                         fields[1] != 0, fields[2] != 0, fields[3],
+                         fields[4] != 0, fields[5] != 0);
+    }
+    catch (InvalidArgumentException&) {
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2011-2013
+ *     Gabriel Hjort Blindell <ghb@kth.se>
+ *     George Ungureanu <ugeorge@kth.se>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OF THIS SOFTWARE NOR THE
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef F2CC_SOURCE_FRONTEND_FUNCTIONCACHE_H_
+#define F2CC_SOURCE_FRONTEND_FUNCTIONCACHE_H_
+
+/**
+ * @file
+ * @version 0.1
+ *
+ * @brief Defines the \c FunctionCache class.
+ */
+
+#include "../logger/logger.h"
+#include "../language/cfunction.h"
+#include "../language/cdatatype.h"
+#include "../exceptions/filenotfoundexception.h"
+#include "../exceptions/ioexception.h"
+#include <string>
+
+namespace f2cc {
+
+/**
+ * @brief An on-disk cache of C functions parsed from function files.
+ *
+ * The \c FunctionCache stores each \c CFunction parsed from a
+ * ForSyDe-SystemC function file in a cache directory, in a file named after a
+ * hash of the function name and the content of the function file. When a
+ * model is synthesized again after only some of its files have changed, the
+ * functions of the unchanged function files are then loaded from the cache
+ * instead of being parsed again.
+ *
+ * The cache may be used by several threads at once. A broken or unreadable
+ * entry is treated as a miss, and failing to store an entry is ignored, as
+ * the cache never affects the parsed functions.
+ */
+class FunctionCache {
+  public:
+    /**
+     * Creates a cache.
+     *
+     * @param directory
+     *        Cache directory, or an empty path to disable the cache.
+     * @param logger
+     *        Reference to the logger.
+     */
+    FunctionCache(const std::string& directory, Logger& logger) throw();
+
+    /**
+     * Destroys this cache.
+     */
+    ~FunctionCache() throw();
+
+    /**
+     * Checks whether the cache is enabled.
+     *
+     * @returns \b true if a cache directory is set.
+     */
+    bool isEnabled() const throw();
+
+    /**
+     * Loads a function which was previously parsed from a function file with
+     * the same content. The caller is responsible for deleting the returned
+     * function.
+     *
+     * @param file
+     *        Function file.
+     * @param name
+     *        Function name.
+     * @returns The function, or \c NULL if it is not in the cache.
+     * @throws IOException
+     *         When the log file cannot be written.
+     */
+    CFunction* load(const std::string& file, const std::string& name)
+        throw(IOException);
+
+    /**
+     * Stores a function parsed from a function file.
+     *
+     * @param file
+     *        Function file.
+     * @param function
+     *        Function parsed from \c file.
+     * @throws IOException
+     *         When the log file cannot be written.
+     */
+    void store(const std::string& file, CFunction& function) throw(IOException);
+
+  private:
+    /**
+     * Gets the path of the entry file for a function.
+     *
+     * @param file
+     *        Function file.
+     * @param name
+     *        Function name.
+     * @returns Entry file path.
+     * @throws FileNotFoundException
+     *         When the function file cannot be found.
+     * @throws IOException
+     *         When the function file cannot be read.
+     */
+    std::string getEntryFile(const std::string& file, const std::string& name)
+        const throw(FileNotFoundException, IOException);
+
+    /**
+     * Appends a data type to an entry.
+     *
+     * @param entry
+     *        Entry data.
+     * @param type
+     *        Data type.
+     */
+    static void appendDataType(std::string& entry, const CDataType& type)
+        throw();
+
+    /**
+     * Reads a data type from an entry, and advances past it.
+     *
+     * @param data
+     *        Entry data.
+     * @param size
+     *        Size of the entry data.
+     * @param pos
+     *        Current position.
+     * @param type
+     *        Data type to store the result in.
+     * @returns \b false if the entry is malformed.
+     */
+    static bool readDataType(const char* data, size_t size, size_t& pos,
+                             CDataType& type) throw();
+
+  private:
+    /**
+     * Cache directory.
+     */
+    const std::string directory_;
+
+    /**
+     * Logger.
+     */
+    Logger& logger_;
+};
+
+}
+
+#endif
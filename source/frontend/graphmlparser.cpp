@@ -29,6 +29,8 @@
 #include "../ticpp/ticpp.h"
 #include "../ticpp/tinyxml.h"
 #include "../tools/tools.h"
+#include "../tools/arena.h"
+#include "../tools/fileview.h"
 #include "../forsyde/SY/mapsy.h"
 #include "../forsyde/SY/parallelmapsy.h"
 #include "../forsyde/SY/zipxsy.h"
@@ -75,10 +77,10 @@ ProcessNetwork* GraphmlParser::createProcessNetwork(const string& file)
     file_ = file;
 
     // Read file content
-    string xml_data;
+    tools::FileView xml_data;
     logger_.logMessage(Logger::INFO, string("Reading xml data from file..."));
     try {
-        tools::readFile(file_, xml_data);
+        xml_data.open(file_);
     } catch (FileNotFoundException& ex) {
         logger_.logMessage(Logger::ERROR, string("No xml input file \"") + file_
                            + "\" could be found");
@@ -93,7 +95,7 @@ ProcessNetwork* GraphmlParser::createProcessNetwork(const string& file)
     Document xml;
     try {
         logger_.logMessage(Logger::INFO, "Building xml structure...");
-        xml.Parse(xml_data);
+        xml.Parse(xml_data.getData());
     } catch (ticpp::Exception& ex) {
         // @todo throw more detailed ParseException (with line and column)
         THROW_EXCEPTION(ParseException, file_, ex.what());
@@ -221,6 +223,7 @@ ProcessNetwork* GraphmlParser::generateProcessNetwork(Element* xml)
 
     ProcessNetwork* processnetwork = new (std::nothrow) ProcessNetwork();
     if (!processnetwork) THROW_EXCEPTION(OutOfMemoryException);
+    tools::Arena::Scope arena_scope(processnetwork->getArena());
 
     logger_.logMessage(Logger::DEBUG, "Parsing \"node\" elements...");
     parseXmlNodes(xml, processnetwork);
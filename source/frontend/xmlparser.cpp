@@ -26,9 +26,11 @@
  */
 
 #include "xmlparser.h"
+#include "xmlstreamreader.h"
 #include "../ticpp/ticpp.h"
 #include "../ticpp/tinyxml.h"
 #include "../tools/tools.h"
+#include "../tools/arena.h"
 //#include "../forsyde/composite.h"
 #include "../forsyde/SY/zipxsy.h"
 #include "../forsyde/SY/unzipxsy.h"
@@ -44,6 +46,9 @@
 #include <vector>
 #include <stdexcept>
 #include <new>
+#include <algorithm>
+#include <cstring>
+#include <pthread.h>
 
 using namespace f2cc;
 using namespace f2cc::Forsyde;
@@ -56,11 +61,19 @@ using std::map;
 using std::pair;
 using std::list;
 using std::vector;
+using std::set;
 using std::bad_alloc;
 
-XmlParser::XmlParser(Logger& logger) throw() : Frontend(logger) {}
+XmlParser::XmlParser(Logger& logger, size_t num_parser_threads,
+                     bool do_streaming, const string& cache_directory) throw()
+        : Frontend(logger), num_parser_threads_(num_parser_threads),
+          do_streaming_(do_streaming),
+          function_cache_(cache_directory, logger),
+          next_function_file_(0) {}
 
-XmlParser::~XmlParser() throw() {}
+XmlParser::~XmlParser() throw() {
+    clearFunctionFiles();
+}
 
 ProcessNetwork* XmlParser::createProcessNetwork(const string& file)
     throw(InvalidArgumentException, FileNotFoundException, IOException,
@@ -76,13 +89,35 @@ ProcessNetwork* XmlParser::createProcessNetwork(const string& file)
     logger_.logMessage(Logger::INFO, "Generating internal process network...");
     ProcessNetwork* processnetwork = new (std::nothrow) ProcessNetwork();
     if (!processnetwork) THROW_EXCEPTION(OutOfMemoryException);
+    tools::Arena::Scope arena_scope(processnetwork->getArena());
+
+    clearFunctionFiles();
+    Composite* root_comp;
+    if (do_streaming_) {
+        if (num_parser_threads_ > 1) {
+            logger_.logMessage(Logger::INFO, "Collecting function files...");
+            set<string> visited_files;
+            collectFunctionFiles(file, visited_files);
+            parseFunctionFiles();
+        }
 
-    Document xml_doc = (parseXmlFile(file));
-    Element* xml_root = dynamic_cast<Element*>(findXmlRootNode(&xml_doc, file));
-    if (!xml_root) THROW_EXCEPTION(CastException);
+        root_comp = streamComposite(file, processnetwork, Id("f2cc0"),
+                                    Hierarchy());
+    }
+    else {
+        Document xml_doc = (parseXmlFile(file));
+        Element* xml_root = dynamic_cast<Element*>(findXmlRootNode(&xml_doc, file));
+        if (!xml_root) THROW_EXCEPTION(CastException);
+
+        if (num_parser_threads_ > 1) {
+            logger_.logMessage(Logger::INFO, "Collecting function files...");
+            collectFunctionFiles(xml_root);
+            parseFunctionFiles();
+        }
 
-    Composite* root_comp = buildComposite(xml_root, processnetwork,
-    		Id("f2cc0"), Hierarchy());
+        root_comp = buildComposite(xml_root, processnetwork,
+        		Id("f2cc0"), Hierarchy());
+    }
 
     processnetwork->addComposite(root_comp);
 
@@ -97,6 +132,7 @@ ProcessNetwork* XmlParser::createProcessNetwork(const string& file)
     		it != output_ports.end(); it++){
     	processnetwork->addOutput(*it);
     }
+    clearFunctionFiles();
 
     return processnetwork;
 }
@@ -115,38 +151,159 @@ Composite* XmlParser::buildComposite(Element* xml, ProcessNetwork* processnetwor
     Composite* curr_composite = new Composite(id, hierarchy, Id(getAttributeByTag(xml,string("name"))));
     if (!curr_composite) THROW_EXCEPTION(OutOfMemoryException);
 
-    logger_.logMessage(Logger::DEBUG, string(tools::indent(level_)
-                           + "Parsing \"leaf_process\" elements..."));
+    LOG_DEBUG(logger_, string(tools::indent(level_)
+                  + "Parsing \"leaf_process\" elements..."));
     parseXmlLeafs(xml, processnetwork, curr_composite);
 
-    logger_.logMessage(Logger::DEBUG, string(tools::indent(level_)
-                           + "Parsing \"composite_process\" elements..."));
+    LOG_DEBUG(logger_, string(tools::indent(level_)
+                  + "Parsing \"composite_process\" elements..."));
     parseXmlComposites(xml, processnetwork, curr_composite);
 
-    logger_.logMessage(Logger::DEBUG, string(tools::indent(level_)
-                           + "Parsing \"port\" elements..."));
+    LOG_DEBUG(logger_, string(tools::indent(level_)
+                  + "Parsing \"port\" elements..."));
     parseXmlPorts(xml, curr_composite);
 
-    logger_.logMessage(Logger::DEBUG, string(tools::indent(level_)
-                           + "Parsing \"signal\" elements..."));
+    LOG_DEBUG(logger_, string(tools::indent(level_)
+                  + "Parsing \"signal\" elements..."));
     parseXmlSignals(xml, curr_composite);
 
     return curr_composite;
 }
 
+Composite* XmlParser::streamComposite(const string& file,
+		ProcessNetwork* processnetwork, const Id id, Hierarchy hierarchy)
+    throw(FileNotFoundException, ParseException, InvalidModelException,
+          IOException, RuntimeException) {
+    if (!processnetwork) {
+        THROW_EXCEPTION(InvalidArgumentException, "\"processnetwork\" must not be NULL");
+    }
+
+    logger_.logMessage(Logger::INFO, string(tools::indent(level_)
+                           + "Level " + tools::toString(level_)
+                           + ". Streaming xml data from file: "
+                           + file
+                           + "..."));
+    if (!tools::existsFile(file)) {
+        logger_.logMessage(Logger::ERROR, string("No xml input file \"") + file
+                           + "\" could be found");
+        THROW_EXCEPTION(FileNotFoundException, file);
+    }
+    XmlStreamReader reader(file);
+
+    // Find the root element
+    XmlStreamReader::TagType type;
+    do {
+        type = reader.next();
+    } while (type == XmlStreamReader::END_TAG);
+    if (type == XmlStreamReader::END_OF_FILE
+        || reader.getName() != "process_network") {
+        THROW_EXCEPTION(ParseException, file,
+                        string("Could not find root element \"graphml\""));
+    }
+    XmlFragment root_fragment;
+    root_fragment.text = reader.getEmptyElementText();
+    root_fragment.row = reader.getRow();
+    root_fragment.column = reader.getColumn();
+    Composite* curr_composite;
+    {
+        Document xml_doc = parseXmlFragment(file, root_fragment);
+        Element* xml_root = dynamic_cast<Element*>(
+            findXmlRootNode(&xml_doc, file));
+        if (!xml_root) THROW_EXCEPTION(CastException);
+        curr_composite = new Composite(id, hierarchy,
+                                       Id(getAttributeByTag(xml_root,
+                                                            string("name"))));
+        if (!curr_composite) THROW_EXCEPTION(OutOfMemoryException);
+    }
+    if (type == XmlStreamReader::EMPTY_TAG) return curr_composite;
+
+    // Leafs are built as soon as they are read, as they make up most of the
+    // file. The remaining elements are small and are kept until the end such
+    // that they are processed in the same order as in buildComposite().
+    LOG_DEBUG(logger_, string(tools::indent(level_)
+                  + "Parsing \"leaf_process\" elements..."));
+    list<XmlFragment> composite_fragments;
+    list<XmlFragment> port_fragments;
+    list<XmlFragment> signal_fragments;
+    while ((type = reader.next()) != XmlStreamReader::END_OF_FILE) {
+        if (type == XmlStreamReader::END_TAG || reader.getDepth() != 1) {
+            continue;
+        }
+
+        list<XmlFragment>* fragments = NULL;
+        if (reader.getName() == "composite_process") {
+            fragments = &composite_fragments;
+        }
+        else if (reader.getName() == "port") {
+            fragments = &port_fragments;
+        }
+        else if (reader.getName() == "signal") {
+            fragments = &signal_fragments;
+        }
+        else if (reader.getName() != "leaf_process") {
+            continue;
+        }
+
+        XmlFragment fragment;
+        fragment.row = reader.getRow();
+        fragment.column = reader.getColumn();
+        reader.readElement(fragment.text);
+        if (fragments) {
+            fragments->push_back(fragment);
+            continue;
+        }
+
+        Document xml_doc = parseXmlFragment(file, fragment);
+        Element* xml = xml_doc.FirstChildElement(false);
+        if (!xml) THROW_EXCEPTION(CastException);
+        parseXmlLeaf(xml, processnetwork, curr_composite);
+    }
+
+    LOG_DEBUG(logger_, string(tools::indent(level_)
+                  + "Parsing \"composite_process\" elements..."));
+    list<XmlFragment>::iterator it;
+    for (it = composite_fragments.begin(); it != composite_fragments.end();
+         ++it) {
+        Document xml_doc = parseXmlFragment(file, *it);
+        Element* xml = xml_doc.FirstChildElement(false);
+        if (!xml) THROW_EXCEPTION(CastException);
+        parseXmlComposite(xml, processnetwork, curr_composite);
+    }
+
+    LOG_DEBUG(logger_, string(tools::indent(level_)
+                  + "Parsing \"port\" elements..."));
+    for (it = port_fragments.begin(); it != port_fragments.end(); ++it) {
+        Document xml_doc = parseXmlFragment(file, *it);
+        Element* xml = xml_doc.FirstChildElement(false);
+        if (!xml) THROW_EXCEPTION(CastException);
+        generateIOPort(xml, curr_composite);
+    }
+
+    LOG_DEBUG(logger_, string(tools::indent(level_)
+                  + "Parsing \"signal\" elements..."));
+    for (it = signal_fragments.begin(); it != signal_fragments.end(); ++it) {
+        Document xml_doc = parseXmlFragment(file, *it);
+        Element* xml = xml_doc.FirstChildElement(false);
+        if (!xml) THROW_EXCEPTION(CastException);
+        generateSignal(xml, curr_composite);
+    }
+
+    return curr_composite;
+}
+
 Document XmlParser::parseXmlFile(const string& file)
     throw(InvalidArgumentException, ParseException, IOException,
           RuntimeException) {
 
     // Read file content
-    string xml_data;
+    tools::FileView xml_data;
     logger_.logMessage(Logger::INFO, string(tools::indent(level_)
                            + "Level " + tools::toString(level_)
                            + ". Reading xml data from file: "
                            + file
                            + "..."));
     try {
-        tools::readFile(file, xml_data);
+        xml_data.open(file);
     } catch (FileNotFoundException& ex) {
         logger_.logMessage(Logger::ERROR, string("No xml input file \"") + file
                            + "\" could be found");
@@ -163,7 +320,7 @@ Document XmlParser::parseXmlFile(const string& file)
         logger_.logMessage(Logger::INFO, string(tools::indent(level_)
                            + file + ": "
                            + "Building xml structure..."));
-        xml_doc.Parse(xml_data);
+        xml_doc.Parse(xml_data.getData());
     } catch (ticpp::Exception& ex) {
         // @todo throw more detailed ParseException (with line and column)
         THROW_EXCEPTION(ParseException, file, ex.what());
@@ -180,6 +337,19 @@ Document XmlParser::parseXmlFile(const string& file)
     return xml_doc;
 }
 
+Document XmlParser::parseXmlFragment(const string& file,
+                                     const XmlFragment& fragment)
+    throw(ParseException) {
+    Document xml_doc;
+    try {
+        xml_doc.ParseFragment(fragment.text, fragment.row, fragment.column);
+    } catch (ticpp::Exception& ex) {
+        THROW_EXCEPTION(ParseException, file, fragment.row + 1,
+                        fragment.column + 1, ex.what());
+    }
+    return xml_doc;
+}
+
 void XmlParser::parseXmlLeafs(Element* xml, ProcessNetwork* processnetwork,
 		Composite* parent)
     throw(InvalidArgumentException, ParseException, IOException,
@@ -197,29 +367,43 @@ void XmlParser::parseXmlLeafs(Element* xml, ProcessNetwork* processnetwork,
     list<Element*> elements = getElementsByName(xml, "leaf_process");
     list<Element*>::iterator it;
     for (it = elements.begin(); it != elements.end(); ++it) {
-        logger_.logMessage(Logger::DEBUG, string(tools::indent(level_)
-                                                 + "Analyzing leaf line "
-                                                 + tools::toString((*it)->Row())
-                                                 + "..."));
-        Leaf* process = generateLeaf(processnetwork, *it, parent);
-        try {
-            if (!parent->addProcess(process)) {
-				THROW_EXCEPTION(ParseException, parent->getName().getString(),
-						        (*it)->Row(),
-								(*it)->Column(),
-								string("Multiple processes with ID \"")
-								+ process->getId()->getString() + "\"");
-			}
-            if (!processnetwork->addProcess(process)) {
-                THROW_EXCEPTION(ParseException, parent->getName().getString(),
-                		        (*it)->Row(),
-                                (*it)->Column(),
-                                string("Multiple processes with ID \"")
-                                + process->getId()->getString() + "\"");
-            }
-        } catch (bad_alloc&) {
-            THROW_EXCEPTION(OutOfMemoryException);
+        parseXmlLeaf(*it, processnetwork, parent);
+    }
+}
+
+void XmlParser::parseXmlLeaf(Element* xml, ProcessNetwork* processnetwork,
+		Composite* parent)
+    throw(InvalidArgumentException, ParseException, IOException,
+          RuntimeException) {
+    if (!xml) {
+        THROW_EXCEPTION(InvalidArgumentException, "\"xml\" must not be NULL");
+    }
+    if (!processnetwork) {
+        THROW_EXCEPTION(InvalidArgumentException, "\"processnetwork\" must not be NULL");
+    }
+
+    LOG_DEBUG(logger_, string(tools::indent(level_)
+                                    + "Analyzing leaf line "
+                                    + tools::toString(xml->Row())
+                                    + "..."));
+    Leaf* process = generateLeaf(processnetwork, xml, parent);
+    try {
+        if (!parent->addProcess(process)) {
+			THROW_EXCEPTION(ParseException, parent->getName().getString(),
+					        xml->Row(),
+							xml->Column(),
+							string("Multiple processes with ID \"")
+							+ process->getId()->getString() + "\"");
+		}
+        if (!processnetwork->addProcess(process)) {
+            THROW_EXCEPTION(ParseException, parent->getName().getString(),
+            		        xml->Row(),
+                            xml->Column(),
+                            string("Multiple processes with ID \"")
+                            + process->getId()->getString() + "\"");
         }
+    } catch (bad_alloc&) {
+        THROW_EXCEPTION(OutOfMemoryException);
     }
 }
 
@@ -240,29 +424,43 @@ void XmlParser::parseXmlComposites(Element* xml, ProcessNetwork* processnetwork,
     list<Element*> elements = getElementsByName(xml, "composite_process");
     list<Element*>::iterator it;
     for (it = elements.begin(); it != elements.end(); ++it) {
-        logger_.logMessage(Logger::DEBUG, string(tools::indent(level_)
-                                                 + "Analyzing composite line "
-                                                 + tools::toString((*it)->Row())
-                                                 + "..."));
-        Composite* process = generateComposite(processnetwork, *it, parent);
-        try {
-            if (!parent->addComposite(process)) {
-				THROW_EXCEPTION(ParseException, parent->getName().getString(),
-						        (*it)->Row(),
-								(*it)->Column(),
-								string("Multiple processes with ID \"")
-								+ process->getId()->getString() + "\"");
-			}
-            if (!processnetwork->addComposite(process)) {
-                THROW_EXCEPTION(ParseException, parent->getName().getString(),
-                		        (*it)->Row(),
-                                (*it)->Column(),
-                                string("Multiple processes with ID \"")
-                                + process->getId()->getString() + "\"");
-            }
-        } catch (bad_alloc&) {
-            THROW_EXCEPTION(OutOfMemoryException);
+        parseXmlComposite(*it, processnetwork, parent);
+    }
+}
+
+void XmlParser::parseXmlComposite(Element* xml, ProcessNetwork* processnetwork,
+		Composite* parent)
+    throw(InvalidArgumentException, ParseException, IOException,
+          RuntimeException) {
+    if (!xml) {
+        THROW_EXCEPTION(InvalidArgumentException, "\"xml\" must not be NULL");
+    }
+    if (!processnetwork) {
+        THROW_EXCEPTION(InvalidArgumentException, "\"processnetwork\" must not be NULL");
+    }
+
+    LOG_DEBUG(logger_, string(tools::indent(level_)
+                                    + "Analyzing composite line "
+                                    + tools::toString(xml->Row())
+                                    + "..."));
+    Composite* process = generateComposite(processnetwork, xml, parent);
+    try {
+        if (!parent->addComposite(process)) {
+			THROW_EXCEPTION(ParseException, parent->getName().getString(),
+					        xml->Row(),
+							xml->Column(),
+							string("Multiple processes with ID \"")
+							+ process->getId()->getString() + "\"");
+		}
+        if (!processnetwork->addComposite(process)) {
+            THROW_EXCEPTION(ParseException, parent->getName().getString(),
+            		        xml->Row(),
+                            xml->Column(),
+                            string("Multiple processes with ID \"")
+                            + process->getId()->getString() + "\"");
         }
+    } catch (bad_alloc&) {
+        THROW_EXCEPTION(OutOfMemoryException);
     }
 }
 
@@ -279,10 +477,10 @@ void XmlParser::parseXmlPorts(Element* xml, Composite* parent)
     list<Element*> elements = getElementsByName(xml, "port");
     list<Element*>::iterator it;
     for (it = elements.begin(); it != elements.end(); ++it) {
-          logger_.logMessage(Logger::DEBUG, string(tools::indent(level_)
-                                                   + "Analyzing line "
-                                                   + tools::toString((*it)->Row())
-                                                   + "..."));
+          LOG_DEBUG(logger_, string(tools::indent(level_)
+                                          + "Analyzing line "
+                                          + tools::toString((*it)->Row())
+                                          + "..."));
 
           generateIOPort(*it, parent);
       }
@@ -301,10 +499,10 @@ void XmlParser::parseXmlSignals(Element* xml, Composite* parent)
     list<Element*> elements = getElementsByName(xml, "signal");
     list<Element*>::iterator it;
     for (it = elements.begin(); it != elements.end(); ++it) {
-          logger_.logMessage(Logger::DEBUG, string(tools::indent(level_)
-                                                   + "Analyzing line "
-                                                   + tools::toString((*it)->Row())
-                                                   + "..."));
+          LOG_DEBUG(logger_, string(tools::indent(level_)
+                                          + "Analyzing line "
+                                          + tools::toString((*it)->Row())
+                                          + "..."));
           generateSignal(*it, parent);
       }
 }
@@ -366,18 +564,18 @@ Leaf* XmlParser::generateLeaf(ProcessNetwork* pn, Element* xml,
     }
     if (!leaf_process) THROW_EXCEPTION(OutOfMemoryException);
 
-    logger_.logMessage(Logger::DEBUG, string(tools::indent(level_))
-                       + "Generated " + leaf_process->type()
-                       + " from \"" + leaf_process->getId()->getString() + "\"");
+    LOG_DEBUG(logger_, string(tools::indent(level_))
+              + "Generated " + leaf_process->type()
+              + " from \"" + leaf_process->getId()->getString() + "\"");
 
     // Get ports
     list<Element*> elements = getElementsByName(xml, "port");
     list<Element*>::iterator it;
     for (it = elements.begin(); it != elements.end(); ++it) {
-        logger_.logMessage(Logger::DEBUG,
+        LOG_DEBUG(logger_,
         		             string(tools::indent(level_)
-                                  + "Analyzing line "
-                                  + tools::toString((*it)->Row()) + "..."));
+                         + "Analyzing line "
+                         + tools::toString((*it)->Row()) + "..."));
 
         generateLeafPort((*it), leaf_process);
     }
@@ -409,19 +607,36 @@ Composite* XmlParser::generateComposite(ProcessNetwork* pn, Element* xml,
     level_++;
     string previous_file = file_;
     file_ = composite_filename;
-    Document xml_doc = (parseXmlFile(composite_filename));
-    Element* xml_root = dynamic_cast<Element*>(findXmlRootNode(&xml_doc, composite_filename));
-    if (!xml_root) THROW_EXCEPTION(CastException);
+    addInputFile(composite_filename);
+    Composite* composite_process;
+    if (do_streaming_) {
+        composite_process = streamComposite(composite_filename, pn,
+                                            composite_id,
+                                            parent->getHierarchy());
+    }
+    else {
+        Document xml_doc;
+        map<string, Document>::iterator cached_doc =
+            composite_documents_.find(composite_filename);
+        if (cached_doc != composite_documents_.end()) {
+            xml_doc = cached_doc->second;
+        }
+        else {
+            xml_doc = parseXmlFile(composite_filename);
+        }
+        Element* xml_root = dynamic_cast<Element*>(findXmlRootNode(&xml_doc, composite_filename));
+        if (!xml_root) THROW_EXCEPTION(CastException);
 
-    Composite* composite_process = buildComposite(xml_root, pn, composite_id,
-    		parent->getHierarchy());
+        composite_process = buildComposite(xml_root, pn, composite_id,
+        		parent->getHierarchy());
+    }
     if (!composite_process) THROW_EXCEPTION(OutOfMemoryException);
     level_--;
     file_ = previous_file;
-    logger_.logMessage(Logger::DEBUG, string(tools::indent(level_))
-                       + "Generated " + composite_process->type()
-                       + " with ID: " + composite_process->getId()->getString()
-                       + " from \"" + composite_process->getName().getString() + "\"");
+    LOG_DEBUG(logger_, string(tools::indent(level_))
+              + "Generated " + composite_process->type()
+              + " with ID: " + composite_process->getId()->getString()
+              + " from \"" + composite_process->getName().getString() + "\"");
 
     return composite_process;
 }
@@ -434,31 +649,37 @@ CFunction* XmlParser::generateLeafFunction(Element* xml, ProcessNetwork* pn,
         THROW_EXCEPTION(InvalidArgumentException, "\"xml\" must not be NULL");
     }
 
-    Element* argument = getUniqueElement(xml, "argument");
-    string file_name = getAttributeByTag(argument,"value");
-    string name = getAttributeByTag(argument,"name");
-    string function_name = file_name;
-    tools::searchReplace(function_name, name, "");
-    file_name += ".hpp";
+    string function_name;
+    string file_name;
+    getFunctionFile(xml, function_name, file_name);
 
     CFunction* existing_function = pn->getFunction(Id(function_name));
 
     if (existing_function) {
-        logger_.logMessage(Logger::DEBUG,
+        LOG_DEBUG(logger_,
         		string(tools::indent(level_)
-                      + "Function \""
-                      + function_name
-                      + "\" already exists. It will not be created... "));
+             + "Function \""
+             + function_name
+             + "\" already exists. It will not be created... "));
         return existing_function;
     }
     else {
-        logger_.logMessage(Logger::DEBUG,
+        LOG_DEBUG(logger_,
         		string(tools::indent(level_)
-                      + "Function \""
-                      + function_name
-                      + "\" is being added to the process network... "));
-        CParser* code_parser = new CParser(logger_, level_);
-        CFunction* new_function = code_parser->parseCFunction(file_name, function_name);
+             + "Function \""
+             + function_name
+             + "\" is being added to the process network... "));
+        addInputFile(file_name);
+        CFunction* new_function = NULL;
+        map<string, size_t>::iterator parsed =
+            function_file_indices_.find(function_name);
+        if (parsed != function_file_indices_.end()) {
+            new_function = function_files_[parsed->second].function;
+            function_files_[parsed->second].function = NULL;
+        }
+        if (!new_function) {
+            new_function = parseFunctionFile(file_name, function_name, level_);
+        }
         try {
             if (!pn->addFunction(new_function)) {
 				THROW_EXCEPTION(ParseException, parent->getName().getString(),
@@ -470,7 +691,6 @@ CFunction* XmlParser::generateLeafFunction(Element* xml, ProcessNetwork* pn,
         } catch (bad_alloc&) {
             THROW_EXCEPTION(OutOfMemoryException);
         }
-        delete code_parser;
         return new_function;
     }
 
@@ -479,6 +699,212 @@ CFunction* XmlParser::generateLeafFunction(Element* xml, ProcessNetwork* pn,
                     "No process function argument found");
 }
 
+void XmlParser::getFunctionFile(Element* xml, string& function_name,
+                                string& file_name)
+    throw(InvalidArgumentException, ParseException) {
+    if (!xml) {
+        THROW_EXCEPTION(InvalidArgumentException, "\"xml\" must not be NULL");
+    }
+
+    Element* argument = getUniqueElement(xml, "argument");
+    file_name = getAttributeByTag(argument,"value");
+    string name = getAttributeByTag(argument,"name");
+    function_name = file_name;
+    tools::searchReplace(function_name, name, "");
+    file_name += ".hpp";
+}
+
+void XmlParser::collectFunctionFiles(Element* xml)
+    throw(IOException, RuntimeException) {
+    list<Element*> elements = getElementsByName(xml, "leaf_process");
+    list<Element*>::iterator it;
+    for (it = elements.begin(); it != elements.end(); ++it) {
+        collectFunctionFile(*it);
+    }
+
+    elements = getElementsByName(xml, "composite_process");
+    for (it = elements.begin(); it != elements.end(); ++it) {
+        string composite_filename;
+        try {
+            composite_filename = getAttributeByTag(*it, "component_name")
+                + ".xml";
+        }
+        catch (ParseException&) {
+            continue;
+        }
+        if (composite_documents_.find(composite_filename)
+            != composite_documents_.end()) {
+            continue;
+        }
+        if (!tools::existsFile(composite_filename)) continue;
+
+        level_++;
+        Element* xml_root = NULL;
+        try {
+            Document xml_doc = parseXmlFile(composite_filename);
+            xml_root = dynamic_cast<Element*>(
+                findXmlRootNode(&xml_doc, composite_filename));
+            if (xml_root) {
+                composite_documents_.insert(
+                    std::make_pair(composite_filename, xml_doc));
+            }
+        }
+        catch (ParseException&) {
+            xml_root = NULL;
+        }
+        if (xml_root) collectFunctionFiles(xml_root);
+        level_--;
+    }
+}
+
+void XmlParser::collectFunctionFiles(const string& file,
+                                     set<string>& visited_files)
+    throw(IOException, RuntimeException) {
+    if (!visited_files.insert(file).second) return;
+
+    // Malformed files are skipped here and reported when the model is built
+    try {
+        XmlStreamReader reader(file);
+        XmlStreamReader::TagType type;
+        while ((type = reader.next()) != XmlStreamReader::END_OF_FILE) {
+            if (type == XmlStreamReader::END_TAG || reader.getDepth() != 1) {
+                continue;
+            }
+            bool is_leaf = reader.getName() == "leaf_process";
+            if (!is_leaf && reader.getName() != "composite_process") continue;
+
+            XmlFragment fragment;
+            fragment.row = reader.getRow();
+            fragment.column = reader.getColumn();
+            reader.readElement(fragment.text);
+            Document xml_doc = parseXmlFragment(file, fragment);
+            Element* xml = xml_doc.FirstChildElement(false);
+            if (!xml) continue;
+            if (is_leaf) {
+                collectFunctionFile(xml);
+                continue;
+            }
+
+            string composite_filename = getAttributeByTag(xml, "component_name")
+                + ".xml";
+            if (!tools::existsFile(composite_filename)) continue;
+            level_++;
+            collectFunctionFiles(composite_filename, visited_files);
+            level_--;
+        }
+    }
+    catch (FileNotFoundException&) {}
+    catch (ParseException&) {}
+}
+
+void XmlParser::collectFunctionFile(Element* leaf)
+    throw(IOException, RuntimeException) {
+    FunctionFile function_file;
+    try {
+        Element* constructor_element =
+            getUniqueElement(leaf, "process_constructor");
+        string process_type = getAttributeByTag(constructor_element, "name");
+        tools::toLowerCase(tools::trim(process_type));
+        string process_moc = getAttributeByTag(constructor_element, "moc");
+        tools::toLowerCase(tools::trim(process_moc));
+        if ((string::npos == process_type.find("comb"))
+            || (process_moc != "sy")) {
+            return;
+        }
+        getFunctionFile(constructor_element, function_file.function_name,
+                        function_file.file_name);
+    }
+    catch (InvalidArgumentException&) {
+        return;
+    }
+    catch (ParseException&) {
+        return;
+    }
+    if (function_file_indices_.find(function_file.function_name)
+        != function_file_indices_.end()) {
+        return;
+    }
+    function_file.level = level_;
+    function_file.function = NULL;
+    function_file_indices_.insert(
+        std::make_pair(function_file.function_name, function_files_.size()));
+    function_files_.push_back(function_file);
+}
+
+void XmlParser::parseFunctionFiles() throw(IOException) {
+    logger_.logMessage(Logger::INFO, string("Parsing ")
+                       + tools::toString(function_files_.size())
+                       + " function files on "
+                       + tools::toString(num_parser_threads_)
+                       + " threads...");
+    next_function_file_ = 0;
+    vector<pthread_t> threads;
+    for (size_t i = 1; i < num_parser_threads_ && i < function_files_.size();
+         ++i) {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, &XmlParser::runFunctionParserThread,
+                           this) != 0) {
+            break;
+        }
+        threads.push_back(thread);
+    }
+    runFunctionParser();
+    for (vector<pthread_t>::iterator it = threads.begin(); it != threads.end();
+         ++it) {
+        pthread_join(*it, NULL);
+    }
+}
+
+CFunction* XmlParser::parseFunctionFile(const string& file, const string& name,
+                                        int level)
+    throw(InvalidArgumentException, IOException, ParseException,
+          RuntimeException) {
+    CFunction* function = function_cache_.load(file, name);
+    if (function) {
+        LOG_DEBUG(logger_, string(tools::indent(level))
+                  + "Function \"" + name + "\" loaded from the cache");
+        return function;
+    }
+
+    CParser code_parser(logger_, level);
+    function = code_parser.parseCFunction(file, name);
+    function_cache_.store(file, *function);
+    return function;
+}
+
+void XmlParser::runFunctionParser() throw() {
+    while (true) {
+        size_t index = __sync_fetch_and_add(&next_function_file_, 1);
+        if (index >= function_files_.size()) return;
+
+        FunctionFile& function_file = function_files_[index];
+        try {
+            function_file.function = parseFunctionFile(
+                function_file.file_name, function_file.function_name,
+                function_file.level);
+        }
+        catch (...) {
+            // Parsed again when the model is built, which reports the error
+            function_file.function = NULL;
+        }
+    }
+}
+
+void* XmlParser::runFunctionParserThread(void* parser) throw() {
+    static_cast<XmlParser*>(parser)->runFunctionParser();
+    return NULL;
+}
+
+void XmlParser::clearFunctionFiles() throw() {
+    for (vector<FunctionFile>::iterator it = function_files_.begin();
+         it != function_files_.end(); ++it) {
+        delete it->function;
+    }
+    function_files_.clear();
+    function_file_indices_.clear();
+    composite_documents_.clear();
+}
+
 void XmlParser::generateLeafPort(Element* xml, Leaf* parent)
     throw(InvalidArgumentException, ParseException, IOException,
           RuntimeException) {
@@ -507,12 +933,12 @@ void XmlParser::generateLeafPort(Element* xml, Leaf* parent)
                         + " with the same ID \""
                         + port_name + "\"");
     }
-    logger_.logMessage(Logger::DEBUG, string()
-                       + tools::indent(level_)
-                       + ((port_direction == "in") ? "In" : "Out")
-                       + " port \"" + port_name
-                       + "\" added to leaf process \""
-                       + parent->getId()->getString() + "\"");
+    LOG_DEBUG(logger_, string()
+              + tools::indent(level_)
+              + ((port_direction == "in") ? "In" : "Out")
+              + " port \"" + port_name
+              + "\" added to leaf process \""
+              + parent->getId()->getString() + "\"");
 
     SY::Comb* comb = dynamic_cast<SY::Comb*>(parent);
     if (comb){
@@ -559,7 +985,7 @@ void XmlParser::generateIOPort(Element* xml, Composite* parent)
 						+ " with the same ID \""
 						+ port_name + "\"");
 	}
-	logger_.logMessage(Logger::DEBUG, string()
+	LOG_DEBUG(logger_, string()
 					   + tools::indent(level_)
 					   + ((port_direction == "in") ? "In" : "Out")
 					   + " port \"" + port_name
@@ -753,7 +1179,7 @@ throw(InvalidArgumentException, ParseException, IOException,
 	//set the array size in variable declaration
 	if (port_type.hasArraySize() && (!param_type->hasArraySize())){
 		param_type->setArraySize(port_type.getArraySize());
-		logger_.logMessage(Logger::DEBUG, string()
+		LOG_DEBUG(logger_, string()
 							   + tools::indent(level_)
 							   + "Added array size to input parameter \""
 							   + assoc_param->getReferenceString()
@@ -764,7 +1190,7 @@ throw(InvalidArgumentException, ParseException, IOException,
 	//associate port with variable
 	assoc_port->setVariable(assoc_param);
 
-	logger_.logMessage(Logger::DEBUG, string()
+	LOG_DEBUG(logger_, string()
 					   + tools::indent(level_)
 					   + "Associated port \"" + assoc_port->getId()->getString()
 					   + "\" with variable \"" + assoc_param->getReferenceString()
@@ -784,7 +1210,7 @@ void XmlParser::generateConnection(Process::Interface* source_port,
         THROW_EXCEPTION(InvalidArgumentException, "\"target_port\" must not be NULL");
     }
 
-	logger_.logMessage(Logger::DEBUG, string()
+	LOG_DEBUG(logger_, string()
 					   + tools::indent(level_)
 					   + "Generating connection between \""
 					   + source_port->toString()
@@ -797,7 +1223,7 @@ void XmlParser::generateConnection(Process::Interface* source_port,
 	if(source){
 		if(!source->isConnected()){
 			source->connect(target_port);
-			logger_.logMessage(Logger::DEBUG, string()
+			LOG_DEBUG(logger_, string()
 							   + tools::indent(level_)
 							   + "Generated connection for \""
 							   + source->toString()
@@ -806,7 +1232,7 @@ void XmlParser::generateConnection(Process::Interface* source_port,
 		else {
 			SY::Fanout* fanout = dynamic_cast<SY::Fanout*>(source->getProcess());
 			if (fanout){
-				logger_.logMessage(Logger::DEBUG, string()
+				LOG_DEBUG(logger_, string()
 								   + tools::indent(level_)
 								   + "Parent process for \""
 								   + source->toString()
@@ -815,7 +1241,7 @@ void XmlParser::generateConnection(Process::Interface* source_port,
 						+ "_"));
 				fanout->addOutPort(new_id, source->getDataType());
 				fanout->getOutPort(new_id)->connect(target_port);
-				logger_.logMessage(Logger::DEBUG, string()
+				LOG_DEBUG(logger_, string()
 								   + tools::indent(level_)
 								   + "Added new port \""
 								   + new_id.getString()
@@ -843,7 +1269,7 @@ void XmlParser::generateConnection(Process::Interface* source_port,
 					+ "Multiple connections are not treated for IO ports.");
 
 			source_io->connect(target_port);
-			logger_.logMessage(Logger::DEBUG, string()
+			LOG_DEBUG(logger_, string()
 							   + tools::indent(level_)
 							   + "Generated connection for \""
 							   + source_io->toString()
@@ -991,10 +1417,10 @@ string XmlParser::getInitialDelayValue(Element* xml, Composite* parent)
     list<Element*> elements = getElementsByName(xml, "argument");
     list<Element*>::iterator it;
     for (it = elements.begin(); it != elements.end(); ++it) {
-        logger_.logMessage(Logger::DEBUG,
+        LOG_DEBUG(logger_,
         		string(tools::indent(level_)
-                      + "Analyzing line "
-                      + tools::toString((*it)->Row()) + "..."));
+             + "Analyzing line "
+             + tools::toString((*it)->Row()) + "..."));
         string value = getAttributeByTag(*it,"value");
         return value;
     }
@@ -1008,7 +1434,7 @@ string XmlParser::getInitialDelayValue(Element* xml, Composite* parent)
 ////////////////////////////////////////////////////////////////////
 
 XmlParser::CParser::CParser(Logger& logger, int indent) throw() :
-		level_(indent), file_(NULL), cdata_(NULL), logger_(logger){}
+		level_(indent), num_scanned_lines_(0), has_body_(false), logger_(logger){}
 
 XmlParser::CParser::~CParser() throw() {}
 
@@ -1028,24 +1454,25 @@ CFunction* XmlParser::CParser::parseCFunction(const string& file, const string&
     }
 
     file_ = file;
-    tools::readFile(file,cdata_);
-    if (cdata_.length() == 0) {
+    cdata_.open(file);
+    if (cdata_.getSize() == 0) {
         THROW_EXCEPTION(IOException, file_, "file contains no data ");
     }
+    scanFunction(name);
 
     CFunction* function = new CFunction(name, file);
 
-	logger_.logMessage(Logger::DEBUG,
+	LOG_DEBUG(logger_,
 	        		string(tools::indent(level_)
 	                      + "Parsing the function declaration..."));
     parseDeclaration(function);
 
-	logger_.logMessage(Logger::DEBUG,
+	LOG_DEBUG(logger_,
 	        		string(tools::indent(level_)
 	                      + "Extracting the function body..."));
     extractBody(function);
 
-	logger_.logMessage(Logger::DEBUG,
+	LOG_DEBUG(logger_,
 	        		string(tools::indent(level_)
 	                      + "Renaming wrapped variables..."));
 	renameWrappedVariables(function);
@@ -1053,6 +1480,90 @@ CFunction* XmlParser::CParser::parseCFunction(const string& file, const string&
     return function;
 }
 
+void XmlParser::CParser::scanFunction(const string& name) throw() {
+    declaration_lines_.clear();
+    assignment_lines_.clear();
+    num_scanned_lines_ = 0;
+    has_body_ = false;
+
+    enum { BEFORE_DECLARATION, IN_DECLARATION, BEFORE_BODY, IN_BODY, AFTER_BODY }
+        state = BEFORE_DECLARATION;
+    const string begin_pragma("#pragma ForSyDe begin");
+    const string end_pragma("#pragma ForSyDe end");
+    const char* data = cdata_.getData();
+    const size_t size = cdata_.getSize();
+    size_t line_start = 0;
+    while (line_start < size) {
+        const char* newline = static_cast<const char*>(
+            std::memchr(data + line_start, '\n', size - line_start));
+        size_t line_end = newline ? newline - data : size;
+        LineRange line(line_start, line_end);
+        line_start = line_end + 1;
+
+        switch (state) {
+            case BEFORE_DECLARATION: {
+                ++num_scanned_lines_;
+                if (lineContains(line, name) && lineContains(line, "void")) {
+                    declaration_lines_.push_back(line);
+                    state = lineContains(line, "{") ? BEFORE_BODY : IN_DECLARATION;
+                }
+                break;
+            }
+
+            case IN_DECLARATION: {
+                declaration_lines_.push_back(line);
+                if (lineContains(line, "{")) state = BEFORE_BODY;
+                break;
+            }
+
+            case BEFORE_BODY: {
+                if (lineContains(line, begin_pragma)) {
+                    has_body_ = true;
+                    state = IN_BODY;
+                }
+                else if (lineContains(line, "=")) {
+                    assignment_lines_.push_back(line);
+                }
+                break;
+            }
+
+            case IN_BODY: {
+                if (lineContains(line, end_pragma)) state = AFTER_BODY;
+                break;
+            }
+
+            case AFTER_BODY: {
+                if (lineContains(line, "=")) {
+                    assignment_lines_.push_back(line);
+                }
+                break;
+            }
+        }
+    }
+}
+
+bool XmlParser::CParser::lineContains(const LineRange& line, const string& str)
+    const throw() {
+    const char* line_begin = cdata_.getData() + line.first;
+    const char* line_end = cdata_.getData() + line.second;
+    return std::search(line_begin, line_end, str.begin(), str.end()) != line_end;
+}
+
+string XmlParser::CParser::concatenateLines(const vector<LineRange>& lines) const
+    throw() {
+    size_t length = 0;
+    vector<LineRange>::const_iterator it;
+    for (it = lines.begin(); it != lines.end(); ++it) {
+        length += it->second - it->first;
+    }
+    string text;
+    text.reserve(length);
+    for (it = lines.begin(); it != lines.end(); ++it) {
+        text.append(cdata_.getData() + it->first, it->second - it->first);
+    }
+    return text;
+}
+
 void XmlParser::CParser::parseDeclaration(CFunction* function)
     throw(InvalidArgumentException, ParseException) {
     if (!function) {
@@ -1060,37 +1571,14 @@ void XmlParser::CParser::parseDeclaration(CFunction* function)
                         "string");
     }
 
-    std::string declaration = "";
     string name = function->getName();
-
-    //getting the declaration stream
-    stringstream tempcode(cdata_);
-    std::string line;
-    unsigned current_line = 0;
-    bool is_declaration = false;
-    while (std::getline(tempcode, line)) {
-    	if((string::npos != line.find(name)) &&
-    			(string::npos != line.find("void"))){
-    		is_declaration = true;
-    		declaration += line;
-    	}
-    	else if((is_declaration) && (string::npos != line.find("{"))){
-			declaration += line;
-			cdata_.erase(cdata_.find(line), line.size());
-			break;
-		}
-    	else if (is_declaration){
-    		declaration += line;
-    	}
-    	cdata_.erase(cdata_.find(line), line.size() + 1);
-    	current_line++;
-    }
-    if (!is_declaration){
+    if (declaration_lines_.empty()){
 		THROW_EXCEPTION(ParseException, file_,
-				        current_line,
+				        num_scanned_lines_,
 						string("Function \"")
 						+ name + "\" does not have a declaration.");
 	}
+    std::string declaration = concatenateLines(declaration_lines_);
     tools::searchReplace(declaration, "\t", "");
     tools::searchReplace(declaration, "void", "");
     tools::searchReplace(declaration, name, "");
@@ -1139,25 +1627,7 @@ void XmlParser::CParser::extractBody(CFunction* function)
         THROW_EXCEPTION(InvalidArgumentException, "\"function\" must not be empty "
                         "string");
     }
-    std::string body = "";
-
-    //getting the declaration stream
-    stringstream tempcode(cdata_);
-    std::string line;
-    bool is_body = false;
-    while (std::getline(tempcode, line)) {
-    	if(string::npos != line.find("#pragma ForSyDe begin")){
-    		is_body = true;
-    	}
-    	else if((is_body) && (string::npos != line.find("#pragma ForSyDe end"))){
-			break;
-		}
-    	else if (is_body){
-    		body += line;
-    		cdata_.erase(cdata_.find(line), line.size() + 1);
-    	}
-    }
-    if (!is_body){
+    if (!has_body_){
 		THROW_EXCEPTION(IOException,
 						string("The function in file \"")
 						+ file_ + "\" has no body.");
@@ -1170,40 +1640,38 @@ void XmlParser::CParser::renameWrappedVariables(CFunction* function)
 		THROW_EXCEPTION(InvalidArgumentException, "\"function\" must not be empty "
 						"string");
 	}
-    stringstream tempcode(cdata_);
-    std::string line;
-
     list<CVariable*> var_list =function->getInputParameters();
     var_list.push_back(function->getOutputParameter());
 
     list<pair<string, string> > name_dict;
 
-    while (std::getline(tempcode, line)) {
-    	if(string::npos != line.find("=")){
-
-			unsigned equal_pos = line.find_first_of("=");
-
-			//get lhs;
-			string lhs = line.substr(0, equal_pos);
+    vector<LineRange>::const_iterator line_it;
+    for (line_it = assignment_lines_.begin(); line_it != assignment_lines_.end();
+         ++line_it) {
+        string line(cdata_.getData() + line_it->first,
+                    line_it->second - line_it->first);
+		unsigned equal_pos = line.find_first_of("=");
+
+		//get lhs;
+		string lhs = line.substr(0, equal_pos);
+		tools::trim(lhs);
+		if(string::npos != lhs.find(" ")){
+			unsigned decl_end_pos = lhs.find_last_of(" ");
+			lhs = lhs.substr(decl_end_pos, lhs.size() - decl_end_pos);
 			tools::trim(lhs);
-			if(string::npos != lhs.find(" ")){
-				unsigned decl_end_pos = lhs.find_last_of(" ");
-				lhs = lhs.substr(decl_end_pos, lhs.size() - decl_end_pos);
-				tools::trim(lhs);
-			}
-			//get rhs
-			string rhs = line.substr(equal_pos, line.size() - equal_pos);
-			unsigned first_par_pos = rhs.find_last_of("(");
-			rhs = rhs.substr(first_par_pos + 1, rhs.size() - first_par_pos - 1);
-			rhs = rhs.substr(0, rhs.find_first_of("),"));
+		}
+		//get rhs
+		string rhs = line.substr(equal_pos, line.size() - equal_pos);
+		unsigned first_par_pos = rhs.find_last_of("(");
+		rhs = rhs.substr(first_par_pos + 1, rhs.size() - first_par_pos - 1);
+		rhs = rhs.substr(0, rhs.find_first_of("),"));
 
-			if ((lhs.length() == 0) || (rhs.length() == 0)){
-				THROW_EXCEPTION(ParseException, file_,
-								string("Could not find rhs or lhs in:\n")
-								+ line);
-			}
-			name_dict.push_back(std::make_pair(lhs,rhs));
-    	}
+		if ((lhs.length() == 0) || (rhs.length() == 0)){
+			THROW_EXCEPTION(ParseException, file_,
+							string("Could not find rhs or lhs in:\n")
+							+ line);
+		}
+		name_dict.push_back(std::make_pair(lhs,rhs));
     }
 
     list<CVariable*>::iterator var_it;
@@ -1213,7 +1681,7 @@ void XmlParser::CParser::renameWrappedVariables(CFunction* function)
     	for (dict_it = name_dict.begin(); dict_it != name_dict.end(); ++dict_it){
     		if (var_name == (*dict_it).first) {
     			(*var_it)->changeReferenceString((*dict_it).second);
-    			logger_.logMessage(Logger::DEBUG,
+    			LOG_DEBUG(logger_,
     			        		string(tools::indent(level_)
     			                      + "Renamed variable \""
     			                      + var_name
@@ -1228,7 +1696,7 @@ void XmlParser::CParser::renameWrappedVariables(CFunction* function)
     		}
     		if (var_name == (*dict_it).second) {
 				(*var_it)->changeReferenceString((*dict_it).first);
-				logger_.logMessage(Logger::DEBUG,
+				LOG_DEBUG(logger_,
 								string(tools::indent(level_)
 									  + "Renamed variable \""
 									  + var_name
@@ -1287,7 +1755,7 @@ void XmlParser::CParser::createFunctionParameter(CFunction* function, string ana
 		if (is_output) is_added = function->setOutputParameter(*c_variable);
 		else is_added = function->addInputParameter(*c_variable);
 		if (is_added) {
-			logger_.logMessage(Logger::DEBUG,
+			LOG_DEBUG(logger_,
 			        		string(tools::indent(level_)
 			                      + "Added variable \""
 			                      + c_variable->getDataType()->toString()
@@ -47,6 +47,8 @@
 #include "../language/cvariable.h"
 #include "../language/cdatatype.h"
 #include "../ticpp/ticpp.h"
+#include "../tools/fileview.h"
+#include "functioncache.h"
 #include "../exceptions/filenotfoundexception.h"
 #include "../exceptions/parseexception.h"
 #include "../exceptions/invalidmodelexception.h"
@@ -55,6 +57,9 @@
 #include <string>
 #include <map>
 #include <list>
+#include <set>
+#include <vector>
+#include <utility>
 
 namespace f2cc {
 
@@ -76,8 +81,21 @@ class XmlParser : public Frontend {
      *
      * @param logger
      *        Reference to the logger.
+     * @param num_parser_threads
+     *        Number of threads which parse the C function files referenced by
+     *        the model. With more than one thread, all function files are
+     *        collected and parsed before the process network is built.
+     * @param do_streaming
+     *        Whether the XML files are read element by element instead of
+     *        being loaded completely. See
+     *        streamComposite(const std::string&, Forsyde::ProcessNetwork*, const Forsyde::Id, Forsyde::Hierarchy).
+     * @param cache_directory
+     *        Directory in which parsed C functions are cached, or an empty
+     *        path to disable the cache. See \c FunctionCache.
      */
-    XmlParser(Logger& logger) throw();
+    XmlParser(Logger& logger, size_t num_parser_threads = 1,
+              bool do_streaming = false,
+              const std::string& cache_directory = std::string("")) throw();
 
     /**
      * Destroys this parser. The logger remains open.
@@ -151,6 +169,83 @@ class XmlParser : public Frontend {
         throw(InvalidArgumentException, ParseException, IOException,
               RuntimeException);
 
+    /**
+     * Converts the \c process_network element of an \c XML file into an
+     * internal \c Forsyde::Composite process, like
+     * buildComposite(ticpp::Element*, Forsyde::ProcessNetwork*, const Forsyde::Id, Forsyde::Hierarchy),
+     * but without loading the whole file. The file is read with an
+     * \c XmlStreamReader, and each child element of the root is parsed on its
+     * own. \c leaf_process elements are converted as soon as they have been
+     * read, while the remaining elements are kept as text until the end of
+     * the file and then converted in the same order as in buildComposite().
+     * Hence only one child element is held as a DOM at a time.
+     *
+     * @param file
+     *        \c XML file.
+     * @param processnetwork
+     *        \c The \c Forsyde::ProcessNetwork that will contain this Composite.
+     * @param id
+     *        \c The \c Forsyde::Composite process ID.
+     * @param hierarchy
+     *        \c The \c Forsyde::Composite process hierarchy path.
+     *
+     * @returns The Composite process in the internal ForSyDe ProcessNetwork.
+     *
+     * @throws FileNotFoundException
+     *         When the file cannot be found.
+     * @throws ParseException
+     *         When the file is malformed, or when some necessary element or
+     *         attribute is missing.
+     * @throws InvalidModelException
+     *         When the processnetwork is invalid (but was successfully parsed).
+     * @throws IOException
+     *         When the file cannot be read or the log file cannot be written.
+     * @throws RuntimeException
+     *         When something unexpected occurs. This is most likely due to a
+     *         bug.
+     */
+    Forsyde::Composite* streamComposite(const std::string& file,
+    		Forsyde::ProcessNetwork* processnetwork, const Forsyde::Id id,
+    		Forsyde::Hierarchy hierarchy)
+        throw(FileNotFoundException, ParseException, InvalidModelException,
+              IOException, RuntimeException);
+
+    /**
+     * @brief An element of an \c XML file read as text.
+     */
+    struct XmlFragment {
+        /**
+         * Text of the element.
+         */
+        std::string text;
+
+        /**
+         * 0-based row at which the element starts.
+         */
+        int row;
+
+        /**
+         * 0-based column at which the element starts.
+         */
+        int column;
+    };
+
+    /**
+     * Parses an element of an \c XML file which has been read as text.
+     *
+     * @param file
+     *        \c XML file containing the element.
+     * @param fragment
+     *        The element.
+     * @returns Document whose root is the element.
+     *
+     * @throws ParseException
+     *         When the element is malformed.
+     */
+    ticpp::Document parseXmlFragment(const std::string& file,
+                                     const XmlFragment& fragment)
+        throw(ParseException);
+
 
     /**
      * Parses the \c leaf XML elements in a \c process_network XML element and passes them
@@ -182,6 +277,32 @@ class XmlParser : public Frontend {
         throw(InvalidArgumentException, ParseException, IOException,
               RuntimeException);
 
+    /**
+     * Converts a \c leaf_process XML element into a leaf and adds it to its
+     * parent and to the \c Forsyde::ProcessNetwork.
+     *
+     * @param xml
+     *        \c leaf_process XML element.
+     * @param processnetwork
+     *        \c Forsyde::ProcessNetwork object to add the leaf to.
+     * @param parent
+     *        The parent \c Forsyde::Composite process object in the \c Forsyde::ProcessNetwork.
+     *
+     * @throws InvalidArgumentException
+     *         When \c xml or \c processnetwork is \c NULL.
+     * @throws ParseException
+     *         When some necessary element or attribute is missing.
+     * @throws IOException
+     *         When access to the log file fails.
+     * @throws RuntimeException
+     *         When something unexpected occurs. This is most likely due to a
+     *         bug.
+     */
+    void parseXmlLeaf(ticpp::Element* xml, Forsyde::ProcessNetwork* processnetwork,
+    		Forsyde::Composite* parent)
+        throw(InvalidArgumentException, ParseException, IOException,
+              RuntimeException);
+
     /**
      * Parses the \c composite_process XML elements in a \c process_network XML
      * element and converts
@@ -212,6 +333,31 @@ class XmlParser : public Frontend {
         throw(InvalidArgumentException, ParseException, IOException,
               RuntimeException);
 
+    /**
+     * Converts a \c composite_process XML element into a composite process and
+     * adds it to its parent and to the \c Forsyde::ProcessNetwork.
+     *
+     * @param xml
+     *        \c composite_process XML element.
+     * @param processnetwork
+     *        \c Forsyde::ProcessNetwork object to add the composite to.
+     * @param parent
+     *        \c Forsyde::Composite object that acts as a parent for this one.
+     * @throws InvalidArgumentException
+     *         When \c xml or \c processnetwork is \c NULL.
+     * @throws ParseException
+     *         When some necessary element or attribute is missing.
+     * @throws IOException
+     *         When access to the log file fails.
+     * @throws RuntimeException
+     *         When something unexpected occurs. This is most likely due to a
+     *         bug.
+     */
+    void parseXmlComposite(ticpp::Element* xml, Forsyde::ProcessNetwork* processnetwork,
+    		Forsyde::Composite* parent)
+        throw(InvalidArgumentException, ParseException, IOException,
+              RuntimeException);
+
     /**
      * Parses the \c port XML elements in a \c process_network XML element and passes them
      * to generateIOPort(ticpp::Element*,Forsyde::Composite*) which converts
@@ -348,6 +494,145 @@ class XmlParser : public Frontend {
         throw(InvalidArgumentException, ParseException, IOException,
               RuntimeException);
 
+    /**
+     * Gets the name of the function of a \c comb process constructor, and the
+     * name of the \c ".hpp" file containing it.
+     *
+     * @param xml
+     *        \c process_constructor XML element.
+     * @param function_name
+     *        String to store the function name in.
+     * @param file_name
+     *        String to store the file name in.
+     *
+     * @throws InvalidArgumentException
+     *         When \c xml is \c NULL.
+     * @throws ParseException
+     *         When the function argument is missing.
+     */
+    void getFunctionFile(ticpp::Element* xml, std::string& function_name,
+                         std::string& file_name)
+        throw(InvalidArgumentException, ParseException);
+
+    /**
+     * Walks the XML model, including the XML files of its composite processes,
+     * and collects every C function file referenced by a \c comb leaf. Each
+     * function is collected only once, in the order in which the model is
+     * later built. Parsed composite XML files are kept for reuse by
+     * generateComposite(Forsyde::ProcessNetwork*, ticpp::Element*, Forsyde::Composite*).
+     *
+     * Elements which cannot be interpreted are skipped, such that the
+     * corresponding errors are reported when the model is built.
+     *
+     * @param xml
+     *        Root element of a composite process.
+     *
+     * @throws IOException
+     *         When the log file cannot be written.
+     * @throws RuntimeException
+     *         When something unexpected occurs. This is most likely due to a
+     *         bug.
+     */
+    void collectFunctionFiles(ticpp::Element* xml)
+        throw(IOException, RuntimeException);
+
+    /**
+     * Collects the C function files referenced by the model in an \c XML file
+     * like collectFunctionFiles(ticpp::Element*), but reads the file with an
+     * \c XmlStreamReader.
+     *
+     * @param file
+     *        \c XML file.
+     * @param visited_files
+     *        \c XML files which have already been visited.
+     *
+     * @throws IOException
+     *         When the log file cannot be written.
+     * @throws RuntimeException
+     *         When something unexpected occurs. This is most likely due to a
+     *         bug.
+     */
+    void collectFunctionFiles(const std::string& file,
+                              std::set<std::string>& visited_files)
+        throw(IOException, RuntimeException);
+
+    /**
+     * Collects the C function file referenced by a \c leaf_process element,
+     * if it is a \c comb leaf whose function has not been collected yet.
+     * Elements which cannot be interpreted are skipped.
+     *
+     * @param xml
+     *        \c leaf_process XML element.
+     *
+     * @throws IOException
+     *         When the log file cannot be written.
+     * @throws RuntimeException
+     *         When something unexpected occurs. This is most likely due to a
+     *         bug.
+     */
+    void collectFunctionFile(ticpp::Element* xml)
+        throw(IOException, RuntimeException);
+
+    /**
+     * Parses all collected function files on a pool of threads. The calling
+     * thread takes part in the parsing, and carries on alone if no further
+     * thread can be started. A file which fails to parse is left for
+     * generateLeafFunction(ticpp::Element*, Forsyde::ProcessNetwork*, Forsyde::Composite*),
+     * which reports the error.
+     *
+     * @throws IOException
+     *         When the log file cannot be written.
+     */
+    void parseFunctionFiles() throw(IOException);
+
+    /**
+     * Parses a C function from a function file, or loads it from the function
+     * cache if the file is unchanged since it was last parsed. The caller is
+     * responsible for deleting the returned function.
+     *
+     * @param file
+     *        Function file.
+     * @param name
+     *        Function name.
+     * @param level
+     *        Logger indentation level.
+     * @returns The function.
+     * @throws InvalidArgumentException
+     *         When \c file is an empty string.
+     * @throws IOException
+     *         When the file cannot be read or the log file cannot be written.
+     * @throws ParseException
+     *         When the file fails to be parsed.
+     * @throws RuntimeException
+     *         When something unexpected occurs. This is most likely due to a
+     *         bug.
+     */
+    CFunction* parseFunctionFile(const std::string& file,
+                                 const std::string& name, int level)
+        throw(InvalidArgumentException, IOException, ParseException,
+              RuntimeException);
+
+    /**
+     * Parses function files until none is left. Run by each parser thread.
+     */
+    void runFunctionParser() throw();
+
+    /**
+     * Entry point of the parser threads.
+     *
+     * @param parser
+     *        The \c XmlParser object.
+     * @returns \c NULL.
+     */
+    static void* runFunctionParserThread(void* parser) throw();
+
+    /**
+     * Destroys the parsed functions which have not been added to a process
+     * network, and forgets all collected function files and cached composite
+     * XML files.
+     */
+    void clearFunctionFiles() throw();
+
     /**
      * Generates a \c Forsyde::Leaf::Port object from a \c port XML element, and adds it
      * to the desired leaf process.
@@ -666,6 +951,67 @@ class XmlParser : public Frontend {
      */
     std::string file_;
 
+    /**
+     * Number of threads which parse C function files.
+     */
+    size_t num_parser_threads_;
+
+    /**
+     * Whether the XML files are read element by element.
+     */
+    bool do_streaming_;
+
+    /**
+     * Cache of parsed C functions.
+     */
+    FunctionCache function_cache_;
+
+    /**
+     * @brief A C function file to be parsed ahead of building the model.
+     */
+    struct FunctionFile {
+        /**
+         * Name of the function.
+         */
+        std::string function_name;
+
+        /**
+         * Name of the \c ".hpp" file.
+         */
+        std::string file_name;
+
+        /**
+         * Level of the XML file which references the function.
+         */
+        int level;
+
+        /**
+         * Parsed function, or \c NULL if it has not been parsed or has
+         * already been added to the process network.
+         */
+        CFunction* function;
+    };
+
+    /**
+     * Function files collected by the last pre-pass, in model order.
+     */
+    std::vector<FunctionFile> function_files_;
+
+    /**
+     * Indices into \c function_files_ by function name.
+     */
+    std::map<std::string, size_t> function_file_indices_;
+
+    /**
+     * Index of the next function file to be parsed by a parser thread.
+     */
+    size_t next_function_file_;
+
+    /**
+     * Composite XML files read during the pre-pass, by file name.
+     */
+    std::map<std::string, ticpp::Document> composite_documents_;
+
   private:
 
     /**
@@ -716,6 +1062,48 @@ class XmlParser : public Frontend {
 
       private:
 
+        /**
+         * A line in the file's text, given as the offsets of its first character
+         * and of the character following its last one (excluding the newline).
+         */
+        typedef std::pair<size_t, size_t> LineRange;
+
+       /**
+    	* Splits the file's text into lines in a single sweep and classifies them
+    	* as belonging to the function declaration or to the wrapper code outside
+    	* the ForSyDe pragmas which contains assignments, and records whether a
+    	* function body between the pragmas exists. Only the line offsets are
+    	* stored; the text itself is left untouched so that each line is visited
+    	* exactly once.
+    	*
+    	* @param name
+    	*        the name of the function.
+    	*/
+        void scanFunction(const std::string& name) throw();
+
+        /**
+         * Checks whether a line of the file's text contains a string.
+         *
+         * @param line
+         *        Line to search.
+         * @param str
+         *        String to search for.
+         * @returns \c true if \c str occurs within \c line.
+         */
+        bool lineContains(const LineRange& line, const std::string& str) const
+            throw();
+
+        /**
+         * Concatenates a list of lines of the file's text, omitting the
+         * newlines.
+         *
+         * @param lines
+         *        Lines to concatenate.
+         * @returns The concatenated text.
+         */
+        std::string concatenateLines(const std::vector<LineRange>& lines) const
+            throw();
+
        /**
     	* Parses the function declaration. It identifies the declaration section; identifies
     	* individual variables as input or output parameters; identifies and converts complex
@@ -847,9 +1235,31 @@ class XmlParser : public Frontend {
         std::string file_;
 
         /**
-         * Local storage of the file's text.
+         * View of the file's text, into which the scanned lines point.
+         */
+        tools::FileView cdata_;
+
+        /**
+         * Number of lines visited by the last scan.
+         */
+        unsigned num_scanned_lines_;
+
+        /**
+         * Lines making up the function declaration, up to and including the
+         * line with the opening brace.
+         */
+        std::vector<LineRange> declaration_lines_;
+
+        /**
+         * Lines after the declaration but outside the function body which
+         * contain an assignment.
+         */
+        std::vector<LineRange> assignment_lines_;
+
+        /**
+         * Whether the last scan found a \c "#pragma ForSyDe begin" annotation.
          */
-        std::string cdata_;
+        bool has_body_;
 
         /**
          * Logger.
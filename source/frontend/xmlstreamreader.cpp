@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2011-2013
+ *     Gabriel Hjort Blindell <ghb@kth.se>
+ *     George Ungureanu <ugeorge@kth.se>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OF THIS SOFTWARE NOR THE
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "xmlstreamreader.h"
+#include <cstring>
+
+using namespace f2cc;
+using std::string;
+
+XmlStreamReader::XmlStreamReader(const string& file)
+        throw(FileNotFoundException)
+        : file_path_(file), file_(NULL), is_eof_(false), position_(0), row_(0),
+          column_(0), type_(END_OF_FILE), depth_(0), tag_row_(0),
+          tag_column_(0), element_text_(NULL) {
+    file_ = std::fopen(file.c_str(), "rb");
+    if (!file_) {
+        THROW_EXCEPTION(FileNotFoundException, file);
+    }
+}
+
+XmlStreamReader::~XmlStreamReader() throw() {
+    if (file_) std::fclose(file_);
+}
+
+XmlStreamReader::TagType XmlStreamReader::next()
+    throw(ParseException, IOException) {
+    while (true) {
+        size_t tag_start = find("<");
+        if (tag_start == string::npos) {
+            consume(buffer_.length());
+            if (!open_elements_.empty()) {
+                THROW_EXCEPTION(ParseException, file_path_, row_ + 1,
+                                column_ + 1, string("Unexpected end of file "
+                                                    "inside element \"")
+                                + open_elements_.back() + "\"");
+            }
+            name_.clear();
+            depth_ = 0;
+            type_ = END_OF_FILE;
+            return type_;
+        }
+        consume(tag_start);
+        tag_row_ = row_;
+        tag_column_ = column_;
+
+        // Skip everything which is not an element
+        fill(9);
+        if (buffer_.compare(position_, 4, "<!--") == 0) {
+            skipPast("-->");
+            continue;
+        }
+        if (buffer_.compare(position_, 9, "<![CDATA[") == 0) {
+            skipPast("]]>");
+            continue;
+        }
+        if (buffer_.compare(position_, 2, "<?") == 0) {
+            skipPast("?>");
+            continue;
+        }
+        if (buffer_.compare(position_, 2, "<!") == 0) {
+            skipPast(">");
+            continue;
+        }
+
+        size_t tag_end = findTagEnd();
+        if (tag_end == string::npos) {
+            THROW_EXCEPTION(ParseException, file_path_, tag_row_ + 1,
+                            tag_column_ + 1, "Unterminated tag");
+        }
+        tag_.assign(buffer_, position_, tag_end + 1 - position_);
+        consume(tag_end + 1);
+
+        bool is_end_tag = tag_[1] == '/';
+        size_t name_start = is_end_tag ? 2 : 1;
+        size_t name_end = tag_.find_first_of(" \t\r\n/>", name_start);
+        name_.assign(tag_, name_start, name_end - name_start);
+        if (name_.empty()) {
+            THROW_EXCEPTION(ParseException, file_path_, tag_row_ + 1,
+                            tag_column_ + 1, "Tag without name");
+        }
+
+        if (is_end_tag) {
+            if (open_elements_.empty() || open_elements_.back() != name_) {
+                THROW_EXCEPTION(ParseException, file_path_, tag_row_ + 1,
+                                tag_column_ + 1, string("Unexpected end "
+                                                        "tag \"")
+                                + name_ + "\"");
+            }
+            open_elements_.pop_back();
+            depth_ = open_elements_.size();
+            type_ = END_TAG;
+        }
+        else if (tag_[tag_.length() - 2] == '/') {
+            depth_ = open_elements_.size();
+            type_ = EMPTY_TAG;
+        }
+        else {
+            depth_ = open_elements_.size();
+            open_elements_.push_back(name_);
+            type_ = START_TAG;
+        }
+        return type_;
+    }
+}
+
+const string& XmlStreamReader::getName() const throw() {
+    return name_;
+}
+
+size_t XmlStreamReader::getDepth() const throw() {
+    return depth_;
+}
+
+int XmlStreamReader::getRow() const throw() {
+    return tag_row_;
+}
+
+int XmlStreamReader::getColumn() const throw() {
+    return tag_column_;
+}
+
+string XmlStreamReader::getEmptyElementText() const throw() {
+    if (type_ != START_TAG) return tag_;
+    string text(tag_, 0, tag_.length() - 1);
+    text += "/>";
+    return text;
+}
+
+void XmlStreamReader::readElement(string& text)
+    throw(ParseException, IOException) {
+    if (type_ != START_TAG && type_ != EMPTY_TAG) {
+        THROW_EXCEPTION(ParseException, file_path_, tag_row_ + 1,
+                        tag_column_ + 1, "No element to read");
+    }
+    text = tag_;
+    if (type_ == EMPTY_TAG) return;
+
+    size_t depth = depth_;
+    element_text_ = &text;
+    try {
+        while (next() != END_TAG || depth_ != depth) {}
+    }
+    catch (...) {
+        element_text_ = NULL;
+        throw;
+    }
+    element_text_ = NULL;
+}
+
+bool XmlStreamReader::fill(size_t num_bytes) throw(IOException) {
+    while (buffer_.length() - position_ < num_bytes) {
+        if (is_eof_) return false;
+
+        // Drop the consumed part before reading the next block
+        buffer_.erase(0, position_);
+        position_ = 0;
+        size_t old_length = buffer_.length();
+        buffer_.resize(old_length + kBlockSize);
+        size_t num_read = std::fread(&buffer_[old_length], 1, kBlockSize,
+                                     file_);
+        buffer_.resize(old_length + num_read);
+        if (num_read < kBlockSize) {
+            if (std::ferror(file_)) THROW_EXCEPTION(IOException, file_path_);
+            is_eof_ = true;
+        }
+    }
+    return true;
+}
+
+size_t XmlStreamReader::find(const char* str) throw(IOException) {
+    size_t length = std::strlen(str);
+    size_t num_searched = 0;
+    while (true) {
+        size_t found = buffer_.find(str, position_ + num_searched);
+        if (found != string::npos) return found;
+
+        // The string may straddle the end of the buffer
+        size_t num_available = buffer_.length() - position_;
+        num_searched = num_available >= length ? num_available - length + 1
+                                               : 0;
+        if (!fill(num_available + 1)) return string::npos;
+    }
+}
+
+size_t XmlStreamReader::findTagEnd() throw(IOException) {
+    char quote = 0;
+    size_t offset = 1;
+    while (true) {
+        if (!fill(offset + 1)) return string::npos;
+        size_t end = buffer_.length();
+        for (size_t i = position_ + offset; i < end; ++i) {
+            char c = buffer_[i];
+            if (quote) {
+                if (c == quote) quote = 0;
+            }
+            else if (c == '"' || c == '\'') {
+                quote = c;
+            }
+            else if (c == '>') {
+                return i;
+            }
+        }
+        offset = end - position_;
+    }
+}
+
+void XmlStreamReader::consume(size_t end) throw() {
+    for (size_t i = position_; i < end; ++i) {
+        unsigned char c = buffer_[i];
+        if (c == '\n') {
+            ++row_;
+            column_ = 0;
+        }
+        else if (c == '\t') {
+            column_ = (column_ / 4 + 1) * 4;
+        }
+        else if (c != '\r' && (c & 0xC0) != 0x80) {
+            // UTF-8 continuation bytes belong to the preceding character
+            ++column_;
+        }
+    }
+    if (element_text_) element_text_->append(buffer_, position_,
+                                             end - position_);
+    position_ = end;
+}
+
+void XmlStreamReader::skipPast(const char* str)
+    throw(ParseException, IOException) {
+    size_t found = find(str);
+    if (found == string::npos) {
+        THROW_EXCEPTION(ParseException, file_path_, tag_row_ + 1,
+                        tag_column_ + 1, string("Missing \"") + str + "\"");
+    }
+    consume(found + std::strlen(str));
+}
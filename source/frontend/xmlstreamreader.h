@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) 2011-2013
+ *     Gabriel Hjort Blindell <ghb@kth.se>
+ *     George Ungureanu <ugeorge@kth.se>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OF THIS SOFTWARE NOR THE
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef F2CC_SOURCE_FRONTEND_XMLSTREAMREADER_H_
+#define F2CC_SOURCE_FRONTEND_XMLSTREAMREADER_H_
+
+/**
+ * @file
+ * @version 0.1
+ *
+ * @brief Defines a reader which walks the tags of an XML file without loading
+ *        the whole file.
+ */
+
+#include "../exceptions/filenotfoundexception.h"
+#include "../exceptions/ioexception.h"
+#include "../exceptions/parseexception.h"
+#include <string>
+#include <vector>
+#include <cstdio>
+
+namespace f2cc {
+
+/**
+ * @brief A pull reader for the tags of an XML file.
+ *
+ * The \c XmlStreamReader reads an XML file in fixed-size blocks and returns
+ * its start and end tags one at a time, skipping text, comments, processing
+ * instructions and declarations. Only the block currently being read and the
+ * names of the open elements are kept in memory.
+ *
+ * The reader does not interpret attributes. Instead, an element can be
+ * extracted as text together with its position in the file, and then be parsed
+ * on its own with \c ticpp::Document::ParseFragment(). That way each element
+ * is checked by the TinyXML tokenizer and reports rows and columns relative to
+ * the whole file, while only one element is held as a DOM at a time.
+ */
+class XmlStreamReader {
+  public:
+    /**
+     * Kinds of tags returned by the reader.
+     */
+    enum TagType {
+        /**
+         * A start tag, such as <code>\<port\></code>.
+         */
+        START_TAG,
+
+        /**
+         * An empty-element tag, such as <code>\<port/\></code>.
+         */
+        EMPTY_TAG,
+
+        /**
+         * An end tag, such as <code>\</port\></code>.
+         */
+        END_TAG,
+
+        /**
+         * The end of the file has been reached.
+         */
+        END_OF_FILE
+    };
+
+    /**
+     * Opens an XML file for reading.
+     *
+     * @param file
+     *        XML file.
+     * @throws FileNotFoundException
+     *         When the file cannot be opened.
+     */
+    XmlStreamReader(const std::string& file) throw(FileNotFoundException);
+
+    /**
+     * Closes the file.
+     */
+    ~XmlStreamReader() throw();
+
+    /**
+     * Advances to the next start, empty-element or end tag.
+     *
+     * @returns Type of the tag.
+     * @throws ParseException
+     *         When a tag is not terminated, when an end tag does not match the
+     *         open element, or when the file ends inside an element.
+     * @throws IOException
+     *         When reading the file fails.
+     */
+    TagType next() throw(ParseException, IOException);
+
+    /**
+     * Gets the name of the current tag.
+     *
+     * @returns Tag name.
+     */
+    const std::string& getName() const throw();
+
+    /**
+     * Gets the number of elements which enclose the current tag. Tags of the
+     * root element are at depth 0.
+     *
+     * @returns Element depth.
+     */
+    size_t getDepth() const throw();
+
+    /**
+     * Gets the 0-based row at which the current tag starts.
+     *
+     * @returns Row.
+     */
+    int getRow() const throw();
+
+    /**
+     * Gets the 0-based column at which the current tag starts. Tabs advance
+     * the column to the next multiple of 4, as in TinyXML.
+     *
+     * @returns Column.
+     */
+    int getColumn() const throw();
+
+    /**
+     * Gets the current start tag written as an empty-element tag, such that
+     * its attributes can be parsed without its content.
+     *
+     * @returns Tag text.
+     */
+    std::string getEmptyElementText() const throw();
+
+    /**
+     * Reads the element starting at the current start or empty-element tag,
+     * including all of its content, and advances past its end tag.
+     *
+     * @param text
+     *        String to store the element text in.
+     * @throws ParseException
+     *         When the element is malformed.
+     * @throws IOException
+     *         When reading the file fails.
+     */
+    void readElement(std::string& text) throw(ParseException, IOException);
+
+  private:
+    /**
+     * Makes at least a number of bytes available from the current position,
+     * reading more of the file if needed.
+     *
+     * @param num_bytes
+     *        Number of bytes.
+     * @returns \c true if the bytes are available.
+     * @throws IOException
+     *         When reading the file fails.
+     */
+    bool fill(size_t num_bytes) throw(IOException);
+
+    /**
+     * Finds a string at or after the current position, reading more of the
+     * file if needed.
+     *
+     * @param str
+     *        String to find.
+     * @returns Offset of \c str in the buffer, or \c std::string::npos if the
+     *          file ends first.
+     * @throws IOException
+     *         When reading the file fails.
+     */
+    size_t find(const char* str) throw(IOException);
+
+    /**
+     * Finds the \c '>' which ends the tag at the current position, skipping
+     * quoted attribute values.
+     *
+     * @returns Offset of the \c '>' in the buffer, or \c std::string::npos if
+     *          the file ends first.
+     * @throws IOException
+     *         When reading the file fails.
+     */
+    size_t findTagEnd() throw(IOException);
+
+    /**
+     * Consumes bytes up to an offset in the buffer, updating the row and
+     * column and appending the bytes to the element being read, if any.
+     *
+     * @param end
+     *        Offset after the last byte to consume.
+     */
+    void consume(size_t end) throw();
+
+    /**
+     * Consumes everything up to and including a string.
+     *
+     * @param str
+     *        String to skip past.
+     * @throws ParseException
+     *         When the file ends before \c str.
+     * @throws IOException
+     *         When reading the file fails.
+     */
+    void skipPast(const char* str) throw(ParseException, IOException);
+
+  private:
+    /**
+     * Size of the blocks in which the file is read.
+     */
+    static const size_t kBlockSize = 1 << 16;
+
+    /**
+     * Path of the file.
+     */
+    const std::string file_path_;
+
+    /**
+     * File being read.
+     */
+    std::FILE* file_;
+
+    /**
+     * Whether the end of the file has been read into the buffer.
+     */
+    bool is_eof_;
+
+    /**
+     * Unconsumed part of the file read so far, starting at offset
+     * \c position_.
+     */
+    std::string buffer_;
+
+    /**
+     * Offset of the first unconsumed byte in \c buffer_.
+     */
+    size_t position_;
+
+    /**
+     * 0-based row of the first unconsumed byte.
+     */
+    int row_;
+
+    /**
+     * 0-based column of the first unconsumed byte.
+     */
+    int column_;
+
+    /**
+     * Text of the current tag.
+     */
+    std::string tag_;
+
+    /**
+     * Name of the current tag.
+     */
+    std::string name_;
+
+    /**
+     * Type of the current tag.
+     */
+    TagType type_;
+
+    /**
+     * Depth of the current tag.
+     */
+    size_t depth_;
+
+    /**
+     * Row at which the current tag starts.
+     */
+    int tag_row_;
+
+    /**
+     * Column at which the current tag starts.
+     */
+    int tag_column_;
+
+    /**
+     * Names of the open elements.
+     */
+    std::vector<std::string> open_elements_;
+
+    /**
+     * Element text being read by readElement(std::string&), or \c NULL.
+     */
+    std::string* element_text_;
+};
+
+}
+
+#endif
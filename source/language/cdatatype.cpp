@@ -92,6 +92,25 @@ void CDataType::setArraySize(size_t size)
     has_array_size_ = true;
     array_size_ = size;
 }
+
+size_t CDataType::getMaxElementSize() const throw() {
+    if (is_pointer_) return 8;
+    switch (type_) {
+        case CHAR: return 1;
+        case UNSIGNED_CHAR: return 1;
+        case SHORT_INT: return 2;
+        case UNSIGNED_SHORT_INT: return 2;
+        case INT: return 4;
+        case UNSIGNED_INT: return 4;
+        case LONG_INT: return 8;
+        case UNSIGNED_LONG_INT: return 8;
+        case FLOAT: return 4;
+        case DOUBLE: return 8;
+        case LONG_DOUBLE: return 16;
+        case VOID: return 1;
+        default: return 1; // Should never happen
+    }
+}
             
 bool CDataType::isPointer() const throw() {
     return is_pointer_;
@@ -209,6 +209,17 @@ class CDataType {
      *         When \c size is less than 1.
      */
     void setArraySize(size_t size) throw(InvalidArgumentException);
+
+    /**
+     * Gets the largest size, in bytes, which a single element of this data
+     * type has on the common 32-bit and 64-bit data models (ILP32, LP64 and
+     * LLP64). Unlike \c sizeof in this tool, the result does not depend on
+     * the platform it is built for, and is therefore safe to use when laying
+     * out memory for code that is compiled for another platform.
+     *
+     * @returns Maximum element size in bytes.
+     */
+    size_t getMaxElementSize() const throw();
             
     /**
      * Checks whether this data type is a pointer.
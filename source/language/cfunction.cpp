@@ -36,17 +36,19 @@ using std::list;
 using std::vector;
 using std::bad_alloc;
 
-CFunction::CFunction() throw() : name_(""), body_("") {}
+CFunction::CFunction() throw()
+        : name_(""), output_parameter_(NULL), body_("") {}
 
 CFunction::CFunction(const string& name, const string& file
-		) throw() : name_(name), file_(file),  body_("") {}
+		) throw() : name_(name), file_(file), output_parameter_(NULL),
+		body_("") {}
 
 CFunction::CFunction(const string& name, CDataType return_type,
                      const list<CVariable> input_parameters,
                      const string& body, const string& prefix)
         throw(InvalidFormatException, OutOfMemoryException)
-        : name_(name), return_data_type_(return_type), body_(body),
-          declaration_prefix_(prefix) {
+        : name_(name), return_data_type_(return_type),
+          output_parameter_(NULL), body_(body), declaration_prefix_(prefix) {
     tools::trim(name_);
     if (name_.length() == 0) {
         THROW_EXCEPTION(InvalidArgumentException, "\"name\" must not be empty "
@@ -64,7 +66,8 @@ CFunction::CFunction(const string& name, CDataType return_type,
     }
 }
 
-CFunction::CFunction(const CFunction& rhs) throw(OutOfMemoryException) {
+CFunction::CFunction(const CFunction& rhs) throw(OutOfMemoryException)
+        : output_parameter_(NULL) {
     copy(rhs);
 }
 
@@ -38,6 +38,7 @@
 
 #include "cvariable.h"
 #include "cdatatype.h"
+#include "../tools/arena.h"
 #include "../exceptions/invalidargumentexception.h"
 #include "../exceptions/invalidformatexception.h"
 #include "../exceptions/outofmemoryexception.h"
@@ -52,7 +53,7 @@ namespace f2cc {
  * the function into distinct parts - return data type, function name,
  * input parameters, and body.
  */
-class CFunction {
+class CFunction : public tools::ArenaObject {
   public:
     /**
      * Creates an unnamed function, with no return type, input parameters nor
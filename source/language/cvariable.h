@@ -37,6 +37,7 @@
  */
 
 #include "cdatatype.h"
+#include "../tools/arena.h"
 #include "../exceptions/invalidargumentexception.h"
 #include "../exceptions/unknownarraysizeexception.h"
 
@@ -51,7 +52,7 @@ namespace f2cc {
  * depending on whether they are defined as a stand-alone variable or as an
  * input parameter to a function.
  */
-class CVariable {
+class CVariable : public tools::ArenaObject {
   public:
     /**
      * Creates an empty variable.
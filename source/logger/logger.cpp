@@ -37,10 +37,30 @@ using std::ofstream;
 
 const size_t Logger::kLogEntryLineWidthLimit = 100;
 
-Logger::Logger() throw() : file_path_(""), is_open_(false), level_(INFO) {}
+const size_t Logger::kMaxNumQueuedMessages = 4096;
+
+Logger::Logger() throw()
+        : file_path_(""), is_open_(false), level_(INFO), last_time_(0),
+          flush_policy_(FLUSH_EVERY_MESSAGE), do_console_echo_(true),
+          is_async_(false), is_writer_running_(false),
+          do_stop_writer_(false), has_write_error_(false),
+          num_queued_messages_(0), num_written_messages_(0) {
+    pthread_mutex_init(&mutex_, NULL);
+    pthread_cond_init(&queue_not_empty_, NULL);
+    pthread_cond_init(&queue_not_full_, NULL);
+    pthread_cond_init(&batch_written_, NULL);
+}
 
 Logger::Logger(const string& file) throw(InvalidArgumentException, IOException) 
-        : level_(INFO) {
+        : is_open_(false), level_(INFO), last_time_(0),
+          flush_policy_(FLUSH_EVERY_MESSAGE),
+          do_console_echo_(true), is_async_(false), is_writer_running_(false),
+          do_stop_writer_(false), has_write_error_(false),
+          num_queued_messages_(0), num_written_messages_(0) {
+    pthread_mutex_init(&mutex_, NULL);
+    pthread_cond_init(&queue_not_empty_, NULL);
+    pthread_cond_init(&queue_not_full_, NULL);
+    pthread_cond_init(&batch_written_, NULL);
     if (file.length() == 0) {
         THROW_EXCEPTION(InvalidArgumentException, "\"file\" must not be empty "
                         "string");
@@ -53,6 +73,10 @@ Logger::Logger(const string& file) throw(InvalidArgumentException, IOException)
 
 Logger::~Logger() throw() {
     close();
+    pthread_cond_destroy(&batch_written_);
+    pthread_cond_destroy(&queue_not_full_);
+    pthread_cond_destroy(&queue_not_empty_);
+    pthread_mutex_destroy(&mutex_);
 }
 
 void Logger::setLogLevel(const LogLevel level) throw() {
@@ -71,12 +95,17 @@ void Logger::open(const std::string& file) throw(f2cc::IOException) {
         THROW_EXCEPTION(IOException, file, "Failed to open log file");
     }
     is_open_ = true;
+    if (is_async_) startWriter();
 }
 
 Logger::LogLevel Logger::getLogLevel() const throw() {
     return level_;
 }
 
+bool Logger::isEnabled(LogLevel level) const throw() {
+    return !is_open_ || level >= level_;
+}
+
 void Logger::logMessage(LogLevel level, const string& message)
     throw(IOException, IllegalCallException) {
     if (!is_open_) {
@@ -88,32 +117,33 @@ void Logger::logMessage(LogLevel level, const string& message)
         return;
     }
 
-    // Generate log entry
-    string entry;
-    entry += f2cc::tools::getCurrentTimestamp();
-    entry += " [";
-    entry += logLevelToString(level);
-    entry += "] - ";
-    int indent_length = entry.length();
-    string formatted_message(message);
-    f2cc::tools::trim(formatted_message);
-    entry += formatted_message;
-    formatLogEntry(entry, indent_length);
-    entry += '\n';
+    PendingMessage pending;
+    pending.level = level;
+    pending.time = time(NULL);
+    pending.message = message;
+    pending.is_flush_request = false;
+    bool is_error = level >= ERROR;
+
+    if (is_writer_running_) {
+        // Errors are waited for so that they are on file should the program
+        // terminate right after
+        queueMessage(pending, is_error);
+        return;
+    }
+
+    string file_output;
+    string console_output;
+    pthread_mutex_lock(&mutex_);
     try {
-        file_ << entry << std::flush;
+        formatMessage(pending, file_output, console_output);
+        writeOutput(file_output, console_output,
+                    is_error || flush_policy_ == FLUSH_EVERY_MESSAGE);
     }
-    catch (ofstream::failure&) {
-        THROW_EXCEPTION(IOException, file_path_);
+    catch (...) {
+        pthread_mutex_unlock(&mutex_);
+        throw;
     }
-
-    // Generate console output
-    string prompt_output(" * ");
-    prompt_output += logLevelToString(level) + ": ";
-    indent_length = prompt_output.length();
-    prompt_output += message;
-    formatLogEntry(prompt_output, indent_length);
-    cout << prompt_output << std::endl;
+    pthread_mutex_unlock(&mutex_);
 }
 
 void Logger::logDebugMessage(const string& message)
@@ -189,11 +219,230 @@ Logger::LogLevel Logger::stringToLogLevel(string str)
 
 void Logger::close() throw() {
     if (is_open_) {
+        stopWriter();
         file_.close();
         is_open_ = false;
     }
 }
 
+void Logger::setFlushPolicy(FlushPolicy policy) throw() {
+    flush_policy_ = policy;
+}
+
+Logger::FlushPolicy Logger::getFlushPolicy() const throw() {
+    return flush_policy_;
+}
+
+void Logger::setConsoleEcho(bool setting) throw() {
+    do_console_echo_ = setting;
+}
+
+bool Logger::getConsoleEcho() const throw() {
+    return do_console_echo_;
+}
+
+void Logger::setAsynchronous(bool setting) throw(IOException) {
+    is_async_ = setting;
+    if (!is_open_) return;
+    if (setting) {
+        startWriter();
+    }
+    else {
+        stopWriter();
+        if (has_write_error_) {
+            has_write_error_ = false;
+            THROW_EXCEPTION(IOException, file_path_);
+        }
+    }
+}
+
+bool Logger::isAsynchronous() const throw() {
+    return is_async_;
+}
+
+void Logger::flush() throw(IOException, IllegalCallException) {
+    if (!is_open_) {
+        THROW_EXCEPTION(IllegalCallException, "Logger is closed");
+    }
+
+    if (is_writer_running_) {
+        PendingMessage request;
+        request.level = CRITICAL;
+        request.time = 0;
+        request.is_flush_request = true;
+        queueMessage(request, true);
+    }
+    else {
+        pthread_mutex_lock(&mutex_);
+        try {
+            writeOutput("", "", true);
+        }
+        catch (...) {
+            pthread_mutex_unlock(&mutex_);
+            throw;
+        }
+        pthread_mutex_unlock(&mutex_);
+    }
+}
+
+void Logger::formatMessage(const PendingMessage& message, string& file_output,
+                           string& console_output) throw() {
+    if (message.time != last_time_ || last_timestamp_.empty()) {
+        last_time_ = message.time;
+        last_timestamp_ = f2cc::tools::getTimestamp(message.time);
+    }
+
+    // Generate log entry
+    string entry(last_timestamp_);
+    entry += " [";
+    entry += logLevelToString(message.level);
+    entry += "] - ";
+    int indent_length = entry.length();
+    string formatted_message(message.message);
+    f2cc::tools::trim(formatted_message);
+    entry += formatted_message;
+    formatLogEntry(entry, indent_length);
+    file_output += entry;
+    file_output += '\n';
+
+    // Generate console output
+    if (do_console_echo_) {
+        string prompt_output(" * ");
+        prompt_output += logLevelToString(message.level) + ": ";
+        indent_length = prompt_output.length();
+        prompt_output += message.message;
+        formatLogEntry(prompt_output, indent_length);
+        console_output += prompt_output;
+        console_output += '\n';
+    }
+}
+
+void Logger::writeOutput(const string& file_output,
+                         const string& console_output, bool do_flush)
+    throw(IOException) {
+    try {
+        file_ << file_output;
+        if (do_flush) file_.flush();
+    }
+    catch (ofstream::failure&) {
+        THROW_EXCEPTION(IOException, file_path_);
+    }
+    if (file_.fail()) THROW_EXCEPTION(IOException, file_path_);
+
+    if (console_output.length() > 0) {
+        cout << console_output << std::flush;
+    }
+}
+
+void Logger::queueMessage(const PendingMessage& message, bool do_wait)
+    throw(IOException) {
+    pthread_mutex_lock(&mutex_);
+    while (queue_.size() >= kMaxNumQueuedMessages && !has_write_error_) {
+        pthread_cond_wait(&queue_not_full_, &mutex_);
+    }
+    if (has_write_error_) {
+        pthread_mutex_unlock(&mutex_);
+        THROW_EXCEPTION(IOException, file_path_);
+    }
+    // The writer only waits when the queue is empty
+    if (queue_.empty()) pthread_cond_signal(&queue_not_empty_);
+    queue_.push_back(message);
+    unsigned long ticket = ++num_queued_messages_;
+    if (do_wait) {
+        while (num_written_messages_ < ticket && !has_write_error_) {
+            pthread_cond_wait(&batch_written_, &mutex_);
+        }
+    }
+    bool has_failed = do_wait && has_write_error_;
+    pthread_mutex_unlock(&mutex_);
+    if (has_failed) THROW_EXCEPTION(IOException, file_path_);
+}
+
+void Logger::startWriter() throw(IOException) {
+    if (is_writer_running_) return;
+
+    do_stop_writer_ = false;
+    has_write_error_ = false;
+    num_queued_messages_ = 0;
+    num_written_messages_ = 0;
+    if (pthread_create(&writer_, NULL, &Logger::runWriterThread, this) != 0) {
+        THROW_EXCEPTION(IOException, file_path_,
+                        "Failed to start log writer thread");
+    }
+    is_writer_running_ = true;
+}
+
+void Logger::stopWriter() throw() {
+    if (!is_writer_running_) return;
+
+    pthread_mutex_lock(&mutex_);
+    do_stop_writer_ = true;
+    pthread_cond_signal(&queue_not_empty_);
+    pthread_mutex_unlock(&mutex_);
+    pthread_join(writer_, NULL);
+    is_writer_running_ = false;
+}
+
+void Logger::runWriter() throw() {
+    std::deque<PendingMessage> batch;
+    string file_output;
+    string console_output;
+
+    pthread_mutex_lock(&mutex_);
+    while (true) {
+        while (queue_.empty() && !do_stop_writer_) {
+            pthread_cond_wait(&queue_not_empty_, &mutex_);
+        }
+        if (queue_.empty()) break;
+
+        batch.swap(queue_);
+        pthread_cond_broadcast(&queue_not_full_);
+        pthread_mutex_unlock(&mutex_);
+
+        // Format and write the whole batch at once, outside the lock
+        bool do_flush = flush_policy_ == FLUSH_EVERY_MESSAGE;
+        file_output.clear();
+        console_output.clear();
+        std::deque<PendingMessage>::const_iterator it;
+        for (it = batch.begin(); it != batch.end(); ++it) {
+            if (it->level >= ERROR) do_flush = true;
+            if (!it->is_flush_request) {
+                formatMessage(*it, file_output, console_output);
+            }
+        }
+        bool has_failed = false;
+        if (!has_write_error_) {
+            try {
+                writeOutput(file_output, console_output, do_flush);
+            }
+            catch (IOException&) {
+                has_failed = true;
+            }
+        }
+
+        pthread_mutex_lock(&mutex_);
+        if (has_failed) has_write_error_ = true;
+        num_written_messages_ += batch.size();
+        batch.clear();
+        pthread_cond_broadcast(&batch_written_);
+        pthread_cond_broadcast(&queue_not_full_);
+    }
+    pthread_mutex_unlock(&mutex_);
+
+    // Make sure everything is on file before the thread exits
+    try {
+        if (!has_write_error_) writeOutput("", "", true);
+    }
+    catch (IOException&) {
+        has_write_error_ = true;
+    }
+}
+
+void* Logger::runWriterThread(void* logger) throw() {
+    static_cast<Logger*>(logger)->runWriter();
+    return NULL;
+}
+
 void Logger::formatLogEntry(string& entry, int indent_length) const throw() {
     // Align the log message over linebreaks
     string new_linebreak(indent_length, ' ');
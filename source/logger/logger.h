@@ -41,6 +41,9 @@
 #include "../exceptions/invalidargumentexception.h"
 #include <fstream>
 #include <string>
+#include <deque>
+#include <ctime>
+#include <pthread.h>
 
 namespace f2cc {
 
@@ -51,7 +54,11 @@ namespace f2cc {
  * either written to the log file or ignored, depending on the currently set log
  * level. The default log level is set to Logger::INFO.
  *
- * Every log message is also printed to std::cout.
+ * By default every log message is also printed to std::cout, and the log file
+ * is flushed after every message. Both can be changed. The logger can also be
+ * made asynchronous, in which case messages are handed over to a background
+ * writer thread through a bounded queue and written in batches. Messages may
+ * be logged from several threads at once.
  */
 class Logger {
   public:
@@ -86,6 +93,28 @@ class Logger {
         CRITICAL
     };
 
+    /**
+     * The flush policy determines when the log file is flushed.
+     */
+    enum FlushPolicy {
+        /**
+         * Flush after every message (or, in asynchronous mode, after every
+         * batch of messages).
+         */
+        FLUSH_EVERY_MESSAGE,
+        /**
+         * Flush only after \c ERROR and \c CRITICAL messages, on flush() and
+         * when the logger is closed.
+         */
+        FLUSH_ON_ERROR
+    };
+
+    /**
+     * Maximum number of messages which may be queued in asynchronous mode.
+     * When the queue is full, logging blocks until the writer has caught up.
+     */
+    static const size_t kMaxNumQueuedMessages;
+
     /**
      * Determines the maximum length of each line in the log entry. This is
      * set to 80 characters.
@@ -160,6 +189,84 @@ class Logger {
      */
     LogLevel getLogLevel() const throw();
 
+    /**
+     * Checks whether a message of a given log level would be written by
+     * logMessage(LogLevel, const std::string&). This allows the caller to
+     * skip building the message altogether when it would be ignored. A closed
+     * logger is always considered enabled so that logMessage() still gets the
+     * chance to report the misuse.
+     *
+     * @param level
+     *        Message's log level.
+     * @returns \b true if such messages are written.
+     * @see LOG_MESSAGE
+     */
+    bool isEnabled(LogLevel level) const throw();
+
+    /**
+     * Sets when the log file is flushed. The default policy is
+     * Logger::FLUSH_EVERY_MESSAGE.
+     *
+     * @param policy
+     *        Flush policy.
+     */
+    void setFlushPolicy(FlushPolicy policy) throw();
+
+    /**
+     * Gets the current flush policy.
+     *
+     * @returns Flush policy.
+     */
+    FlushPolicy getFlushPolicy() const throw();
+
+    /**
+     * Sets whether log messages are also printed to std::cout. Default
+     * setting is \b true.
+     *
+     * @param setting
+     *        New setting.
+     */
+    void setConsoleEcho(bool setting) throw();
+
+    /**
+     * Gets whether log messages are also printed to std::cout.
+     *
+     * @returns \b true if messages are echoed.
+     */
+    bool getConsoleEcho() const throw();
+
+    /**
+     * Sets whether log messages are written by a background thread. When
+     * enabled, logMessage() only queues the message, except for \c ERROR and
+     * \c CRITICAL messages which are waited for until written and flushed.
+     * Disabling asynchronous mode writes all queued messages before
+     * returning. Default setting is \b false.
+     *
+     * @param setting
+     *        New setting.
+     * @throws IOException
+     *         When the writer thread cannot be started, or when an I/O error
+     *         occurred while writing queued messages.
+     */
+    void setAsynchronous(bool setting) throw(f2cc::IOException);
+
+    /**
+     * Gets whether log messages are written by a background thread.
+     *
+     * @returns \b true if asynchronous.
+     */
+    bool isAsynchronous() const throw();
+
+    /**
+     * Writes all pending log messages and flushes the log file.
+     *
+     * @throws IOException
+     *         When an I/O error occurs.
+     * @throws IllegalCallException
+     *         When this method is invoked on a closed logger.
+     */
+    void flush() throw(f2cc::IOException, f2cc::IllegalCallException);
+
     /**
      * Logs a message with the current time stamp of the system. Whether the
      * message is written to the log file depends on its log level and the
@@ -317,6 +424,105 @@ class Logger {
      */
     void formatLogEntry(std::string& entry, int indent_length) const throw();
 
+    /**
+     * @brief A log message waiting to be written.
+     */
+    struct PendingMessage {
+        /**
+         * Message's log level.
+         */
+        LogLevel level;
+
+        /**
+         * Time of when the message was logged.
+         */
+        time_t time;
+
+        /**
+         * Log message. Unused for flush requests.
+         */
+        std::string message;
+
+        /**
+         * Whether this is a flush request rather than a message.
+         */
+        bool is_flush_request;
+    };
+
+    /**
+     * Formats a message and appends it to the file and console output.
+     *
+     * @param message
+     *        Message to format.
+     * @param file_output
+     *        String to append the log file entry to.
+     * @param console_output
+     *        String to append the console entry to. Unused if console echo is
+     *        disabled.
+     */
+    void formatMessage(const PendingMessage& message, std::string& file_output,
+                       std::string& console_output) throw();
+
+    /**
+     * Writes formatted output to the log file and the console.
+     *
+     * @param file_output
+     *        Log file output.
+     * @param console_output
+     *        Console output.
+     * @param do_flush
+     *        Whether to flush the log file afterwards.
+     * @throws IOException
+     *         When an I/O error occurs.
+     */
+    void writeOutput(const std::string& file_output,
+                     const std::string& console_output, bool do_flush)
+        throw(f2cc::IOException);
+
+    /**
+     * Queues a message for the writer thread, blocking while the queue is
+     * full. If \c do_wait is set, this also waits until the message has been
+     * written.
+     *
+     * @param message
+     *        Message to queue.
+     * @param do_wait
+     *        Whether to wait for the message to be written.
+     * @throws IOException
+     *         When the writer thread has failed to write to the log file.
+     */
+    void queueMessage(const PendingMessage& message, bool do_wait)
+        throw(f2cc::IOException);
+
+    /**
+     * Starts the writer thread.
+     *
+     * @throws IOException
+     *         When the thread cannot be started.
+     */
+    void startWriter() throw(f2cc::IOException);
+
+    /**
+     * Writes all queued messages and stops the writer thread. Does nothing if
+     * the thread is not running.
+     */
+    void stopWriter() throw();
+
+    /**
+     * Main loop of the writer thread. Repeatedly takes all queued messages
+     * and writes them as one batch.
+     */
+    void runWriter() throw();
+
+    /**
+     * Entry point of the writer thread.
+     *
+     * @param logger
+     *        The logger.
+     * @returns \c NULL.
+     */
+    static void* runWriterThread(void* logger) throw();
+
   private:
     /**
      * Path to log file.
@@ -337,8 +543,125 @@ class Logger {
      * Current log level.
      */
     LogLevel level_;
+
+    /**
+     * Time of the most recently formatted message.
+     */
+    time_t last_time_;
+
+    /**
+     * Timestamp of \c last_time_, which is reused as long as messages are
+     * logged within the same second.
+     */
+    std::string last_timestamp_;
+
+    /**
+     * Current flush policy.
+     */
+    FlushPolicy flush_policy_;
+
+    /**
+     * Whether messages are echoed to std::cout.
+     */
+    bool do_console_echo_;
+
+    /**
+     * Whether messages are written by the writer thread.
+     */
+    bool is_async_;
+
+    /**
+     * Whether the writer thread is running.
+     */
+    bool is_writer_running_;
+
+    /**
+     * Set to make the writer thread exit once the queue is empty.
+     */
+    bool do_stop_writer_;
+
+    /**
+     * Set by the writer thread when it fails to write to the log file.
+     */
+    bool has_write_error_;
+
+    /**
+     * Messages queued for the writer thread.
+     */
+    std::deque<PendingMessage> queue_;
+
+    /**
+     * Number of messages queued since the writer thread was started.
+     */
+    unsigned long num_queued_messages_;
+
+    /**
+     * Number of queued messages which have been written.
+     */
+    unsigned long num_written_messages_;
+
+    /**
+     * Writer thread.
+     */
+    pthread_t writer_;
+
+    /**
+     * Protects the queue and the writer state, and serializes the writes made
+     * by the logging code itself when the logger is synchronous.
+     */
+    pthread_mutex_t mutex_;
+
+    /**
+     * Signalled when a message is queued or the writer is to stop.
+     */
+    pthread_cond_t queue_not_empty_;
+
+    /**
+     * Signalled when the writer has taken messages from the queue.
+     */
+    pthread_cond_t queue_not_full_;
+
+    /**
+     * Signalled when the writer has written a batch.
+     */
+    pthread_cond_t batch_written_;
 };
 
 }
 
+/**
+ * @brief Logs a message only if its log level is enabled.
+ *
+ * Unlike calling Logger::logMessage() directly, the message expression is not
+ * evaluated unless the logger would actually write it. Hence this macro should
+ * be used wherever the message is built from several parts, especially inside
+ * loops over the model. For example:
+ * @code
+ *    LOG_MESSAGE(logger_, Logger::DEBUG, string("Analyzing leaf \"")
+ *                + leaf->getId()->getString() + "\"...");
+ * @endcode
+ *
+ * @param logger
+ *        Logger.
+ * @param level
+ *        Message's log level.
+ * @param message
+ *        Expression which evaluates to the log message.
+ */
+#define LOG_MESSAGE(logger, level, message) \
+    do { \
+        if ((logger).isEnabled(level)) (logger).logMessage(level, message); \
+    } while (false)
+
+/**
+ * Same as LOG_MESSAGE with \c Logger::DEBUG as log level.
+ *
+ * @param logger
+ *        Logger.
+ * @param message
+ *        Expression which evaluates to the log message.
+ */
+#define LOG_DEBUG(logger, message) \
+    LOG_MESSAGE(logger, f2cc::Logger::DEBUG, message)
+
 #endif
@@ -28,19 +28,24 @@
 #include "schedulefinder.h"
 #include "../forsyde/SY/delaysy.h"
 #include "../tools/tools.h"
+#include <deque>
+#include <map>
+#include <set>
 
 using namespace f2cc;
 using namespace f2cc::Forsyde;
 using namespace f2cc::Forsyde::SY;
 using std::string;
 using std::list;
+using std::vector;
+using std::deque;
+using std::map;
 using std::set;
-using std::pair;
-using std::bad_alloc;
-using std::queue;
 
-ScheduleFinder::ScheduleFinder(Forsyde::ProcessNetwork* processnetwork, Logger& logger)
-        throw(InvalidArgumentException) : processnetwork_(processnetwork), logger_(logger) {
+ScheduleFinder::ScheduleFinder(Forsyde::ProcessNetwork* processnetwork, Logger& logger,
+                               bool is_locality_aware)
+        throw(InvalidArgumentException) : processnetwork_(processnetwork), logger_(logger),
+                                          is_locality_aware_(is_locality_aware) {
     if (!processnetwork) {
         THROW_EXCEPTION(InvalidArgumentException, "\"processnetwork\" must not be NULL");
     }
@@ -48,128 +53,117 @@ ScheduleFinder::ScheduleFinder(Forsyde::ProcessNetwork* processnetwork, Logger&
 
 ScheduleFinder::~ScheduleFinder() throw() {}
 
-list<Id> ScheduleFinder::findSchedule() throw(IOException, RuntimeException) {
-    // Add all leafs at processnetwork outputs to starting point queue
-    list<Process::Interface*> output_ports = processnetwork_->getOutputs();
-    logger_.logMessage(Logger::DEBUG, string("Scanning all processnetwork outputs..."));
-    for (list<Process::Interface*>::iterator it = output_ports.begin();
-         it != output_ports.end(); ++it) {
-        logger_.logMessage(Logger::DEBUG, string("Adding \"")
-                           + (*it)->getProcess()->getId()->getString()
-                           + "\" to starting point queue...");
-        starting_points_.push(dynamic_cast<Leaf*>((*it)->getProcess()));
+list<Id> ScheduleFinder::findSchedule()
+    throw(InvalidModelException, IOException, RuntimeException) {
+    vector<Leaf*> leafs = findLeafsToSchedule();
+    map<const Leaf*, size_t> indices;
+    for (size_t i = 0; i < leafs.size(); ++i) {
+        indices[leafs[i]] = i;
     }
-    
-    // Iterate over all starting points
-    list<Id> schedule;
-    globally_visited_.clear();
-    while (!starting_points_.empty()) {
-        Leaf* next_starting_point = starting_points_.front();
-        starting_points_.pop();
-        if (!next_starting_point) {
-            THROW_EXCEPTION(RuntimeException, "Next starting point is NULL");
+
+    // Build the data flow graph, cutting all edges to and from delay leafs
+    vector< vector<size_t> > successors(leafs.size());
+    vector<size_t> num_predecessors(leafs.size(), 0);
+    for (size_t i = 0; i < leafs.size(); ++i) {
+        if (dynamic_cast<delay*>(leafs[i])) continue;
+        const Leaf::PortVector& out_ports = leafs[i]->getOutPortRange();
+        Leaf::PortVector::const_iterator it;
+        for (it = out_ports.begin(); it != out_ports.end(); ++it) {
+            Leaf* consumer = getConnectedLeaf(*it);
+            if (!consumer || dynamic_cast<delay*>(consumer)) continue;
+            map<const Leaf*, size_t>::iterator index_it =
+                indices.find(consumer);
+            if (index_it == indices.end()) continue;
+            successors[i].push_back(index_it->second);
+            ++num_predecessors[index_it->second];
         }
-        logger_.logMessage(Logger::DEBUG, string("Starting search at \"")
-                           + next_starting_point->getId()->getString()
-                           + "\"...");
+    }
 
-        set<Id> locally_visited;
-        PartialSchedule partial = findPartialSchedule(next_starting_point,
-                                                      locally_visited);
-        if (partial.at_beginning) {
-            schedule.insert(schedule.begin(), partial.schedule.begin(),
-                            partial.schedule.end());
+    // Repeatedly schedule a leaf whose predecessors have all been scheduled.
+    // Ready leafs are taken from the front of the list, and newly ready leafs
+    // are added to the back, or, when locality-aware, to the front in order
+    // to be scheduled next
+    deque<size_t> ready;
+    for (size_t i = 0; i < leafs.size(); ++i) {
+        if (num_predecessors[i] == 0) ready.push_back(i);
+    }
+    list<Id> schedule;
+    while (!ready.empty()) {
+        size_t current = ready.front();
+        ready.pop_front();
+        LOG_DEBUG(logger_, string("Scheduling leaf \"")
+                  + leafs[current]->getId()->getString() + "\"...");
+        schedule.push_back(*leafs[current]->getId());
+
+        vector<size_t>& next = successors[current];
+        for (size_t k = 0; k < next.size(); ++k) {
+            size_t successor = is_locality_aware_ ? next[next.size() - 1 - k]
+                : next[k];
+            if (--num_predecessors[successor] > 0) continue;
+            if (is_locality_aware_) ready.push_front(successor);
+            else                    ready.push_back(successor);
         }
-        else {
-            list<Id>::iterator it;
-            for (it = schedule.begin(); it != schedule.end(); ++it) {
-                if (*it == partial.insertion_point) {
-                    ++it;
-                    break;
-                }
-            }
-            if (it == schedule.end()) {
-                THROW_EXCEPTION(IllegalStateException, string("Failed to add ")
-                                + "partial schedule: Insertion point \""
-                                + partial.insertion_point.getString()
-                                + "\" not found in schedule");
-            }
+    }
 
-            schedule.insert(it, partial.schedule.begin(),
-                            partial.schedule.end());
+    if (schedule.size() < leafs.size()) {
+        for (size_t i = 0; i < leafs.size(); ++i) {
+            if (num_predecessors[i] == 0) continue;
+            THROW_EXCEPTION(InvalidModelException, string("Leaf \"")
+                            + leafs[i]->getId()->getString() + "\" is part "
+                            "of a loop without any delay leaf");
         }
-        
-        globally_visited_.insert(locally_visited.begin(),
-                                 locally_visited.end());
     }
+
     return schedule;
 }
 
-ScheduleFinder::PartialSchedule ScheduleFinder::findPartialSchedule(
-    Leaf* start, set<Id>& locally_visited)
+vector<Leaf*> ScheduleFinder::findLeafsToSchedule()
     throw(IOException, RuntimeException) {
-    PartialSchedule partial_schedule;
-
-    if (isGloballyVisited(start)) {
-        partial_schedule.at_beginning = false;
-        partial_schedule.insertion_point = *start->getId();
-        return partial_schedule;
-    }
-
-    // If this is a delay, add the delay element to the schedule and add its
-    // preceding leaf to starting point queue
-    if (dynamic_cast<delay*>(start)) {
-        Leaf::Port* inport = start->getInPorts().front();
-        if (inport->isConnected()) {
-            Leaf* preceding_leaf =
-            		dynamic_cast<Leaf*>(inport->getConnectedPort()->getProcess());
-            starting_points_.push(preceding_leaf);
+    set<const Leaf*> reached;
+    vector<Leaf*> pending;
+    list<Process::Interface*> output_ports = processnetwork_->getOutputs();
+    LOG_DEBUG(logger_, string("Scanning all processnetwork outputs..."));
+    for (list<Process::Interface*>::iterator it = output_ports.begin();
+         it != output_ports.end(); ++it) {
+        Leaf* leaf = dynamic_cast<Leaf*>((*it)->getProcess());
+        if (!leaf) {
+            THROW_EXCEPTION(RuntimeException, string("Process \"")
+                            + (*it)->getProcess()->getId()->getString()
+                            + "\" at processnetwork output is not a leaf");
         }
-        partial_schedule.schedule.push_back(*start->getId());
-        return partial_schedule;
+        if (reached.insert(leaf).second) pending.push_back(leaf);
     }
-
-    if (!visitLocally(start, locally_visited)) {
-        return partial_schedule;
-    }
-
-    // Find partial schedule
-    logger_.logMessage(Logger::DEBUG, string("Analyzing leaf \"")
-                       + start->getId()->getString() + "\"...");
-    list<Leaf::Port*> in_ports = start->getInPorts();
-    list<Leaf::Port*>::iterator it;
-    for (it = in_ports.begin(); it != in_ports.end(); ++it) {
-        if ((*it)->isConnected()) {
-            Leaf* next_leaf = dynamic_cast<Leaf*>((*it)->getConnectedPort()->getProcess());
-            PartialSchedule pp_schedule(findPartialSchedule(next_leaf,
-                                                            locally_visited));
-            tools::append<Id>(partial_schedule.schedule, pp_schedule.schedule);
-            if (!pp_schedule.at_beginning) {
-                partial_schedule.at_beginning = false;
-                partial_schedule.insertion_point = pp_schedule.insertion_point;
+    while (!pending.empty()) {
+        Leaf* leaf = pending.back();
+        pending.pop_back();
+        const Leaf::PortVector& in_ports = leaf->getInPortRange();
+        Leaf::PortVector::const_iterator it;
+        for (it = in_ports.begin(); it != in_ports.end(); ++it) {
+            Leaf* producer = getConnectedLeaf(*it);
+            if (producer && reached.insert(producer).second) {
+                pending.push_back(producer);
             }
         }
     }
-    partial_schedule.schedule.push_back(*start->getId());
 
-    return partial_schedule;
-}
-
-bool ScheduleFinder::isGloballyVisited(Forsyde::Leaf* leaf) {
-    return globally_visited_.find(*leaf->getId()) != globally_visited_.end();
+    // Keep the order of the processnetwork to get a deterministic schedule
+    vector<Leaf*> leafs;
+    list<Leaf*> all_leafs = processnetwork_->getProcesses();
+    for (list<Leaf*>::iterator it = all_leafs.begin(); it != all_leafs.end();
+         ++it) {
+        if (reached.find(*it) != reached.end()) leafs.push_back(*it);
+    }
+    return leafs;
 }
 
-bool ScheduleFinder::visitLocally(Forsyde::Leaf* leaf,
-                                  set<Forsyde::Id>& visited) {
-    return visited.insert(*leaf->getId()).second;
+Leaf* ScheduleFinder::getConnectedLeaf(Leaf::Port* port) const
+    throw(RuntimeException) {
+    if (!port->isConnected()) return NULL;
+    Leaf* leaf = dynamic_cast<Leaf*>(port->getConnectedPort()->getProcess());
+    if (!leaf) {
+        THROW_EXCEPTION(RuntimeException, string("Port \"")
+                        + port->toString() + "\" is not connected to a "
+                        "leaf");
+    }
+    return leaf;
 }
-
-
-ScheduleFinder::PartialSchedule::PartialSchedule() :
-        at_beginning(true), insertion_point(Id("")) {}
-
-ScheduleFinder::PartialSchedule::PartialSchedule(list<Id>& schedule,
-                                                 bool at_beginning,
-                                                 Id insertion_point) :
-        schedule(schedule), at_beginning(at_beginning),
-        insertion_point(insertion_point) {}
@@ -48,8 +48,7 @@
 #include "../exceptions/illegalstateexception.h"
 #include <string>
 #include <list>
-#include <set>
-#include <queue>
+#include <vector>
 
 namespace f2cc {
 
@@ -60,44 +59,28 @@ namespace f2cc {
  * The \c ScheduleFinder class implements an algorithm for finding a leaf
  * schedule for a given instance of a \c Forsyde::ProcessNetwork.
  *
- * The algorithm is a recursive DFS algorithm which traverses over the leafs
- * in the processnetwork. It starts by building a \em starting \em point \em queue,
- * containing all leafs connected directly to the processnetwork outputs. It then
- * pops a leaf from the head of the queue, and creates a \em partial \em
- * leaf \em schedule. The partial leaf schedule is created by recursively
- * traversing upwards along the data flow, moving via the in ports (\c
- * Forsyde::Leaf::Port) of a \c Forsyde::Leaf. When no more traversing can
- * be done, it rewinds the stack, and adds the current leaf to the
- * schedule. If a leaf has more than one in port, then a partial schedule is
- * generated for each, concatenated together, and then the current leaf is
- * appended to the end of the partial leaf schedule. Throughout the
- * traversing, a set of already-visited leafs is maintained. If an
- * already-visited leaf is reached, then an empty schedule is returned and
- * the function stack starts to rewind.
+ * The algorithm is Kahn's algorithm for topological sorting. First, the leafs
+ * to schedule are found by traversing upwards along the data flow from the
+ * leafs connected directly to the processnetwork outputs; leafs from which no
+ * output can be reached are not scheduled. Then, the data flow between the
+ * leafs is turned into a graph where each connection between two leafs is an
+ * edge. As the output of a \c delay leaf only depends on values of previous
+ * evaluation cycles, every edge to or from a \c delay leaf is cut, which
+ * breaks all loops in a valid processnetwork. Lastly, a leaf is added to the
+ * schedule once all leafs it has edges from have been added, starting with
+ * those without any such edges.
  *
- * This works very well as long as the processnetwork contains no loops. However, if it
- * does, then more needs to be done to get a correct schedule. First, the
- * visited leaf set is split into a \em global and a \em local set. Whenever
- * a leaf is popped from the starting point queue, the local set is reset,
- * and once the partial search has finished for that starting point leaf, the
- * local set is added to the global set. In addition to halting the search
- * whenever no more traversing can be done (i.e. when reaching a processnetwork input)
- * and when a leaf has already been visited, the search also halts whenever a
- * delay element is hit. In such instances, the preceding leaf (if any) is
- * added to the starting point queue, the delay element is added to the partial
- * element, and the function stack then rewinds.
+ * When several leafs are ready to be added, the leaf which became ready first
+ * is normally chosen, which schedules the leafs level by level. With
+ * locality-aware scheduling, the leaf which became ready last is chosen
+ * instead, which places a leaf directly after the leaf producing its input
+ * whenever possible so that the data is likely to still be in the cache.
  *
- * Lastly, for a given partial schedule, we need to know where to insert it
- * into the final schedule. If the partial search was halted due to hitting a
- * processnetwork input, then the partial schedule is inserted at the beginning of the
- * schedule. If the partial search was halted due to hitting a globally-visited
- * leaf \em P, then the partial schedule is inserted after the leaf \em P
- * in the schedule.
+ * Both the traversal and the sorting use explicit work lists rather than
+ * recursion, and the algorithm runs in time linear in the number of leafs and
+ * connections (up to the logarithmic cost of looking up leafs).
  */
 class ScheduleFinder {
-  private:
-    struct PartialSchedule;
-
   public:
     /**
      * Creates a schedule finder.
@@ -106,10 +89,13 @@ class ScheduleFinder {
      *        ForSyDe processnetwork.
      * @param logger
      *        Reference to the logger object.
+     * @param is_locality_aware
+     *        Whether the schedule should be locality-aware.
      * @throws InvalidArgumentException
      *         When \c processnetwork is \c NULL.
      */
-    ScheduleFinder(Forsyde::ProcessNetwork* processnetwork, Logger& logger)
+    ScheduleFinder(Forsyde::ProcessNetwork* processnetwork, Logger& logger,
+                   bool is_locality_aware = false)
         throw(InvalidArgumentException);
 
     /**
@@ -126,55 +112,42 @@ class ScheduleFinder {
      * works.
      *
      * @returns Leaf schedule.
+     * @throws InvalidModelException
+     *         When the processnetwork contains a loop without any \c delay
+     *         leaf.
      * @throws IOException
      *         When access to the log file fails.
      * @throws RuntimeException
      *         When a program error occurs. This most likely indicates a bug.
      */
-    std::list<Forsyde::Id> findSchedule() throw(IOException, RuntimeException);
+    std::list<Forsyde::Id> findSchedule()
+        throw(InvalidModelException, IOException, RuntimeException);
 
+  private:
     /**
-     * Finds a partial schedule for unvisited leafs when traversing from a
-     * given leaf to an input port of the processnetwork.
-     *
-     * See detailed class description for information on how the algorithm
-     * works.
+     * Finds the leafs from which at least one processnetwork output can be
+     * reached.
      *
-     * @param start
-     *        Leaf to start from.
-     * @param locally_visited
-     *        Set of already locally visited leafs.
-     * @returns Partial leaf schedule.
+     * @returns Leafs to schedule.
      * @throws IOException
      *         When access to the log file fails.
      * @throws RuntimeException
      *         When a program error occurs. This most likely indicates a bug.
      */
-    PartialSchedule findPartialSchedule(
-        Forsyde::Leaf* start, std::set<Forsyde::Id>& locally_visited)
+    std::vector<Forsyde::Leaf*> findLeafsToSchedule()
         throw(IOException, RuntimeException);
 
     /**
-     * Checks if a leaf has already been visited in a global sense. This
-     * does \em not, however, \em set the leaf as globally visited.
+     * Gets the leaf to which a port is connected.
      *
-     * @param leaf
-     *        Leaf.
-     * @returns \b true if the leaf has already been visited.
-     */
-    bool isGloballyVisited(Forsyde::Leaf* leaf);
-
-    /**
-     * Visits a leaf in a local sense.
-     *
-     * @param leaf
-     *        Leaf to visit.
-     * @param visited
-     *        Set of locally visited leafs.
-     * @returns \b true if the leaf has not previously been locally visisted.
+     * @param port
+     *        Port.
+     * @returns Connected leaf, or \c NULL if the port is not connected.
+     * @throws RuntimeException
+     *         When the port is connected to something other than a leaf.
      */
-    bool visitLocally(Forsyde::Leaf* leaf,
-                      std::set<Forsyde::Id>& visited);
+    Forsyde::Leaf* getConnectedLeaf(Forsyde::Leaf::Port* port) const
+        throw(RuntimeException);
 
   private:
     /**
@@ -188,60 +161,9 @@ class ScheduleFinder {
     Logger& logger_;
 
     /**
-     * Set of globally already visited leafs.
+     * Whether the schedule should be locality-aware.
      */
-    std::set<Forsyde::Id> globally_visited_;
-
-    /**
-     * Queue of starting points.
-     */
-    std::queue<Forsyde::Leaf*> starting_points_;
-
-  private:
-    /**
-     * A structure for describing a partial leaf schedule and where to 
-     * insert it in the final schedule.
-     */
-    struct PartialSchedule {
-      public:
-        /**
-         * Creates an empty partial schedule, set to be inserted at beginning of
-         * schedule.
-         */
-        PartialSchedule();
-
-        /**
-         * Creates a partial schedule.
-         *
-         * @param schedule
-         *        Partial schedule.
-         * @param at_beginning
-         *        Whether the partial schedule is to be inserted at the
-         *        beginning of the global schedule.
-         * @param insertion_point
-         *        Schedule insertion point (leave undefined if \c at_beginning
-         *        is set to \b true).
-         */
-        PartialSchedule(std::list<Forsyde::Id>& schedule, bool at_beginning,
-                       Forsyde::Id insertion_point);
-
-        /**
-         * Partial schedule.
-         */
-        std::list<Forsyde::Id> schedule;
-
-        /**
-         * Whether the insertion point is at the beginning of the schedule.
-         * Default value is \b true.
-         */
-        bool at_beginning;
-
-        /**
-         * Leaf ID (only defined if the insertion point is not at the
-         * beginning of the schedule).
-         */
-        Forsyde::Id insertion_point;
-    };
+    const bool is_locality_aware_;
 };
 
 }
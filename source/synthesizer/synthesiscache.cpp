@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) 2011-2013
+ *     Gabriel Hjort Blindell <ghb@kth.se>
+ *     George Ungureanu <ugeorge@kth.se>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OF THIS SOFTWARE NOR THE
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "synthesiscache.h"
+#include "../tools/tools.h"
+#include "../tools/fileview.h"
+#include "../tools/codewriter.h"
+#include <cstdlib>
+#include <cstring>
+
+using namespace f2cc;
+using std::string;
+using std::set;
+
+namespace {
+
+/**
+ * Identifies the format of the entry files. Increase the version whenever the
+ * format changes.
+ */
+const char kEntryMagic[] = "F2CC-CACHE 1";
+
+/**
+ * Reads a line from an entry file, and advances past it.
+ *
+ * @returns \b false if there is no further line.
+ */
+bool readLine(const char* data, size_t size, size_t& pos, string& line) {
+    if (pos >= size) return false;
+    const char* start = data + pos;
+    const char* newline = static_cast<const char*>(
+        std::memchr(start, '\n', size - pos));
+    if (!newline) return false;
+    line.assign(start, newline - start);
+    pos = newline - data + 1;
+    return true;
+}
+
+/**
+ * Reads a block of data, preceded by a line with its name and size, from an
+ * entry file, and advances past it.
+ *
+ * @returns \b false if the block is missing or truncated.
+ */
+bool readBlock(const char* data, size_t size, size_t& pos, const string& name,
+               const char*& block, size_t& length) {
+    string line;
+    if (!readLine(data, size, pos, line)) return false;
+    if (line.compare(0, name.length() + 1, name + " ") != 0) return false;
+    string block_size = line.substr(name.length() + 1);
+    if (!f2cc::tools::isNumeric(block_size)) return false;
+    length = std::strtoul(block_size.c_str(), NULL, 10);
+    if (length > size - pos) return false;
+    block = data + pos;
+    pos += length;
+    return true;
+}
+
+/**
+ * Appends a block of data, preceded by a line with its name and size, to an
+ * entry.
+ */
+void appendBlock(f2cc::tools::CodeWriter& entry, const string& name,
+                 const char* block, size_t length) {
+    entry << name << " " << length << "\n";
+    entry.write(block, length);
+}
+
+/**
+ * Writes a block of data to an output file.
+ *
+ * @throws IOException
+ *         When the file cannot be written.
+ */
+void writeBlock(const string& file, const char* block, size_t length)
+    throw(f2cc::IOException) {
+    f2cc::tools::CodeWriter writer;
+    writer.open(file);
+    writer.write(block, length);
+    writer.close();
+}
+
+}
+
+SynthesisCache::SynthesisCache(const Config& config, Logger& logger) throw()
+        : config_(config), logger_(logger) {}
+
+SynthesisCache::~SynthesisCache() throw() {}
+
+bool SynthesisCache::isEnabled() const throw() {
+    return !config_.getCacheDirectory().empty();
+}
+
+bool SynthesisCache::restore() throw(IOException) {
+    if (!isEnabled()) return false;
+
+    tools::FileView entry;
+    string entry_file;
+    try {
+        entry_file = getEntryFile();
+        entry.open(entry_file);
+    }
+    catch (FileNotFoundException&) {
+        logger_.logMessage(Logger::INFO, "No cached code found");
+        return false;
+    }
+    catch (IOException& ex) {
+        logger_.logMessage(Logger::WARNING, string("Failed to read cache:\n")
+                           + ex.getMessage());
+        return false;
+    }
+
+    // Check that all files which the model was built from are unchanged
+    const char* data = entry.getData();
+    size_t size = entry.getSize();
+    size_t pos = 0;
+    string line;
+    if (!readLine(data, size, pos, line) || line != kEntryMagic
+        || !readLine(data, size, pos, line)
+        || line.compare(0, 6, "files ") != 0
+        || !tools::isNumeric(line.substr(6))) {
+        logger_.logMessage(Logger::WARNING, string("Ignoring malformed cache "
+                           "entry \"") + entry_file + "\"");
+        return false;
+    }
+    size_t num_files = std::strtoul(line.c_str() + 6, NULL, 10);
+    for (size_t i = 0; i < num_files; ++i) {
+        if (!readLine(data, size, pos, line) || line.length() < 18
+            || line[16] != ' ') {
+            logger_.logMessage(Logger::WARNING, string("Ignoring malformed "
+                               "cache entry \"") + entry_file + "\"");
+            return false;
+        }
+        string file = line.substr(17);
+        try {
+            if (tools::toHexString(tools::hashFile(file))
+                != line.substr(0, 16)) {
+                logger_.logMessage(Logger::INFO, string("Cached code is out "
+                                   "of date (\"") + file + "\" has changed)");
+                return false;
+            }
+        }
+        catch (IOException&) {
+            logger_.logMessage(Logger::INFO, string("Cached code is out of "
+                               "date (\"") + file + "\" cannot be read)");
+            return false;
+        }
+    }
+
+    const char* header;
+    const char* implementation;
+    const char* benchmark;
+    size_t header_length;
+    size_t implementation_length;
+    size_t benchmark_length;
+    if (!readBlock(data, size, pos, "header", header, header_length)
+        || !readBlock(data, size, pos, "implementation", implementation,
+                      implementation_length)
+        || !readBlock(data, size, pos, "benchmark", benchmark,
+                      benchmark_length)) {
+        logger_.logMessage(Logger::WARNING, string("Ignoring malformed cache "
+                           "entry \"") + entry_file + "\"");
+        return false;
+    }
+    logger_.logMessage(Logger::INFO, string("Found cached code in \"")
+                       + entry_file + "\"");
+
+    logger_.logMessage(Logger::INFO, "Writing cached code to output files...");
+    writeBlock(config_.getHeaderOutputFile(), header, header_length);
+    writeBlock(config_.getImplementationOutputFile(), implementation,
+               implementation_length);
+    if (config_.doGenerateBenchmark()) {
+        writeBlock(config_.getBenchmarkOutputFile(), benchmark,
+                   benchmark_length);
+    }
+    return true;
+}
+
+void SynthesisCache::store(const set<string>& input_files)
+    throw(IOException) {
+    if (!isEnabled()) return;
+
+    try {
+        string entry_file = getEntryFile();
+
+        // The code is taken from the output files which were just written
+        tools::FileView header(config_.getHeaderOutputFile());
+        tools::FileView implementation(config_.getImplementationOutputFile());
+        tools::FileView benchmark;
+        if (config_.doGenerateBenchmark()) {
+            benchmark.open(config_.getBenchmarkOutputFile());
+        }
+
+        // The writer only replaces the entry file once it has been completely
+        // written, such that concurrent runs never see a partial entry
+        tools::createDirectory(config_.getCacheDirectory());
+        tools::CodeWriter entry;
+        entry.open(entry_file);
+        entry << kEntryMagic << "\n";
+
+        // The input file itself is covered by the name of the entry file
+        set<string> files(input_files);
+        files.erase(config_.getInputFile());
+        entry << "files " << files.size() << "\n";
+        for (set<string>::const_iterator it = files.begin(); it != files.end();
+             ++it) {
+            entry << tools::toHexString(tools::hashFile(*it)) << " " << *it
+                  << "\n";
+        }
+        appendBlock(entry, "header", header.getData(), header.getSize());
+        appendBlock(entry, "implementation", implementation.getData(),
+                    implementation.getSize());
+        appendBlock(entry, "benchmark", benchmark.getData(),
+                    benchmark.getSize());
+        entry.close();
+        logger_.logMessage(Logger::INFO, string("Stored code in cache entry \"")
+                           + entry_file + "\"");
+    }
+    catch (IOException& ex) {
+        logger_.logMessage(Logger::WARNING, string("Failed to store code in "
+                           "cache:\n") + ex.getMessage());
+    }
+}
+
+string SynthesisCache::getEntryFile() const
+    throw(FileNotFoundException, IOException) {
+    uint64_t key = tools::hash(getSettingsString());
+    key = tools::hash(config_.getInputFile(), key);
+    tools::FileView input(config_.getInputFile());
+    key = tools::hash(input.getData(), input.getSize(), key);
+
+    string directory = config_.getCacheDirectory();
+    if (directory[directory.length() - 1] != '/') directory += "/";
+    return directory + tools::toHexString(key) + ".cache";
+}
+
+string SynthesisCache::getSettingsString() const throw() {
+    string settings;
+    settings += "version=" + Config::getVersion() + "\n";
+    settings += "revision=" + Config::getSvnRevision() + "\n";
+    settings += "format=" + tools::toString(config_.getInputFormat()) + "\n";
+    settings += "platform=" + tools::toString(config_.getTargetPlatform())
+        + "\n";
+    settings += "header=" + config_.getHeaderOutputFile() + "\n";
+    settings += "implementation=" + config_.getImplementationOutputFile()
+        + "\n";
+    settings += "benchmark=" + tools::toString(config_.doGenerateBenchmark())
+        + "\n";
+    settings += "coalescing="
+        + tools::toString(config_.doDataParallelLeafCoalesing()) + "\n";
+    settings += "zero-copy=" + tools::toString(config_.doZeroCopyViews())
+        + "\n";
+    settings += "memory-planning="
+        + tools::toString(config_.doMemoryPlanning()) + "\n";
+    settings += "locality-aware-scheduling="
+        + tools::toString(config_.doLocalityAwareScheduling()) + "\n";
+    settings += "reentrant=" + tools::toString(config_.doReentrantCode())
+        + "\n";
+    settings += "profiling=" + tools::toString(config_.doProfiling()) + "\n";
+    settings += "shared-memory-input="
+        + tools::toString(config_.useSharedMemoryForInput()) + "\n";
+    settings += "shared-memory-output="
+        + tools::toString(config_.useSharedMemoryForOutput()) + "\n";
+    settings += "block-processing="
+        + tools::toString(config_.doBlockProcessing()) + "\n";
+    settings += "schedule=" + config_.getParallelSchedule() + "\n";
+    settings += "chunk-size=" + tools::toString(config_.getParallelChunkSize())
+        + "\n";
+    settings += "pipeline-stages="
+        + tools::toString(config_.getNumPipelineStages()) + "\n";
+    settings += "threads=" + tools::toString(config_.getNumThreads()) + "\n";
+    return settings;
+}
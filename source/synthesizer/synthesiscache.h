@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2011-2013
+ *     Gabriel Hjort Blindell <ghb@kth.se>
+ *     George Ungureanu <ugeorge@kth.se>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OF THIS SOFTWARE NOR THE
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef F2CC_SOURCE_SYNTHESIZER_SYNTHESISCACHE_H_
+#define F2CC_SOURCE_SYNTHESIZER_SYNTHESISCACHE_H_
+
+/**
+ * @file
+ * @version 0.1
+ *
+ * @brief Defines the \c SynthesisCache class.
+ */
+
+#include "../logger/logger.h"
+#include "../config/config.h"
+#include "../exceptions/filenotfoundexception.h"
+#include "../exceptions/ioexception.h"
+#include <string>
+#include <set>
+
+namespace f2cc {
+
+/**
+ * @brief An on-disk cache of synthesized code.
+ *
+ * The \c SynthesisCache stores the code synthesized for a model in a cache
+ * directory, such that a later run on the same, unchanged model can write the
+ * code again without parsing the model, modifying it or synthesizing it.
+ *
+ * Each cache entry is stored in a file named after a hash of the input file
+ * path, the input file content and the settings which affect the synthesized
+ * code. Along with the code, the entry records a hash of the content of each
+ * other file which the frontend read while building the model, such as the
+ * composite and function files of an XML model. An entry is only used if all
+ * of these files are still unchanged; otherwise it is replaced once the code
+ * has been synthesized again.
+ *
+ * A broken or unreadable entry is treated as a miss, and failing to store an
+ * entry only results in a warning, as the cache never affects the code which
+ * is written.
+ */
+class SynthesisCache {
+  public:
+    /**
+     * Creates a cache for the settings of a run. The cache is disabled if no
+     * cache directory is set.
+     *
+     * @param config
+     *        Reference to the configuration of the run.
+     * @param logger
+     *        Reference to the logger.
+     */
+    SynthesisCache(const Config& config, Logger& logger) throw();
+
+    /**
+     * Destroys this cache.
+     */
+    ~SynthesisCache() throw();
+
+    /**
+     * Checks whether the cache is enabled.
+     *
+     * @returns \b true if a cache directory is set.
+     */
+    bool isEnabled() const throw();
+
+    /**
+     * Looks up the code synthesized for the input file in a previous run and,
+     * if found, writes it to the output files.
+     *
+     * @returns \b true if an up-to-date entry was found.
+     * @throws IOException
+     *         When the log file or the output files cannot be written.
+     */
+    bool restore() throw(IOException);
+
+    /**
+     * Stores the code synthesized for the input file, as read back from the
+     * output files.
+     *
+     * @param input_files
+     *        Files which the model was built from, as reported by
+     *        Frontend::getInputFiles().
+     * @throws IOException
+     *         When the log file cannot be written.
+     */
+    void store(const std::set<std::string>& input_files) throw(IOException);
+
+  private:
+    /**
+     * Gets the path of the entry file for the input file and the current
+     * settings.
+     *
+     * @returns Entry file path.
+     * @throws FileNotFoundException
+     *         When the input file cannot be found.
+     * @throws IOException
+     *         When the input file cannot be read.
+     */
+    std::string getEntryFile() const throw(FileNotFoundException, IOException);
+
+    /**
+     * Gets a string describing all settings which affect the synthesized
+     * code, including the tool version.
+     *
+     * @returns Settings string.
+     */
+    std::string getSettingsString() const throw();
+
+  private:
+    /**
+     * Configuration of the run.
+     */
+    const Config& config_;
+
+    /**
+     * Logger.
+     */
+    Logger& logger_;
+};
+
+}
+
+#endif
@@ -41,20 +41,33 @@
 #include "../exceptions/unknownarraysizeexception.h"
 #include <new>
 #include <map>
+#include <vector>
+#include <algorithm>
+#include <functional>
 
 using namespace f2cc;
 using namespace f2cc::Forsyde;
 using namespace f2cc::Forsyde::SY;
+using f2cc::tools::CodeWriter;
 using std::string;
 using std::list;
 using std::set;
 using std::pair;
 using std::bad_alloc;
 using std::map;
+using std::vector;
+using std::multimap;
 
 const string Synthesizer::kIndents = "    ";
 const string Synthesizer::kProcessNetworkInputParameterPrefix = "input";
 const string Synthesizer::kProcessNetworkOutputParameterPrefix = "output";
+const string Synthesizer::kBlockNumTokensParameterName = "num_tokens";
+const string Synthesizer::kBlockTokenVariableName = "token";
+const string Synthesizer::kSignalArenaVariableName = "signal_arena";
+const size_t Synthesizer::kSignalArenaAlignment = 64;
+const string Synthesizer::kStateStructName = "ProcessNetworkState";
+const string Synthesizer::kStateParameterName = "state";
+const string Synthesizer::kThreadPoolVariableName = "thread_pool";
 
 Synthesizer::Synthesizer(ProcessNetwork* processnetwork, Logger& logger, Config& config)
         throw(InvalidArgumentException) : processnetwork_(processnetwork), logger_(logger),
@@ -71,19 +84,37 @@ Synthesizer::~Synthesizer() throw() {
     }
 }
 
-Synthesizer::CodeSet Synthesizer::generateCCode()
+void Synthesizer::generateCCode()
     throw(InvalidModelException, IOException, RuntimeException) {
     target_platform_ = Synthesizer::C;
-    return generateCode();
+    generateCode();
 }
 
-Synthesizer::CodeSet Synthesizer::generateCudaCCode()
+void Synthesizer::generateCudaCCode()
     throw(InvalidModelException, IOException, RuntimeException) {
     target_platform_ = Synthesizer::CUDA;
-    return generateCode();
+    generateCode();
 }
 
-Synthesizer::CodeSet Synthesizer::generateCode()
+void Synthesizer::generateMulticoreCCode()
+    throw(InvalidModelException, IOException, RuntimeException) {
+    target_platform_ = Synthesizer::C_MULTICORE;
+    generateCode();
+}
+
+void Synthesizer::generatePipelinedCCode()
+    throw(InvalidModelException, IOException, RuntimeException) {
+    target_platform_ = Synthesizer::C_PIPELINED;
+    generateCode();
+}
+
+void Synthesizer::generateTaskParallelCCode()
+    throw(InvalidModelException, IOException, RuntimeException) {
+    target_platform_ = Synthesizer::C_TASK_PARALLEL;
+    generateCode();
+}
+
+void Synthesizer::generateCode()
     throw(InvalidModelException, IOException, RuntimeException) {
     logger_.logMessage(Logger::INFO, "Checking that the internal processnetwork is "
                        "valid for synthesis...");
@@ -144,6 +175,27 @@ Synthesizer::CodeSet Synthesizer::generateCode()
     logger_.logMessage(Logger::INFO, "Creating delay variables...");
     createDelayVariables();
 
+    if (target_platform_ == C_PIPELINED) {
+        logger_.logMessage(Logger::INFO, "Splitting schedule into pipeline "
+                           "stages...");
+        findPipelineStages();
+    }
+    else if (target_platform_ == C_TASK_PARALLEL) {
+        logger_.logMessage(Logger::INFO, "Finding task dependencies...");
+        findTasks();
+    }
+
+    logger_.logMessage(Logger::INFO, "Creating zero-copy views for Unzipx "
+                       "and Zipx leafs...");
+    createSignalArrayViews();
+
+    logger_.logMessage(Logger::INFO, "Creating delay rings for array delay "
+                       "leafs...");
+    createDelayRings();
+
+    logger_.logMessage(Logger::INFO, "Planning signal array memory...");
+    planSignalMemory();
+
     switch (target_platform_) {
         case C: {
             logger_.logMessage(Logger::INFO, "Generating C code...");
@@ -154,61 +206,226 @@ Synthesizer::CodeSet Synthesizer::generateCode()
             logger_.logMessage(Logger::INFO, "Generating CUDA C code...");
             break;
         }
+
+        case C_MULTICORE: {
+            logger_.logMessage(Logger::INFO, "Generating multi-core C "
+                               "code...");
+            break;
+        }
+
+        case C_PIPELINED: {
+            logger_.logMessage(Logger::INFO, "Generating pipelined C "
+                               "code...");
+            break;
+        }
+
+        case C_TASK_PARALLEL: {
+            logger_.logMessage(Logger::INFO, "Generating task-parallel C "
+                               "code...");
+            break;
+        }
             
         default:
             // Should never get here
             break;
     }
 
-    CodeSet code;
     string boiler_plate = string()
         + "////////////////////////////////////////////////////////////\n"
         + "// AUTO-GENERATED BY F2CC " + config_.getVersion() + "\n"
         + "////////////////////////////////////////////////////////////\n";
-    code.header = boiler_plate + "\n";
-    logger_.logMessage(Logger::DEBUG, "Generating processnetwork function "
-                       "description...");
-    code.header += generateProcessNetworkFunctionDescription() + "\n";
-    logger_.logMessage(Logger::DEBUG, "Generating processnetwork function "
-                       "prototype...");
-    code.header += generateProcessNetworkFunctionPrototypeCode() + ";\n";
-    code.implementation = boiler_plate
-        + "\n"
-        + "#include \"" + config_.getHeaderOutputFile() + "\"\n";
+    CodeWriter header(kIndents);
+    header.open(config_.getHeaderOutputFile());
+    header << boiler_plate << "\n";
+    if (config_.doReentrantCode()) {
+        LOG_DEBUG(logger_, "Generating state struct "
+                  "definition...");
+        generateStateStructDefinitionCode(header);
+        header << "\n";
+        LOG_DEBUG(logger_, "Generating state function "
+                  "prototypes...");
+        generateStateFunctionPrototypesCode(header);
+        header << "\n";
+    }
+    LOG_DEBUG(logger_, "Generating processnetwork function "
+              "description...");
+    generateProcessNetworkFunctionDescription(header);
+    header << "\n";
+    LOG_DEBUG(logger_, "Generating processnetwork function "
+              "prototype...");
+    header << generateProcessNetworkFunctionPrototypeCode() << ";\n";
+    if (hasBlockFunction()) {
+        LOG_DEBUG(logger_, "Generating block-processing "
+                  "function description...");
+        header << "\n";
+        generateProcessNetworkBlockFunctionDescription(header);
+        header << "\n";
+        LOG_DEBUG(logger_, "Generating block-processing "
+                  "function prototype...");
+        header << generateProcessNetworkBlockFunctionPrototypeCode() << ";\n";
+    }
+    if (hasThreadPool()) {
+        LOG_DEBUG(logger_, "Generating thread stopping function "
+                  "prototype...");
+        header << "\n";
+        generateStopThreadsFunctionDescription(header);
+        header << generateStopThreadsFunctionPrototypeCode() << ";\n";
+    }
+    if (config_.doProfiling()) {
+        LOG_DEBUG(logger_, "Generating profiling function "
+                  "prototype...");
+        header << "\n";
+        generateProfileFunctionPrototypeCode(header);
+    }
+
+    CodeWriter implementation(kIndents);
+    implementation.open(config_.getImplementationOutputFile());
+    implementation << boiler_plate
+        << "\n"
+        << "#include \"" << config_.getHeaderOutputFile() << "\"\n";
+    if (signal_arena_sizes_.size() > 0) {
+        implementation << "#include <stddef.h>\n";
+    }
     if (target_platform_ == CUDA) {
-        code.implementation += string()
-            + "#include <stdio.h> // Remove when error handling and "
-            + "reporting of too small input data is fixed\n"
-            + "\n";
-        logger_.logMessage(Logger::DEBUG, "Generating kernel config struct "
-                           "definition...");
-        code.implementation += generateKernelConfigStructDefinitionCode()
-            + "\n";
-        logger_.logMessage(Logger::DEBUG, "Generating kernel config function "
-                           "definition...");
-        code.implementation += generateKernelConfigFunctionDefinitionCode()
-            + "\n";
+        implementation << "#include <stdio.h> // Remove when error handling "
+            "and reporting of too small input data is fixed\n"
+            << "\n";
+        LOG_DEBUG(logger_, "Generating kernel config struct "
+                  "definition...");
+        generateKernelConfigStructDefinitionCode(implementation);
+        implementation << "\n";
+        LOG_DEBUG(logger_, "Generating kernel config function "
+                  "definition...");
+        generateKernelConfigFunctionDefinitionCode(implementation);
+        implementation << "\n";
+    }
+    else if (target_platform_ == C_MULTICORE) {
+        implementation << "\n";
+        LOG_DEBUG(logger_, "Generating parallel map range "
+                  "struct definition...");
+        generateParallelMapRangeStructDefinitionCode(implementation);
+        implementation << "\n";
+    }
+    else if (target_platform_ == C_PIPELINED) {
+        implementation << "\n";
+        LOG_DEBUG(logger_, "Generating pipeline ring buffer "
+                  "definitions...");
+        generatePipelineRingDefinitionCode(implementation);
+        implementation << "\n";
+    }
+    else if (target_platform_ == C_TASK_PARALLEL) {
+        implementation << "\n";
+        LOG_DEBUG(logger_, "Generating task pool struct "
+                  "definitions...");
+        generateTaskPoolDefinitionCode(implementation);
+        implementation << "\n";
+    }
+    else {
+        implementation << "\n";
+    }
+
+    if (signal_arena_sizes_.size() > 0) {
+        LOG_DEBUG(logger_, "Generating signal arena data type size "
+                  "check...");
+        generateSignalArenaSizeCheckCode(implementation);
+        implementation << "\n";
+    }
+    LOG_DEBUG(logger_, "Generating leaf function "
+              "definitions...");
+    generateLeafFunctionDefinitionsCode(implementation);
+    implementation << "\n";
+    if (config_.doReentrantCode()) {
+        LOG_DEBUG(logger_, "Generating state function "
+                  "definitions...");
+        generateStateFunctionDefinitionsCode(implementation);
+        implementation << "\n";
+    }
+    if (config_.doProfiling()) {
+        LOG_DEBUG(logger_, "Generating profiling "
+                  "definitions...");
+        generateProfileDefinitionsCode(implementation);
+        implementation << "\n";
+    }
+    if (target_platform_ == C_PIPELINED) {
+        LOG_DEBUG(logger_, "Generating pipeline context "
+                  "struct definition...");
+        generatePipelineContextStructDefinitionCode(implementation);
+        implementation << "\n";
+        for (int stage = 0; stage < num_pipeline_stages_; ++stage) {
+            LOG_DEBUG(logger_, string("Generating pipeline ")
+                      + "stage " + tools::toString(stage + 1)
+                      + " function definition...");
+            generatePipelineStageFunctionDefinitionCode(implementation, stage);
+            implementation << "\n\n";
+        }
+        LOG_DEBUG(logger_, "Generating pipeline runtime "
+                  "definitions...");
+        generatePipelineRuntimeDefinitionCode(implementation);
+        implementation << "\n";
+    }
+    else if (target_platform_ == C_TASK_PARALLEL) {
+        LOG_DEBUG(logger_, "Generating task context struct "
+                  "definition...");
+        generateTaskContextStructDefinitionCode(implementation);
+        implementation << "\n";
+        for (size_t task = 0; task < tasks_.size(); ++task) {
+            LOG_DEBUG(logger_, string("Generating task ")
+                      + tools::toString(task + 1)
+                      + " function definition...");
+            generateTaskFunctionDefinitionCode(implementation, task);
+            implementation << "\n\n";
+        }
+        LOG_DEBUG(logger_, "Generating task runtime "
+                  "definitions...");
+        generateTaskRuntimeDefinitionCode(implementation);
+        implementation << "\n";
+    }
+    LOG_DEBUG(logger_, "Generating processnetwork function "
+              "definition...");
+    if (target_platform_ == C_PIPELINED) {
+        generatePipelinedBlockFunctionDefinitionCode(implementation);
+        implementation << "\n\n";
+        generateProcessNetworkForwardingFunctionDefinitionCode(implementation);
+        implementation << "\n";
+    }
+    else if (target_platform_ == C_TASK_PARALLEL) {
+        generateTaskParallelBlockFunctionDefinitionCode(implementation);
+        implementation << "\n\n";
+        generateProcessNetworkForwardingFunctionDefinitionCode(implementation);
+        implementation << "\n";
+    }
+    else if (config_.doBlockProcessing()) {
+        generateProcessNetworkBlockFunctionDefinitionCode(implementation);
+        implementation << "\n\n";
+        generateProcessNetworkForwardingFunctionDefinitionCode(implementation);
+        implementation << "\n";
     }
     else {
-        code.implementation += "\n";
+        generateProcessNetworkFunctionDefinitionCode(implementation);
+        implementation << "\n";
     }
 
-    logger_.logMessage(Logger::DEBUG, "Generating leaf function "
-                       "definitions...");
-    code.implementation += generateLeafFunctionDefinitionsCode() + "\n";
-    logger_.logMessage(Logger::DEBUG, "Generating processnetwork function "
-                       "definition...");
-    code.implementation += generateProcessNetworkFunctionDefinitionCode() + "\n";
+    if (config_.doGenerateBenchmark()) {
+        LOG_DEBUG(logger_, "Generating benchmark driver...");
+        CodeWriter benchmark(kIndents);
+        benchmark.open(config_.getBenchmarkOutputFile());
+        benchmark << boiler_plate << "\n";
+        generateBenchmarkCode(benchmark);
+        benchmark.close();
+    }
 
-    return code;
+    header.close();
+    implementation.close();
 }
 
 void Synthesizer::checkProcessNetwork()
     throw(InvalidModelException, IOException, RuntimeException) {}
 
-void Synthesizer::findSchedule() throw (IOException, RuntimeException) {
+void Synthesizer::findSchedule()
+    throw(InvalidModelException, IOException, RuntimeException) {
     schedule_.clear();
-    ScheduleFinder schedule_finder(processnetwork_, logger_);
+    ScheduleFinder schedule_finder(processnetwork_, logger_,
+                                   config_.doLocalityAwareScheduling());
     schedule_ = schedule_finder.findSchedule();
 }
 
@@ -225,8 +442,8 @@ Synthesizer::Signal* Synthesizer::registerSignal(Signal* signal)
         Signal* new_signal = new Signal(*signal);
         signals_.insert(new_signal);
 
-        logger_.logMessage(Logger::DEBUG, string("Registred new signal ")
-                           + new_signal->toString());
+        LOG_DEBUG(logger_, string("Registred new signal ")
+                  + new_signal->toString());
 
         return new_signal;
     } catch (bad_alloc&) {
@@ -279,8 +496,8 @@ void Synthesizer::renameMapFunctions()
             THROW_EXCEPTION(IllegalStateException, string("Leaf \"") +
                             it->getString() + "\" not found");
         }
-        logger_.logMessage(Logger::DEBUG, string("Analyzing leaf \"")
-                           + current_leaf->getId()->getString() + "\"...");
+        LOG_DEBUG(logger_, string("Analyzing leaf \"")
+                  + current_leaf->getId()->getString() + "\"...");
 
         Map* mapsy = dynamic_cast<Map*>(current_leaf);
         if (mapsy) {
@@ -320,8 +537,8 @@ void Synthesizer::CombineFunctionDuplicates()
             THROW_EXCEPTION(IllegalStateException, string("Leaf \"") +
                             it->getString() + "\" not found");
         }
-        logger_.logMessage(Logger::DEBUG, string("Analyzing leaf \"")
-                           + current_leaf->getId()->getString() + "\"...");
+        LOG_DEBUG(logger_, string("Analyzing leaf \"")
+                  + current_leaf->getId()->getString() + "\"...");
 
         Map* mapsy = dynamic_cast<Map*>(current_leaf);
         if (mapsy) {
@@ -346,11 +563,11 @@ void Synthesizer::CombineFunctionDuplicates()
                 if (!result.second) {
                     string new_name = result.first->second;
                     if (function->getName() != new_name) {
-                        logger_.logMessage(Logger::DEBUG, string("Duplicate ")
-                                           + "found. Function \""
-                                           + function->getName()
-                                           + "\" renamed to \"" + new_name
-                                           + "\"");
+                        LOG_DEBUG(logger_, string("Duplicate ")
+                                  + "found. Function \""
+                                  + function->getName()
+                                  + "\" renamed to \"" + new_name
+                                  + "\"");
                         function->setName(new_name);
                     }
                 }
@@ -368,8 +585,8 @@ void Synthesizer::generateCoalescedSyWrapperFunctions()
             THROW_EXCEPTION(IllegalStateException, string("Leaf \"") +
                             it->getString() + "\" not found");
         }
-        logger_.logMessage(Logger::DEBUG, string("Analyzing leaf \"")
-                           + current_leaf->getId()->getString() + "\"...");
+        LOG_DEBUG(logger_, string("Analyzing leaf \"")
+                  + current_leaf->getId()->getString() + "\"...");
 
         CoalescedMap* cmapsy = dynamic_cast<CoalescedMap*>(current_leaf);
         if (cmapsy) {
@@ -441,9 +658,8 @@ CFunction Synthesizer::generateCoalescedSyWrapperFunction(
     return CFunction(new_name, new_return_type, new_input_parameters, new_body);
 }
 
-string Synthesizer::generateLeafFunctionDefinitionsCode()
+void Synthesizer::generateLeafFunctionDefinitionsCode(CodeWriter& code)
     throw(InvalidModelException, IOException, RuntimeException) {
-    string code;
     set<string> unique_function_names;
     for (list<Id>::iterator it = schedule_.begin(); it != schedule_.end();
          ++it) {
@@ -452,8 +668,8 @@ string Synthesizer::generateLeafFunctionDefinitionsCode()
             THROW_EXCEPTION(IllegalStateException, string("Leaf \"") +
                             it->getString() + "\" not found");
         }
-        logger_.logMessage(Logger::DEBUG, string("Analyzing leaf \"")
-                           + current_leaf->getId()->getString() + "\"...");
+        LOG_DEBUG(logger_, string("Analyzing leaf \"")
+                  + current_leaf->getId()->getString() + "\"...");
 
         list<CFunction*> functions;
         if (Map* mapsy = dynamic_cast<Map*>(current_leaf)) {
@@ -479,13 +695,11 @@ string Synthesizer::generateLeafFunctionDefinitionsCode()
                 bool not_yet_defined = 
                     unique_function_names.insert(function->getName()).second;
                 if (not_yet_defined) {
-                    code += function->getString() + "\n\n";
+                    code << function->getString() << "\n\n";
                 }
             }
         }
     }
-    
-    return code;
 }
 
 string Synthesizer::generateProcessNetworkFunctionPrototypeCode()
@@ -497,37 +711,517 @@ string Synthesizer::generateProcessNetworkFunctionPrototypeCode()
     return code;
 }
 
-string Synthesizer::generateProcessNetworkFunctionDefinitionCode()
+void Synthesizer::generateProcessNetworkFunctionDefinitionCode(
+    CodeWriter& code)
+    throw(InvalidModelException, IOException, RuntimeException) {
+    code << generateProcessNetworkFunctionPrototypeCode() << " {\n";
+    code << kIndents << "int i; // Can safely be removed if the compiler "
+        "warns\n"
+        << kIndents << "       // about it being unused\n";
+    generateSignalVariableDeclarationsCode(code);
+    code << "\n";
+    size_t delay_code_start = code.getSize();
+    generateDelayVariableDeclarationsCode(code);
+    if (code.getSize() > delay_code_start) code << "\n";
+    generateArrayInputOutputsToSignalsAliasingCode(code);
+    code << "\n";
+    size_t ring_code_start = code.getSize();
+    generateDelayRingAliasingCode(code);
+    if (code.getSize() > ring_code_start) code << "\n";
+    size_t view_code_start = code.getSize();
+    generateSignalArrayViewsAliasingCode(code);
+    if (code.getSize() > view_code_start) code << "\n";
+    generateInputsToSignalsCopyingCode(code);
+    code << "\n";
+    code << kIndents << "// Execute leafs\n";
+    generateScheduleExecutionCode(code);
+    code << "\n";
+    generateSignalsToOutputsCopyingCode(code);
+    code << "\n";
+    code << "\n";
+    generateSignalVariableCleanupCode(code);
+    code << "}";
+}
+
+string Synthesizer::generateProcessNetworkBlockFunctionPrototypeCode()
     throw(InvalidModelException, IOException, RuntimeException) {
     string code;
-    code += generateProcessNetworkFunctionPrototypeCode() + " {\n";
-    code += kIndents + "int i; // Can safely be removed if the compiler warns\n"
-        + kIndents + "       // about it being unused\n";
-    code += generateSignalVariableDeclarationsCode() + "\n";
-    code += generateDelayVariableDeclarationsCode() + "\n";
-    code += generateArrayInputOutputsToSignalsAliasingCode() + "\n";
-    code += generateInputsToSignalsCopyingCode() + "\n";
-    code += kIndents + "// Execute leafs\n";
+    code += "void executeProcessNetworkBlock("
+        + generateProcessNetworkFunctionParameterListCode(true)
+        + ")";
+    return code;
+}
 
-    // First, execute the first step of all delay leafs
-    for (list<Id>::iterator it = schedule_.begin(); it != schedule_.end();
-         ++it) {
-        Leaf* current_leaf = processnetwork_->getProcess(*it);
-        if (!current_leaf) {
-            THROW_EXCEPTION(IllegalStateException, string("Leaf \"") +
-                            it->getString() + "\" not found");
+void Synthesizer::generateProcessNetworkBlockFunctionDefinitionCode(
+    CodeWriter& code)
+    throw(InvalidModelException, IOException, RuntimeException) {
+    code << generateProcessNetworkBlockFunctionPrototypeCode() << " {\n";
+    code << kIndents << "int i; // Can safely be removed if the compiler "
+        "warns\n"
+        << kIndents << "       // about it being unused\n";
+    code << kIndents << "int " << kBlockTokenVariableName << ";\n";
+    generateSignalVariableDeclarationsCode(code);
+    code << "\n";
+    size_t delay_code_start = code.getSize();
+    generateDelayVariableDeclarationsCode(code);
+    if (code.getSize() > delay_code_start) code << "\n";
+
+    code << kIndents << "// Execute processnetwork once for each token\n";
+    code << kIndents << "for (" << kBlockTokenVariableName << " = 0; "
+        << kBlockTokenVariableName << " < " << kBlockNumTokensParameterName
+        << "; ++" << kBlockTokenVariableName << ") {\n";
+    code.indent();
+    generateArrayInputOutputsToSignalsAliasingCode(code, true);
+    code << "\n";
+    size_t ring_code_start = code.getSize();
+    generateDelayRingAliasingCode(code);
+    if (code.getSize() > ring_code_start) code << "\n";
+    size_t view_code_start = code.getSize();
+    generateSignalArrayViewsAliasingCode(code);
+    if (code.getSize() > view_code_start) code << "\n";
+    generateInputsToSignalsCopyingCode(code, true);
+    code << "\n";
+    code << kIndents << "// Execute leafs\n";
+    generateScheduleExecutionCode(code);
+    code << "\n";
+    generateSignalsToOutputsCopyingCode(code, true);
+    code.unindent();
+    code << kIndents << "}\n";
+    code << "\n";
+    generateSignalVariableCleanupCode(code);
+    code << "}";
+}
+
+void Synthesizer::generateProcessNetworkForwardingFunctionDefinitionCode(
+    CodeWriter& code)
+    throw(InvalidModelException, IOException, RuntimeException) {
+    code << generateProcessNetworkFunctionPrototypeCode() << " {\n";
+    code << kIndents << "executeProcessNetworkBlock(";
+    if (config_.doReentrantCode()) code << kStateParameterName << ", ";
+    code << "1";
+
+    list<Process::Interface*> inputs = processnetwork_->getInputs();
+    list<Process::Interface*>::iterator it;
+    int id;
+    for (it = inputs.begin(), id = 1; it != inputs.end(); ++it, ++id) {
+        Signal* signal = getSignalByInPort(dynamic_cast<Leaf::Port*>(*it));
+        code << ", ";
+        if (!signal->getDataType()->isArray()) code << "&";
+        code << kProcessNetworkInputParameterPrefix << id;
+    }
+    list<Process::Interface*> outputs = processnetwork_->getOutputs();
+    for (it = outputs.begin(), id = 1; it != outputs.end(); ++it, ++id) {
+        code << ", " << kProcessNetworkOutputParameterPrefix << id;
+    }
+
+    code << ");\n";
+    code << "}";
+}
+
+void Synthesizer::generateBenchmarkCode(CodeWriter& code)
+    throw(InvalidModelException, IOException, RuntimeException) {
+    string target;
+    switch (target_platform_) {
+        case C:           target = "c"; break;
+        case CUDA:        target = "cuda"; break;
+        case C_MULTICORE: target = "c-multicore"; break;
+        case C_PIPELINED: target = "c-pipelined"; break;
+        case C_TASK_PARALLEL: target = "c-task-parallel"; break;
+    }
+
+    // Gather the processnetwork parameters; each buffer holds the data of all
+    // tokens in the pool
+    list< pair<string, CDataType> > buffers;
+    list<Process::Interface*> inputs = processnetwork_->getInputs();
+    list<Process::Interface*>::iterator it;
+    int id;
+    for (it = inputs.begin(), id = 1; it != inputs.end(); ++it, ++id) {
+        Signal* signal = getSignalByInPort(dynamic_cast<Leaf::Port*>(*it));
+        buffers.push_back(pair<string, CDataType>(
+                              kProcessNetworkInputParameterPrefix
+                              + tools::toString(id), *signal->getDataType()));
+    }
+    list<Process::Interface*> outputs = processnetwork_->getOutputs();
+    for (it = outputs.begin(), id = 1; it != outputs.end(); ++it, ++id) {
+        Signal* signal = getSignalByOutPort(dynamic_cast<Leaf::Port*>(*it));
+        buffers.push_back(pair<string, CDataType>(
+                              kProcessNetworkOutputParameterPrefix
+                              + tools::toString(id), *signal->getDataType()));
+    }
+
+    string declarations_code;
+    string allocation_code;
+    string filling_code;
+    string checksum_code;
+    string cleanup_code;
+    string bytes_per_token;
+    list< pair<string, CDataType> >::iterator buffer_it;
+    for (buffer_it = buffers.begin(); buffer_it != buffers.end();
+         ++buffer_it) {
+        string name = buffer_it->first;
+        CDataType data_type = buffer_it->second;
+        if (data_type.isArray() && !data_type.hasArraySize()) {
+            THROW_EXCEPTION(InvalidModelException, string("Size not known ")
+                            + "for processnetwork parameter \"" + name
+                            + "\"");
         }
-        if (delay* delaysy = dynamic_cast<delay*>(current_leaf)) {
-            try {
-                code += generateLeafExecutionCodeFordelayStep1(delaysy);
+        data_type.setIsConst(false);
+        data_type.setIsPointer(false);
+        string type = data_type.getVariableDataTypeString();
+        string size = tools::toString(data_type.getArraySize());
+        string num_elements = size + "L * F2CC_BENCH_TOKENS";
+        bool is_input = name.find(kProcessNetworkInputParameterPrefix) == 0;
+
+        declarations_code += kIndents + type + "* " + name + ";\n";
+        allocation_code += kIndents + name + " = (" + type + "*) malloc(sizeof("
+            + type + ") * " + num_elements + ");\n";
+        if (is_input) {
+            string value;
+            if (data_type.getType() == CDataType::FLOAT
+                || data_type.getType() == CDataType::DOUBLE
+                || data_type.getType() == CDataType::LONG_DOUBLE) {
+                value = "benchRandom() * 2.0 - 1.0";
             }
-            catch (InvalidModelException& ex) {
-                THROW_EXCEPTION(InvalidModelException, "Error in leaf \""
-                                + current_leaf->getId()->getString() + "\": "
-                                + ex.getMessage());
+            else {
+                value = "benchRandom() * 100.0";
             }
+            filling_code += kIndents + "for (i = 0; i < " + num_elements
+                + "; ++i) " + name + "[i] = (" + type + ") (" + value
+                + ");\n";
+        }
+        else {
+            checksum_code += kIndents + "for (i = 0; i < " + num_elements
+                + "; ++i) checksum += (double) " + name + "[i];\n";
+        }
+        cleanup_code += kIndents + "free(" + name + ");\n";
+        if (bytes_per_token.length() > 0) bytes_per_token += " + ";
+        bytes_per_token += "sizeof(" + type + ") * " + size;
+    }
+    if (bytes_per_token.length() == 0) bytes_per_token = "0";
+
+    code << "#ifndef _POSIX_C_SOURCE\n"
+        << "#define _POSIX_C_SOURCE 199309L // For clock_gettime()\n"
+        << "#endif\n"
+        << "\n"
+        << "#include \"" << config_.getHeaderOutputFile() << "\"\n"
+        << "#include <stdio.h>\n"
+        << "#include <stdlib.h>\n"
+        << "#include <time.h>\n"
+        << "\n"
+        << "/**\n"
+        << " * Number of tokens processed in each benchmark iteration.\n"
+        << " */\n"
+        << "#ifndef F2CC_BENCH_TOKENS\n"
+        << "#define F2CC_BENCH_TOKENS 1024\n"
+        << "#endif\n"
+        << "\n"
+        << "/**\n"
+        << " * Default number of untimed warm-up iterations.\n"
+        << " */\n"
+        << "#ifndef F2CC_BENCH_WARMUP_ITERATIONS\n"
+        << "#define F2CC_BENCH_WARMUP_ITERATIONS 10\n"
+        << "#endif\n"
+        << "\n"
+        << "/**\n"
+        << " * Default number of timed iterations.\n"
+        << " */\n"
+        << "#ifndef F2CC_BENCH_ITERATIONS\n"
+        << "#define F2CC_BENCH_ITERATIONS 100\n"
+        << "#endif\n"
+        << "\n"
+        << "/**\n"
+        << " * Number of bytes of input and output data per token.\n"
+        << " */\n"
+        << "#define F2CC_BENCH_BYTES_PER_TOKEN (" << bytes_per_token << ")\n"
+        << "\n";
+
+    code << "/**\n"
+        << " * Gets the next value of a deterministic pseudo-random sequence.\n"
+        << " *\n"
+        << " * @returns Value in the range [0, 1).\n"
+        << " */\n"
+        << "static double benchRandom(void) {\n"
+        << kIndents << "static unsigned long seed = 12345UL;\n"
+        << kIndents << "seed = (seed * 1103515245UL + 12345UL) & "
+        "0x7fffffffUL;\n"
+        << kIndents << "return (double) seed / 2147483648.0;\n"
+        << "}\n"
+        << "\n"
+        << "/**\n"
+        << " * Gets the current time of a monotonic clock.\n"
+        << " *\n"
+        << " * @returns Time in seconds.\n"
+        << " */\n"
+        << "static double benchTime(void) {\n"
+        << kIndents << "struct timespec now;\n"
+        << kIndents << "clock_gettime(CLOCK_MONOTONIC, &now);\n"
+        << kIndents << "return (double) now.tv_sec + (double) now.tv_nsec * "
+        << "1e-9;\n"
+        << "}\n"
+        << "\n";
+
+    code << "/**\n"
+        << " * Runs the benchmark.\n"
+        << " *\n"
+        << " * Usage: <program> [ITERATIONS [WARMUP_ITERATIONS]]\n"
+        << " */\n"
+        << "int main(int argc, char** argv) {\n"
+        << kIndents << "int iterations = F2CC_BENCH_ITERATIONS;\n"
+        << kIndents << "int warmup_iterations = F2CC_BENCH_WARMUP_ITERATIONS;\n"
+        << kIndents << "int iteration;\n";
+    if (!hasBlockFunction()) {
+        code << kIndents << "int " << kBlockTokenVariableName << ";\n";
+    }
+    code << kIndents << "long i;\n"
+        << kIndents << "double start;\n"
+        << kIndents << "double seconds;\n"
+        << kIndents << "double tokens;\n"
+        << kIndents << "double checksum = 0.0;\n";
+    if (config_.doReentrantCode()) {
+        code << kIndents << "struct " << kStateStructName << " "
+            << kStateParameterName << ";\n";
+    }
+    code << declarations_code;
+    code << "\n";
+    code << kIndents << "if (argc > 1) iterations = atoi(argv[1]);\n"
+        << kIndents << "if (argc > 2) warmup_iterations = atoi(argv[2]);\n"
+        << kIndents << "if (iterations < 1) iterations = 1;\n"
+        << "\n";
+    code << kIndents << "// Allocate and fill buffers with pseudo-random "
+        "data\n";
+    code << allocation_code;
+    code << filling_code;
+    if (config_.doReentrantCode()) {
+        code << kIndents << "init" << kStateStructName << "(&"
+            << kStateParameterName << ");\n";
+    }
+    code << "\n";
+
+    code << kIndents << "// Warm up\n"
+        << kIndents << "for (iteration = 0; iteration < warmup_iterations; "
+        << "++iteration) {\n";
+    code.indent();
+    generateBenchmarkExecutionCode(code);
+    code.unindent();
+    code << kIndents << "}\n"
+        << "\n";
+    code << kIndents << "// Execute timed iterations\n"
+        << kIndents << "start = benchTime();\n"
+        << kIndents << "for (iteration = 0; iteration < iterations; "
+        << "++iteration) {\n";
+    code.indent();
+    generateBenchmarkExecutionCode(code);
+    code.unindent();
+    code << kIndents << "}\n"
+        << kIndents << "seconds = benchTime() - start;\n"
+        << kIndents << "if (seconds <= 0.0) seconds = 1e-9;\n"
+        << "\n";
+
+    code << kIndents << "// Report results\n";
+    code << checksum_code;
+    code << kIndents << "tokens = (double) iterations * F2CC_BENCH_TOKENS;\n"
+        << kIndents << "printf(\"{\\\"network\\\": \\\""
+        << tools::getFileName(config_.getImplementationOutputFile())
+        << "\\\", \\\"target\\\": \\\"" << target << "\\\", \"\n"
+        << kIndents << "       \"\\\"tokens\\\": %.0f, \\\"seconds\\\": %.9f, "
+        << "\"\n"
+        << kIndents << "       \"\\\"tokens_per_second\\\": %.3f, "
+        << "\\\"ns_per_token\\\": %.3f, \"\n"
+        << kIndents << "       \"\\\"bytes_per_second\\\": %.3f, "
+        << "\\\"checksum\\\": %.17g}\\n\",\n"
+        << kIndents << "       tokens, seconds, tokens / seconds, "
+        << "seconds * 1e9 / tokens,\n"
+        << kIndents << "       tokens * F2CC_BENCH_BYTES_PER_TOKEN / seconds, "
+        << "checksum);\n"
+        << "\n";
+
+    code << kIndents << "// Clean up\n";
+    if (hasThreadPool()) {
+        code << kIndents << "stopProcessNetworkThreads(";
+        if (config_.doReentrantCode()) code << "&" << kStateParameterName;
+        code << ");\n";
+    }
+    code << cleanup_code;
+    code << kIndents << "return 0;\n"
+        << "}\n";
+}
+
+void Synthesizer::generateBenchmarkExecutionCode(CodeWriter& code)
+    throw(InvalidModelException, RuntimeException) {
+    string state_argument;
+    if (config_.doReentrantCode()) {
+        state_argument = string("&") + kStateParameterName + ", ";
+    }
+
+    if (hasBlockFunction()) {
+        code << kIndents << "executeProcessNetworkBlock(" << state_argument
+            << "F2CC_BENCH_TOKENS";
+        list<Process::Interface*> inputs = processnetwork_->getInputs();
+        list<Process::Interface*>::iterator it;
+        int id;
+        for (it = inputs.begin(), id = 1; it != inputs.end(); ++it, ++id) {
+            code << ", " << kProcessNetworkInputParameterPrefix << id;
+        }
+        list<Process::Interface*> outputs = processnetwork_->getOutputs();
+        for (it = outputs.begin(), id = 1; it != outputs.end(); ++it, ++id) {
+            code << ", " << kProcessNetworkOutputParameterPrefix << id;
+        }
+        code << ");\n";
+        return;
+    }
+
+    string arguments;
+    list<Process::Interface*> inputs = processnetwork_->getInputs();
+    list<Process::Interface*>::iterator it;
+    int id;
+    for (it = inputs.begin(), id = 1; it != inputs.end(); ++it, ++id) {
+        Signal* signal = getSignalByInPort(dynamic_cast<Leaf::Port*>(*it));
+        string name = kProcessNetworkInputParameterPrefix + tools::toString(id);
+        if (arguments.length() > 0) arguments += ", ";
+        if (signal->getDataType()->isArray()) {
+            arguments += string("&") + name + "[" + kBlockTokenVariableName
+                + " * "
+                + tools::toString(signal->getDataType()->getArraySize()) + "]";
+        }
+        else {
+            arguments += name + "[" + kBlockTokenVariableName + "]";
         }
     }
+    list<Process::Interface*> outputs = processnetwork_->getOutputs();
+    for (it = outputs.begin(), id = 1; it != outputs.end(); ++it, ++id) {
+        Signal* signal = getSignalByOutPort(dynamic_cast<Leaf::Port*>(*it));
+        string name = kProcessNetworkOutputParameterPrefix
+            + tools::toString(id);
+        if (arguments.length() > 0) arguments += ", ";
+        arguments += string("&") + name + "[" + kBlockTokenVariableName;
+        if (signal->getDataType()->isArray()) {
+            arguments += " * "
+                + tools::toString(signal->getDataType()->getArraySize());
+        }
+        arguments += "]";
+    }
+
+    code << kIndents << "for (" << kBlockTokenVariableName << " = 0; "
+        << kBlockTokenVariableName << " < F2CC_BENCH_TOKENS; ++"
+        << kBlockTokenVariableName << ") {\n";
+    code << kIndents << kIndents << "executeProcessNetwork(" << state_argument
+        << arguments << ");\n";
+    code << kIndents << "}\n";
+}
+
+void Synthesizer::generateProfileFunctionPrototypeCode(CodeWriter& code)
+    throw() {
+    code << "/**\n"
+        << " * Prints the number of invocations of, and the time spent in, "
+        "each\n"
+        << " * leaf of the processnetwork since the program started.\n"
+        << " */\n";
+    code << "void dumpProcessNetworkProfile(void);\n";
+}
+
+void Synthesizer::generateProfileDefinitionsCode(CodeWriter& code)
+    throw(IOException, RuntimeException) {
+    code << "#include <stdio.h>\n"
+        << "#include <time.h>\n"
+        << "\n";
+    code << "/**\n"
+        << " * C struct for the profiling measurements of a leaf.\n"
+        << " */\n"
+        << "struct LeafProfile {\n"
+        << kIndents << "const char* id;\n"
+        << kIndents << "unsigned long calls;\n"
+        << kIndents << "unsigned long long total_ns;\n"
+        << "};\n"
+        << "\n";
+    code << "static struct LeafProfile leaf_profiles["
+        << schedule_.size() << "] = {\n";
+    for (list<Id>::iterator it = schedule_.begin(); it != schedule_.end();
+         ++it) {
+        code << kIndents << "{\"" << it->getString() << "\", 0, 0}";
+        if (*it != schedule_.back()) code << ",";
+        code << "\n";
+    }
+    code << "};\n"
+        "\n";
+    code << "static unsigned long long getLeafProfileTime(void) {\n"
+        << kIndents << "struct timespec now;\n"
+        << kIndents << "clock_gettime(CLOCK_MONOTONIC, &now);\n"
+        << kIndents << "return (unsigned long long) now.tv_sec * "
+        "1000000000ULL\n"
+        << kIndents << "    + (unsigned long long) now.tv_nsec;\n"
+        << "}\n"
+        << "\n";
+    code << "void dumpProcessNetworkProfile(void) {\n"
+        << kIndents << "int i;\n"
+        << kIndents << "printf(\"%-24s %12s %16s %12s\\n\", \"leaf\", "
+        << "\"calls\", \"total ns\",\n"
+        << kIndents << "       \"ns/call\");\n"
+        << kIndents << "for (i = 0; i < " << schedule_.size() << "; ++i) {\n"
+        << kIndents << kIndents << "struct LeafProfile* profile = "
+        << "&leaf_profiles[i];\n"
+        << kIndents << kIndents << "printf(\"%-24s %12lu %16llu %12.1f\\n\", "
+        << "profile->id, profile->calls,\n"
+        << kIndents << kIndents << "       profile->total_ns, "
+        << "profile->calls > 0\n"
+        << kIndents << kIndents << "       ? (double) profile->total_ns / "
+        << "profile->calls : 0.0);\n"
+        << kIndents << "}\n"
+        << "}\n";
+}
+
+void Synthesizer::generateProfiledLeafExecutionCode(CodeWriter& code,
+                                                    Leaf* leaf,
+                                                    const string& leaf_code,
+                                                    bool count_invocation)
+    throw(RuntimeException) {
+    if (!config_.doProfiling()) {
+        code << leaf_code;
+        return;
+    }
+    if (leaf_code.length() == 0 && !count_invocation) return;
+
+    size_t index = 0;
+    list<Id>::iterator it;
+    for (it = schedule_.begin(); it != schedule_.end() && *it != *leaf->getId();
+         ++it) {
+        ++index;
+    }
+    if (it == schedule_.end()) {
+        THROW_EXCEPTION(IllegalStateException, string("Leaf \"")
+                        + leaf->getId()->getString() + "\" not in schedule");
+    }
+    if (leaf_code.length() == 0) {
+        // Nothing to measure, but the invocation should still be counted
+        code << kIndents << "++leaf_profiles[" << index << "].calls;\n";
+        return;
+    }
+
+    code << kIndents << "{\n";
+    code << kIndents << kIndents << "unsigned long long profile_start = "
+        << "getLeafProfileTime();\n";
+    code.indent();
+    code << leaf_code;
+    code.unindent();
+    code << kIndents << kIndents << "leaf_profiles[" << index
+        << "].total_ns += getLeafProfileTime() - profile_start;\n";
+    if (count_invocation) {
+        code << kIndents << kIndents << "++leaf_profiles[" << index
+            << "].calls;\n";
+    }
+    code << kIndents << "}\n";
+}
+
+void Synthesizer::generateScheduleExecutionCode(CodeWriter& code, int stage)
+    throw(InvalidModelException, IOException, RuntimeException) {
+    // First, execute the first step of all delay leafs
+    generateDelayExecutionCode(code, stage, true);
+
+    // When pipelined, pass on the delay values before waiting for any values
+    // from previous stages as those stages may in turn wait on them
+    if (stage >= 0) {
+        generatePipelineRingTransferCode(code, stage, true, true);
+        generatePipelineRingTransferCode(code, stage, false, false);
+    }
 
     // Then, execute all leafs in order, but ignore all delay leafs
     for (list<Id>::iterator it = schedule_.begin(); it != schedule_.end();
@@ -537,8 +1231,11 @@ string Synthesizer::generateProcessNetworkFunctionDefinitionCode()
             THROW_EXCEPTION(IllegalStateException, string("Leaf \"") +
                             it->getString() + "\" not found");
         }
+        if (stage >= 0 && getPipelineStage(current_leaf) != stage) continue;
         try {
-            code += generateLeafExecutionCode(current_leaf);
+            generateProfiledLeafExecutionCode(
+                code, current_leaf, generateLeafExecutionCode(current_leaf),
+                !dynamic_cast<delay*>(current_leaf));
         }
         catch (InvalidModelException& ex) {
             THROW_EXCEPTION(InvalidModelException, "Error in leaf \""
@@ -547,8 +1244,18 @@ string Synthesizer::generateProcessNetworkFunctionDefinitionCode()
         }
     }
 
+    if (stage >= 0) {
+        generatePipelineRingTransferCode(code, stage, true, false);
+    }
+
     // After the entire schedule has been executed, execute the second step
     // of all delay leafs
+    generateDelayExecutionCode(code, stage, false);
+}
+
+void Synthesizer::generateDelayExecutionCode(CodeWriter& code, int stage,
+                                             bool first_step)
+    throw(InvalidModelException, IOException, RuntimeException) {
     for (list<Id>::iterator it = schedule_.begin(); it != schedule_.end();
          ++it) {
         Leaf* current_leaf = processnetwork_->getProcess(*it);
@@ -556,9 +1263,21 @@ string Synthesizer::generateProcessNetworkFunctionDefinitionCode()
             THROW_EXCEPTION(IllegalStateException, string("Leaf \"") +
                             it->getString() + "\" not found");
         }
+        if (stage >= 0 && getPipelineStage(current_leaf) != stage) continue;
         if (delay* delaysy = dynamic_cast<delay*>(current_leaf)) {
             try {
-                code += generateLeafExecutionCodeFordelayStep2(delaysy);
+                if (first_step) {
+                    generateProfiledLeafExecutionCode(
+                        code, current_leaf,
+                        generateLeafExecutionCodeFordelayStep1(delaysy),
+                        false);
+                }
+                else {
+                    generateProfiledLeafExecutionCode(
+                        code, current_leaf,
+                        generateLeafExecutionCodeFordelayStep2(delaysy),
+                        true);
+                }
             }
             catch (InvalidModelException& ex) {
                 THROW_EXCEPTION(InvalidModelException, "Error in leaf \""
@@ -567,21 +1286,114 @@ string Synthesizer::generateProcessNetworkFunctionDefinitionCode()
             }
         }
     }
+}
 
-    code += "\n";
-    code += generateSignalsToOutputsCopyingCode() + "\n";
-    code += "\n";
-    code += generateSignalVariableCleanupCode();
-    code += "}";
-    return code;
+void Synthesizer::generateProcessNetworkFunctionDescription(CodeWriter& desc)
+    throw(InvalidModelException, IOException, RuntimeException) {
+    desc << "/**\n"
+        << " * Executes the processnetwork.\n"
+        << " *\n";
+    if (hasStaticState()) {
+        desc << " * The state of the processnetwork is kept in static "
+            "variables, which\n"
+            << " * makes this function non-reentrant. Generate the code with "
+            "-re to\n"
+            << " * get a reentrant variant.\n"
+            << " *\n";
+    }
+    if (target_platform_ == C_PIPELINED) {
+        desc << " * A single token gives the pipeline stages nothing to "
+            "overlap, so the\n"
+            << " * stages run one after another and pass the token between "
+            "threads,\n"
+            << " * which makes this function slower than sequential code. Use\n"
+            << " * executeProcessNetworkBlock() with large blocks instead.\n"
+            << " *\n";
+    }
+    if (config_.doReentrantCode()) {
+        desc << " * @param " << kStateParameterName << "\n"
+            << " *        State of the processnetwork instance to execute.\n";
+    }
+
+    // Generate description for the function input parameters
+    list<Process::Interface*> inputs = processnetwork_->getInputs();
+    list<Process::Interface*>::iterator it;
+    int id;
+    for (it = inputs.begin(), id = 1; it != inputs.end(); ++it, ++id) {
+        Signal* signal = getSignalByInPort(dynamic_cast<Leaf::Port*>(*it));
+        CDataType data_type = *signal->getDataType();
+        string param_name = kProcessNetworkInputParameterPrefix + tools::toString(id);
+        string leaf_name =
+            signal->getInPort()->getProcess()->getId()->getString();
+        desc << " * @param " << param_name << "\n";
+        desc << " *        Input to leaf \"" << leaf_name << "\".\n";
+        if (data_type.isArray()) {
+            desc << " *        Expects an array of size "
+                << data_type.getArraySize() << ".\n";
+        }
+    }
+
+    // Generate description for the function output parameters
+    list<Process::Interface*> outputs = processnetwork_->getOutputs();
+    for (it = outputs.begin(), id = 1; it != outputs.end(); ++it, ++id) {
+        Signal* signal = getSignalByOutPort(dynamic_cast<Leaf::Port*>(*it));
+        CDataType data_type = *signal->getDataType();
+        string param_name = kProcessNetworkOutputParameterPrefix + tools::toString(id);
+        string leaf_name =
+            signal->getOutPort()->getProcess()->getId()->getString();
+        desc << " * @param " << param_name << "\n";
+        desc << " *        Output from leaf \"" << leaf_name << "\".\n";
+        if (data_type.isArray()) {
+            desc << " *        Expects an array of size "
+                << data_type.getArraySize() << ".\n";
+        }
+    }
+
+    desc << " */\n";
 }
 
-string Synthesizer::generateProcessNetworkFunctionDescription() 
+void Synthesizer::generateProcessNetworkBlockFunctionDescription(
+    CodeWriter& desc)
     throw(InvalidModelException, IOException, RuntimeException) {
-    string desc;
-    desc += string("/**\n")
-        + " * Executes the processnetwork.\n"
-        + " *\n";
+    desc << "/**\n"
+        << " * Executes the processnetwork once for each token in a block of\n"
+        << " * tokens. The delay state is carried from one token to the next, "
+        "which\n"
+        << " * makes a call with N tokens equivalent to N consecutive calls "
+        "to\n"
+        << " * executeProcessNetwork().\n"
+        << " *\n";
+    if (hasStaticState()) {
+        desc << " * Like executeProcessNetwork(), this function is "
+            "non-reentrant.\n"
+            << " *\n";
+    }
+    if (target_platform_ == C_TASK_PARALLEL) {
+        desc << " * The tasks are executed by a pool of threads which is "
+            "started by\n"
+            << " * the first call and kept until stopProcessNetworkThreads() "
+            "is\n"
+            << " * called.\n"
+            << " *\n";
+    }
+    else if (target_platform_ == C_PIPELINED) {
+        desc << " * All pipeline stages but the first are executed by threads "
+            "which are\n"
+            << " * started by the first call and kept until "
+            "stopProcessNetworkThreads()\n"
+            << " * is called. The stages only overlap within a call, and each "
+            "call\n"
+            << " * hands the block over to the threads, so only calls with "
+            "many tokens\n"
+            << " * benefit from the pipeline.\n"
+            << " *\n";
+    }
+    if (config_.doReentrantCode()) {
+        desc << " * @param " << kStateParameterName << "\n"
+            << " *        State of the processnetwork instance to execute.\n";
+    }
+    desc << " * @param " << kBlockNumTokensParameterName << "\n"
+        << " *        Number of tokens in the block.\n";
 
     // Generate description for the function input parameters
     list<Process::Interface*> inputs = processnetwork_->getInputs();
@@ -593,13 +1405,15 @@ string Synthesizer::generateProcessNetworkFunctionDescription()
         string param_name = kProcessNetworkInputParameterPrefix + tools::toString(id);
         string leaf_name =
             signal->getInPort()->getProcess()->getId()->getString();
-        desc += string(" * @param ") + param_name + "\n";
-        desc += string(" *        Input to leaf \"") + leaf_name
-            + "\".\n";
+        desc << " * @param " << param_name << "\n";
+        desc << " *        Input to leaf \"" << leaf_name
+            << "\", one token after another.\n";
+        desc << " *        Expects an array of size "
+            << kBlockNumTokensParameterName;
         if (data_type.isArray()) {
-            desc += string(" *        Expects an array of size ")
-                + tools::toString(data_type.getArraySize()) + ".\n";
+            desc << " * " << data_type.getArraySize();
         }
+        desc << ".\n";
     }
 
     // Generate description for the function output parameters
@@ -610,32 +1424,71 @@ string Synthesizer::generateProcessNetworkFunctionDescription()
         string param_name = kProcessNetworkOutputParameterPrefix + tools::toString(id);
         string leaf_name =
             signal->getOutPort()->getProcess()->getId()->getString();
-        desc += string(" * @param ") + param_name + "\n";
-        desc += string(" *        Output from leaf \"") + leaf_name
-            + "\".\n";
+        desc << " * @param " << param_name << "\n";
+        desc << " *        Output from leaf \"" << leaf_name
+            << "\", one token after another.\n";
+        desc << " *        Expects an array of size "
+            << kBlockNumTokensParameterName;
         if (data_type.isArray()) {
-            desc += string(" *        Expects an array of size ")
-                + tools::toString(data_type.getArraySize()) + ".\n";
+            desc << " * " << data_type.getArraySize();
         }
+        desc << ".\n";
     }
 
-    desc += " */\n";
-    return desc;
+    desc << " */\n";
+}
+
+void Synthesizer::generateStopThreadsFunctionDescription(CodeWriter& desc)
+    throw() {
+    desc << "/**\n"
+        << " * Stops the threads which execute the processnetwork. The "
+        "threads\n"
+        << " * are started by the first call to executeProcessNetworkBlock() "
+        "and\n"
+        << " * are kept for later calls, so this should be called once the\n"
+        << " * processnetwork is no longer used";
+    if (config_.doReentrantCode()) {
+        desc << " and before the state is\n"
+            << " * discarded. A later call starts the threads again.\n"
+            << " *\n"
+            << " * @param " << kStateParameterName << "\n"
+            << " *        State of the processnetwork instance.\n";
+    }
+    else {
+        desc << ". A later call\n"
+            << " * starts the threads again.\n";
+    }
+    desc << " */\n";
 }
 
-string Synthesizer::generateProcessNetworkFunctionParameterListCode()
+string Synthesizer::generateProcessNetworkFunctionParameterListCode(
+    bool for_block)
     throw(InvalidModelException, RuntimeException) {
     string code;
 
-    // Generate input parameters
+    // Generate state parameter
     bool has_input_parameter = false;
+    if (config_.doReentrantCode()) {
+        code += getStateParameterDeclarationString();
+        has_input_parameter = true;
+    }
+
+    // Generate token count parameter
+    if (for_block) {
+        if (has_input_parameter) code += ", ";
+        code += string("int ") + kBlockNumTokensParameterName;
+        has_input_parameter = true;
+    }
+
+    // Generate input parameters
     list<Process::Interface*> inputs = processnetwork_->getInputs();
     list<Process::Interface*>::iterator it;
     int id;
     for (it = inputs.begin(), id = 1; it != inputs.end(); ++it, ++id) {
-        if (it != inputs.begin()) code += ", ";
+        if (has_input_parameter) code += ", ";
         CDataType data_type = *getSignalByInPort(dynamic_cast<Leaf::Port*>(*it))->getDataType();
         data_type.setIsConst(true);
+        if (for_block) data_type.setIsArray(true);
         CVariable parameter(kProcessNetworkInputParameterPrefix + tools::toString(id),
                             data_type);
         code += parameter.getInputParameterDeclarationString();
@@ -647,7 +1500,8 @@ string Synthesizer::generateProcessNetworkFunctionParameterListCode()
     for (it = outputs.begin(), id = 1; it != outputs.end(); ++it, ++id) {
         if (has_input_parameter || it != outputs.begin()) code += ", ";
         CDataType data_type = *getSignalByOutPort(dynamic_cast<Leaf::Port*>(*it))->getDataType();
-        if (!data_type.isArray()) data_type.setIsPointer(true);
+        if (for_block) data_type.setIsArray(true);
+        else if (!data_type.isArray()) data_type.setIsPointer(true);
         CVariable parameter(kProcessNetworkOutputParameterPrefix + tools::toString(id),
                             data_type);
         code += parameter.getInputParameterDeclarationString();
@@ -656,68 +1510,75 @@ string Synthesizer::generateProcessNetworkFunctionParameterListCode()
     return code;
 }
 
-string Synthesizer::generateInputsToSignalsCopyingCode()
+void Synthesizer::generateInputsToSignalsCopyingCode(CodeWriter& code,
+                                                     bool for_block, int stage)
     throw(InvalidModelException, RuntimeException) {
-    string code;
-
     list<Process::Interface*> inputs = processnetwork_->getInputs();
     list<Process::Interface*>::iterator it;
     int id;
     bool at_least_one = false;
     for (it = inputs.begin(), id = 1; it != inputs.end(); ++it, ++id) {
         Signal* signal = getSignalByInPort(dynamic_cast<Leaf::Port*>(*it));
-        logger_.logMessage(Logger::DEBUG, string("Analyzing signal ")
-                           + signal->toString() + "...");
+        LOG_DEBUG(logger_, string("Analyzing signal ")
+                  + signal->toString() + "...");
+        if (stage >= 0 && !isSignalInPipelineStage(signal, stage)) continue;
 
         CDataType data_type = *signal->getDataType();
         if (data_type.isArray()) continue;
-        at_least_one = true;
+        if (!at_least_one) {
+            code << kIndents << "// Copy processnetwork inputs to signal "
+                "variables\n";
+            at_least_one = true;
+        }
         CVariable input_parameter(
             kProcessNetworkInputParameterPrefix + tools::toString(id), data_type);
-        code += generateVariableCopyingCode(signal->getVariable(),
+        if (for_block) {
+            input_parameter = getBlockParameterTokenVariable(
+                input_parameter.getReferenceString(), data_type);
+        }
+        code << generateVariableCopyingCode(signal->getVariable(),
                                             input_parameter, false);
     }
-
-    if (at_least_one) {
-        code = kIndents + "// Copy processnetwork inputs to signal variables\n" + code;
-    }
-
-    return code;
 }
 
-string Synthesizer::generateSignalsToOutputsCopyingCode()
+void Synthesizer::generateSignalsToOutputsCopyingCode(CodeWriter& code,
+                                                      bool for_block,
+                                                      int stage)
     throw(InvalidModelException, RuntimeException) {
-    string code;
-
     list<Process::Interface*> outputs = processnetwork_->getOutputs();
     list<Process::Interface*>::iterator it;
     int id;
     bool at_least_one = false;
     for (it = outputs.begin(), id = 1; it != outputs.end(); ++it, ++id) {
         Signal* signal = getSignalByOutPort(dynamic_cast<Leaf::Port*>(*it));
-        logger_.logMessage(Logger::DEBUG, string("Analyzing signal ")
-                           + signal->toString() + "...");
+        LOG_DEBUG(logger_, string("Analyzing signal ")
+                  + signal->toString() + "...");
+        if (stage >= 0 && !isSignalInPipelineStage(signal, stage)) continue;
 
         CDataType data_type = *signal->getDataType();
         if (data_type.isArray()) continue;
-        at_least_one = true;
-        data_type.setIsPointer(true);
+        if (!at_least_one) {
+            code << kIndents << "// Copy signal variables to processnetwork "
+                "outputs\n";
+            at_least_one = true;
+        }
         CVariable output_parameter(
             kProcessNetworkOutputParameterPrefix + tools::toString(id), data_type);
-        code += generateVariableCopyingCode(output_parameter,
+        if (for_block) {
+            output_parameter = getBlockParameterTokenVariable(
+                output_parameter.getReferenceString(), data_type);
+        }
+        else {
+            output_parameter.getDataType()->setIsPointer(true);
+        }
+        code << generateVariableCopyingCode(output_parameter,
                                             signal->getVariable(), false);
     }
-
-    if (at_least_one) {
-        code = kIndents + "// Copy signal variables to processnetwork outputs\n" + code;
-    }
-
-    return code;
 }
 
-string Synthesizer::generateArrayInputOutputsToSignalsAliasingCode()
+void Synthesizer::generateArrayInputOutputsToSignalsAliasingCode(
+    CodeWriter& code, bool for_block, int stage)
     throw(InvalidModelException, RuntimeException) {
-    string code;
     bool at_least_one = false;
 
     // Iterate over the input parameters
@@ -726,15 +1587,24 @@ string Synthesizer::generateArrayInputOutputsToSignalsAliasingCode()
     int id;
     for (it = inputs.begin(), id = 1; it != inputs.end(); ++it, ++id) {
         Signal* signal = getSignalByInPort(dynamic_cast<Leaf::Port*>(*it));
-        logger_.logMessage(Logger::DEBUG, string("Analyzing signal ")
-                           + signal->toString() + "...");
+        LOG_DEBUG(logger_, string("Analyzing signal ")
+                  + signal->toString() + "...");
+        if (stage >= 0 && !isSignalInPipelineStage(signal, stage)) continue;
 
         CDataType data_type = *signal->getDataType();
         if (!data_type.isArray()) continue;
-        at_least_one = true;
+        if (!at_least_one) {
+            code << kIndents << "// Alias signal array variables with "
+                "processnetwork input/output arrays\n";
+            at_least_one = true;
+        }
         CVariable input_parameter(
             kProcessNetworkInputParameterPrefix + tools::toString(id), data_type);
-        code += generateVariableCopyingCode(signal->getVariable(),
+        if (for_block) {
+            input_parameter = getBlockParameterTokenVariable(
+                input_parameter.getReferenceString(), data_type);
+        }
+        code << generateVariableCopyingCode(signal->getVariable(),
                                             input_parameter, false);
     }
 
@@ -742,24 +1612,26 @@ string Synthesizer::generateArrayInputOutputsToSignalsAliasingCode()
     list<Process::Interface*> outputs = processnetwork_->getOutputs();
     for (it = outputs.begin(), id = 1; it != outputs.end(); ++it, ++id) {
         Signal* signal = getSignalByOutPort(dynamic_cast<Leaf::Port*>(*it));
-        logger_.logMessage(Logger::DEBUG, string("Analyzing signal ")
-                           + signal->toString() + "...");
+        LOG_DEBUG(logger_, string("Analyzing signal ")
+                  + signal->toString() + "...");
+        if (stage >= 0 && !isSignalInPipelineStage(signal, stage)) continue;
 
         CDataType data_type = *signal->getDataType();
         if (!data_type.isArray()) continue;
-        at_least_one = true;
+        if (!at_least_one) {
+            code << kIndents << "// Alias signal array variables with "
+                "processnetwork input/output arrays\n";
+            at_least_one = true;
+        }
         CVariable output_parameter(
             kProcessNetworkOutputParameterPrefix + tools::toString(id), data_type);
-        code += generateVariableCopyingCode(signal->getVariable(),
+        if (for_block) {
+            output_parameter = getBlockParameterTokenVariable(
+                output_parameter.getReferenceString(), data_type);
+        }
+        code << generateVariableCopyingCode(signal->getVariable(),
                                             output_parameter, false);
     }
-
-    if (at_least_one) {
-        code = kIndents + "// Alias signal array variables with processnetwork "
-            "input/output arrays\n" + code;
-    }
-
-    return code;
 }
 
 void Synthesizer::createSignals()
@@ -772,16 +1644,17 @@ void Synthesizer::createSignals()
             THROW_EXCEPTION(IllegalStateException, string("Leaf \"") +
                             it->getString() + "\" not found");
         }
-        logger_.logMessage(Logger::DEBUG, string("Analyzing leaf \"")
-                           + current_leaf->getId()->getString() + "\"...");
+        LOG_DEBUG(logger_, string("Analyzing leaf \"")
+                  + current_leaf->getId()->getString() + "\"...");
 
-        list<Leaf::Port*> ports = current_leaf->getInPorts();
-        list<Leaf::Port*>::iterator port_it;
-        for (port_it = ports.begin(); port_it != ports.end(); ++port_it) {
+        const Leaf::PortVector& in_ports = current_leaf->getInPortRange();
+        Leaf::PortVector::const_iterator port_it;
+        for (port_it = in_ports.begin(); port_it != in_ports.end(); ++port_it) {
             getSignalByInPort(*port_it);
         }
-        ports = current_leaf->getOutPorts();
-        for (port_it = ports.begin(); port_it != ports.end(); ++port_it) {
+        const Leaf::PortVector& out_ports = current_leaf->getOutPortRange();
+        for (port_it = out_ports.begin(); port_it != out_ports.end();
+             ++port_it) {
             getSignalByOutPort(*port_it);
         }
     }
@@ -801,15 +1674,15 @@ void Synthesizer::createDelayVariables() throw(IOException, RuntimeException) {
             THROW_EXCEPTION(IllegalStateException, string("Leaf \"") +
                             it->getString() + "\" not found");
         }
-        logger_.logMessage(Logger::DEBUG, string("Analyzing leaf \"")
-                           + current_leaf->getId()->getString() + "\"...");
+        LOG_DEBUG(logger_, string("Analyzing leaf \"")
+                  + current_leaf->getId()->getString() + "\"...");
 
         delay* delay_leaf = dynamic_cast<delay*>(current_leaf);
         if (delay_leaf) {
             string name = string("v_delay_element") + tools::toString(counter);
             ++counter;
             CDataType data_type =
-                *getSignalByInPort(delay_leaf->getInPorts().front())
+                *getSignalByInPort(delay_leaf->getInPortRange().front())
                 ->getDataType();
             CVariable variable(name, data_type);
             pair<CVariable, string> value(variable,
@@ -838,8 +1711,8 @@ void Synthesizer::setInputArraySignalVariableDataTypesAsConst()
         Signal* signal = getSignalByInPort(dynamic_cast<Leaf::Port*>(*it));
         CDataType data_type = *signal->getDataType();
         if (!data_type.isArray()) continue;
-        logger_.logMessage(Logger::DEBUG, string("Modifying data type for ")
-                           + "signal " + signal->toString() + "...");
+        LOG_DEBUG(logger_, string("Modifying data type for ")
+                  + "signal " + signal->toString() + "...");
         data_type.setIsConst(true);
         signal->setDataType(data_type);
     }
@@ -861,18 +1734,18 @@ void Synthesizer::discoverSignalDataTypes()
 
 CDataType Synthesizer::discoverSignalDataTypeForwardSearch(Signal* signal)
     throw(InvalidModelException, IOException, RuntimeException) {
-    logger_.logMessage(Logger::DEBUG, string("Searching data type for signal ")
-                       + signal->toString() + "...");
+    LOG_DEBUG(logger_, string("Searching data type for signal ")
+              + signal->toString() + "...");
 
     if (signal->hasDataType()) {
-        logger_.logMessage(Logger::DEBUG, string("Found data type \"")
-                           + signal->getVariable().getDataType()->toString()
-                           + "\"");
+        LOG_DEBUG(logger_, string("Found data type \"")
+                  + signal->getVariable().getDataType()->toString()
+                  + "\"");
         return *signal->getVariable().getDataType();
     }
 
     if (!signal->getInPort()) {
-        logger_.logMessage(Logger::DEBUG, "Reached end of network");
+        LOG_DEBUG(logger_, "Reached end of network");
         THROW_EXCEPTION(InvalidModelException, string("No data type for ")
                         + "signal " + signal->toString() + " could be found");
     }
@@ -889,8 +1762,8 @@ CDataType Synthesizer::discoverSignalDataTypeForwardSearch(Signal* signal)
     }
     else if (ZipWithNSY* zipwithnsy = dynamic_cast<ZipWithNSY*>(leaf)) {
         Leaf::Port* sought_port = signal->getInPort();
-        list<Leaf::Port*> in_ports = zipwithnsy->getInPorts();
-        list<Leaf::Port*>::iterator port_it;
+        const Leaf::PortVector& in_ports = zipwithnsy->getInPortRange();
+        Leaf::PortVector::const_iterator port_it;
         list<CVariable*> input_parameters =
             zipwithnsy->getFunction()->getInputParameters();
         list<CVariable*>::iterator param_it;
@@ -919,8 +1792,8 @@ CDataType Synthesizer::discoverSignalDataTypeForwardSearch(Signal* signal)
     }
     else {
         bool data_type_found = false;
-        list<Leaf::Port*> out_ports = leaf->getOutPorts();
-        for (list<Leaf::Port*>::iterator it = out_ports.begin(); 
+        const Leaf::PortVector& out_ports = leaf->getOutPortRange();
+        for (Leaf::PortVector::const_iterator it = out_ports.begin(); 
              it != out_ports.end(); ++it) {
             Signal* next_signal = getSignalByOutPort(*it);
             try {
@@ -951,25 +1824,25 @@ CDataType Synthesizer::discoverSignalDataTypeForwardSearch(Signal* signal)
     }
 
     signal->setDataType(data_type);
-    logger_.logMessage(Logger::DEBUG, string("Found data type \"")
-                       + data_type.toString() + "\"");
+    LOG_DEBUG(logger_, string("Found data type \"")
+              + data_type.toString() + "\"");
     return data_type;
 }
 
 CDataType Synthesizer::discoverSignalDataTypeBackwardSearch(Signal* signal)
     throw(InvalidModelException, IOException, RuntimeException) {
-    logger_.logMessage(Logger::DEBUG, string("Searching data type for signal ")
-                       + signal->toString() + "...");
+    LOG_DEBUG(logger_, string("Searching data type for signal ")
+              + signal->toString() + "...");
 
     if (signal->hasDataType()) {
-        logger_.logMessage(Logger::DEBUG, string("Found data type \"")
-                           + signal->getVariable().getDataType()->toString()
-                           + "\"");
+        LOG_DEBUG(logger_, string("Found data type \"")
+                  + signal->getVariable().getDataType()->toString()
+                  + "\"");
         return *signal->getVariable().getDataType();
     }
 
     if (!signal->getOutPort()) {
-        logger_.logMessage(Logger::DEBUG, "Reached end of network");
+        LOG_DEBUG(logger_, "Reached end of network");
         THROW_EXCEPTION(InvalidModelException, string("No data type for ")
                         + "signal " + signal->toString() + " could be found");
     }
@@ -1015,8 +1888,8 @@ CDataType Synthesizer::discoverSignalDataTypeBackwardSearch(Signal* signal)
     }
     else {
         bool data_type_found = false;
-        list<Leaf::Port*> in_ports = leaf->getInPorts();
-        for (list<Leaf::Port*>::iterator it = in_ports.begin(); 
+        const Leaf::PortVector& in_ports = leaf->getInPortRange();
+        for (Leaf::PortVector::const_iterator it = in_ports.begin(); 
              it != in_ports.end(); ++it) {
             Signal* prev_signal = getSignalByInPort(*it);
             try {
@@ -1047,8 +1920,8 @@ CDataType Synthesizer::discoverSignalDataTypeBackwardSearch(Signal* signal)
     }
 
     signal->setDataType(data_type);
-    logger_.logMessage(Logger::DEBUG, string("Found data type \"")
-                       + data_type.toString() + "\"");
+    LOG_DEBUG(logger_, string("Found data type \"")
+              + data_type.toString() + "\"");
     return data_type;
 }
 
@@ -1062,9 +1935,9 @@ void Synthesizer::propagateArraySizesBetweenSignals()
                             it->getString() + "\" not found");
         }
 
-        list<Leaf::Port*> ports = current_leaf->getInPorts();
-        list<Leaf::Port*>::iterator port_it;
-        for (port_it = ports.begin(); port_it != ports.end(); ++port_it) {
+        const Leaf::PortVector& in_ports = current_leaf->getInPortRange();
+        Leaf::PortVector::const_iterator port_it;
+        for (port_it = in_ports.begin(); port_it != in_ports.end(); ++port_it) {
             Signal* signal = getSignalByInPort(*port_it);
             try {
                 discoverSignalArraySizeBackwardSearch(signal);
@@ -1074,8 +1947,9 @@ void Synthesizer::propagateArraySizesBetweenSignals()
                 discoverSignalArraySizeForwardSearch(signal);
             }
         }
-        ports = current_leaf->getOutPorts();
-        for (port_it = ports.begin(); port_it != ports.end(); ++port_it) {
+        const Leaf::PortVector& out_ports = current_leaf->getOutPortRange();
+        for (port_it = out_ports.begin(); port_it != out_ports.end();
+             ++port_it) {
             Signal* signal = getSignalByOutPort(*port_it);
             try {
                 discoverSignalArraySizeForwardSearch(signal);
@@ -1090,18 +1964,18 @@ void Synthesizer::propagateArraySizesBetweenSignals()
 
 size_t Synthesizer::discoverSignalArraySizeForwardSearch(Signal* signal)
     throw(InvalidModelException, IOException, RuntimeException) {
-    logger_.logMessage(Logger::DEBUG, string("Searching array size for signal ")
-                       + signal->toString() + "...");
+    LOG_DEBUG(logger_, string("Searching array size for signal ")
+              + signal->toString() + "...");
 
     CDataType data_type = *signal->getVariable().getDataType();
     if (data_type.hasArraySize()) {
-        logger_.logMessage(Logger::DEBUG, string("Found array size ")
-                           + tools::toString(data_type.getArraySize()));
+        LOG_DEBUG(logger_, string("Found array size ")
+                  + tools::toString(data_type.getArraySize()));
         return data_type.getArraySize();
     }
 
     if (!signal->getInPort()) {
-        logger_.logMessage(Logger::DEBUG, "Reached end of network");        
+        LOG_DEBUG(logger_, "Reached end of network");        
         THROW_EXCEPTION(InvalidModelException, string("No array size for ")
                         + "signal " + signal->toString() + " could be found");
     }
@@ -1111,7 +1985,7 @@ size_t Synthesizer::discoverSignalArraySizeForwardSearch(Signal* signal)
     // an Unzipx, get the array size from a neighbouring signal
     size_t array_size = 0;
     Leaf* leaf = dynamic_cast<Leaf*>(signal->getInPort()->getProcess());
-    list<Leaf::Port*> out_ports = leaf->getOutPorts();
+    const Leaf::PortVector& out_ports = leaf->getOutPortRange();
     if (out_ports.size() == 0) {
         THROW_EXCEPTION(IllegalStateException, string("Leaf \"")
                         + leaf->getId()->getString() + "\" does not "
@@ -1119,9 +1993,9 @@ size_t Synthesizer::discoverSignalArraySizeForwardSearch(Signal* signal)
     }
     try {
         if (dynamic_cast<Unzipx*>(leaf)) {
-            logger_.logMessage(Logger::DEBUG, "Found Unzipx leaf. Summing "
-                               "up array sizes from its out ports...");
-            list<Leaf::Port*>::iterator it;
+            LOG_DEBUG(logger_, "Found Unzipx leaf. Summing "
+                      "up array sizes from its out ports...");
+            Leaf::PortVector::const_iterator it;
             for (it = out_ports.begin(); it != out_ports.end(); ++it) {
                 Signal* next_signal = getSignalByOutPort(*it);
                 array_size += discoverSignalArraySizeForwardSearch(next_signal);
@@ -1140,25 +2014,25 @@ size_t Synthesizer::discoverSignalArraySizeForwardSearch(Signal* signal)
     }
     data_type.setArraySize(array_size);
     signal->setDataType(data_type);
-    logger_.logMessage(Logger::DEBUG, string("Found array size ")
-                       + tools::toString(data_type.getArraySize()));
+    LOG_DEBUG(logger_, string("Found array size ")
+              + tools::toString(data_type.getArraySize()));
     return array_size;
 }
 
 size_t Synthesizer::discoverSignalArraySizeBackwardSearch(Signal* signal)
         throw(InvalidModelException, IOException, RuntimeException) {
-    logger_.logMessage(Logger::DEBUG, string("Searching array size for signal ")
-                       + signal->toString() + "...");
+    LOG_DEBUG(logger_, string("Searching array size for signal ")
+              + signal->toString() + "...");
 
     CDataType data_type = *signal->getVariable().getDataType();
     if (data_type.hasArraySize()) {
-        logger_.logMessage(Logger::DEBUG, string("Found array size ")
-                           + tools::toString(data_type.getArraySize()));
+        LOG_DEBUG(logger_, string("Found array size ")
+                  + tools::toString(data_type.getArraySize()));
         return data_type.getArraySize();
     }
 
     if (!signal->getOutPort()) {
-        logger_.logMessage(Logger::DEBUG, "Reached end of network");        
+        LOG_DEBUG(logger_, "Reached end of network");        
         THROW_EXCEPTION(InvalidModelException, string("No array size for ")
                         + "signal " + signal->toString() + " could be found");
     }
@@ -1168,7 +2042,7 @@ size_t Synthesizer::discoverSignalArraySizeBackwardSearch(Signal* signal)
     // a Zipx, get the array size from a neighbouring signal
     size_t array_size = 0;
     Leaf* leaf = dynamic_cast<Leaf*>(signal->getOutPort()->getProcess());
-    list<Leaf::Port*> in_ports = leaf->getInPorts();
+    const Leaf::PortVector& in_ports = leaf->getInPortRange();
     if (in_ports.size() == 0) {
         THROW_EXCEPTION(IllegalStateException, string("Leaf \"")
                         + leaf->getId()->getString() + "\" does not "
@@ -1176,9 +2050,9 @@ size_t Synthesizer::discoverSignalArraySizeBackwardSearch(Signal* signal)
     }
     try {
         if (dynamic_cast<Zipx*>(leaf)) {
-            logger_.logMessage(Logger::DEBUG, "Found Zipx leaf. Summing "
-                               "up array sizes from its in ports...");
-            list<Leaf::Port*>::iterator it;
+            LOG_DEBUG(logger_, "Found Zipx leaf. Summing "
+                      "up array sizes from its in ports...");
+            Leaf::PortVector::const_iterator it;
             for (it = in_ports.begin(); it != in_ports.end(); ++it) {
                 Signal* next_signal = getSignalByInPort(*it);
                 array_size +=
@@ -1198,8 +2072,8 @@ size_t Synthesizer::discoverSignalArraySizeBackwardSearch(Signal* signal)
     }
     data_type.setArraySize(array_size);
     signal->setDataType(data_type);
-    logger_.logMessage(Logger::DEBUG, string("Found array size ")
-                       + tools::toString(data_type.getArraySize()));
+    LOG_DEBUG(logger_, string("Found array size ")
+              + tools::toString(data_type.getArraySize()));
     return array_size;
 }
 
@@ -1210,61 +2084,124 @@ void Synthesizer::propagateSignalArraySizesToLeafFunctions()
                        "propagation not implemented");
 }
 
-string Synthesizer::generateSignalVariableDeclarationsCode()
+void Synthesizer::generateSignalVariableDeclarationsCode(CodeWriter& code,
+                                                         int stage)
     throw(InvalidModelException, IOException, RuntimeException) {
     try {
-        string code;
-        code += kIndents + "// Declare signal variables\n";
+        code << kIndents << "// Declare signal variables\n";
+        map<int, size_t>::iterator arena_it = signal_arena_sizes_.find(stage);
+        if (arena_it != signal_arena_sizes_.end()) {
+            size_t alignment = kSignalArenaAlignment;
+            string base_name = kSignalArenaVariableName + "_base";
+            if (config_.doReentrantCode()) {
+                code << kIndents << "char* " << base_name << " = "
+                    << kStateParameterName << "->"
+                    << getSignalArenaMemberName(stage) << ";\n";
+            }
+            else if (hasStaticState()) {
+                code << kIndents << "static char " << base_name << "["
+                    << arena_it->second + alignment - 1 << "];\n";
+            }
+            else {
+                code << kIndents << "char* " << base_name << " = new char["
+                    << arena_it->second + alignment - 1 << "];\n";
+            }
+            code << kIndents << "char* " << kSignalArenaVariableName << " = "
+                << base_name << " + (" << alignment << " - (size_t) "
+                << base_name << " % " << alignment << ") % " << alignment
+                << ";\n";
+        }
         set<Signal*>::iterator it;
         for (it = signals_.begin(); it != signals_.end(); ++it) {
             Signal* signal = *it;
-            logger_.logMessage(Logger::DEBUG, string("Generating variable ")
-                               + "declaration for signal "
-                               + signal->toString() + "...");
+            if (stage >= 0 && !isSignalInPipelineStage(signal, stage)) {
+                continue;
+            }
+            LOG_DEBUG(logger_, string("Generating variable ")
+                      + "declaration for signal "
+                      + signal->toString() + "...");
 
-            code += kIndents;
+            code << kIndents;
             if (signal->getVariable().getDataType()->isArray()) {
-                if (dynamicallyAllocateMemoryForSignalVariable(signal)) {
-                    code += signal->getVariable()
+                if (isSignalInArena(signal, stage)) {
+                    CVariable variable = signal->getVariable();
+                    size_t offset = signal_arena_offsets_.find(
+                        pair<int, Signal*>(stage, signal))->second;
+                    code << variable.getPointerDeclarationString() << " = ("
+                        << variable.getDataType()
+                        ->getInputParameterDataTypeString() << ") ("
+                        << kSignalArenaVariableName << " + " << offset << ")";
+                }
+                else if (dynamicallyAllocateMemoryForSignalVariable(signal)) {
+                    code << signal->getVariable()
                         .getDynamicVariableDeclarationString();
                 }
                 else {
-                    code += signal->getVariable()
+                    code << signal->getVariable()
                         .getPointerDeclarationString();
                 }
             }
             else {
-                code += signal->getVariable()
+                code << signal->getVariable()
                     .getLocalVariableDeclarationString();
             }
-            code += ";\n";
+            code << ";\n";
         }
-        return code;
     }
     catch (UnknownArraySizeException& ex) {
         THROW_EXCEPTION(InvalidModelException, ex.getMessage());
     }
 }
 
-string Synthesizer::generateDelayVariableDeclarationsCode()
+void Synthesizer::generateDelayVariableDeclarationsCode(CodeWriter& code,
+                                                        int stage)
     throw(InvalidModelException, IOException, RuntimeException) {
     try {
-        string code;
-        if (delay_variables_.size() > 0) {
-            code += kIndents + "// Declare delay variables\n";
-        }
+        if (config_.doReentrantCode()) return;
+        bool at_least_one = false;
         map< delay*, pair<CVariable, std::string> >::iterator it;
         for (it = delay_variables_.begin(); it != delay_variables_.end();
              ++it) {
+            if (stage >= 0 && getPipelineStage(it->first) != stage) continue;
+            if (getDelayRing(it->first)) continue;
             CVariable variable = it->second.first;
             string initial_value = it->second.second;
-            code += kIndents + "static ";
-            code += variable.getLocalVariableDeclarationString();
-            code += " = ";
-            code += initial_value;
-            code += ";\n";
+            if (!at_least_one) {
+                code << kIndents << "// Declare delay variables\n";
+                at_least_one = true;
+            }
+            code << kIndents << "static ";
+            code << variable.getLocalVariableDeclarationString();
+            code << " = ";
+            code << initial_value;
+            code << ";\n";
+        }
+        list< vector<delay*> >::iterator ring_it;
+        for (ring_it = delay_rings_.begin(); ring_it != delay_rings_.end();
+             ++ring_it) {
+            if (stage >= 0 && getPipelineStage(ring_it->front()) != stage) {
+                continue;
+            }
+            size_t num_buffers = ring_it->size() + 1;
+            vector<string> initial_values(num_buffers, "{0}");
+            for (size_t k = 1; k < num_buffers; ++k) {
+                initial_values[num_buffers - k] =
+                    delay_variables_[(*ring_it)[k - 1]].second;
+            }
+            if (!at_least_one) {
+                code << kIndents << "// Declare delay variables\n";
+                at_least_one = true;
+            }
+            code << kIndents << "static "
+                << getDelayRingDeclarationString(*ring_it) << " = {";
+            for (size_t k = 0; k < num_buffers; ++k) {
+                if (k > 0) code << ", ";
+                code << initial_values[k];
+            }
+            code << "};\n";
+            code << kIndents << "static int " << getDelayRingName(*ring_it)
+                << "_position = 0;\n";
         }
-        return code;
     }
     catch (UnknownArraySizeException& ex) {
         THROW_EXCEPTION(InvalidModelException, ex.getMessage());
@@ -1280,6 +2217,12 @@ pair<CVariable, string> Synthesizer::getDelayVariable(delay* leaf)
     map< delay*, pair<CVariable, string> >::iterator it = 
         delay_variables_.find(leaf);
     if (it != delay_variables_.end()) {
+        if (config_.doReentrantCode()) {
+            CVariable member(kStateParameterName + "->"
+                             + it->second.first.getReferenceString(),
+                             *it->second.first.getDataType());
+            return pair<CVariable, string>(member, it->second.second);
+        }
         return it->second;
     }
     else {
@@ -1289,24 +2232,184 @@ pair<CVariable, string> Synthesizer::getDelayVariable(delay* leaf)
     }
 }
 
-string Synthesizer::generateSignalVariableCleanupCode()
-    throw(IOException, RuntimeException) {
-    string code;
-    set<Signal*>::iterator it;
-    bool at_least_one = false;
-    for (it = signals_.begin(); it != signals_.end(); ++it) {
-        Signal* signal = *it;
-        logger_.logMessage(Logger::DEBUG, string("Analyzing signal ")
-                           + signal->toString() + "...");
-
-        if (dynamicallyAllocateMemoryForSignalVariable(signal)) {
-            at_least_one = true;
-            code += kIndents + "delete[] "
-                + signal->getVariable().getReferenceString() + ";\n";
+void Synthesizer::generateStateStructDefinitionCode(CodeWriter& code)
+    throw(InvalidModelException, IOException, RuntimeException) {
+    try {
+        code << "/**\n"
+            << " * C struct for the delay state of one instance of the\n"
+            << " * processnetwork. The struct is owned by the caller and must "
+            "be\n"
+            << " * initialized with init" << kStateStructName
+            << "() before use.\n"
+            << " */\n";
+        code << "struct " << kStateStructName << " {\n";
+        map< delay*, pair<CVariable, std::string> >::iterator it;
+        for (it = delay_variables_.begin(); it != delay_variables_.end();
+             ++it) {
+            if (getDelayRing(it->first)) continue;
+            code << kIndents
+                << it->second.first.getLocalVariableDeclarationString()
+                << ";\n";
         }
+        list< vector<delay*> >::iterator ring_it;
+        for (ring_it = delay_rings_.begin(); ring_it != delay_rings_.end();
+             ++ring_it) {
+            code << kIndents << getDelayRingDeclarationString(*ring_it)
+                << ";\n";
+            code << kIndents << "int "
+                << delay_variables_[ring_it->front()].first.getReferenceString()
+                << "_ring_position;\n";
+        }
+        map<int, size_t>::iterator arena_it;
+        for (arena_it = signal_arena_sizes_.begin();
+             arena_it != signal_arena_sizes_.end(); ++arena_it) {
+            code << kIndents << "char "
+                << getSignalArenaMemberName(arena_it->first) << "["
+                << arena_it->second + kSignalArenaAlignment - 1 << "];\n";
+        }
+        if (hasThreadPool()) {
+            code << kIndents << "struct " << getThreadPoolStructName() << "* "
+                << kThreadPoolVariableName << ";\n";
+        }
+        else if (delay_variables_.size() == 0
+                 && signal_arena_sizes_.size() == 0) {
+            code << kIndents << "char unused; // The processnetwork has no "
+                "state\n";
+        }
+        code << "};\n";
+    }
+    catch (UnknownArraySizeException& ex) {
+        THROW_EXCEPTION(InvalidModelException, ex.getMessage());
+    }
+}
+
+void Synthesizer::generateStateFunctionPrototypesCode(CodeWriter& code)
+    throw() {
+    code << "/**\n"
+        << " * Initializes the state of a processnetwork instance by setting\n"
+        << " * every delay to its initial value.\n"
+        << " *\n"
+        << " * @param " << kStateParameterName << "\n"
+        << " *        State to initialize.\n"
+        << " */\n";
+    code << "void init" << kStateStructName << "("
+        << getStateParameterDeclarationString() << ");\n";
+    code << "\n";
+    code << "/**\n"
+        << " * Resets the state of a processnetwork instance to the state it\n"
+        << " * had right after initialization.\n";
+    if (hasThreadPool()) {
+        code << " * Its threads are stopped, see stopProcessNetworkThreads().\n";
+    }
+    code << " *\n"
+        << " * @param " << kStateParameterName << "\n"
+        << " *        State to reset.\n"
+        << " */\n";
+    code << "void reset" << kStateStructName << "("
+        << getStateParameterDeclarationString() << ");\n";
+}
+
+void Synthesizer::generateStateFunctionDefinitionsCode(CodeWriter& code)
+    throw(InvalidModelException, IOException, RuntimeException) {
+    try {
+        code << "void init" << kStateStructName << "("
+            << getStateParameterDeclarationString() << ") {\n";
+        code << kIndents << "int i; // Can safely be removed if the compiler "
+            "warns\n"
+            << kIndents << "       // about it being unused\n";
+        map< delay*, pair<CVariable, std::string> >::iterator it;
+        for (it = delay_variables_.begin(); it != delay_variables_.end();
+             ++it) {
+            CVariable member = getDelayVariable(it->first).first;
+            string initial_value = it->second.second;
+
+            // Delay variables in a delay ring are initialized in the ring
+            // buffer which is output by the delay leaf at the first invocation
+            const vector<delay*>* ring = getDelayRing(it->first);
+            if (ring) {
+                size_t k = 1;
+                while ((*ring)[k - 1] != it->first) ++k;
+                member = CVariable(getDelayRingName(*ring) + "["
+                                   + tools::toString(ring->size() + 1 - k)
+                                   + "]", *member.getDataType());
+            }
+
+            if (member.getDataType()->isArray()) {
+                CDataType data_type = *member.getDataType();
+                data_type.setIsConst(true);
+                CVariable initial_variable(
+                    it->second.first.getReferenceString() + "_initial",
+                    data_type);
+                code << kIndents << "static "
+                    << initial_variable.getLocalVariableDeclarationString()
+                    << " = " << initial_value << ";\n";
+                code << generateVariableCopyingCode(member, initial_variable);
+            }
+            else {
+                code << kIndents << member.getReferenceString() << " = "
+                    << initial_value << ";\n";
+            }
+        }
+        list< vector<delay*> >::iterator ring_it;
+        for (ring_it = delay_rings_.begin(); ring_it != delay_rings_.end();
+             ++ring_it) {
+            code << kIndents << getDelayRingName(*ring_it)
+                << "_position = 0;\n";
+        }
+        if (hasThreadPool()) {
+            code << kIndents << getThreadPoolReferenceString() << " = NULL;\n";
+        }
+        code << "}\n";
+        code << "\n";
+        code << "void reset" << kStateStructName << "("
+            << getStateParameterDeclarationString() << ") {\n";
+        if (hasThreadPool()) {
+            code << kIndents << "stopProcessNetworkThreads("
+                << kStateParameterName << ");\n";
+        }
+        code << kIndents << "init" << kStateStructName << "("
+            << kStateParameterName << ");\n";
+        code << "}\n";
+    }
+    catch (UnknownArraySizeException& ex) {
+        THROW_EXCEPTION(InvalidModelException, ex.getMessage());
+    }
+}
+
+string Synthesizer::getStateParameterDeclarationString() const throw() {
+    return string("struct ") + kStateStructName + "* " + kStateParameterName;
+}
+
+void Synthesizer::generateSignalVariableCleanupCode(CodeWriter& code,
+                                                    int stage)
+    throw(IOException, RuntimeException) {
+    set<Signal*>::iterator it;
+    bool at_least_one = false;
+    for (it = signals_.begin(); it != signals_.end(); ++it) {
+        Signal* signal = *it;
+        LOG_DEBUG(logger_, string("Analyzing signal ")
+                  + signal->toString() + "...");
+        if (stage >= 0 && !isSignalInPipelineStage(signal, stage)) continue;
+
+        if (dynamicallyAllocateMemoryForSignalVariable(signal)
+            && !isSignalInArena(signal, stage)) {
+            if (!at_least_one) {
+                code << kIndents << "// Clean up memory\n";
+                at_least_one = true;
+            }
+            code << kIndents << "delete[] "
+                << signal->getVariable().getReferenceString() << ";\n";
+        }
+    }
+    if (signal_arena_sizes_.find(stage) != signal_arena_sizes_.end()
+        && !config_.doReentrantCode() && !hasStaticState()) {
+        if (!at_least_one) {
+            code << kIndents << "// Clean up memory\n";
+            at_least_one = true;
+        }
+        code << kIndents << "delete[] " << kSignalArenaVariableName
+            << "_base;\n";
     }
-    if (at_least_one) code = kIndents + "// Clean up memory\n" + code;
-    return code;
 }
 
 string Synthesizer::scheduleToString() const throw() {
@@ -1319,11 +2422,30 @@ string Synthesizer::scheduleToString() const throw() {
     return str;
 }
         
+CVariable Synthesizer::getBlockParameterTokenVariable(const string& name,
+                                                      CDataType data_type)
+    const throw(InvalidModelException) {
+    data_type.setIsPointer(false);
+    if (data_type.isArray()) {
+        if (!data_type.hasArraySize()) {
+            THROW_EXCEPTION(InvalidModelException, string("Size not known ")
+                            + "for array parameter \"" + name + "\"");
+        }
+        return CVariable(string("&") + name + "[" + kBlockTokenVariableName
+                         + " * " + tools::toString(data_type.getArraySize())
+                         + "]", data_type);
+    }
+    else {
+        return CVariable(name + "[" + kBlockTokenVariableName + "]",
+                         data_type);
+    }
+}
+
 string Synthesizer::generateLeafExecutionCode(Leaf* leaf)
     throw(InvalidModelException, IOException, RuntimeException) {
-    logger_.logMessage(Logger::DEBUG, string("Generating execution code for ")
-                       + "leaf \"" + leaf->getId()->getString()
-                       + "\"...");
+    LOG_DEBUG(logger_, string("Generating execution code for ")
+              + "leaf \"" + leaf->getId()->getString()
+              + "\"...");
 
     string code;
     if (dynamic_cast<delay*>(leaf)) {
@@ -1363,8 +2485,8 @@ void Synthesizer::generateCudaKernelFunctions()
             THROW_EXCEPTION(IllegalStateException, string("Leaf \"") +
                             it->getString() + "\" not found");
         }
-        logger_.logMessage(Logger::DEBUG, string("Analyzing leaf \"")
-                           + current_leaf->getId()->getString() + "\"...");
+        LOG_DEBUG(logger_, string("Analyzing leaf \"")
+                  + current_leaf->getId()->getString() + "\"...");
 
         ParallelMap* parmapsy = dynamic_cast<ParallelMap*>(current_leaf);
         if (parmapsy) {
@@ -1753,8 +2875,8 @@ void Synthesizer::generateParallelMapSyWrapperFunctions()
             THROW_EXCEPTION(IllegalStateException, string("Leaf \"") +
                             it->getString() + "\" not found");
         }
-        logger_.logMessage(Logger::DEBUG, string("Analyzing leaf \"")
-                           + current_leaf->getId()->getString() + "\"...");
+        LOG_DEBUG(logger_, string("Analyzing leaf \"")
+                  + current_leaf->getId()->getString() + "\"...");
 
         ParallelMap* parmapsy = dynamic_cast<ParallelMap*>(current_leaf);
         if (parmapsy) {
@@ -1766,6 +2888,13 @@ void Synthesizer::generateParallelMapSyWrapperFunctions()
                 wrapper_function.setName(getGlobalLeafFunctionName(
                                              *parmapsy->getId(),
                                              wrapper_function.getName()));
+                if (target_platform_ == C_MULTICORE) {
+                    CFunction worker_function =
+                        generateParallelMapSyWorkerFunction(
+                            &wrapper_function,
+                            parmapsy->getFunctions().front());
+                    parmapsy->insertFunctionFirst(worker_function);
+                }
                 parmapsy->insertFunctionFirst(wrapper_function);
             }
             catch (InvalidModelException& ex) {
@@ -1851,42 +2980,1548 @@ CFunction Synthesizer::generateParallelMapSyWrapperFunction(CFunction* function,
 
     // Create body
     string new_body = string("{\n");
-    new_body += kIndents + "int i;\n"
-        + kIndents + "for (i = 0; i < " + tools::toString(num_leafs)
-        + "; ++i) {\n";
-    if (old_parameters.size() == 1) {
-        new_body += kIndents + kIndents + output_param_name + "[i] = "
-            + function->getName() + "(";
-        if (old_input_param_data_type.getArraySize() > 0) {
-            new_body += "&" + input_param_name + "[i * "
-                + tools::toString(old_input_param_data_type.getArraySize())
-                + "]";
+    if (target_platform_ == C_MULTICORE) {
+        new_body += generateParallelMapSyMulticoreLoopCode(function, num_leafs,
+                                                           input_param_name,
+                                                           output_param_name);
+    }
+    else {
+        new_body += kIndents + "int i;\n"
+            + kIndents + "for (i = 0; i < " + tools::toString(num_leafs)
+            + "; ++i) {\n"
+            + kIndents + kIndents
+            + generateParallelMapSyFunctionCallCode(function, input_param_name,
+                                                    output_param_name)
+            + "\n"
+            + kIndents + "}\n";
+    }
+    new_body += "}";
+
+    return CFunction(new_name, new_return_type, new_parameters, new_body);
+}
+
+string Synthesizer::generateParallelMapSyMulticoreLoopCode(
+    CFunction* function, size_t num_leafs, const string& input_param_name,
+    const string& output_param_name)
+    throw(InvalidModelException, IOException, RuntimeException) {
+    string num_leafs_str = tools::toString(num_leafs);
+    string call_code = generateParallelMapSyFunctionCallCode(function,
+                                                             input_param_name,
+                                                             output_param_name);
+    string schedule = config_.getParallelSchedule();
+    if (config_.getParallelChunkSize() > 0 && schedule != "auto"
+        && schedule != "runtime") {
+        schedule += string(", ")
+            + tools::toString(config_.getParallelChunkSize());
+    }
+    string worker_name = getParallelMapSyWorkerFunctionName(function);
+
+    string code;
+    code += kIndents + "int i;\n"
+        + "#ifdef _OPENMP\n"
+        + kIndents + "#pragma omp parallel for schedule(" + schedule + ")\n"
+        + kIndents + "for (i = 0; i < " + num_leafs_str + "; ++i) {\n"
+        + kIndents + kIndents + call_code + "\n"
+        + kIndents + "}\n"
+        + "#else\n"
+        + kIndents + "pthread_t threads[F2CC_MAX_NUM_THREADS];\n"
+        + kIndents + "int is_thread_started[F2CC_MAX_NUM_THREADS];\n"
+        + kIndents + "struct ParallelMapRange ranges[F2CC_MAX_NUM_THREADS];\n"
+        + kIndents + "int num_threads = (int) sysconf(_SC_NPROCESSORS_ONLN);\n"
+        + kIndents + "if (num_threads > " + num_leafs_str + ") num_threads = "
+        + num_leafs_str + ";\n"
+        + kIndents + "if (num_threads > F2CC_MAX_NUM_THREADS) {\n"
+        + kIndents + kIndents + "num_threads = F2CC_MAX_NUM_THREADS;\n"
+        + kIndents + "}\n"
+        + kIndents + "if (num_threads < 1) num_threads = 1;\n"
+        + kIndents + "for (i = 0; i < num_threads; ++i) {\n"
+        + kIndents + kIndents + "ranges[i].input = " + input_param_name
+        + ";\n"
+        + kIndents + kIndents + "ranges[i].output = " + output_param_name
+        + ";\n"
+        + kIndents + kIndents + "ranges[i].begin = i * " + num_leafs_str
+        + " / num_threads;\n"
+        + kIndents + kIndents + "ranges[i].end = (i + 1) * " + num_leafs_str
+        + " / num_threads;\n"
+        + kIndents + "}\n"
+        + kIndents + "// The last range is executed by the calling thread\n"
+        + kIndents + "for (i = 0; i < num_threads - 1; ++i) {\n"
+        + kIndents + kIndents + "is_thread_started[i] = pthread_create("
+        + "&threads[i], NULL, " + worker_name + ", &ranges[i]) == 0;\n"
+        + kIndents + kIndents + "if (!is_thread_started[i]) " + worker_name
+        + "(&ranges[i]);\n"
+        + kIndents + "}\n"
+        + kIndents + worker_name + "(&ranges[num_threads - 1]);\n"
+        + kIndents + "for (i = 0; i < num_threads - 1; ++i) {\n"
+        + kIndents + kIndents + "if (is_thread_started[i]) "
+        + "pthread_join(threads[i], NULL);\n"
+        + kIndents + "}\n"
+        + "#endif\n";
+    return code;
+}
+
+CFunction Synthesizer::generateParallelMapSyWorkerFunction(
+    CFunction* wrapper, CFunction* function)
+    throw(InvalidModelException, IOException, RuntimeException) {
+    list<CVariable*> wrapper_parameters = wrapper->getInputParameters();
+    if (wrapper_parameters.size() != 2) {
+        THROW_EXCEPTION(IllegalStateException, "Wrapper function has "
+                        "unexpected number of input parameters");
+    }
+    CVariable input_param = *wrapper_parameters.front();
+    CVariable output_param = *wrapper_parameters.back();
+    string input_type = input_param.getDataType()
+        ->getInputParameterDataTypeString();
+    string output_type = output_param.getDataType()
+        ->getInputParameterDataTypeString();
+
+    // Both the return type and the parameter are of type 'void*', as expected
+    // by pthread_create()
+    string new_name = getParallelMapSyWorkerFunctionName(function);
+    CDataType new_return_type(CDataType::VOID, false, false, 0, false, false);
+    new_return_type.setIsPointer(true);
+    list<CVariable> new_parameters;
+    new_parameters.push_back(CVariable("arg", new_return_type));
+
+    string new_body = string("{\n")
+        + kIndents + "struct ParallelMapRange* range = "
+        + "(struct ParallelMapRange*) arg;\n"
+        + kIndents + input_type + " " + input_param.getReferenceString()
+        + " = (" + input_type + ") range->input;\n"
+        + kIndents + output_type + " " + output_param.getReferenceString()
+        + " = (" + output_type + ") range->output;\n"
+        + kIndents + "int i;\n"
+        + kIndents + "for (i = range->begin; i < range->end; ++i) {\n"
+        + kIndents + kIndents
+        + generateParallelMapSyFunctionCallCode(
+            function, input_param.getReferenceString(),
+            output_param.getReferenceString())
+        + "\n"
+        + kIndents + "}\n"
+        + kIndents + "return NULL;\n"
+        + "}";
+
+    return CFunction(new_name, new_return_type, new_parameters, new_body);
+}
+
+string Synthesizer::getParallelMapSyWorkerFunctionName(CFunction* function)
+    const throw() {
+    return function->getName() + "_worker";
+}
+
+string Synthesizer::generateParallelMapSyFunctionCallCode(
+    CFunction* function, const string& input_param_name,
+    const string& output_param_name) throw() {
+    list<CVariable*> parameters = function->getInputParameters();
+    CDataType input_data_type = *parameters.front()->getDataType();
+    string input_arg;
+    if (input_data_type.isArray()) {
+        input_arg = "&" + input_param_name + "[i * "
+            + tools::toString(input_data_type.getArraySize()) + "]";
+    }
+    else {
+        input_arg = input_param_name + "[i]";
+    }
+
+    string code;
+    if (parameters.size() == 1) {
+        code += output_param_name + "[i] = " + function->getName() + "("
+            + input_arg + ");";
+    }
+    else {
+        CDataType output_data_type = *parameters.back()->getDataType();
+        code += function->getName() + "(" + input_arg + ", &"
+            + output_param_name + "[i * "
+            + tools::toString(output_data_type.getArraySize()) + "]);";
+    }
+    return code;
+}
+
+void Synthesizer::generateParallelMapRangeStructDefinitionCode(
+    CodeWriter& code)
+    throw(InvalidModelException, IOException, RuntimeException) {
+    code << "#ifndef _OPENMP\n"
+        << "#include <pthread.h>\n"
+        << "#include <unistd.h>\n"
+        << "#endif\n"
+        << "#include <stddef.h>\n"
+        << "\n"
+        << "/**\n"
+        << " * Maximum number of threads used for executing a data parallel\n"
+        << " * leaf when the code is compiled without OpenMP support.\n"
+        << " */\n"
+        << "#define F2CC_MAX_NUM_THREADS 64\n"
+        << "\n";
+    code << "/**\n"
+        << " * C struct for passing the range of array elements to process to\n"
+        << " * the worker function of a data parallel leaf.\n"
+        << " */\n";
+    code << "struct ParallelMapRange {\n"
+        << kIndents << "const void* input;\n"
+        << kIndents << "void* output;\n"
+        << kIndents << "int begin;\n"
+        << kIndents << "int end;\n"
+        << "};\n";
+}
+
+void Synthesizer::findPipelineStages()
+    throw(InvalidModelException, IOException, RuntimeException) {
+    pipeline_stages_.clear();
+
+    // Only leafs other than delay leafs are considered when splitting the
+    // schedule; the delay leafs are placed afterwards
+    vector<Leaf*> leafs;
+    map<const Process*, size_t> positions;
+    list<delay*> delays;
+    for (list<Id>::iterator it = schedule_.begin(); it != schedule_.end();
+         ++it) {
+        Leaf* current_leaf = processnetwork_->getProcess(*it);
+        if (!current_leaf) {
+            THROW_EXCEPTION(IllegalStateException, string("Leaf \"") +
+                            it->getString() + "\" not found");
+        }
+        if (delay* delaysy = dynamic_cast<delay*>(current_leaf)) {
+            delays.push_back(delaysy);
         }
         else {
-            new_body += input_param_name + "[i]";
+            positions[current_leaf] = leafs.size();
+            leafs.push_back(current_leaf);
         }
-        new_body += ");\n";
     }
-    else {
-        new_body += kIndents + kIndents + function->getName() + "(";
-        if (old_input_param_data_type.getArraySize() > 0) {
-            new_body += "&" + input_param_name + "[i * "
-                + tools::toString(old_input_param_data_type.getArraySize())
-                + "]";
+
+    // The schedule may place the consumer of a delay leaf's output before
+    // the producer of its input even if the delay leaf is not part of a
+    // feedback loop. Such delay leafs are therefore turned into dependencies,
+    // and the leafs reordered accordingly, before the stages are formed
+    vector< set<size_t> > dependencies(leafs.size());
+    for (size_t i = 0; i < leafs.size(); ++i) {
+        const Leaf::PortVector& in_ports = leafs[i]->getInPortRange();
+        Leaf::PortVector::const_iterator port_it;
+        for (port_it = in_ports.begin(); port_it != in_ports.end();
+             ++port_it) {
+            Leaf::Port* out_port = getSignalByInPort(*port_it)->getOutPort();
+            if (!out_port) continue;
+            map<const Process*, size_t>::iterator pos_it =
+                positions.find(out_port->getProcess());
+            if (pos_it == positions.end()) continue;
+            dependencies[i].insert(pos_it->second);
+        }
+    }
+    list< pair<Process*, Process*> > feedback_delays;
+    list<delay*>::iterator delay_it;
+    for (delay_it = delays.begin(); delay_it != delays.end(); ++delay_it) {
+        Process* producer = getDelayInputProducer(*delay_it);
+        Leaf::Port* consumer_port =
+            getSignalByOutPort((*delay_it)->getOutPortRange().front())
+            ->getInPort();
+        if (!producer || !consumer_port) continue;
+        Process* consumer = consumer_port->getProcess();
+        if (dynamic_cast<delay*>(consumer)) continue;
+        if (isProcessReachable(consumer, producer)) {
+            feedback_delays.push_back(pair<Process*, Process*>(producer,
+                                                               consumer));
         }
         else {
-            new_body += input_param_name + "[i]";
+            dependencies[positions[consumer]].insert(positions[producer]);
+        }
+    }
+    orderLeafsByDependencies(leafs, dependencies);
+    for (size_t i = 0; i < leafs.size(); ++i) positions[leafs[i]] = i;
+
+    // A delay leaf which is part of a feedback loop must not be split from
+    // the rest of the loop, as the data would then have to flow backwards
+    // through the pipeline
+    vector<bool> is_split_allowed(leafs.size(), true);
+    list< pair<Process*, Process*> >::iterator loop_it;
+    for (loop_it = feedback_delays.begin(); loop_it != feedback_delays.end();
+         ++loop_it) {
+        for (size_t i = positions[loop_it->second] + 1;
+             i <= positions[loop_it->first]; ++i) {
+            is_split_allowed[i] = false;
         }
-        CDataType old_output_param_data_type =
-            *old_parameters.back()->getDataType();
-        new_body += ", &" + output_param_name + "[i * "
-                + tools::toString(old_output_param_data_type.getArraySize())
-                + "]);\n";
     }
-    new_body += kIndents + "}\n"
-        + "}";
 
-    return CFunction(new_name, new_return_type, new_parameters, new_body);
+    // Group the leafs into units which cannot be split
+    vector<int> unit_costs;
+    int max_unit_cost = 0;
+    int total_cost = 0;
+    for (size_t i = 0; i < leafs.size(); ++i) {
+        int cost = leafs[i]->getCost() > 0 ? leafs[i]->getCost() : 1;
+        if (i == 0 || is_split_allowed[i]) unit_costs.push_back(0);
+        unit_costs.back() += cost;
+        total_cost += cost;
+        if (unit_costs.back() > max_unit_cost) {
+            max_unit_cost = unit_costs.back();
+        }
+    }
+
+    // Find the smallest stage cost which still yields no more stages than
+    // requested
+    size_t max_num_stages = config_.getNumPipelineStages();
+    int lower_cost = max_unit_cost;
+    int upper_cost = total_cost;
+    while (lower_cost < upper_cost) {
+        int cost = lower_cost + (upper_cost - lower_cost) / 2;
+        if (countPipelineStages(unit_costs, cost) <= max_num_stages) {
+            upper_cost = cost;
+        }
+        else {
+            lower_cost = cost + 1;
+        }
+    }
+
+    vector<int> stage_costs(1, 0);
+    vector<string> stage_leafs(1);
+    for (size_t i = 0, unit = 0; i < leafs.size(); ++i) {
+        if (i > 0 && is_split_allowed[i]) {
+            ++unit;
+            if (stage_costs.back() > 0
+                && stage_costs.back() + unit_costs[unit] > lower_cost) {
+                stage_costs.push_back(0);
+                stage_leafs.push_back("");
+            }
+        }
+        stage_costs.back() += leafs[i]->getCost() > 0 ? leafs[i]->getCost()
+            : 1;
+        if (stage_leafs.back().length() > 0) stage_leafs.back() += ", ";
+        stage_leafs.back() += leafs[i]->getId()->getString();
+        pipeline_stages_[leafs[i]] = stage_costs.size() - 1;
+    }
+    num_pipeline_stages_ = stage_costs.size();
+
+    // Place each delay leaf in the same stage as the producer of its input,
+    // or, if there is none, in the same stage as the consumer of its output
+    for (delay_it = delays.begin(); delay_it != delays.end(); ++delay_it) {
+        int stage = 0;
+        Process* producer = getDelayInputProducer(*delay_it);
+        Leaf::Port* consumer_port =
+            getSignalByOutPort((*delay_it)->getOutPortRange().front())
+            ->getInPort();
+        if (producer) {
+            stage = pipeline_stages_[producer];
+        }
+        else if (consumer_port
+                 && !dynamic_cast<delay*>(consumer_port->getProcess())) {
+            stage = pipeline_stages_[consumer_port->getProcess()];
+        }
+        pipeline_stages_[*delay_it] = stage;
+        if (stage_leafs[stage].length() > 0) stage_leafs[stage] += ", ";
+        stage_leafs[stage] += (*delay_it)->getId()->getString();
+    }
+
+    for (int stage = 0; stage < num_pipeline_stages_; ++stage) {
+        logger_.logMessage(Logger::INFO, string("Pipeline stage ")
+                           + tools::toString(stage + 1) + " (cost "
+                           + tools::toString(stage_costs[stage]) + "): "
+                           + stage_leafs[stage]);
+    }
+    if ((size_t) num_pipeline_stages_ < max_num_stages) {
+        logger_.logMessage(Logger::WARNING, string("Only ")
+                           + tools::toString(num_pipeline_stages_)
+                           + " pipeline stage(s) could be formed");
+    }
+}
+
+void Synthesizer::orderLeafsByDependencies(
+    vector<Leaf*>& leafs, const vector< set<size_t> >& dependencies)
+    const throw() {
+    vector<size_t> num_dependencies(leafs.size());
+    vector< vector<size_t> > successors(leafs.size());
+    set<size_t> ready;
+    for (size_t i = 0; i < leafs.size(); ++i) {
+        num_dependencies[i] = dependencies[i].size();
+        set<size_t>::const_iterator it;
+        for (it = dependencies[i].begin(); it != dependencies[i].end(); ++it) {
+            successors[*it].push_back(i);
+        }
+        if (num_dependencies[i] == 0) ready.insert(i);
+    }
+
+    // Always take the ready leaf which comes first in the current order, such
+    // that the order is only changed where needed
+    vector<Leaf*> ordered;
+    while (!ready.empty()) {
+        size_t i = *ready.begin();
+        ready.erase(ready.begin());
+        ordered.push_back(leafs[i]);
+        for (size_t k = 0; k < successors[i].size(); ++k) {
+            if (--num_dependencies[successors[i][k]] == 0) {
+                ready.insert(successors[i][k]);
+            }
+        }
+    }
+    if (ordered.size() == leafs.size()) leafs.swap(ordered);
+}
+
+bool Synthesizer::isProcessReachable(Process* from, Process* to)
+    throw(InvalidModelException, IOException, RuntimeException) {
+    set<Process*> visited;
+    list<Process*> pending(1, from);
+    while (!pending.empty()) {
+        Process* current = pending.front();
+        pending.pop_front();
+        if (current == to) return true;
+        if (!visited.insert(current).second) continue;
+        Leaf* leaf = dynamic_cast<Leaf*>(current);
+        if (!leaf) continue;
+        const Leaf::PortVector& out_ports = leaf->getOutPortRange();
+        Leaf::PortVector::const_iterator it;
+        for (it = out_ports.begin(); it != out_ports.end(); ++it) {
+            Leaf::Port* in_port = getSignalByOutPort(*it)->getInPort();
+            if (in_port) pending.push_back(in_port->getProcess());
+        }
+    }
+    return false;
+}
+
+size_t Synthesizer::countPipelineStages(const vector<int>& unit_costs,
+                                        int max_stage_cost) const throw() {
+    size_t num_stages = 1;
+    int stage_cost = 0;
+    for (size_t i = 0; i < unit_costs.size(); ++i) {
+        if (stage_cost > 0 && stage_cost + unit_costs[i] > max_stage_cost) {
+            ++num_stages;
+            stage_cost = 0;
+        }
+        stage_cost += unit_costs[i];
+    }
+    return num_stages;
+}
+
+Process* Synthesizer::getDelayInputProducer(delay* leaf)
+    throw(InvalidModelException, IOException, RuntimeException) {
+    set<delay*> visited;
+    delay* current_leaf = leaf;
+    while (visited.insert(current_leaf).second) {
+        Leaf::Port* out_port =
+            getSignalByInPort(current_leaf->getInPortRange().front())
+            ->getOutPort();
+        if (!out_port) return NULL;
+        Process* producer = out_port->getProcess();
+        current_leaf = dynamic_cast<delay*>(producer);
+        if (!current_leaf) return producer;
+    }
+    THROW_EXCEPTION(InvalidModelException, string("Leaf \"")
+                    + leaf->getId()->getString() + "\" is part of a loop "
+                    "consisting of only delay leafs");
+}
+
+int Synthesizer::getPipelineStage(const Process* leaf) const
+    throw(IllegalStateException) {
+    map<const Process*, int>::const_iterator it = pipeline_stages_.find(leaf);
+    if (it == pipeline_stages_.end()) {
+        THROW_EXCEPTION(IllegalStateException, string("Leaf \"")
+                        + leaf->getId()->getString() + "\" has not been "
+                        "assigned any pipeline stage");
+    }
+    return it->second;
+}
+
+pair<int, int> Synthesizer::getPipelineStagesOfSignal(Signal* signal) const
+    throw(IllegalStateException) {
+    int writing_stage = -1;
+    int reading_stage = -1;
+    if (signal->getOutPort()) {
+        writing_stage = getPipelineStage(signal->getOutPort()->getProcess());
+    }
+    if (signal->getInPort()) {
+        reading_stage = getPipelineStage(signal->getInPort()->getProcess());
+    }
+    if (writing_stage < 0) writing_stage = reading_stage;
+    if (reading_stage < 0) reading_stage = writing_stage;
+    return pair<int, int>(writing_stage, reading_stage);
+}
+
+bool Synthesizer::isSignalInPipelineStage(Signal* signal, int stage) const
+    throw(IllegalStateException) {
+    pair<int, int> stages = getPipelineStagesOfSignal(signal);
+    return stages.first == stage || stages.second == stage;
+}
+
+string Synthesizer::getPipelineRingName(Signal* signal) const
+    throw(IllegalStateException) {
+    return string("ring_") + signal->getVariable().getReferenceString();
+}
+
+string Synthesizer::getPipelineStageFunctionName(int stage) const throw() {
+    return string("executePipelineStage") + tools::toString(stage + 1);
+}
+
+list<CVariable> Synthesizer::getPipelineParameters(int stage)
+    throw(InvalidModelException, RuntimeException) {
+    list<CVariable> parameters;
+
+    list<Process::Interface*> inputs = processnetwork_->getInputs();
+    list<Process::Interface*>::iterator it;
+    int id;
+    for (it = inputs.begin(), id = 1; it != inputs.end(); ++it, ++id) {
+        Signal* signal = getSignalByInPort(dynamic_cast<Leaf::Port*>(*it));
+        if (stage >= 0 && !isSignalInPipelineStage(signal, stage)) continue;
+        CDataType data_type = *signal->getDataType();
+        data_type.setIsConst(true);
+        data_type.setIsArray(true);
+        parameters.push_back(
+            CVariable(kProcessNetworkInputParameterPrefix
+                      + tools::toString(id), data_type));
+    }
+
+    list<Process::Interface*> outputs = processnetwork_->getOutputs();
+    for (it = outputs.begin(), id = 1; it != outputs.end(); ++it, ++id) {
+        Signal* signal = getSignalByOutPort(dynamic_cast<Leaf::Port*>(*it));
+        if (stage >= 0 && !isSignalInPipelineStage(signal, stage)) continue;
+        CDataType data_type = *signal->getDataType();
+        data_type.setIsArray(true);
+        parameters.push_back(
+            CVariable(kProcessNetworkOutputParameterPrefix
+                      + tools::toString(id), data_type));
+    }
+
+    return parameters;
+}
+
+void Synthesizer::generatePipelineRingDefinitionCode(CodeWriter& code)
+    throw() {
+    code << "#include <pthread.h>\n"
+        << "#include <stdlib.h>\n"
+        << "#include <string.h>\n"
+        << "\n"
+        << "/**\n"
+        << " * Number of signal values which a ring buffer between two "
+        "pipeline\n"
+        << " * stages can hold.\n"
+        << " */\n"
+        << "#ifndef F2CC_PIPELINE_RING_CAPACITY\n"
+        << "#define F2CC_PIPELINE_RING_CAPACITY 16\n"
+        << "#endif\n"
+        << "\n";
+    code << "/**\n"
+        << " * C struct for a single-producer, single-consumer ring buffer "
+        "which\n"
+        << " * carries the values of a signal from one pipeline stage to "
+        "another.\n"
+        << " * The write index is only accessed by the producer and the read "
+        "index\n"
+        << " * only by the consumer, so only the count needs to be protected.\n"
+        << " */\n";
+    code << "struct PipelineRing {\n"
+        << kIndents << "char* slots;\n"
+        << kIndents << "size_t slot_size;\n"
+        << kIndents << "int read_index;\n"
+        << kIndents << "int write_index;\n"
+        << kIndents << "int count;\n"
+        << kIndents << "pthread_mutex_t lock;\n"
+        << kIndents << "pthread_cond_t changed;\n"
+        << "};\n"
+        << "\n";
+    code << "static void initPipelineRing(struct PipelineRing* ring, "
+        << "size_t slot_size) {\n"
+        << kIndents << "ring->slots = (char*) malloc(slot_size * "
+        << "F2CC_PIPELINE_RING_CAPACITY);\n"
+        << kIndents << "ring->slot_size = slot_size;\n"
+        << kIndents << "ring->read_index = 0;\n"
+        << kIndents << "ring->write_index = 0;\n"
+        << kIndents << "ring->count = 0;\n"
+        << kIndents << "pthread_mutex_init(&ring->lock, NULL);\n"
+        << kIndents << "pthread_cond_init(&ring->changed, NULL);\n"
+        << "}\n"
+        << "\n";
+    code << "static void destroyPipelineRing(struct PipelineRing* "
+        << "ring) {\n"
+        << kIndents << "pthread_cond_destroy(&ring->changed);\n"
+        << kIndents << "pthread_mutex_destroy(&ring->lock);\n"
+        << kIndents << "free(ring->slots);\n"
+        << "}\n"
+        << "\n";
+    code << "static void pushPipelineRing(struct PipelineRing* ring, "
+        << "const void* data) {\n"
+        << kIndents << "pthread_mutex_lock(&ring->lock);\n"
+        << kIndents << "while (ring->count == F2CC_PIPELINE_RING_CAPACITY) {\n"
+        << kIndents << kIndents << "pthread_cond_wait(&ring->changed, "
+        << "&ring->lock);\n"
+        << kIndents << "}\n"
+        << kIndents << "pthread_mutex_unlock(&ring->lock);\n"
+        << kIndents << "memcpy(ring->slots + ring->write_index * "
+        << "ring->slot_size, data,\n"
+        << kIndents << "       ring->slot_size);\n"
+        << kIndents << "ring->write_index = (ring->write_index + 1) % "
+        << "F2CC_PIPELINE_RING_CAPACITY;\n"
+        << kIndents << "pthread_mutex_lock(&ring->lock);\n"
+        << kIndents << "++ring->count;\n"
+        << kIndents << "pthread_cond_signal(&ring->changed);\n"
+        << kIndents << "pthread_mutex_unlock(&ring->lock);\n"
+        << "}\n"
+        << "\n";
+    code << "static void popPipelineRing(struct PipelineRing* ring, "
+        << "void* data) {\n"
+        << kIndents << "pthread_mutex_lock(&ring->lock);\n"
+        << kIndents << "while (ring->count == 0) {\n"
+        << kIndents << kIndents << "pthread_cond_wait(&ring->changed, "
+        << "&ring->lock);\n"
+        << kIndents << "}\n"
+        << kIndents << "pthread_mutex_unlock(&ring->lock);\n"
+        << kIndents << "memcpy(data, ring->slots + ring->read_index * "
+        << "ring->slot_size,\n"
+        << kIndents << "       ring->slot_size);\n"
+        << kIndents << "ring->read_index = (ring->read_index + 1) % "
+        << "F2CC_PIPELINE_RING_CAPACITY;\n"
+        << kIndents << "pthread_mutex_lock(&ring->lock);\n"
+        << kIndents << "--ring->count;\n"
+        << kIndents << "pthread_cond_signal(&ring->changed);\n"
+        << kIndents << "pthread_mutex_unlock(&ring->lock);\n"
+        << "}\n";
+}
+
+void Synthesizer::generatePipelineContextStructDefinitionCode(
+    CodeWriter& code)
+    throw(InvalidModelException, IOException, RuntimeException) {
+    code << "/**\n"
+        << " * C struct for the data shared between the pipeline stages.\n"
+        << " */\n";
+    code << "struct PipelineContext {\n";
+    if (config_.doReentrantCode()) {
+        code << kIndents << getStateParameterDeclarationString() << ";\n";
+    }
+    code << kIndents << "int " << kBlockNumTokensParameterName << ";\n";
+    list<CVariable> parameters = getPipelineParameters(-1);
+    list<CVariable>::iterator param_it;
+    for (param_it = parameters.begin(); param_it != parameters.end();
+         ++param_it) {
+        code << kIndents << param_it->getInputParameterDeclarationString()
+            << ";\n";
+    }
+    set<Signal*>::iterator it;
+    for (it = signals_.begin(); it != signals_.end(); ++it) {
+        pair<int, int> stages = getPipelineStagesOfSignal(*it);
+        if (stages.first == stages.second) continue;
+        code << kIndents << "struct PipelineRing " << getPipelineRingName(*it)
+            << ";\n";
+    }
+    code << "};\n"
+        "\n";
+
+    code << "/**\n"
+        << " * C struct for a pipeline stage executed on a separate thread.\n"
+        << " */\n";
+    code << "struct PipelineThread {\n"
+        << kIndents << "pthread_t thread;\n"
+        << kIndents << "int is_running;\n"
+        << kIndents << "int stage;\n"
+        << kIndents << "struct PipelinePool* pool;\n"
+        << "};\n"
+        << "\n";
+    code << "/**\n"
+        << " * C struct for the threads executing the pipeline stages. The "
+        "pool is\n"
+        << " * created by the first call and kept until "
+        "stopProcessNetworkThreads()\n"
+        << " * is called, so that no threads are started per call. Each call "
+        "is a\n"
+        << " * round in which every running thread executes its stage once.\n"
+        << " */\n";
+    code << "struct PipelinePool {\n"
+        << kIndents << "pthread_mutex_t lock;\n"
+        << kIndents << "pthread_cond_t changed;\n"
+        << kIndents << "struct PipelineContext* context;\n"
+        << kIndents << "struct PipelineThread threads["
+        << num_pipeline_stages_ << "];\n"
+        << kIndents << "int num_unfinished;\n"
+        << kIndents << "int round;\n"
+        << kIndents << "int is_stopping;\n"
+        << "};\n";
+}
+
+void Synthesizer::generatePipelineRuntimeDefinitionCode(CodeWriter& code)
+    throw() {
+    code << "static void (* const pipeline_stage_functions["
+        << num_pipeline_stages_ << "])\n"
+        << kIndents << "(struct PipelineContext*, int, int) = {\n";
+    for (int stage = 0; stage < num_pipeline_stages_; ++stage) {
+        code << kIndents << getPipelineStageFunctionName(stage);
+        if (stage + 1 < num_pipeline_stages_) code << ",";
+        code << "\n";
+    }
+    code << "};\n"
+        << "\n";
+    code << "static void* runPipelineThread(void* arg) {\n"
+        << kIndents << "struct PipelineThread* thread = "
+        << "(struct PipelineThread*) arg;\n"
+        << kIndents << "struct PipelinePool* pool = thread->pool;\n"
+        << kIndents << "struct PipelineContext* context;\n"
+        << kIndents << "int round = 0;\n"
+        << kIndents << "pthread_mutex_lock(&pool->lock);\n"
+        << kIndents << "for (;;) {\n"
+        << kIndents << kIndents << "while (pool->round == round && "
+        << "!pool->is_stopping) {\n"
+        << kIndents << kIndents << kIndents
+        << "pthread_cond_wait(&pool->changed, &pool->lock);\n"
+        << kIndents << kIndents << "}\n"
+        << kIndents << kIndents << "if (pool->is_stopping) break;\n"
+        << kIndents << kIndents << "round = pool->round;\n"
+        << kIndents << kIndents << "context = pool->context;\n"
+        << kIndents << kIndents << "pthread_mutex_unlock(&pool->lock);\n"
+        << kIndents << kIndents << "pipeline_stage_functions[thread->stage]("
+        << "context, 0,\n"
+        << kIndents << kIndents << "                                        "
+        << "context->" << kBlockNumTokensParameterName << ");\n"
+        << kIndents << kIndents << "pthread_mutex_lock(&pool->lock);\n"
+        << kIndents << kIndents << "if (--pool->num_unfinished == 0) {\n"
+        << kIndents << kIndents << kIndents
+        << "pthread_cond_broadcast(&pool->changed);\n"
+        << kIndents << kIndents << "}\n"
+        << kIndents << "}\n"
+        << kIndents << "pthread_mutex_unlock(&pool->lock);\n"
+        << kIndents << "return NULL;\n"
+        << "}\n"
+        << "\n";
+    code << "/**\n"
+        << " * Allocates a pipeline pool and starts all pipeline stages but "
+        "the\n"
+        << " * first on separate threads. Should a thread fail to start, its "
+        "stage\n"
+        << " * is instead executed by the calling thread. Returns NULL if the "
+        "pool\n"
+        << " * could not be allocated.\n"
+        << " */\n";
+    code << "static struct PipelinePool* createPipelinePool(void) {\n"
+        << kIndents << "struct PipelinePool* pool = (struct PipelinePool*) "
+        << "malloc(sizeof(struct PipelinePool));\n"
+        << kIndents << "int stage;\n"
+        << kIndents << "if (!pool) return NULL;\n"
+        << kIndents << "pthread_mutex_init(&pool->lock, NULL);\n"
+        << kIndents << "pthread_cond_init(&pool->changed, NULL);\n"
+        << kIndents << "pool->context = NULL;\n"
+        << kIndents << "pool->num_unfinished = 0;\n"
+        << kIndents << "pool->round = 0;\n"
+        << kIndents << "pool->is_stopping = 0;\n"
+        << kIndents << "for (stage = 0; stage < " << num_pipeline_stages_
+        << "; ++stage) {\n"
+        << kIndents << kIndents << "pool->threads[stage].stage = stage;\n"
+        << kIndents << kIndents << "pool->threads[stage].pool = pool;\n"
+        << kIndents << kIndents << "pool->threads[stage].is_running = "
+        << "stage > 0\n"
+        << kIndents << kIndents << kIndents << "&& pthread_create("
+        << "&pool->threads[stage].thread, NULL,\n"
+        << kIndents << kIndents << kIndents << "                  "
+        << "runPipelineThread, &pool->threads[stage]) == 0;\n"
+        << kIndents << "}\n"
+        << kIndents << "return pool;\n"
+        << "}\n"
+        << "\n";
+    code << "/**\n"
+        << " * Executes every pipeline stage once for all tokens of the "
+        "context and\n"
+        << " * returns when all stages have finished. The stages without a "
+        "thread,\n"
+        << " * which are all stages if there is no pool, are executed by the\n"
+        << " * calling thread in chunks which fit in the ring buffers.\n"
+        << " */\n";
+    code << "static void runPipelineRound(struct PipelinePool* pool,\n"
+        << "                             struct PipelineContext* context) {\n"
+        << kIndents << "int begin;\n"
+        << kIndents << "int end;\n"
+        << kIndents << "int stage;\n"
+        << kIndents << "if (pool) {\n"
+        << kIndents << kIndents << "pthread_mutex_lock(&pool->lock);\n"
+        << kIndents << kIndents << "pool->context = context;\n"
+        << kIndents << kIndents << "pool->num_unfinished = 0;\n"
+        << kIndents << kIndents << "for (stage = 0; stage < "
+        << num_pipeline_stages_ << "; ++stage) {\n"
+        << kIndents << kIndents << kIndents
+        << "if (pool->threads[stage].is_running) ++pool->num_unfinished;\n"
+        << kIndents << kIndents << "}\n"
+        << kIndents << kIndents << "++pool->round;\n"
+        << kIndents << kIndents << "pthread_cond_broadcast(&pool->changed);\n"
+        << kIndents << kIndents << "pthread_mutex_unlock(&pool->lock);\n"
+        << kIndents << "}\n"
+        << kIndents << "for (begin = 0; begin < context->"
+        << kBlockNumTokensParameterName << "; begin = end) {\n"
+        << kIndents << kIndents << "end = begin + "
+        << "F2CC_PIPELINE_RING_CAPACITY;\n"
+        << kIndents << kIndents << "if (end > context->"
+        << kBlockNumTokensParameterName << ") end = context->"
+        << kBlockNumTokensParameterName << ";\n"
+        << kIndents << kIndents << "for (stage = 0; stage < "
+        << num_pipeline_stages_ << "; ++stage) {\n"
+        << kIndents << kIndents << kIndents
+        << "if (!pool || !pool->threads[stage].is_running) {\n"
+        << kIndents << kIndents << kIndents << kIndents
+        << "pipeline_stage_functions[stage](context, begin, end);\n"
+        << kIndents << kIndents << kIndents << "}\n"
+        << kIndents << kIndents << "}\n"
+        << kIndents << "}\n"
+        << kIndents << "if (pool) {\n"
+        << kIndents << kIndents << "// Wait for the pipeline to drain\n"
+        << kIndents << kIndents << "pthread_mutex_lock(&pool->lock);\n"
+        << kIndents << kIndents << "while (pool->num_unfinished > 0) {\n"
+        << kIndents << kIndents << kIndents
+        << "pthread_cond_wait(&pool->changed, &pool->lock);\n"
+        << kIndents << kIndents << "}\n"
+        << kIndents << kIndents << "pthread_mutex_unlock(&pool->lock);\n"
+        << kIndents << "}\n"
+        << "}\n"
+        << "\n";
+    code << "/**\n"
+        << " * Stops the threads of a pipeline pool and frees it.\n"
+        << " */\n";
+    code << "static void destroyPipelinePool(struct PipelinePool* pool) {\n"
+        << kIndents << "int stage;\n"
+        << kIndents << "pthread_mutex_lock(&pool->lock);\n"
+        << kIndents << "pool->is_stopping = 1;\n"
+        << kIndents << "pthread_cond_broadcast(&pool->changed);\n"
+        << kIndents << "pthread_mutex_unlock(&pool->lock);\n"
+        << kIndents << "for (stage = 0; stage < " << num_pipeline_stages_
+        << "; ++stage) {\n"
+        << kIndents << kIndents << "if (pool->threads[stage].is_running) {\n"
+        << kIndents << kIndents << kIndents
+        << "pthread_join(pool->threads[stage].thread, NULL);\n"
+        << kIndents << kIndents << "}\n"
+        << kIndents << "}\n"
+        << kIndents << "pthread_cond_destroy(&pool->changed);\n"
+        << kIndents << "pthread_mutex_destroy(&pool->lock);\n"
+        << kIndents << "free(pool);\n"
+        << "}\n"
+        << "\n";
+    generateStopThreadsFunctionDefinitionCode(code);
+}
+
+void Synthesizer::generatePipelineStageFunctionDefinitionCode(
+    CodeWriter& code, int stage)
+    throw(InvalidModelException, IOException, RuntimeException) {
+    code << "static void " << getPipelineStageFunctionName(stage)
+        << "(struct PipelineContext* context, int begin, int end) {\n";
+    code << kIndents << "int i; // Can safely be removed if the compiler "
+        "warns\n"
+        << kIndents << "       // about it being unused\n";
+    code << kIndents << "int " << kBlockTokenVariableName << ";\n";
+    if (config_.doReentrantCode()) {
+        code << kIndents << getStateParameterDeclarationString()
+            << " = context->" << kStateParameterName << ";\n";
+    }
+    list<CVariable> parameters = getPipelineParameters(stage);
+    list<CVariable>::iterator param_it;
+    for (param_it = parameters.begin(); param_it != parameters.end();
+         ++param_it) {
+        code << kIndents << param_it->getInputParameterDeclarationString()
+            << " = context->" << param_it->getReferenceString() << ";\n";
+    }
+    generateSignalVariableDeclarationsCode(code, stage);
+    code << "\n";
+    size_t delay_code_start = code.getSize();
+    generateDelayVariableDeclarationsCode(code, stage);
+    if (code.getSize() > delay_code_start) code << "\n";
+
+    code << kIndents << "for (" << kBlockTokenVariableName << " = begin; "
+        << kBlockTokenVariableName << " < end; ++" << kBlockTokenVariableName
+        << ") {\n";
+    code.indent();
+    generateArrayInputOutputsToSignalsAliasingCode(code, true, stage);
+    code << "\n";
+    size_t ring_code_start = code.getSize();
+    generateDelayRingAliasingCode(code, stage);
+    if (code.getSize() > ring_code_start) code << "\n";
+    size_t view_code_start = code.getSize();
+    generateSignalArrayViewsAliasingCode(code, stage);
+    if (code.getSize() > view_code_start) code << "\n";
+    generateInputsToSignalsCopyingCode(code, true, stage);
+    code << "\n";
+    code << kIndents << "// Execute leafs\n";
+    generateScheduleExecutionCode(code, stage);
+    code << "\n";
+    generateSignalsToOutputsCopyingCode(code, true, stage);
+    code.unindent();
+    code << kIndents << "}\n";
+    code << "\n";
+    generateSignalVariableCleanupCode(code, stage);
+    code << "}";
+}
+
+void Synthesizer::generatePipelineRingTransferCode(CodeWriter& code,
+                                                   int stage, bool do_write,
+                                                   bool only_delays)
+    throw(InvalidModelException, IOException, RuntimeException) {
+    bool at_least_one = false;
+    set<Signal*>::iterator it;
+    for (it = signals_.begin(); it != signals_.end(); ++it) {
+        Signal* signal = *it;
+        pair<int, int> stages = getPipelineStagesOfSignal(signal);
+        if (stages.first == stages.second) continue;
+        if (do_write) {
+            bool is_written_by_delay =
+                dynamic_cast<delay*>(signal->getOutPort()->getProcess());
+            if (stages.first != stage || is_written_by_delay != only_delays) {
+                continue;
+            }
+        }
+        else if (stages.second != stage) {
+            continue;
+        }
+
+        CVariable variable = signal->getVariable();
+        string argument = variable.getReferenceString();
+        if (!variable.getDataType()->isArray()) argument = "&" + argument;
+        if (!at_least_one) {
+            if (do_write) {
+                code << kIndents << "// Send signal variables to subsequent "
+                    "pipeline stages\n";
+            }
+            else {
+                code << kIndents << "// Receive signal variables from "
+                    "previous pipeline stages\n";
+            }
+            at_least_one = true;
+        }
+        code << kIndents << (do_write ? "push" : "pop")
+            << "PipelineRing(&context->" << getPipelineRingName(signal) << ", "
+            << argument << ");\n";
+    }
+}
+
+void Synthesizer::generatePipelinedBlockFunctionDefinitionCode(
+    CodeWriter& code)
+    throw(InvalidModelException, IOException, RuntimeException) {
+    code << generateProcessNetworkBlockFunctionPrototypeCode() << " {\n";
+    code << kIndents << "struct PipelineContext context;\n"
+        << "\n";
+
+    code << kIndents << "// Set up pipeline context\n";
+    if (config_.doReentrantCode()) {
+        code << kIndents << "context." << kStateParameterName << " = "
+            << kStateParameterName << ";\n";
+    }
+    code << kIndents << "context." << kBlockNumTokensParameterName << " = "
+        << kBlockNumTokensParameterName << ";\n";
+    list<CVariable> parameters = getPipelineParameters(-1);
+    list<CVariable>::iterator param_it;
+    for (param_it = parameters.begin(); param_it != parameters.end();
+         ++param_it) {
+        code << kIndents << "context." << param_it->getReferenceString()
+            << " = " << param_it->getReferenceString() << ";\n";
+    }
+    string ring_cleanup_code;
+    set<Signal*>::iterator it;
+    for (it = signals_.begin(); it != signals_.end(); ++it) {
+        Signal* signal = *it;
+        pair<int, int> stages = getPipelineStagesOfSignal(signal);
+        if (stages.first == stages.second) continue;
+        CDataType data_type = *signal->getDataType();
+        data_type.setIsConst(false);
+        data_type.setIsPointer(false);
+        string slot_size = string("sizeof(")
+            + data_type.getVariableDataTypeString() + ")";
+        if (data_type.isArray()) {
+            if (!data_type.hasArraySize()) {
+                THROW_EXCEPTION(InvalidModelException, string("Size not ")
+                                + "known for signal " + signal->toString());
+            }
+            slot_size += " * " + tools::toString(data_type.getArraySize());
+        }
+        code << kIndents << "initPipelineRing(&context."
+            << getPipelineRingName(signal) << ", " << slot_size << ");\n";
+        ring_cleanup_code += kIndents + "destroyPipelineRing(&context."
+            + getPipelineRingName(signal) + ");\n";
+    }
+    code << "\n";
+
+    code << kIndents << "// Execute the pipeline stages on the thread pool\n"
+        << kIndents << "if (!" << getThreadPoolReferenceString() << ") {\n"
+        << kIndents << kIndents << getThreadPoolReferenceString()
+        << " = createPipelinePool();\n"
+        << kIndents << "}\n"
+        << kIndents << "runPipelineRound(" << getThreadPoolReferenceString()
+        << ", &context);\n";
+    if (ring_cleanup_code.length() > 0) {
+        code << "\n" << kIndents << "// Clean up ring buffers\n"
+            << ring_cleanup_code;
+    }
+    code << "}";
+}
+
+void Synthesizer::findTasks()
+    throw(InvalidModelException, IOException, RuntimeException) {
+    tasks_.clear();
+    task_successors_.clear();
+    task_num_dependencies_.clear();
+
+    map<const Process*, size_t> task_indices;
+    for (list<Id>::iterator it = schedule_.begin(); it != schedule_.end();
+         ++it) {
+        Leaf* current_leaf = processnetwork_->getProcess(*it);
+        if (!current_leaf) {
+            THROW_EXCEPTION(IllegalStateException, string("Leaf \"") +
+                            it->getString() + "\" not found");
+        }
+        if (dynamic_cast<delay*>(current_leaf)) continue;
+        task_indices[current_leaf] = tasks_.size();
+        tasks_.push_back(current_leaf);
+    }
+    if (tasks_.size() == 0) {
+        THROW_EXCEPTION(InvalidModelException, "Process network has no leafs "
+                        "other than delay leafs to execute as tasks");
+    }
+
+    task_successors_.resize(tasks_.size());
+    task_num_dependencies_.resize(tasks_.size(), 0);
+    vector<size_t> depths(tasks_.size(), 1);
+    size_t max_depth = 0;
+    size_t num_ready = 0;
+    for (size_t task = 0; task < tasks_.size(); ++task) {
+        set<size_t> dependencies;
+        const Leaf::PortVector& in_ports = tasks_[task]->getInPortRange();
+        Leaf::PortVector::const_iterator port_it;
+        for (port_it = in_ports.begin(); port_it != in_ports.end();
+             ++port_it) {
+            Leaf::Port* out_port = getSignalByInPort(*port_it)->getOutPort();
+            if (!out_port) continue;
+            map<const Process*, size_t>::iterator index_it =
+                task_indices.find(out_port->getProcess());
+            if (index_it == task_indices.end()) continue;
+            dependencies.insert(index_it->second);
+        }
+
+        // As the schedule is in data flow order, all dependencies of a task
+        // have already been visited
+        set<size_t>::iterator dep_it;
+        for (dep_it = dependencies.begin(); dep_it != dependencies.end();
+             ++dep_it) {
+            task_successors_[*dep_it].push_back(task);
+            depths[task] = std::max(depths[task], depths[*dep_it] + 1);
+        }
+        task_num_dependencies_[task] = dependencies.size();
+        if (dependencies.size() == 0) ++num_ready;
+        max_depth = std::max(max_depth, depths[task]);
+    }
+
+    logger_.logMessage(Logger::INFO, string("Found ")
+                       + tools::toString(tasks_.size()) + " task(s), "
+                       + tools::toString(num_ready) + " of which have no "
+                       "dependencies; the longest dependency chain has "
+                       + tools::toString(max_depth) + " task(s)");
+}
+
+bool Synthesizer::isTaskSignal(Signal* signal) const throw() {
+    if (signal->getOutPort()
+        && !dynamic_cast<delay*>(signal->getOutPort()->getProcess())) {
+        return true;
+    }
+    if (signal->getInPort()
+        && !dynamic_cast<delay*>(signal->getInPort()->getProcess())) {
+        return true;
+    }
+    return false;
+}
+
+string Synthesizer::getTaskFunctionName(size_t task) const throw() {
+    return string("executeTask") + tools::toString(task + 1);
+}
+
+void Synthesizer::generateTaskPoolDefinitionCode(CodeWriter& code) throw() {
+    code << "#include <pthread.h>\n"
+        << "#include <stdlib.h>\n"
+        << "\n"
+        << "/**\n"
+        << " * Number of threads, including the calling thread, which execute\n"
+        << " * the leaf tasks.\n"
+        << " */\n"
+        << "#ifndef F2CC_NUM_THREADS\n"
+        << "#define F2CC_NUM_THREADS "
+        << config_.getNumThreads() << "\n"
+        << "#endif\n"
+        << "\n"
+        << "/**\n"
+        << " * Number of leaf tasks.\n"
+        << " */\n"
+        << "#define F2CC_NUM_TASKS " << tasks_.size() << "\n"
+        << "\n";
+    code << "/**\n"
+        << " * C struct for the queue of ready tasks of a thread. The owning\n"
+        << " * thread takes tasks from the tail while other threads steal "
+        "from\n"
+        << " * the head. As each task becomes ready once per round, the queue\n"
+        << " * never needs to hold more than all tasks.\n"
+        << " */\n";
+    code << "struct TaskQueue {\n"
+        << kIndents << "int tasks[F2CC_NUM_TASKS];\n"
+        << kIndents << "int head;\n"
+        << kIndents << "int tail;\n"
+        << "};\n"
+        << "\n";
+    code << "/**\n"
+        << " * C struct for a thread in the task pool.\n"
+        << " */\n";
+    code << "struct TaskWorker {\n"
+        << kIndents << "pthread_t thread;\n"
+        << kIndents << "int id;\n"
+        << kIndents << "int is_running;\n"
+        << kIndents << "struct TaskPool* pool;\n"
+        << "};\n"
+        << "\n";
+    code << "/**\n"
+        << " * C struct for the task pool. A round executes every task once; "
+        "a\n"
+        << " * task becomes ready when its count of pending dependencies "
+        "reaches\n"
+        << " * zero. The queues and counts are protected by the lock, which "
+        "is\n"
+        << " * not held while a task executes. The pool is created by the "
+        "first\n"
+        << " * call to executeProcessNetworkBlock() and its threads are kept "
+        "until\n"
+        << " * stopProcessNetworkThreads() is called.\n"
+        << " */\n";
+    code << "struct TaskPool {\n"
+        << kIndents << "pthread_mutex_t lock;\n"
+        << kIndents << "pthread_cond_t changed;\n"
+        << kIndents << "struct TaskContext* context;\n"
+        << kIndents << "struct TaskWorker workers[F2CC_NUM_THREADS];\n"
+        << kIndents << "struct TaskQueue queues[F2CC_NUM_THREADS];\n"
+        << kIndents << "int num_pending[F2CC_NUM_TASKS];\n"
+        << kIndents << "int num_unfinished;\n"
+        << kIndents << "int round;\n"
+        << kIndents << "int is_stopping;\n"
+        << "};\n";
+}
+
+void Synthesizer::generateTaskContextStructDefinitionCode(CodeWriter& code)
+    throw(InvalidModelException, IOException, RuntimeException) {
+    code << "/**\n"
+        << " * C struct for the signal variables shared between the tasks.\n"
+        << " */\n";
+    code << "struct TaskContext {\n";
+    bool at_least_one = false;
+    set<Signal*>::iterator it;
+    for (it = signals_.begin(); it != signals_.end(); ++it) {
+        Signal* signal = *it;
+        if (!isTaskSignal(signal)) continue;
+        at_least_one = true;
+        CVariable variable = signal->getVariable();
+        if (variable.getDataType()->isArray()) {
+            code << kIndents << variable.getPointerDeclarationString()
+                << ";\n";
+        }
+        else {
+            code << kIndents << variable.getLocalVariableDeclarationString()
+                << ";\n";
+        }
+    }
+    if (!at_least_one) code << kIndents << "char unused;\n";
+    code << "};\n";
+}
+
+void Synthesizer::generateTaskFunctionDefinitionCode(CodeWriter& code,
+                                                     size_t task)
+    throw(InvalidModelException, IOException, RuntimeException) {
+    Leaf* leaf = tasks_[task];
+    code << "/**\n"
+        << " * Executes leaf \"" << leaf->getId()->getString() << "\".\n"
+        << " */\n";
+    code << "static void " << getTaskFunctionName(task)
+        << "(struct TaskContext* context) {\n";
+    code << kIndents << "int i; // Can safely be removed if the compiler "
+        "warns\n"
+        << kIndents << "       // about it being unused\n";
+
+    // Gather the signals read and written by the leaf
+    list<Signal*> signals;
+    const Leaf::PortVector& in_ports = leaf->getInPortRange();
+    Leaf::PortVector::const_iterator port_it;
+    for (port_it = in_ports.begin(); port_it != in_ports.end(); ++port_it) {
+        signals.push_back(getSignalByInPort(*port_it));
+    }
+    list<Signal*> output_signals;
+    const Leaf::PortVector& out_ports = leaf->getOutPortRange();
+    for (port_it = out_ports.begin(); port_it != out_ports.end(); ++port_it) {
+        signals.push_back(getSignalByOutPort(*port_it));
+        output_signals.push_back(signals.back());
+    }
+
+    list<Signal*>::iterator it;
+    for (it = signals.begin(); it != signals.end(); ++it) {
+        CVariable variable = (*it)->getVariable();
+        code << kIndents;
+        if (variable.getDataType()->isArray()) {
+            code << variable.getPointerDeclarationString();
+        }
+        else {
+            code << variable.getLocalVariableDeclarationString();
+        }
+        code << " = context->" << variable.getReferenceString() << ";\n";
+    }
+    code << "\n";
+
+    try {
+        generateProfiledLeafExecutionCode(
+            code, leaf, generateLeafExecutionCode(leaf), true);
+    }
+    catch (InvalidModelException& ex) {
+        THROW_EXCEPTION(InvalidModelException, "Error in leaf \""
+                        + leaf->getId()->getString() + "\": "
+                        + ex.getMessage());
+    }
+
+    string write_back_code;
+    for (it = output_signals.begin(); it != output_signals.end(); ++it) {
+        CVariable variable = (*it)->getVariable();
+        if (variable.getDataType()->isArray()) continue;
+        write_back_code += kIndents + "context->"
+            + variable.getReferenceString() + " = "
+            + variable.getReferenceString() + ";\n";
+    }
+    if (write_back_code.length() > 0) code << "\n" << write_back_code;
+    code << "}";
+}
+
+void Synthesizer::generateTaskRuntimeDefinitionCode(CodeWriter& code)
+    throw() {
+    // Dependency tables
+    code << "static void (* const task_functions[F2CC_NUM_TASKS])"
+        << "(struct TaskContext*) = {\n";
+    for (size_t task = 0; task < tasks_.size(); ++task) {
+        code << kIndents << getTaskFunctionName(task);
+        if (task + 1 < tasks_.size()) code << ",";
+        code << "\n";
+    }
+    code << "};\n";
+    code << "static const int task_num_dependencies[F2CC_NUM_TASKS] = {";
+    for (size_t task = 0; task < tasks_.size(); ++task) {
+        if (task > 0) code << ", ";
+        code << task_num_dependencies_[task];
+    }
+    code << "};\n";
+    code << "static const int task_successor_offsets[F2CC_NUM_TASKS + 1] = {";
+    size_t num_successors = 0;
+    for (size_t task = 0; task < tasks_.size(); ++task) {
+        code << num_successors << ", ";
+        num_successors += task_successors_[task].size();
+    }
+    code << num_successors << "};\n";
+    code << "static const int task_successors[] = {";
+    if (num_successors == 0) code << "0";
+    num_successors = 0;
+    for (size_t task = 0; task < tasks_.size(); ++task) {
+        for (size_t k = 0; k < task_successors_[task].size(); ++k) {
+            if (num_successors > 0) code << ", ";
+            code << task_successors_[task][k];
+            ++num_successors;
+        }
+    }
+    code << "};\n"
+        << "\n";
+
+    code << "static void pushTask(struct TaskPool* pool, int worker, "
+        << "int task) {\n"
+        << kIndents << "struct TaskQueue* queue = &pool->queues[worker];\n"
+        << kIndents << "queue->tasks[queue->tail++] = task;\n"
+        << "}\n"
+        << "\n";
+    code << "static int popTask(struct TaskPool* pool, int worker) {\n"
+        << kIndents << "struct TaskQueue* queue = &pool->queues[worker];\n"
+        << kIndents << "int victim;\n"
+        << kIndents << "if (queue->tail > queue->head) {\n"
+        << kIndents << kIndents << "return queue->tasks[--queue->tail];\n"
+        << kIndents << "}\n"
+        << kIndents << "for (victim = 1; victim < F2CC_NUM_THREADS; ++victim) "
+        << "{\n"
+        << kIndents << kIndents << "queue = &pool->queues[(worker + victim) % "
+        << "F2CC_NUM_THREADS];\n"
+        << kIndents << kIndents << "if (queue->tail > queue->head) {\n"
+        << kIndents << kIndents << kIndents
+        << "return queue->tasks[queue->head++];\n"
+        << kIndents << kIndents << "}\n"
+        << kIndents << "}\n"
+        << kIndents << "return -1;\n"
+        << "}\n"
+        << "\n";
+    code << "/**\n"
+        << " * Executes tasks until all tasks of the current round have\n"
+        << " * finished. Must be called with the pool lock held.\n"
+        << " */\n";
+    code << "static void executeTasks(struct TaskPool* pool, "
+        << "int worker) {\n"
+        << kIndents << "int task;\n"
+        << kIndents << "int k;\n"
+        << kIndents << "int num_ready;\n"
+        << kIndents << "while (pool->num_unfinished > 0) {\n"
+        << kIndents << kIndents << "task = popTask(pool, worker);\n"
+        << kIndents << kIndents << "if (task < 0) {\n"
+        << kIndents << kIndents << kIndents
+        << "pthread_cond_wait(&pool->changed, &pool->lock);\n"
+        << kIndents << kIndents << kIndents << "continue;\n"
+        << kIndents << kIndents << "}\n"
+        << kIndents << kIndents << "pthread_mutex_unlock(&pool->lock);\n"
+        << kIndents << kIndents << "task_functions[task](pool->context);\n"
+        << kIndents << kIndents << "pthread_mutex_lock(&pool->lock);\n"
+        << kIndents << kIndents << "--pool->num_unfinished;\n"
+        << kIndents << kIndents << "num_ready = 0;\n"
+        << kIndents << kIndents << "for (k = task_successor_offsets[task];\n"
+        << kIndents << kIndents << "     k < task_successor_offsets[task + 1]; "
+        << "++k) {\n"
+        << kIndents << kIndents << kIndents
+        << "if (--pool->num_pending[task_successors[k]] == 0) {\n"
+        << kIndents << kIndents << kIndents << kIndents
+        << "pushTask(pool, worker, task_successors[k]);\n"
+        << kIndents << kIndents << kIndents << kIndents << "++num_ready;\n"
+        << kIndents << kIndents << kIndents << "}\n"
+        << kIndents << kIndents << "}\n"
+        << kIndents << kIndents << "// This thread takes one of the ready "
+        "tasks "
+        << "itself, so only wake the\n"
+        << kIndents << kIndents << "// others if there are more\n"
+        << kIndents << kIndents << "if (num_ready > 1 || pool->num_unfinished "
+        "== "
+        << "0) {\n"
+        << kIndents << kIndents << kIndents
+        << "pthread_cond_broadcast(&pool->changed);\n"
+        << kIndents << kIndents << "}\n"
+        << kIndents << "}\n"
+        << "}\n"
+        << "\n";
+    code << "static void* runTaskWorker(void* arg) {\n"
+        << kIndents << "struct TaskWorker* worker = (struct TaskWorker*) arg;\n"
+        << kIndents << "struct TaskPool* pool = worker->pool;\n"
+        << kIndents << "int round = 0;\n"
+        << kIndents << "pthread_mutex_lock(&pool->lock);\n"
+        << kIndents << "for (;;) {\n"
+        << kIndents << kIndents << "while (pool->round == round && "
+        << "!pool->is_stopping) {\n"
+        << kIndents << kIndents << kIndents
+        << "pthread_cond_wait(&pool->changed, &pool->lock);\n"
+        << kIndents << kIndents << "}\n"
+        << kIndents << kIndents << "if (pool->is_stopping) break;\n"
+        << kIndents << kIndents << "round = pool->round;\n"
+        << kIndents << kIndents << "executeTasks(pool, worker->id);\n"
+        << kIndents << "}\n"
+        << kIndents << "pthread_mutex_unlock(&pool->lock);\n"
+        << kIndents << "return NULL;\n"
+        << "}\n"
+        << "\n";
+    code << "/**\n"
+        << " * Starts all threads of the task pool but the first, which is "
+        "the\n"
+        << " * calling thread. Should a thread fail to start, the tasks are\n"
+        << " * executed by the remaining threads.\n"
+        << " */\n";
+    code << "static void startTaskPool(struct TaskPool* pool) {\n"
+        << kIndents << "int worker;\n"
+        << kIndents << "pthread_mutex_init(&pool->lock, NULL);\n"
+        << kIndents << "pthread_cond_init(&pool->changed, NULL);\n"
+        << kIndents << "pool->context = NULL;\n"
+        << kIndents << "pool->num_unfinished = 0;\n"
+        << kIndents << "pool->round = 0;\n"
+        << kIndents << "pool->is_stopping = 0;\n"
+        << kIndents << "for (worker = 0; worker < F2CC_NUM_THREADS; ++worker) "
+        << "{\n"
+        << kIndents << kIndents << "pool->workers[worker].id = worker;\n"
+        << kIndents << kIndents << "pool->workers[worker].pool = pool;\n"
+        << kIndents << kIndents << "pool->workers[worker].is_running = "
+        << "worker > 0\n"
+        << kIndents << kIndents << kIndents << "&& pthread_create("
+        << "&pool->workers[worker].thread, NULL,\n"
+        << kIndents << kIndents << kIndents << "                  "
+        << "runTaskWorker, &pool->workers[worker]) == 0;\n"
+        << kIndents << "}\n"
+        << "}\n"
+        << "\n";
+    code << "/**\n"
+        << " * Allocates a task pool and starts its threads. Returns NULL if "
+        "the\n"
+        << " * pool could not be allocated.\n"
+        << " */\n";
+    code << "static struct TaskPool* createTaskPool(void) {\n"
+        << kIndents << "struct TaskPool* pool = (struct TaskPool*) "
+        << "malloc(sizeof(struct TaskPool));\n"
+        << kIndents << "if (pool) startTaskPool(pool);\n"
+        << kIndents << "return pool;\n"
+        << "}\n"
+        << "\n";
+    code << "/**\n"
+        << " * Executes every task once, with the calling thread taking part,\n"
+        << " * and returns when all tasks have finished. Without a pool, the\n"
+        << " * calling thread executes the tasks on its own, in dependency "
+        "order.\n"
+        << " */\n";
+    code << "static void runTaskRound(struct TaskPool* pool, "
+        << "struct TaskContext* context) {\n"
+        << kIndents << "int task;\n"
+        << kIndents << "int worker;\n"
+        << kIndents << "if (!pool) {\n"
+        << kIndents << kIndents << "for (task = 0; task < F2CC_NUM_TASKS; "
+        << "++task) {\n"
+        << kIndents << kIndents << kIndents
+        << "task_functions[task](context);\n"
+        << kIndents << kIndents << "}\n"
+        << kIndents << kIndents << "return;\n"
+        << kIndents << "}\n"
+        << kIndents << "pthread_mutex_lock(&pool->lock);\n"
+        << kIndents << "pool->context = context;\n"
+        << kIndents << "for (worker = 0; worker < F2CC_NUM_THREADS; ++worker) "
+        << "{\n"
+        << kIndents << kIndents << "pool->queues[worker].head = 0;\n"
+        << kIndents << kIndents << "pool->queues[worker].tail = 0;\n"
+        << kIndents << "}\n"
+        << kIndents << "// Spread the tasks without dependencies over the "
+        << "threads\n"
+        << kIndents << "for (task = 0, worker = 0; task < F2CC_NUM_TASKS; "
+        << "++task) {\n"
+        << kIndents << kIndents << "pool->num_pending[task] = "
+        << "task_num_dependencies[task];\n"
+        << kIndents << kIndents << "if (pool->num_pending[task] == 0) {\n"
+        << kIndents << kIndents << kIndents
+        << "pushTask(pool, worker, task);\n"
+        << kIndents << kIndents << kIndents
+        << "worker = (worker + 1) % F2CC_NUM_THREADS;\n"
+        << kIndents << kIndents << "}\n"
+        << kIndents << "}\n"
+        << kIndents << "pool->num_unfinished = F2CC_NUM_TASKS;\n"
+        << kIndents << "++pool->round;\n"
+        << kIndents << "pthread_cond_broadcast(&pool->changed);\n"
+        << kIndents << "executeTasks(pool, 0);\n"
+        << kIndents << "pthread_mutex_unlock(&pool->lock);\n"
+        << "}\n"
+        << "\n";
+    code << "/**\n"
+        << " * Stops the threads of a task pool and frees it.\n"
+        << " */\n";
+    code << "static void destroyTaskPool(struct TaskPool* pool) {\n"
+        << kIndents << "int worker;\n"
+        << kIndents << "pthread_mutex_lock(&pool->lock);\n"
+        << kIndents << "pool->is_stopping = 1;\n"
+        << kIndents << "pthread_cond_broadcast(&pool->changed);\n"
+        << kIndents << "pthread_mutex_unlock(&pool->lock);\n"
+        << kIndents << "for (worker = 0; worker < F2CC_NUM_THREADS; ++worker) "
+        << "{\n"
+        << kIndents << kIndents << "if (pool->workers[worker].is_running) {\n"
+        << kIndents << kIndents << kIndents
+        << "pthread_join(pool->workers[worker].thread, NULL);\n"
+        << kIndents << kIndents << "}\n"
+        << kIndents << "}\n"
+        << kIndents << "pthread_cond_destroy(&pool->changed);\n"
+        << kIndents << "pthread_mutex_destroy(&pool->lock);\n"
+        << kIndents << "free(pool);\n"
+        << "}\n"
+        << "\n";
+    generateStopThreadsFunctionDefinitionCode(code);
+}
+
+void Synthesizer::generateStopThreadsFunctionDefinitionCode(CodeWriter& code)
+    throw() {
+    string pool = getThreadPoolReferenceString();
+    if (!config_.doReentrantCode()) {
+        code << "/**\n"
+            << " * Thread pool shared by all calls.\n"
+            << " */\n";
+        code << "static struct " << getThreadPoolStructName() << "* "
+            << kThreadPoolVariableName << " = NULL;\n"
+            << "\n";
+    }
+    code << generateStopThreadsFunctionPrototypeCode() << " {\n"
+        << kIndents << "if (" << pool << ") {\n"
+        << kIndents << kIndents << "destroy" << getThreadPoolStructName()
+        << "(" << pool << ");\n"
+        << kIndents << kIndents << pool << " = NULL;\n"
+        << kIndents << "}\n"
+        << "}\n";
+}
+
+string Synthesizer::generateStopThreadsFunctionPrototypeCode() const throw() {
+    string code = "void stopProcessNetworkThreads(";
+    if (config_.doReentrantCode()) {
+        code += getStateParameterDeclarationString();
+    }
+    else {
+        code += "void";
+    }
+    return code + ")";
+}
+
+string Synthesizer::getThreadPoolReferenceString() const throw() {
+    if (config_.doReentrantCode()) {
+        return kStateParameterName + "->" + kThreadPoolVariableName;
+    }
+    return kThreadPoolVariableName;
+}
+
+string Synthesizer::getThreadPoolStructName() const throw() {
+    return target_platform_ == C_PIPELINED ? "PipelinePool" : "TaskPool";
+}
+
+bool Synthesizer::hasThreadPool() const throw() {
+    return target_platform_ == C_PIPELINED
+        || target_platform_ == C_TASK_PARALLEL;
+}
+
+void Synthesizer::generateTaskParallelBlockFunctionDefinitionCode(
+    CodeWriter& code)
+    throw(InvalidModelException, IOException, RuntimeException) {
+    code << generateProcessNetworkBlockFunctionPrototypeCode() << " {\n";
+    code << kIndents << "int i; // Can safely be removed if the compiler "
+        "warns\n"
+        << kIndents << "       // about it being unused\n";
+    code << kIndents << "int " << kBlockTokenVariableName << ";\n";
+    code << kIndents << "struct TaskContext context;\n";
+    generateSignalVariableDeclarationsCode(code);
+    code << "\n";
+    size_t delay_code_start = code.getSize();
+    generateDelayVariableDeclarationsCode(code);
+    if (code.getSize() > delay_code_start) code << "\n";
+
+    string to_context_code;
+    string from_context_code;
+    set<Signal*>::iterator it;
+    for (it = signals_.begin(); it != signals_.end(); ++it) {
+        Signal* signal = *it;
+        if (!isTaskSignal(signal)) continue;
+        string name = signal->getVariable().getReferenceString();
+        to_context_code += kIndents + "context." + name + " = " + name
+            + ";\n";
+        if (!signal->getVariable().getDataType()->isArray()
+            && signal->getOutPort()
+            && !dynamic_cast<delay*>(signal->getOutPort()->getProcess())) {
+            from_context_code += kIndents + name + " = context." + name
+                + ";\n";
+        }
+    }
+
+    code << kIndents << "if (!" << getThreadPoolReferenceString() << ") {\n"
+        << kIndents << kIndents << getThreadPoolReferenceString()
+        << " = createTaskPool();\n"
+        << kIndents << "}\n"
+        << "\n";
+    code << kIndents << "// Execute processnetwork once for each token\n";
+    code << kIndents << "for (" << kBlockTokenVariableName << " = 0; "
+        << kBlockTokenVariableName << " < " << kBlockNumTokensParameterName
+        << "; ++" << kBlockTokenVariableName << ") {\n";
+    code.indent();
+    generateArrayInputOutputsToSignalsAliasingCode(code, true);
+    code << "\n";
+    size_t ring_code_start = code.getSize();
+    generateDelayRingAliasingCode(code);
+    if (code.getSize() > ring_code_start) code << "\n";
+    size_t view_code_start = code.getSize();
+    generateSignalArrayViewsAliasingCode(code);
+    if (code.getSize() > view_code_start) code << "\n";
+    generateInputsToSignalsCopyingCode(code, true);
+    code << "\n";
+    code << kIndents << "// Execute leafs\n";
+    generateDelayExecutionCode(code, -1, true);
+    code << kIndents << "// Share signal variables with the tasks and "
+        "execute them\n";
+    code << to_context_code;
+    code << kIndents << "runTaskRound(" << getThreadPoolReferenceString()
+        << ", &context);\n";
+    code << from_context_code;
+    generateDelayExecutionCode(code, -1, false);
+    code << "\n";
+    generateSignalsToOutputsCopyingCode(code, true);
+    code.unindent();
+    code << kIndents << "}\n";
+    code << "\n";
+    generateSignalVariableCleanupCode(code);
+    code << "}";
+}
+
+bool Synthesizer::hasBlockFunction() const throw() {
+    return config_.doBlockProcessing() || target_platform_ == C_PIPELINED
+        || target_platform_ == C_TASK_PARALLEL;
 }
 
 string Synthesizer::generateVariableCopyingCode(CVariable to, CVariable from,
@@ -1955,13 +4590,14 @@ string Synthesizer::generateVariableCopyingCode(CVariable to,
         }
         else {
             size_t from_array_size = it->getDataType()->getArraySize();
-            code += kIndents + "for (i = " + tools::toString(to_index)
-                + ", j = 0; i < "
-                + tools::toString(to_index + from_array_size)
-                + "; ++i, ++j) {\n"
-                + kIndents + kIndents + to.getReferenceString() + "[i] = "
-                + it->getReferenceString() + "[j];\n"
-                + kIndents + "}\n";
+            if (!isSignalArrayView(*it, &to)) {
+                code += kIndents + "for (i = 0; i < "
+                    + tools::toString(from_array_size) + "; ++i) {\n"
+                    + kIndents + kIndents + to.getReferenceString() + "[i + "
+                    + tools::toString(to_index) + "] = "
+                    + it->getReferenceString() + "[i];\n"
+                    + kIndents + "}\n";
+            }
             to_index += from_array_size;
         }
     }
@@ -1973,7 +4609,7 @@ string Synthesizer::generateVariableCopyingCode(list<CVariable>& to,
     throw(InvalidModelException, IOException, RuntimeException) {
     size_t num_to_elements = 0;
     for (list<CVariable>::iterator it = to.begin(); it != to.end(); ++it) {
-        ensureVariableIsNotConst(*it);
+        if (!isSignalArrayView(*it, &from)) ensureVariableIsNotConst(*it);
         ensureVariableDataTypeCompatibilities(*it, from);
         num_to_elements += it->getDataType()->getArraySize();
     }
@@ -1999,13 +4635,14 @@ string Synthesizer::generateVariableCopyingCode(list<CVariable>& to,
         }
         else {
             size_t to_array_size = it->getDataType()->getArraySize();
-            code += kIndents + "for (i = " + tools::toString(from_index)
-                + ", j = 0; i < "
-                + tools::toString(from_index + to_array_size)
-                + "; ++i, ++j) {\n"
-                + kIndents + kIndents + it->getReferenceString() + "[j] = "
-                + from.getReferenceString() + "[i];\n"
-                + kIndents + "}\n";
+            if (!isSignalArrayView(*it, &from)) {
+                code += kIndents + "for (i = 0; i < "
+                    + tools::toString(to_array_size) + "; ++i) {\n"
+                    + kIndents + kIndents + it->getReferenceString()
+                    + "[i] = " + from.getReferenceString() + "[i + "
+                    + tools::toString(from_index) + "];\n"
+                    + kIndents + "}\n";
+            }
             from_index += to_array_size;
         }
     }
@@ -2159,112 +4796,113 @@ void Synthesizer::ensureVariableArrayCompatibilities(CVariable lhs,
     }
 }
 
-string Synthesizer::generateKernelConfigStructDefinitionCode()
+void Synthesizer::generateKernelConfigStructDefinitionCode(CodeWriter& code)
     throw(InvalidModelException, IOException, RuntimeException) {
-    string code;
-    code += string("/**\n")
-        + " * C struct for returning the calculated kernel configuration for \n"
-        + " * best performance.\n"
-        + " */\n";
-    code += string("struct KernelConfig {\n")
-        + kIndents + "dim3 grid;\n"
-        + kIndents + "dim3 threadBlock;\n"
-        + kIndents + "size_t sharedMemory;\n"
-        + "};\n";
-    return code;
+    code << "/**\n"
+        << " * C struct for returning the calculated kernel configuration for "
+        "\n"
+        << " * best performance.\n"
+        << " */\n";
+    code << "struct KernelConfig {\n"
+        << kIndents << "dim3 grid;\n"
+        << kIndents << "dim3 threadBlock;\n"
+        << kIndents << "size_t sharedMemory;\n"
+        << "};\n";
 }
 
-string Synthesizer::generateKernelConfigFunctionDefinitionCode()
+void Synthesizer::generateKernelConfigFunctionDefinitionCode(
+    CodeWriter& code)
     throw(InvalidModelException, IOException, RuntimeException) {
-    string code;
-    code += string("/**\n")
-        + " * Calculate the best kernel configuration of grid and thread\n"
-        + " * blocks for best performance. The aim is to maximize the number\n"
-        + " * of threads available for each CUDA multi-leafor.\n"
-        + " *\n"
-        + " * When no shared memory is used:\n"
-        + " * The configuration is calculated by using the maximum number of\n"
-        + " * threads per thread block, and then the grid is set to the\n"
-        + " * lowest number of thread blocks which will accommodate the\n"
-        + " * desired thread count.\n"
-        + " * \n"
-        + " * When shared memory is used:\n"
-        + " * The configuration is calculated by starting with as large a\n"
-        + " * thread block as possible. If the thread block uses too much\n"
-        + " * shared memory, the size is decreased until it does fit. If \n"
-        + " * the shared memory is not optimally used, the thread block\n"
-        + " * continues until either all shared memory is used optimally or\n"
-        + " * until the shared memory can fit more than 8 thread blocks\n"
-        + " * (there is no point in going further since no more than 8 thread\n"
-        + " * blocks can be scheduled on an SM). If no optimal configuration\n"
-        + " * has been found, the best one is selected.\n"
-        + " *\n"
-        + " * @param num_threads\n"
-        + " *        Number of threads to execute in the kernel invocation.\n"
-        + " * @param max_threads_per_block\n"
-        + " *        Maximum number of threads per block on this device.\n"
-        + " * @param shared_memory_used_per_thread\n"
-        + " *        Amount of shared memory used per thread.\n"
-        + " * @param shared_memory_per_sm\n"
-        + " *        Amount of shared memory available per streaming \n"
-        + " *        multi-leafor.\n"
-        + " */\n";
-    code += string("struct KernelConfig calculateBestKernelConfig(")
-        + "int num_threads, int max_threads_per_block, "
-        + "int shared_memory_used_per_thread, "
-        + "int shared_memory_per_sm) {\n";
+    code << "/**\n"
+        << " * Calculate the best kernel configuration of grid and thread\n"
+        << " * blocks for best performance. The aim is to maximize the number\n"
+        << " * of threads available for each CUDA multi-leafor.\n"
+        << " *\n"
+        << " * When no shared memory is used:\n"
+        << " * The configuration is calculated by using the maximum number of\n"
+        << " * threads per thread block, and then the grid is set to the\n"
+        << " * lowest number of thread blocks which will accommodate the\n"
+        << " * desired thread count.\n"
+        << " * \n"
+        << " * When shared memory is used:\n"
+        << " * The configuration is calculated by starting with as large a\n"
+        << " * thread block as possible. If the thread block uses too much\n"
+        << " * shared memory, the size is decreased until it does fit. If \n"
+        << " * the shared memory is not optimally used, the thread block\n"
+        << " * continues until either all shared memory is used optimally or\n"
+        << " * until the shared memory can fit more than 8 thread blocks\n"
+        << " * (there is no point in going further since no more than 8 "
+        "thread\n"
+        << " * blocks can be scheduled on an SM). If no optimal configuration\n"
+        << " * has been found, the best one is selected.\n"
+        << " *\n"
+        << " * @param num_threads\n"
+        << " *        Number of threads to execute in the kernel invocation.\n"
+        << " * @param max_threads_per_block\n"
+        << " *        Maximum number of threads per block on this device.\n"
+        << " * @param shared_memory_used_per_thread\n"
+        << " *        Amount of shared memory used per thread.\n"
+        << " * @param shared_memory_per_sm\n"
+        << " *        Amount of shared memory available per streaming \n"
+        << " *        multi-leafor.\n"
+        << " */\n";
+    code << "struct KernelConfig calculateBestKernelConfig("
+        << "int num_threads, int max_threads_per_block, "
+        << "int shared_memory_used_per_thread, "
+        << "int shared_memory_per_sm) {\n";
     if (config_.useSharedMemoryForInput()) {
-        code += string()
-            + kIndents + "int threads_per_block_best;\n"
-            + kIndents + "int unused_shared_memory_best = "
-            + "shared_memory_per_sm;\n"
-            + kIndents + "for (int threads_per_block = max_threads_per_block; "
-            + "; --threads_per_block) {\n"
-            + kIndents + kIndents + "int num_blocks_per_sm = "
-            + "shared_memory_per_sm"
-            + " / (threads_per_block * shared_memory_used_per_thread);\n"
-            + kIndents + kIndents + "if (num_blocks_per_sm == 0) continue;\n"
-            + kIndents + kIndents + "int total_shared_memory_used = "
-            + "num_blocks_per_sm * threads_per_block"
-            + " * shared_memory_used_per_thread;\n"
-            + kIndents + kIndents + "int unused_shared_memory = "
-            + "shared_memory_per_sm - total_shared_memory_used;\n"
-            + kIndents + kIndents + "if (unused_shared_memory"
-            + " < unused_shared_memory_best) {\n"
-            + kIndents + kIndents + kIndents + "threads_per_block_best = "
-            + "threads_per_block;\n"
-            + kIndents + kIndents + kIndents + "unused_shared_memory_best = "
-            + "unused_shared_memory;\n"
-            + kIndents + kIndents + "}\n"
-            + kIndents + kIndents + "// Stop if this is optimal or as good as "
+        code << kIndents << "int threads_per_block_best;\n"
+            << kIndents << "int unused_shared_memory_best = "
+            << "shared_memory_per_sm;\n"
+            << kIndents << "for (int threads_per_block = "
+            "max_threads_per_block; "
+            << "; --threads_per_block) {\n"
+            << kIndents << kIndents << "int num_blocks_per_sm = "
+            << "shared_memory_per_sm"
+            << " / (threads_per_block * shared_memory_used_per_thread);\n"
+            << kIndents << kIndents << "if (num_blocks_per_sm == 0) continue;\n"
+            << kIndents << kIndents << "int total_shared_memory_used = "
+            << "num_blocks_per_sm * threads_per_block"
+            << " * shared_memory_used_per_thread;\n"
+            << kIndents << kIndents << "int unused_shared_memory = "
+            << "shared_memory_per_sm - total_shared_memory_used;\n"
+            << kIndents << kIndents << "if (unused_shared_memory"
+            << " < unused_shared_memory_best) {\n"
+            << kIndents << kIndents << kIndents << "threads_per_block_best = "
+            << "threads_per_block;\n"
+            << kIndents << kIndents << kIndents << "unused_shared_memory_best "
+            "= "
+            << "unused_shared_memory;\n"
+            << kIndents << kIndents << "}\n"
+            << kIndents << kIndents << "// Stop if this is optimal or as good "
+            "as "
             "it gets\n"
-            + kIndents + kIndents + "if (unused_shared_memory == 0 "
+            << kIndents << kIndents << "if (unused_shared_memory == 0 "
             "|| num_blocks_per_sm > 8) break;\n"
-            + kIndents + "}\n"
-            + "\n"
-            + kIndents + "int num_blocks = (num_threads + "
-            + "threads_per_block_best - 1) / threads_per_block_best;\n"
-            + kIndents + "struct KernelConfig config;\n"
-            + kIndents + "config.grid = dim3(num_blocks, 1);\n"
-            + kIndents + "config.threadBlock = dim3(threads_per_block_best, "
-            + "1);\n"
-            + kIndents + "config.sharedMemory = "
-            + "threads_per_block_best * shared_memory_used_per_thread;\n"
-            + kIndents + "return config;\n";
+            << kIndents << "}\n"
+            << "\n"
+            << kIndents << "int num_blocks = (num_threads + "
+            << "threads_per_block_best - 1) / threads_per_block_best;\n"
+            << kIndents << "struct KernelConfig config;\n"
+            << kIndents << "config.grid = dim3(num_blocks, 1);\n"
+            << kIndents << "config.threadBlock = dim3(threads_per_block_best, "
+            << "1);\n"
+            << kIndents << "config.sharedMemory = "
+            << "threads_per_block_best * shared_memory_used_per_thread;\n"
+            << kIndents << "return config;\n";
     }
     else {
-        code += kIndents + "int num_blocks = "
-            + "(num_threads + max_threads_per_block - 1)"
-            + " / max_threads_per_block;\n"
-            + kIndents + "struct KernelConfig config;\n"
-            + kIndents + "config.grid = dim3(num_blocks, 1);\n"
-            + kIndents + "config.threadBlock = "
-            + "dim3(max_threads_per_block, 1);\n"
-            + kIndents + "config.sharedMemory = 0;\n"
-            + kIndents + "return config;\n";
-    }
-    code += "}\n";
-    return code;
+        code << kIndents << "int num_blocks = "
+            << "(num_threads + max_threads_per_block - 1)"
+            << " / max_threads_per_block;\n"
+            << kIndents << "struct KernelConfig config;\n"
+            << kIndents << "config.grid = dim3(num_blocks, 1);\n"
+            << kIndents << "config.threadBlock = "
+            << "dim3(max_threads_per_block, 1);\n"
+            << kIndents << "config.sharedMemory = 0;\n"
+            << kIndents << "return config;\n";
+    }
+    code << "}\n";
 }
 
 string Synthesizer::getGlobalLeafFunctionName(
@@ -2277,14 +4915,544 @@ bool Synthesizer::dynamicallyAllocateMemoryForSignalVariable(Signal* signal) {
     // from any processnetwork input parameter nor read from for the processnetwork output
     // parameters
     return signal->getOutPort() && signal->getInPort()
-        && signal->getVariable().getDataType()->isArray();
+        && signal->getVariable().getDataType()->isArray()
+        && !isSignalArrayView(signal->getVariable())
+        && !isDelayRingSignal(signal);
+}
+
+void Synthesizer::createSignalArrayViews()
+    throw(InvalidModelException, IOException, RuntimeException) {
+    signal_array_views_.clear();
+    if (!config_.doZeroCopyViews()) {
+        logger_.logMessage(Logger::INFO, "Zero-copy views are disabled");
+        return;
+    }
+
+    // Unzipx outputs become views into the input, in schedule order as the
+    // input may in turn be a view into the input of a preceding Unzipx leaf
+    for (list<Id>::iterator it = schedule_.begin(); it != schedule_.end();
+         ++it) {
+        Leaf* current_leaf = processnetwork_->getProcess(*it);
+        if (!current_leaf) {
+            THROW_EXCEPTION(IllegalStateException, string("Leaf \"") +
+                            it->getString() + "\" not found");
+        }
+        Unzipx* unzipx = dynamic_cast<Unzipx*>(current_leaf);
+        if (!unzipx) continue;
+
+        Signal* input = getSignalByInPort(unzipx->getInPortRange().front());
+        bool is_input_const = input->getDataType()->isConst();
+        const Leaf::PortVector& out_ports = unzipx->getOutPortRange();
+        Leaf::PortVector::const_iterator port_it;
+        size_t offset = 0;
+        for (port_it = out_ports.begin(); port_it != out_ports.end();
+             ++port_it) {
+            Signal* output = getSignalByOutPort(*port_it);
+            if (canBeSignalArrayView(output)
+                && (!is_input_const || isSignalOnlyReadByConsumer(output))) {
+                output->getDataType()->setIsConst(is_input_const);
+                signal_array_views_.push_back(
+                    pair<Signal*, pair<Signal*, size_t> >(
+                        output, pair<Signal*, size_t>(input, offset)));
+            }
+            offset += output->getDataType()->getArraySize();
+        }
+    }
+
+    // Zipx inputs become views into the output, in reversed schedule order as
+    // the output may in turn be a view into the output of a succeeding Zipx
+    // leaf
+    for (list<Id>::reverse_iterator it = schedule_.rbegin();
+         it != schedule_.rend(); ++it) {
+        Leaf* current_leaf = processnetwork_->getProcess(*it);
+        if (!current_leaf) {
+            THROW_EXCEPTION(IllegalStateException, string("Leaf \"") +
+                            it->getString() + "\" not found");
+        }
+        Zipx* zipx = dynamic_cast<Zipx*>(current_leaf);
+        if (!zipx) continue;
+
+        Signal* output = getSignalByOutPort(zipx->getOutPortRange().front());
+        if (output->getDataType()->isConst()) continue;
+        const Leaf::PortVector& in_ports = zipx->getInPortRange();
+        Leaf::PortVector::const_iterator port_it;
+        size_t offset = 0;
+        for (port_it = in_ports.begin(); port_it != in_ports.end();
+             ++port_it) {
+            Signal* input = getSignalByInPort(*port_it);
+            if (canBeSignalArrayView(input)
+                && !isSignalArrayView(input->getVariable())) {
+                signal_array_views_.push_back(
+                    pair<Signal*, pair<Signal*, size_t> >(
+                        input, pair<Signal*, size_t>(output, offset)));
+            }
+            offset += input->getDataType()->getArraySize();
+        }
+    }
+
+    logger_.logMessage(Logger::INFO, string("Created ")
+                       + tools::toString(signal_array_views_.size())
+                       + " zero-copy view(s)");
+}
+
+bool Synthesizer::canBeSignalArrayView(Signal* signal)
+    throw(RuntimeException) {
+    if (!signal->getOutPort() || !signal->getInPort()) return false;
+    if (!signal->getDataType()->isArray()) return false;
+    if (target_platform_ == C_PIPELINED) {
+        pair<int, int> stages = getPipelineStagesOfSignal(signal);
+        if (stages.first != stages.second) return false;
+    }
+    return true;
+}
+
+bool Synthesizer::isSignalOnlyReadByConsumer(Signal* signal)
+    throw(RuntimeException) {
+    Process* consumer = signal->getInPort()->getProcess();
+    CFunction* function = NULL;
+    size_t parameter_index = 0;
+    if (Map* mapsy = dynamic_cast<Map*>(consumer)) {
+        function = mapsy->getFunction();
+    }
+    else if (ZipWithNSY* zipwithnsy = dynamic_cast<ZipWithNSY*>(consumer)) {
+        function = zipwithnsy->getFunction();
+        const Leaf::PortVector& in_ports = zipwithnsy->getInPortRange();
+        Leaf::PortVector::const_iterator port_it;
+        for (port_it = in_ports.begin(); port_it != in_ports.end()
+                 && *port_it != signal->getInPort(); ++port_it) {
+            ++parameter_index;
+        }
+    }
+    else {
+        // The remaining leafs only copy their inputs
+        return dynamic_cast<Unzipx*>(consumer) || dynamic_cast<Zipx*>(consumer)
+            || dynamic_cast<Fanout*>(consumer)
+            || dynamic_cast<delay*>(consumer);
+    }
+
+    list<CVariable*> parameters = function->getInputParameters();
+    list<CVariable*>::iterator param_it = parameters.begin();
+    for (size_t i = 0; i < parameter_index && param_it != parameters.end();
+         ++i) {
+        ++param_it;
+    }
+    if (param_it == parameters.end()) return false;
+    return (*param_it)->getDataType()->isConst();
+}
+
+bool Synthesizer::isSignalArrayView(const CVariable& variable,
+                                    const CVariable* viewed) const throw() {
+    list< pair<Signal*, pair<Signal*, size_t> > >::const_iterator it;
+    for (it = signal_array_views_.begin(); it != signal_array_views_.end();
+         ++it) {
+        if (it->first->getVariable().getReferenceString()
+            != variable.getReferenceString()) {
+            continue;
+        }
+        return !viewed || it->second.first->getVariable().getReferenceString()
+            == viewed->getReferenceString();
+    }
+    return false;
+}
+
+void Synthesizer::generateSignalArrayViewsAliasingCode(CodeWriter& code,
+                                                       int stage)
+    throw(InvalidModelException, IOException, RuntimeException) {
+    bool at_least_one = false;
+    list< pair<Signal*, pair<Signal*, size_t> > >::iterator it;
+    for (it = signal_array_views_.begin(); it != signal_array_views_.end();
+         ++it) {
+        Signal* view = it->first;
+        Signal* viewed = it->second.first;
+        if (stage >= 0 && !isSignalInPipelineStage(view, stage)) continue;
+
+        CVariable view_variable = view->getVariable();
+        CDataType viewed_part_data_type = *view_variable.getDataType();
+        viewed_part_data_type.setIsConst(viewed->getDataType()->isConst());
+        CVariable viewed_part(string("&")
+                              + viewed->getVariable().getReferenceString()
+                              + "[" + tools::toString(it->second.second)
+                              + "]", viewed_part_data_type);
+        string copy_code =
+            generateVariableCopyingCode(view_variable, viewed_part, false);
+        if (copy_code.empty()) continue;
+        if (!at_least_one) {
+            code << kIndents << "// Alias signal array variables with parts "
+                "of other signal array variables\n";
+            at_least_one = true;
+        }
+        code << copy_code;
+    }
+}
+
+void Synthesizer::planSignalMemory()
+    throw(InvalidModelException, IOException, RuntimeException) {
+    signal_arena_offsets_.clear();
+    signal_arena_sizes_.clear();
+    if (!config_.doMemoryPlanning()) {
+        logger_.logMessage(Logger::INFO, "Memory planning is disabled");
+        return;
+    }
+
+    map<const Process*, size_t> positions;
+    size_t position = 1;
+    for (list<Id>::iterator it = schedule_.begin(); it != schedule_.end();
+         ++it, ++position) {
+        Leaf* current_leaf = processnetwork_->getProcess(*it);
+        if (!current_leaf) {
+            THROW_EXCEPTION(IllegalStateException, string("Leaf \"") +
+                            it->getString() + "\" not found");
+        }
+        positions[current_leaf] = position;
+    }
+
+    if (target_platform_ == C_PIPELINED) {
+        for (int stage = 0; stage < num_pipeline_stages_; ++stage) {
+            planSignalMemory(stage, positions);
+        }
+    }
+    else {
+        planSignalMemory(-1, positions);
+    }
+}
+
+void Synthesizer::planSignalMemory(int stage,
+                                   const map<const Process*, size_t>&
+                                   positions)
+    throw(InvalidModelException, IOException, RuntimeException) {
+    // Find the live intervals of all arrays which would otherwise be allocated
+    // separately
+    map<Signal*, pair<size_t, size_t> > intervals;
+    set<Signal*>::iterator it;
+    for (it = signals_.begin(); it != signals_.end(); ++it) {
+        Signal* signal = *it;
+        if (stage >= 0 && !isSignalInPipelineStage(signal, stage)) continue;
+        if (!dynamicallyAllocateMemoryForSignalVariable(signal)) continue;
+        intervals[signal] = getSignalLiveInterval(signal, stage, positions);
+    }
+    if (intervals.size() == 0) return;
+
+    // Extend the live intervals with those of the views into the arrays
+    list< pair<Signal*, pair<Signal*, size_t> > >::iterator view_it;
+    for (view_it = signal_array_views_.begin();
+         view_it != signal_array_views_.end(); ++view_it) {
+        Signal* view = view_it->first;
+        if (stage >= 0 && !isSignalInPipelineStage(view, stage)) continue;
+        map<Signal*, pair<size_t, size_t> >::iterator interval_it =
+            intervals.find(getSignalArrayViewRoot(view));
+        if (interval_it == intervals.end()) continue;
+        pair<size_t, size_t> view_interval =
+            getSignalLiveInterval(view, stage, positions);
+        interval_it->second.first = std::min(interval_it->second.first,
+                                             view_interval.first);
+        interval_it->second.second = std::max(interval_it->second.second,
+                                              view_interval.second);
+    }
+
+    // Place the arrays, largest first. Arrays of equal size are placed in
+    // signal order, as the placement would otherwise depend on where the
+    // signals happen to be allocated
+    vector< pair<size_t, Signal*> > arrays_by_size;
+    size_t unshared_size = 0;
+    set<Signal*, SignalComparator> ordered_signals;
+    map<Signal*, pair<size_t, size_t> >::iterator interval_it;
+    for (interval_it = intervals.begin(); interval_it != intervals.end();
+         ++interval_it) {
+        ordered_signals.insert(interval_it->first);
+    }
+    set<Signal*, SignalComparator>::iterator signal_it;
+    for (signal_it = ordered_signals.begin();
+         signal_it != ordered_signals.end(); ++signal_it) {
+        CDataType* data_type = (*signal_it)->getDataType();
+        size_t size =
+            data_type->getArraySize() * data_type->getMaxElementSize();
+        size = (size + kSignalArenaAlignment - 1) / kSignalArenaAlignment
+            * kSignalArenaAlignment;
+        arrays_by_size.push_back(pair<size_t, Signal*>(size, *signal_it));
+        unshared_size += size;
+    }
+    std::stable_sort(arrays_by_size.begin(), arrays_by_size.end(),
+                     ArraySizeComparator());
+    list< pair<Signal*, pair<size_t, size_t> > > placed_arrays;
+    size_t arena_size = 0;
+    vector< pair<size_t, Signal*> >::iterator array_it;
+    for (array_it = arrays_by_size.begin(); array_it != arrays_by_size.end();
+         ++array_it) {
+        Signal* signal = array_it->second;
+        size_t size = array_it->first;
+        pair<size_t, size_t> interval = intervals[signal];
+
+        // Find the memory ranges occupied by arrays live at the same time
+        vector< pair<size_t, size_t> > occupied_ranges;
+        list< pair<Signal*, pair<size_t, size_t> > >::iterator placed_it;
+        for (placed_it = placed_arrays.begin();
+             placed_it != placed_arrays.end(); ++placed_it) {
+            pair<size_t, size_t> placed_interval = intervals[placed_it->first];
+            if (placed_interval.second < interval.first
+                || interval.second < placed_interval.first) {
+                continue;
+            }
+            occupied_ranges.push_back(placed_it->second);
+        }
+        std::sort(occupied_ranges.begin(), occupied_ranges.end());
+
+        size_t offset = 0;
+        vector< pair<size_t, size_t> >::iterator range_it;
+        for (range_it = occupied_ranges.begin();
+             range_it != occupied_ranges.end(); ++range_it) {
+            if (range_it->first >= offset + size) break;
+            offset = std::max(offset, range_it->second);
+        }
+
+        placed_arrays.push_back(pair<Signal*, pair<size_t, size_t> >(
+                                    signal, pair<size_t, size_t>(
+                                        offset, offset + size)));
+        signal_arena_offsets_[pair<int, Signal*>(stage, signal)] = offset;
+        arena_size = std::max(arena_size, offset + size);
+    }
+    signal_arena_sizes_[stage] = arena_size;
+
+    string message = string("Planned signal arena of ")
+        + tools::toString(arena_size) + " bytes for "
+        + tools::toString(intervals.size()) + " signal array(s) ("
+        + tools::toString(unshared_size) + " bytes without sharing)";
+    if (stage >= 0) {
+        message += string(" in pipeline stage ") + tools::toString(stage + 1);
+    }
+    logger_.logMessage(Logger::INFO, message);
+}
+
+pair<size_t, size_t> Synthesizer::getSignalLiveInterval(
+    Signal* signal, int stage, const map<const Process*, size_t>& positions)
+    throw(RuntimeException) {
+    pair<size_t, size_t> interval(0, schedule_.size() + 1);
+
+    // Tasks of independent branches may execute in any order, so schedule
+    // positions say nothing about which arrays are live at the same time
+    if (target_platform_ == C_TASK_PARALLEL) return interval;
+
+    Process* producer = signal->getOutPort()->getProcess();
+    if (!dynamic_cast<delay*>(producer)
+        && (stage < 0 || getPipelineStage(producer) == stage)) {
+        map<const Process*, size_t>::const_iterator it =
+            positions.find(producer);
+        if (it == positions.end()) {
+            THROW_EXCEPTION(IllegalStateException, string("Leaf \"")
+                            + producer->getId()->getString() + "\" not in "
+                            "schedule");
+        }
+        interval.first = it->second;
+    }
+    Process* consumer = signal->getInPort()->getProcess();
+    if (!dynamic_cast<delay*>(consumer)
+        && (stage < 0 || getPipelineStage(consumer) == stage)) {
+        map<const Process*, size_t>::const_iterator it =
+            positions.find(consumer);
+        if (it == positions.end()) {
+            THROW_EXCEPTION(IllegalStateException, string("Leaf \"")
+                            + consumer->getId()->getString() + "\" not in "
+                            "schedule");
+        }
+        interval.second = it->second;
+    }
+    return interval;
+}
+
+Synthesizer::Signal* Synthesizer::getSignalArrayViewRoot(Signal* signal)
+    const throw() {
+    list< pair<Signal*, pair<Signal*, size_t> > >::const_iterator it;
+    for (it = signal_array_views_.begin(); it != signal_array_views_.end();
+         ++it) {
+        if (it->first == signal) {
+            return getSignalArrayViewRoot(it->second.first);
+        }
+    }
+    return signal;
+}
+
+void Synthesizer::createDelayRings()
+    throw(InvalidModelException, IOException, RuntimeException) {
+    delay_rings_.clear();
+    for (list<Id>::iterator it = schedule_.begin(); it != schedule_.end();
+         ++it) {
+        Leaf* current_leaf = processnetwork_->getProcess(*it);
+        if (!current_leaf) {
+            THROW_EXCEPTION(IllegalStateException, string("Leaf \"") +
+                            it->getString() + "\" not found");
+        }
+        delay* delay_leaf = dynamic_cast<delay*>(current_leaf);
+        if (!delay_leaf) continue;
+
+        // Only start chains at delay leafs whose input is not produced by
+        // another delay leaf
+        Signal* input = getSignalByInPort(delay_leaf->getInPortRange().front());
+        if (!input->getOutPort()
+            || dynamic_cast<delay*>(input->getOutPort()->getProcess())) {
+            continue;
+        }
+
+        vector<delay*> chain;
+        chain.push_back(delay_leaf);
+        while (true) {
+            Signal* output =
+                getSignalByOutPort(chain.back()->getOutPortRange().front());
+            if (!output->getInPort()) break;
+            delay* next_leaf =
+                dynamic_cast<delay*>(output->getInPort()->getProcess());
+            if (!next_leaf) break;
+            chain.push_back(next_leaf);
+        }
+        if (canBeDelayRing(chain)) delay_rings_.push_back(chain);
+    }
+
+    logger_.logMessage(Logger::INFO, string("Created ")
+                       + tools::toString(delay_rings_.size())
+                       + " delay ring(s)");
+}
+
+bool Synthesizer::canBeDelayRing(const vector<delay*>& chain)
+    throw(RuntimeException) {
+    list<Signal*> signals;
+    signals.push_back(getSignalByInPort(chain.front()->getInPortRange().front()));
+    vector<delay*>::const_iterator it;
+    for (it = chain.begin(); it != chain.end(); ++it) {
+        signals.push_back(getSignalByOutPort((*it)->getOutPortRange().front()));
+    }
+
+    list<Signal*>::iterator signal_it;
+    for (signal_it = signals.begin(); signal_it != signals.end();
+         ++signal_it) {
+        Signal* signal = *signal_it;
+        if (!signal->getOutPort() || !signal->getInPort()) return false;
+        if (!signal->getDataType()->isArray()) return false;
+        if (isSignalArrayView(signal->getVariable())) return false;
+        if (target_platform_ == C_PIPELINED) {
+            pair<int, int> stages = getPipelineStagesOfSignal(signal);
+            if (stages.first != stages.second) return false;
+        }
+    }
+    return true;
+}
+
+const vector<delay*>* Synthesizer::getDelayRing(const delay* leaf) const
+    throw() {
+    list< vector<delay*> >::const_iterator it;
+    for (it = delay_rings_.begin(); it != delay_rings_.end(); ++it) {
+        vector<delay*>::const_iterator leaf_it;
+        for (leaf_it = it->begin(); leaf_it != it->end(); ++leaf_it) {
+            if (*leaf_it == leaf) return &*it;
+        }
+    }
+    return NULL;
+}
+
+bool Synthesizer::isDelayRingSignal(Signal* signal) const throw() {
+    if (signal->getOutPort()) {
+        delay* producer =
+            dynamic_cast<delay*>(signal->getOutPort()->getProcess());
+        if (producer && getDelayRing(producer)) return true;
+    }
+    if (signal->getInPort()) {
+        delay* consumer =
+            dynamic_cast<delay*>(signal->getInPort()->getProcess());
+        if (consumer && getDelayRing(consumer)) return true;
+    }
+    return false;
+}
+
+string Synthesizer::getDelayRingName(const vector<delay*>& ring)
+    throw(RuntimeException) {
+    return getDelayVariable(ring.front()).first.getReferenceString()
+        + "_ring";
+}
+
+string Synthesizer::getDelayRingDeclarationString(const vector<delay*>& ring)
+    throw(RuntimeException) {
+    CVariable variable = delay_variables_[ring.front()].first;
+    CDataType data_type = *variable.getDataType();
+    data_type.setIsConst(false);
+    return data_type.getVariableDataTypeString() + " "
+        + variable.getReferenceString() + "_ring["
+        + tools::toString(ring.size() + 1) + "]["
+        + tools::toString(data_type.getArraySize()) + "]";
+}
+
+void Synthesizer::generateDelayRingAliasingCode(CodeWriter& code, int stage)
+    throw(InvalidModelException, IOException, RuntimeException) {
+    bool at_least_one = false;
+    list< vector<delay*> >::iterator it;
+    for (it = delay_rings_.begin(); it != delay_rings_.end(); ++it) {
+        if (stage >= 0 && getPipelineStage(it->front()) != stage) continue;
+        string name = getDelayRingName(*it);
+        string position = name + "_position";
+        string num_buffers = tools::toString(it->size() + 1);
+        CVariable input =
+            getSignalByInPort(it->front()->getInPortRange().front())
+            ->getVariable();
+        if (!at_least_one) {
+            code << kIndents << "// Point signal array variables into delay "
+                "rings\n";
+            at_least_one = true;
+        }
+        code << kIndents << input.getReferenceString() << " = " << name << "["
+            << position << "];\n";
+        for (size_t k = 1; k <= it->size(); ++k) {
+            CVariable output =
+                getSignalByOutPort((*it)[k - 1]->getOutPortRange().front())
+                ->getVariable();
+            code << kIndents << output.getReferenceString() << " = " << name
+                << "[(" << position << " + " << it->size() + 1 - k
+                << ") % " << num_buffers << "];\n";
+        }
+    }
+}
+
+void Synthesizer::generateSignalArenaSizeCheckCode(CodeWriter& code)
+    throw(IOException, RuntimeException) {
+    map<string, size_t> max_sizes;
+    map<pair<int, Signal*>, size_t>::iterator it;
+    for (it = signal_arena_offsets_.begin();
+         it != signal_arena_offsets_.end(); ++it) {
+        CDataType data_type = *it->first.second->getDataType();
+        data_type.setIsConst(false);
+        max_sizes[data_type.getVariableDataTypeString()] =
+            data_type.getMaxElementSize();
+    }
+
+    code << "// Fails to compile if a data type is larger than assumed by the "
+        "signal\n"
+        << "// arena offsets; generate the code with -no-mp in that case\n"
+        << "typedef char signal_arena_size_check[";
+    map<string, size_t>::iterator size_it;
+    for (size_it = max_sizes.begin(); size_it != max_sizes.end(); ++size_it) {
+        if (size_it != max_sizes.begin()) code << " && ";
+        code << "sizeof(" << size_it->first << ") <= " << size_it->second;
+    }
+    code << " ? 1 : -1];\n";
+}
+
+string Synthesizer::getSignalArenaMemberName(int stage) const throw() {
+    string name = kSignalArenaVariableName;
+    if (stage >= 0) name += "_stage" + tools::toString(stage + 1);
+    return name;
+}
+
+bool Synthesizer::hasStaticState() const throw() {
+    return !config_.doReentrantCode()
+        && (delay_variables_.size() > 0 || hasThreadPool());
+}
+
+bool Synthesizer::isSignalInArena(Signal* signal, int stage) const throw() {
+    return signal_arena_offsets_.find(pair<int, Signal*>(stage, signal))
+        != signal_arena_offsets_.end();
 }
 
 string Synthesizer::generateLeafExecutionCodeFordelayStep1(
     delay* leaf)
     throw(InvalidModelException, IOException, RuntimeException) {
+    if (getDelayRing(leaf)) return "";
     CVariable output =
-        getSignalByOutPort(leaf->getOutPorts().front())->getVariable();
+        getSignalByOutPort(leaf->getOutPortRange().front())->getVariable();
     CVariable delay_variable = getDelayVariable(leaf).first;
     return generateVariableCopyingCode(output, delay_variable);
 }
@@ -2292,8 +5460,15 @@ string Synthesizer::generateLeafExecutionCodeFordelayStep1(
 string Synthesizer::generateLeafExecutionCodeFordelayStep2(
     delay* leaf)
     throw(InvalidModelException, IOException, RuntimeException) {
+    const vector<delay*>* ring = getDelayRing(leaf);
+    if (ring) {
+        if (ring->front() != leaf) return "";
+        string position = getDelayRingName(*ring) + "_position";
+        return kIndents + position + " = (" + position + " + 1) % "
+            + tools::toString(ring->size() + 1) + ";\n";
+    }
     CVariable input = 
-        getSignalByInPort(leaf->getInPorts().front())->getVariable();
+        getSignalByInPort(leaf->getInPortRange().front())->getVariable();
     CVariable delay_variable = getDelayVariable(leaf).first;
     return generateVariableCopyingCode(delay_variable, input);
 }
@@ -2301,10 +5476,10 @@ string Synthesizer::generateLeafExecutionCodeFordelayStep2(
 string Synthesizer::generateLeafExecutionCodeForMap(Map* leaf)
     throw(InvalidModelException, IOException, RuntimeException) {
     list<CVariable> inputs;
-    inputs.push_back(getSignalByInPort(leaf->getInPorts().front())
+    inputs.push_back(getSignalByInPort(leaf->getInPortRange().front())
                      ->getVariable());
     CVariable output =
-        getSignalByOutPort(leaf->getOutPorts().front())->getVariable();
+        getSignalByOutPort(leaf->getOutPortRange().front())->getVariable();
     CFunction* function = leaf->getFunction();
     return generateLeafFunctionExecutionCode(function, inputs, output);
 }
@@ -2313,13 +5488,13 @@ string Synthesizer::generateLeafExecutionCodeForZipWithNSY(
     ZipWithNSY* leaf)
     throw(InvalidModelException, IOException, RuntimeException) {
     list<CVariable> inputs;
-    list<Leaf::Port*> in_ports = leaf->getInPorts();
-    list<Leaf::Port*>::iterator it;
+    const Leaf::PortVector& in_ports = leaf->getInPortRange();
+    Leaf::PortVector::const_iterator it;
     for (it = in_ports.begin(); it != in_ports.end(); ++it) {
         inputs.push_back(getSignalByInPort(*it)->getVariable());
     }
     CVariable output =
-        getSignalByOutPort(leaf->getOutPorts().front())->getVariable();
+        getSignalByOutPort(leaf->getOutPortRange().front())->getVariable();
     CFunction* function = leaf->getFunction();
     return generateLeafFunctionExecutionCode(function, inputs, output);
 }
@@ -2327,10 +5502,10 @@ string Synthesizer::generateLeafExecutionCodeForZipWithNSY(
 string Synthesizer::generateLeafExecutionCodeForUnzipx(Unzipx* leaf)
     throw(InvalidModelException, IOException, RuntimeException) {
     CVariable input =
-        getSignalByInPort(leaf->getInPorts().front())->getVariable();
+        getSignalByInPort(leaf->getInPortRange().front())->getVariable();
     list<CVariable> outputs;
-    list<Leaf::Port*> out_ports = leaf->getOutPorts();
-    list<Leaf::Port*>::iterator it;
+    const Leaf::PortVector& out_ports = leaf->getOutPortRange();
+    Leaf::PortVector::const_iterator it;
     for (it = out_ports.begin(); it != out_ports.end(); ++it) {
         outputs.push_back(getSignalByOutPort(*it)->getVariable());
     }
@@ -2340,10 +5515,10 @@ string Synthesizer::generateLeafExecutionCodeForUnzipx(Unzipx* leaf)
 string Synthesizer::generateLeafExecutionCodeForZipx(Zipx* leaf)
     throw(InvalidModelException, IOException, RuntimeException) {
     CVariable output =
-        getSignalByOutPort(leaf->getOutPorts().front())->getVariable();
+        getSignalByOutPort(leaf->getOutPortRange().front())->getVariable();
     list<CVariable> inputs;
-    list<Leaf::Port*> in_ports = leaf->getInPorts();
-    list<Leaf::Port*>::iterator it;
+    const Leaf::PortVector& in_ports = leaf->getInPortRange();
+    Leaf::PortVector::const_iterator it;
 
     string code;
     for (it = in_ports.begin(); it != in_ports.end(); ++it) {
@@ -2356,9 +5531,9 @@ string Synthesizer::generateLeafExecutionCodeForZipx(Zipx* leaf)
 string Synthesizer::generateLeafExecutionCodeForFanout(Fanout* leaf)
     throw(InvalidModelException, IOException, RuntimeException) {
     CVariable input =
-        getSignalByInPort(leaf->getInPorts().front())->getVariable();
-    list<Leaf::Port*> out_ports = leaf->getOutPorts();
-    list<Leaf::Port*>::iterator it;
+        getSignalByInPort(leaf->getInPortRange().front())->getVariable();
+    const Leaf::PortVector& out_ports = leaf->getOutPortRange();
+    Leaf::PortVector::const_iterator it;
 
     string code;
     for (it = out_ports.begin(); it != out_ports.end(); ++it) {
@@ -2459,6 +5634,12 @@ Leaf::Port* Synthesizer::Signal::getInPort() const throw() {
     return in_port_;
 }
 
+bool Synthesizer::ArraySizeComparator::operator() (
+    const pair<size_t, Signal*>& lhs, const pair<size_t, Signal*>& rhs) const
+    throw() {
+    return lhs.first > rhs.first;
+}
+
 bool Synthesizer::SignalComparator::operator() (const Signal* lhs,
                                                 const Signal* rhs) const
     throw() {
@@ -38,6 +38,7 @@
 
 #include "../logger/logger.h"
 #include "../config/config.h"
+#include "../tools/codewriter.h"
 #include "../forsyde/id.h"
 #include "../forsyde/processnetwork.h"
 #include "../forsyde/leaf.h"
@@ -61,6 +62,7 @@
 #include <set>
 #include <map>
 #include <stack>
+#include <vector>
 
 namespace f2cc {
 
@@ -75,26 +77,6 @@ namespace f2cc {
  * compiler.
  */
 class Synthesizer {
-  public:
-    /**
-     * @brief Contains the code for the header and implementation file.
-     *
-     * The generated code is split into a header and an implementation file.
-     * But as a function can only return a single value, this struct was devised
-     * to be able to return both from the same function.
-     */
-    struct CodeSet {
-        /**
-         * Contains the code for the header file.
-         */
-        std::string header;
-
-        /**
-         * Contains the code for the implementation file.
-         */
-        std::string implementation;
-    };
-
   private:
     /**
      * Indentation string.
@@ -111,12 +93,56 @@ class Synthesizer {
      */
     static const std::string kProcessNetworkOutputParameterPrefix;
 
+    /**
+     * Name of the parameter which specifies the number of tokens to process in
+     * the block-processing C function.
+     */
+    static const std::string kBlockNumTokensParameterName;
+
+    /**
+     * Name of the loop variable which iterates over the tokens in the
+     * block-processing C function.
+     */
+    static const std::string kBlockTokenVariableName;
+
+    /**
+     * Name of the variable which points to the memory arena holding the
+     * internal signal arrays.
+     */
+    static const std::string kSignalArenaVariableName;
+
+    /**
+     * Alignment, in bytes, of the memory arena and of each signal array placed
+     * within it.
+     */
+    static const size_t kSignalArenaAlignment;
+
+    /**
+     * Name of the C struct which holds the delay state of reentrant code.
+     */
+    static const std::string kStateStructName;
+
+    /**
+     * Name of the parameter through which the delay state is passed to the
+     * functions of reentrant code.
+     */
+    static const std::string kStateParameterName;
+
+    /**
+     * Name of the variable, or state struct member in reentrant code, which
+     * points to the thread pool of task-parallel and pipelined code.
+     */
+    static const std::string kThreadPoolVariableName;
+
     /**
      * Code target platforms.
      */
     enum TargetPlatform {
         C,
-        CUDA
+        CUDA,
+        C_MULTICORE,
+        C_PIPELINED,
+        C_TASK_PARALLEL
     };
 
     class Signal;
@@ -139,6 +165,24 @@ class Synthesizer {
         bool operator() (const Signal* lhs, const Signal* rhs) const throw();
     };
 
+    /**
+     * Class for ordering signal arrays by decreasing size.
+     */
+    class ArraySizeComparator {
+      public:
+        /**
+         * Compares the size of one signal array with another.
+         *
+         * @param lhs
+         *        First size and signal.
+         * @param rhs
+         *        Second size and signal.
+         * @returns \b true if the first array is larger.
+         */
+        bool operator() (const std::pair<size_t, Signal*>& lhs,
+                         const std::pair<size_t, Signal*>& rhs) const throw();
+    };
+
   public:
     /**
      * Creates a synthesizer.
@@ -163,29 +207,85 @@ class Synthesizer {
     /**
      * Generates sequential C code.
      *
-     * @returns Generated code.
+     * The code is written to the header, implementation and, if requested,
+     * benchmark driver output files given by the configuration.
+     *
      * @throws InvalidModelException
      *         When the processnetwork is such that it cannot be synthesized.
      * @throws IOException
-     *         When access to the log file fails.
+     *         When access to the log file or the output files fails.
      * @throws RuntimeException
      *         When something goes wrong during the synthesis leaf.
      */
-    CodeSet generateCCode()
+    void generateCCode()
         throw(InvalidModelException, IOException, RuntimeException);
 
     /**
      * Generates CUDA C code.
      *
-     * @returns Generated code.
+     * The code is written to the header, implementation and, if requested,
+     * benchmark driver output files given by the configuration.
+     *
      * @throws InvalidModelException
      *         When the processnetwork is such that it cannot be synthesized.
      * @throws IOException
-     *         When access to the log file fails.
+     *         When access to the log file or the output files fails.
+     * @throws RuntimeException
+     *         When something goes wrong during the synthesis leaf.
+     */
+    void generateCudaCCode()
+        throw(InvalidModelException, IOException, RuntimeException);
+
+    /**
+     * Generates multi-core C code, where data parallel leafs are executed
+     * using OpenMP or, as fallback, POSIX threads.
+     *
+     * The code is written to the header, implementation and, if requested,
+     * benchmark driver output files given by the configuration.
+     *
+     * @throws InvalidModelException
+     *         When the processnetwork is such that it cannot be synthesized.
+     * @throws IOException
+     *         When access to the log file or the output files fails.
+     * @throws RuntimeException
+     *         When something goes wrong during the synthesis leaf.
+     */
+    void generateMulticoreCCode()
+        throw(InvalidModelException, IOException, RuntimeException);
+
+    /**
+     * Generates pipelined C code, where the schedule is split into pipeline
+     * stages which are executed on separate POSIX threads.
+     *
+     * The code is written to the header, implementation and, if requested,
+     * benchmark driver output files given by the configuration.
+     *
+     * @throws InvalidModelException
+     *         When the processnetwork is such that it cannot be synthesized.
+     * @throws IOException
+     *         When access to the log file or the output files fails.
+     * @throws RuntimeException
+     *         When something goes wrong during the synthesis leaf.
+     */
+    void generatePipelinedCCode()
+        throw(InvalidModelException, IOException, RuntimeException);
+
+    /**
+     * Generates task-parallel C code, where each leaf is a task which is
+     * executed on a pool of POSIX threads as soon as the leafs it depends on
+     * have been executed.
+     *
+     * The code is written to the header, implementation and, if requested,
+     * benchmark driver output files given by the configuration.
+     *
+     * @throws InvalidModelException
+     *         When the processnetwork is such that it cannot be synthesized.
+     * @throws IOException
+     *         When access to the log file or the output files fails.
      * @throws RuntimeException
      *         When something goes wrong during the synthesis leaf.
      */
-    CodeSet generateCudaCCode()
+    void generateTaskParallelCCode()
         throw(InvalidModelException, IOException, RuntimeException);
     
   private:
@@ -206,26 +306,32 @@ class Synthesizer {
     /**
      * Generates code for the currently set target platform.
      *
-     * @returns Generated code.
+     * The code is written to the header, implementation and, if requested,
+     * benchmark driver output files given by the configuration.
+     *
      * @throws InvalidModelException
      *         When the processnetwork is such that it cannot be synthesized.
      * @throws IOException
-     *         When access to the log file fails.
+     *         When access to the log file or the output files fails.
      * @throws RuntimeException
      *         When something goes wrong during the synthesis leaf.
      */
-    CodeSet generateCode()
+    void generateCode()
         throw(InvalidModelException, IOException, RuntimeException);
 
     /**
      * Finds a leaf schedule for the processnetwork. 
      *
+     * @throws InvalidModelException
+     *         When the processnetwork contains a loop without any \c delay
+     *         leaf.
      * @throws IOException
      *         When access to the log file fails.
      * @throws RuntimeException
      *         When a program error occurs. This most likely indicates a bug.
      */
-    void findSchedule() throw(IOException, RuntimeException);
+    void findSchedule()
+        throw(InvalidModelException, IOException, RuntimeException);
 
     /**
      * Registers a new signal. If no such signal is registred, it is registred
@@ -448,6 +554,778 @@ class Synthesizer {
      * Map::getFunction() is invoked and thus the leaf can be handled like
      * any other \c Map leaf.
      *
+     * When synthesizing multi-core C code, a worker function for the POSIX
+     * threads fallback is also added to the leaf, just after the wrapper
+     * function.
+     *
+     * @throws InvalidModelException
+     *         When something is wrong with the processnetwork.
+     * @throws IOException
+     *         When access to the log file fails.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    void generateParallelMapSyWrapperFunctions()
+        throw(InvalidModelException, IOException, RuntimeException);
+
+    /**
+     * Generates a wrapper function which executes a given function for the
+     * entire input array. The wrapping function is left intact.
+     *
+     * @param function
+     *        Function to execute.
+     * @param num_leafs
+     *        Number of leafs which the function encompasses.
+     * @returns Wrapper function.
+     * @throws InvalidModelException
+     *         When something is wrong with the processnetwork.
+     * @throws IOException
+     *         When access to the log file fails.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    CFunction generateParallelMapSyWrapperFunction(CFunction* function,
+                                                   size_t num_leafs)
+        throw(InvalidModelException, IOException, RuntimeException);
+
+    /**
+     * Generates the code for the loop which executes a given function for the
+     * entire input array in parallel on multiple cores. If the code is
+     * compiled with OpenMP support, the loop is annotated with an OpenMP
+     * <tt>parallel for</tt> directive using the schedule and chunk size
+     * specified in the configuration. Otherwise, the iterations are split into
+     * equally sized ranges which are executed by POSIX threads, one per online
+     * processor.
+     *
+     * @param function
+     *        Function to execute.
+     * @param num_leafs
+     *        Number of leafs which the function encompasses.
+     * @param input_param_name
+     *        Name of the wrapper function's input parameter.
+     * @param output_param_name
+     *        Name of the wrapper function's output parameter.
+     * @returns Loop code.
+     * @throws InvalidModelException
+     *         When something is wrong with the processnetwork.
+     * @throws IOException
+     *         When access to the log file fails.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    std::string generateParallelMapSyMulticoreLoopCode(
+        CFunction* function, size_t num_leafs,
+        const std::string& input_param_name,
+        const std::string& output_param_name)
+        throw(InvalidModelException, IOException, RuntimeException);
+
+    /**
+     * Generates a worker function which is executed by each POSIX thread in
+     * the multi-core C code. The worker function executes a given function for
+     * the range of the input array which is given by its \c ParallelMapRange
+     * argument.
+     *
+     * @param wrapper
+     *        Wrapper function generated by
+     *        generateParallelMapSyWrapperFunction(CFunction*, size_t).
+     * @param function
+     *        Function to execute.
+     * @returns Worker function.
+     * @throws InvalidModelException
+     *         When something is wrong with the processnetwork.
+     * @throws IOException
+     *         When access to the log file fails.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    CFunction generateParallelMapSyWorkerFunction(CFunction* wrapper,
+                                                  CFunction* function)
+        throw(InvalidModelException, IOException, RuntimeException);
+
+    /**
+     * Gets the name of the POSIX threads worker function for a given
+     * function. As the name is derived from the function name, leafs which
+     * share the same function also share the same worker function.
+     *
+     * @param function
+     *        Function executed by the worker.
+     * @returns Worker function name.
+     */
+    std::string getParallelMapSyWorkerFunctionName(CFunction* function) const
+        throw();
+
+    /**
+     * Generates the statement which executes a given function for the
+     * \c i:th element of a \c ParallelMap leaf's input array.
+     *
+     * @param function
+     *        Function to execute.
+     * @param input_param_name
+     *        Name of the input array.
+     * @param output_param_name
+     *        Name of the output array.
+     * @returns Function call statement, without indentation.
+     */
+    std::string generateParallelMapSyFunctionCallCode(
+        CFunction* function, const std::string& input_param_name,
+        const std::string& output_param_name) throw();
+
+    /**
+     * Generates code for the parallel map range struct definition, together
+     * with the header includes needed by the multi-core C code. The struct
+     * is used to pass the range of array elements to process to the POSIX
+     * threads worker functions.
+     *
+     * @param code
+     *        Code writer to which the code is written.
+     * @throws InvalidModelException
+     *         When something is wrong with the processnetwork.
+     * @throws IOException
+     *         When access to the log file fails.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    void generateParallelMapRangeStructDefinitionCode(tools::CodeWriter& code)
+        throw(InvalidModelException, IOException, RuntimeException);
+
+    /**
+     * Splits the schedule into pipeline stages of balanced cost, using the
+     * cost of each leaf (a leaf without cost is counted as having cost 1).
+     * The stages are contiguous parts of the schedule, which means that data
+     * only flows from one stage to a subsequent stage. To that end, the
+     * leafs are first reordered such that the producer of the input of a
+     * \c delay leaf comes before the consumer of its output, unless the
+     * \c delay leaf is part of a feedback loop. All leafs of a feedback loop
+     * are kept within the same stage. The \c delay leafs themselves are
+     * placed in the same stage as the leaf producing their input.
+     *
+     * @throws InvalidModelException
+     *         When something is wrong with the processnetwork.
+     * @throws IOException
+     *         When access to the log file fails.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    void findPipelineStages()
+        throw(InvalidModelException, IOException, RuntimeException);
+
+    /**
+     * Reorders leafs such that each leaf comes after all leafs it depends on,
+     * while otherwise keeping the current order as far as possible. The order
+     * is left unchanged if the dependencies are cyclic.
+     *
+     * @param leafs
+     *        Leafs to reorder.
+     * @param dependencies
+     *        For each leaf, the indices of the leafs it depends on.
+     */
+    void orderLeafsByDependencies(
+        std::vector<Forsyde::Leaf*>& leafs,
+        const std::vector< std::set<size_t> >& dependencies) const throw();
+
+    /**
+     * Checks whether there is a data path from one process to another.
+     *
+     * @param from
+     *        Process at which the path starts.
+     * @param to
+     *        Process at which the path ends.
+     * @returns \b true if \c to can be reached from \c from.
+     * @throws InvalidModelException
+     *         When something is wrong with the processnetwork.
+     * @throws IOException
+     *         When access to the log file fails.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    bool isProcessReachable(Forsyde::Process* from, Forsyde::Process* to)
+        throw(InvalidModelException, IOException, RuntimeException);
+
+    /**
+     * Counts the number of pipeline stages needed if the cost of a stage may
+     * not exceed a given maximum. The stages are formed greedily from a
+     * sequence of indivisible units.
+     *
+     * @param unit_costs
+     *        Costs of the units, in schedule order.
+     * @param max_stage_cost
+     *        Maximum cost of a stage.
+     * @returns Number of stages.
+     */
+    size_t countPipelineStages(const std::vector<int>& unit_costs,
+                               int max_stage_cost) const throw();
+
+    /**
+     * Gets the leaf which produces the input of a \c delay leaf. Chains of
+     * \c delay leafs are followed until a leaf of another type is found.
+     *
+     * @param leaf
+     *        Delay leaf.
+     * @returns Producing leaf, or \c NULL if the input comes from a
+     *          processnetwork input parameter.
+     * @throws InvalidModelException
+     *         When the \c delay leafs form a loop by themselves.
+     * @throws IOException
+     *         When access to the log file fails.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    Forsyde::Process* getDelayInputProducer(Forsyde::SY::delay* leaf)
+        throw(InvalidModelException, IOException, RuntimeException);
+
+    /**
+     * Gets the pipeline stage to which a leaf belongs.
+     *
+     * @param leaf
+     *        Leaf.
+     * @returns Pipeline stage, starting from 0.
+     * @throws IllegalStateException
+     *         When the leaf has not been assigned any stage.
+     */
+    int getPipelineStage(const Forsyde::Process* leaf) const
+        throw(IllegalStateException);
+
+    /**
+     * Gets the pipeline stages in which a signal is written and read. A
+     * signal connected to a processnetwork input or output parameter is
+     * considered to be both written and read in the stage of its leaf.
+     *
+     * @param signal
+     *        Signal.
+     * @returns Pair where the first value is the writing stage and the second
+     *          the reading stage.
+     * @throws IllegalStateException
+     *         When a leaf of the signal has not been assigned any stage.
+     */
+    std::pair<int, int> getPipelineStagesOfSignal(Signal* signal) const
+        throw(IllegalStateException);
+
+    /**
+     * Checks whether a signal is written or read in a given pipeline stage.
+     *
+     * @param signal
+     *        Signal.
+     * @param stage
+     *        Pipeline stage.
+     * @returns \b true if it is.
+     * @throws IllegalStateException
+     *         When a leaf of the signal has not been assigned any stage.
+     */
+    bool isSignalInPipelineStage(Signal* signal, int stage) const
+        throw(IllegalStateException);
+
+    /**
+     * Gets the name of the ring buffer which carries the values of a signal
+     * from one pipeline stage to another.
+     *
+     * @param signal
+     *        Signal.
+     * @returns Ring buffer name.
+     * @throws IllegalStateException
+     *         When the signal has no data type.
+     */
+    std::string getPipelineRingName(Signal* signal) const
+        throw(IllegalStateException);
+
+    /**
+     * Gets the parameters of the block-processing function whose signals
+     * belong to a given pipeline stage.
+     *
+     * @param stage
+     *        Pipeline stage. A negative value means all stages.
+     * @returns List of parameters, inputs first.
+     * @throws InvalidModelException
+     *         When something is wrong with the processnetwork.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    std::list<CVariable> getPipelineParameters(int stage)
+        throw(InvalidModelException, RuntimeException);
+
+    /**
+     * Gets the name of the function which executes a pipeline stage.
+     *
+     * @param stage
+     *        Pipeline stage.
+     * @returns Function name.
+     */
+    std::string getPipelineStageFunctionName(int stage) const throw();
+
+    /**
+     * Generates code for the ring buffer struct and the functions operating
+     * on it. A ring buffer connects exactly one writing and one reading
+     * pipeline stage, and blocks the writer when full and the reader when
+     * empty.
+     *
+     * @param code
+     *        Code writer to which the code is written.
+     */
+    void generatePipelineRingDefinitionCode(tools::CodeWriter& code) throw();
+
+    /**
+     * Generates code for the pipeline context struct, which holds the
+     * parameters of the block-processing function and the ring buffers
+     * between the pipeline stages, as well as the structs for the threads
+     * executing the pipeline stages.
+     *
+     * @param code
+     *        Code writer to which the code is written.
+     * @throws InvalidModelException
+     *         When something is wrong with the processnetwork.
+     * @throws IOException
+     *         When access to the log file fails.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    void generatePipelineContextStructDefinitionCode(tools::CodeWriter& code)
+        throw(InvalidModelException, IOException, RuntimeException);
+
+    /**
+     * Generates code for the function definition of a pipeline stage. The
+     * function executes the leafs of the stage for a range of tokens, reading
+     * signal values produced by previous stages from and writing signal
+     * values consumed by subsequent stages to the ring buffers. The values of
+     * \c delay leafs are sent before any values are read, which ensures that
+     * no stage waits on itself.
+     *
+     * @param code
+     *        Code writer to which the code is written.
+     * @param stage
+     *        Pipeline stage.
+     * @throws InvalidModelException
+     *         When something is wrong with the processnetwork.
+     * @throws IOException
+     *         When access to the log file fails.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    void generatePipelineStageFunctionDefinitionCode(tools::CodeWriter& code,
+                                                     int stage)
+        throw(InvalidModelException, IOException, RuntimeException);
+
+    /**
+     * Generates code for the pipeline runtime: the table of pipeline stage
+     * functions, the functions which create and destroy the pool of stage
+     * threads and run one round of the pipeline on it, and the function
+     * which stops the threads.
+     *
+     * @param code
+     *        Code writer to which the code is written.
+     */
+    void generatePipelineRuntimeDefinitionCode(tools::CodeWriter& code)
+        throw();
+
+    /**
+     * Generates code which writes signal values to, or reads signal values
+     * from, the ring buffers connecting a pipeline stage with other stages.
+     *
+     * @param code
+     *        Code writer to which the code is written.
+     * @param stage
+     *        Pipeline stage.
+     * @param do_write
+     *        Whether to generate code for writing the signals produced in the
+     *        stage, or for reading the signals consumed in the stage.
+     * @param only_delays
+     *        Whether to only consider signals written by \c delay leafs. Only
+     *        applicable when writing. When \c false, these signals are
+     *        instead ignored.
+     * @throws InvalidModelException
+     *         When something is wrong with the processnetwork.
+     * @throws IOException
+     *         When access to the log file fails.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    void generatePipelineRingTransferCode(tools::CodeWriter& code, int stage,
+                                          bool do_write, bool only_delays)
+        throw(InvalidModelException, IOException, RuntimeException);
+
+    /**
+     * Generates code for the block-processing function definition of the
+     * pipelined target. The function sets up the ring buffers and runs one
+     * round of the pipeline, in which all pipeline stages but the first are
+     * executed by the threads of the pipeline pool and the first stage by
+     * the calling thread. The pool is created by the first call and kept for
+     * later calls, so that no threads are started per call.
+     *
+     * @param code
+     *        Code writer to which the code is written.
+     * @throws InvalidModelException
+     *         When something is wrong with the processnetwork.
+     * @throws IOException
+     *         When access to the log file fails.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    void generatePipelinedBlockFunctionDefinitionCode(tools::CodeWriter& code)
+        throw(InvalidModelException, IOException, RuntimeException);
+
+    /**
+     * Creates a task for each leaf other than the \c delay leafs and finds
+     * the dependencies between them from the port connectivity. A task depends
+     * on the leafs producing its inputs; as the \c delay leafs are executed
+     * before and after the tasks, data flowing through them does not give
+     * rise to any dependencies.
+     *
+     * @throws InvalidModelException
+     *         When there are no leafs to execute as tasks.
+     * @throws IOException
+     *         When access to the log file fails.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    void findTasks()
+        throw(InvalidModelException, IOException, RuntimeException);
+
+    /**
+     * Checks whether a signal is read or written by any task.
+     *
+     * @param signal
+     *        Signal.
+     * @returns \c true if the signal is connected to a task.
+     */
+    bool isTaskSignal(Signal* signal) const throw();
+
+    /**
+     * Gets the name of the function which executes a task.
+     *
+     * @param task
+     *        Task index.
+     * @returns Function name.
+     */
+    std::string getTaskFunctionName(size_t task) const throw();
+
+    /**
+     * Generates code for the task pool structs, together with the header
+     * includes needed by the task-parallel C code. Each thread in the pool
+     * has a queue of ready tasks from which it takes the most recently added
+     * task, and when empty, steals the oldest task from the queue of another
+     * thread.
+     *
+     * @param code
+     *        Code writer to which the code is written.
+     */
+    void generateTaskPoolDefinitionCode(tools::CodeWriter& code) throw();
+
+    /**
+     * Generates code for the task context struct, which holds the signal
+     * variables shared between the tasks.
+     *
+     * @param code
+     *        Code writer to which the code is written.
+     * @throws InvalidModelException
+     *         When something is wrong with the processnetwork.
+     * @throws IOException
+     *         When access to the log file fails.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    void generateTaskContextStructDefinitionCode(tools::CodeWriter& code)
+        throw(InvalidModelException, IOException, RuntimeException);
+
+    /**
+     * Generates code for the function definition of a task. The function
+     * reads the signal variables of the leaf from the task context, executes
+     * the leaf, and writes back the scalar signal variables it produces.
+     *
+     * @param code
+     *        Code writer to which the code is written.
+     * @param task
+     *        Task index.
+     * @throws InvalidModelException
+     *         When something is wrong with the processnetwork.
+     * @throws IOException
+     *         When access to the log file fails.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    void generateTaskFunctionDefinitionCode(tools::CodeWriter& code,
+                                            size_t task)
+        throw(InvalidModelException, IOException, RuntimeException);
+
+    /**
+     * Generates code for the task dependency tables, for the functions
+     * which create, run, and destroy the task pool, and for the function
+     * which stops the threads of the pool kept between calls.
+     *
+     * @param code
+     *        Code writer to which the code is written.
+     */
+    void generateTaskRuntimeDefinitionCode(tools::CodeWriter& code) throw();
+
+    /**
+     * Generates the description of the function which stops the threads of
+     * the thread pool.
+     *
+     * @param desc
+     *        Code writer to which the description is written.
+     */
+    void generateStopThreadsFunctionDescription(tools::CodeWriter& desc)
+        throw();
+
+    /**
+     * Generates the prototype of the function which stops the threads of the
+     * thread pool.
+     *
+     * @returns Function prototype.
+     */
+    std::string generateStopThreadsFunctionPrototypeCode() const throw();
+
+    /**
+     * Generates code for the definition of the function which stops the
+     * threads of the thread pool, preceded by the static thread pool variable
+     * in non-reentrant code.
+     *
+     * @param code
+     *        Code writer to which the code is written.
+     */
+    void generateStopThreadsFunctionDefinitionCode(tools::CodeWriter& code)
+        throw();
+
+    /**
+     * Gets the C expression which refers to the thread pool, which is a
+     * member of the state struct in reentrant code and a static variable
+     * otherwise.
+     *
+     * @returns Thread pool reference.
+     */
+    std::string getThreadPoolReferenceString() const throw();
+
+    /**
+     * Gets the name of the thread pool struct of the current target
+     * platform.
+     *
+     * @returns Struct name.
+     */
+    std::string getThreadPoolStructName() const throw();
+
+    /**
+     * Checks whether the generated code keeps a pool of threads between
+     * calls, which is the case for the task-parallel and pipelined targets.
+     *
+     * @returns \c true if so.
+     */
+    bool hasThreadPool() const throw();
+
+    /**
+     * Generates code for the block-processing function definition of the
+     * task-parallel target. For each token, the function executes the first
+     * step of the \c delay leafs, runs all tasks on the task pool, and then
+     * executes the second step of the \c delay leafs. The calling thread
+     * takes part in executing the tasks. The task pool is created by the
+     * first call and kept for later calls, so that no threads are started
+     * per call or per token.
+     *
+     * @param code
+     *        Code writer to which the code is written.
+     * @throws InvalidModelException
+     *         When something is wrong with the processnetwork.
+     * @throws IOException
+     *         When access to the log file fails.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    void generateTaskParallelBlockFunctionDefinitionCode(
+        tools::CodeWriter& code)
+        throw(InvalidModelException, IOException, RuntimeException);
+
+    /**
+     * Checks whether the synthesized code contains the block-processing
+     * function, which is the case when block processing has been requested or
+     * when the target platform requires it.
+     *
+     * @returns \c true if the block-processing function is generated.
+     */
+    bool hasBlockFunction() const throw();
+
+    /**
+     * Generates code for the function definitions for the leafs present
+     * in the schedule.
+     *
+     * @param code
+     *        Code writer to which the code is written.
+     * @throws InvalidModelException
+     *         When something is wrong with the processnetwork.
+     * @throws IOException
+     *         When access to the log file fails.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    void generateLeafFunctionDefinitionsCode(tools::CodeWriter& code)
+        throw(InvalidModelException, IOException, RuntimeException);
+
+    /**
+     * Generates code for the processnetwork function definition, which implements the
+     * schedule.
+     *
+     * Note that \c delay leafs are executed in two steps. The first step
+     * of all \c delay leafs is executed before all other leafs. Then,
+     * the leafs are executed in order as defined by the schedule but the \c
+     * delay leafs are ignored. Once the schedule has been executed, the
+     * second step of all \c delay leafs is executed. This must be done in
+     * order to first propagate the values of the delay variables to the signal
+     * variables, and then save the new values in the delay variables until the
+     * next processnetwork invocation.
+     *
+     * @param code
+     *        Code writer to which the code is written.
+     * @throws InvalidModelException
+     *         When something is wrong with the processnetwork.
+     * @throws IOException
+     *         When access to the log file fails.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    void generateProcessNetworkFunctionDefinitionCode(tools::CodeWriter& code)
+        throw(InvalidModelException, IOException, RuntimeException);
+
+    /**
+     * Generates code for the block-processing function definition. The
+     * function executes the schedule once for every token in the input
+     * arrays, thus processing an entire block of tokens in a single call. The
+     * signal and delay variables are declared only once per call, and as the
+     * delay variables are shared with the loop the delay state is naturally
+     * carried from one token to the next.
+     *
+     * @param code
+     *        Code writer to which the code is written.
+     * @throws InvalidModelException
+     *         When something is wrong with the processnetwork.
+     * @throws IOException
+     *         When access to the log file fails.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    void generateProcessNetworkBlockFunctionDefinitionCode(
+        tools::CodeWriter& code)
+        throw(InvalidModelException, IOException, RuntimeException);
+
+    /**
+     * Generates code for a processnetwork function definition which simply
+     * forwards a single token to the block-processing function. This is used
+     * instead of generateProcessNetworkFunctionDefinitionCode() when block
+     * processing is enabled, so that both entry points share the same delay
+     * state.
+     *
+     * @param code
+     *        Code writer to which the code is written.
+     * @throws InvalidModelException
+     *         When something is wrong with the processnetwork.
+     * @throws IOException
+     *         When access to the log file fails.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    void generateProcessNetworkForwardingFunctionDefinitionCode(
+        tools::CodeWriter& code)
+        throw(InvalidModelException, IOException, RuntimeException);
+
+    /**
+     * Generates code for a stand-alone benchmark driver. The driver fills the
+     * processnetwork inputs with deterministic pseudo-random data for a pool
+     * of tokens, executes the processnetwork on the pool for a number of
+     * untimed warm-up iterations followed by a number of timed iterations,
+     * and prints the throughput in tokens/s, ns/token and bytes/s (counting
+     * both input and output data) as a single line of JSON. The pool size and
+     * iteration counts default to macros which can be overridden when the
+     * driver is compiled, and the iteration counts can also be given on the
+     * command line.
+     *
+     * @param code
+     *        Code writer to which the code is written.
+     * @throws InvalidModelException
+     *         When something is wrong with the processnetwork.
+     * @throws IOException
+     *         When access to the log file fails.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    void generateBenchmarkCode(tools::CodeWriter& code)
+        throw(InvalidModelException, IOException, RuntimeException);
+
+    /**
+     * Generates code which executes the processnetwork once on every token in
+     * the benchmark driver's token pool, through the block-processing
+     * function if there is one and otherwise one token at a time.
+     *
+     * @param code
+     *        Code writer to which the code is written.
+     * @throws InvalidModelException
+     *         When something is wrong with the processnetwork.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    void generateBenchmarkExecutionCode(tools::CodeWriter& code)
+        throw(InvalidModelException, RuntimeException);
+
+    /**
+     * Generates the prototype, with description, of the function which
+     * prints the profiling measurements of instrumented code.
+     *
+     * @param code
+     *        Code writer to which the code is written.
+     */
+    void generateProfileFunctionPrototypeCode(tools::CodeWriter& code) throw();
+
+    /**
+     * Generates the definitions needed by instrumented code: a table with the
+     * number of invocations of and the total time spent in each leaf in the
+     * schedule, a function which reads a monotonic clock, and the function
+     * which prints the table. The table is shared by all invocations of the
+     * processnetwork, and is not protected against concurrent updates from
+     * independent processnetwork instances.
+     *
+     * @param code
+     *        Code writer to which the code is written.
+     * @throws IOException
+     *         When access to the log file fails.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    void generateProfileDefinitionsCode(tools::CodeWriter& code)
+        throw(IOException, RuntimeException);
+
+    /**
+     * Wraps the execution code of a leaf with code which measures the time
+     * spent executing it and adds the measurement to the leaf's entry in the
+     * profiling table. If profiling is disabled, or if there is no execution
+     * code, the code is written as is.
+     *
+     * @param code
+     *        Code writer to which the code is written.
+     * @param leaf
+     *        Leaf being executed.
+     * @param leaf_code
+     *        Execution code of the leaf.
+     * @param count_invocation
+     *        Whether the code completes an invocation of the leaf. For
+     *        \c delay leafs, only the second step does.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    void generateProfiledLeafExecutionCode(
+        tools::CodeWriter& code, Forsyde::Leaf* leaf,
+        const std::string& leaf_code, bool count_invocation)
+        throw(RuntimeException);
+
+    /**
+     * Generates code which executes the schedule once. The first step of all
+     * \c delay leafs is executed first, then all leafs in schedule order, and
+     * last the second step of all \c delay leafs (see
+     * generateProcessNetworkFunctionDefinitionCode()).
+     *
+     * When generating code for a pipeline stage, only the leafs of that stage
+     * are executed. The signal values written by the \c delay leafs are then
+     * sent to subsequent stages directly after the first step, the values from
+     * previous stages are received before the leafs are executed, and the
+     * remaining values are sent after the leafs have been executed.
+     *
+     * @param code
+     *        Code writer to which the code is written.
+     * @param stage
+     *        Pipeline stage for which to generate code. A negative value means
+     *        all stages, without any communication between stages.
      * @throws InvalidModelException
      *         When something is wrong with the processnetwork.
      * @throws IOException
@@ -455,18 +1333,20 @@ class Synthesizer {
      * @throws RuntimeException
      *         When a program error occurs. This most likely indicates a bug.
      */
-    void generateParallelMapSyWrapperFunctions()
+    void generateScheduleExecutionCode(tools::CodeWriter& code, int stage = -1)
         throw(InvalidModelException, IOException, RuntimeException);
 
     /**
-     * Generates a wrapper function which executes a given function for the
-     * entire input array. The wrapping function is left intact.
+     * Generates code which executes either the first or the second step of
+     * all \c delay leafs.
      *
-     * @param function
-     *        Function to execute.
-     * @param num_leafs
-     *        Number of leafs which the function encompasses.
-     * @returns Wrapper function.
+     * @param code
+     *        Code writer to which the code is written.
+     * @param stage
+     *        Pipeline stage for which to generate code. A negative value means
+     *        all stages.
+     * @param first_step
+     *        Whether to execute the first step rather than the second.
      * @throws InvalidModelException
      *         When something is wrong with the processnetwork.
      * @throws IOException
@@ -474,15 +1354,15 @@ class Synthesizer {
      * @throws RuntimeException
      *         When a program error occurs. This most likely indicates a bug.
      */
-    CFunction generateParallelMapSyWrapperFunction(CFunction* function,
-                                                   size_t num_leafs)
+    void generateDelayExecutionCode(tools::CodeWriter& code, int stage,
+                                    bool first_step)
         throw(InvalidModelException, IOException, RuntimeException);
 
     /**
-     * Generates code for the function definitions for the leafs present
-     * in the schedule.
+     * Generates code for the processnetwork function prototype. This is used for the
+     * header file.
      *
-     * @returns Leaf function definitions code.
+     * @returns ProcessNetwork function prototype.
      * @throws InvalidModelException
      *         When something is wrong with the processnetwork.
      * @throws IOException
@@ -490,23 +1370,14 @@ class Synthesizer {
      * @throws RuntimeException
      *         When a program error occurs. This most likely indicates a bug.
      */
-    std::string generateLeafFunctionDefinitionsCode()
+    std::string generateProcessNetworkFunctionPrototypeCode()
         throw(InvalidModelException, IOException, RuntimeException);
 
     /**
-     * Generates code for the processnetwork function definition, which implements the
-     * schedule.
-     *
-     * Note that \c delay leafs are executed in two steps. The first step
-     * of all \c delay leafs is executed before all other leafs. Then,
-     * the leafs are executed in order as defined by the schedule but the \c
-     * delay leafs are ignored. Once the schedule has been executed, the
-     * second step of all \c delay leafs is executed. This must be done in
-     * order to first propagate the values of the delay variables to the signal
-     * variables, and then save the new values in the delay variables until the
-     * next processnetwork invocation.
+     * Generates code for the block-processing function prototype. This is used
+     * for the header file.
      *
-     * @returns ProcessNetwork function definition code.
+     * @returns Block-processing function prototype.
      * @throws InvalidModelException
      *         When something is wrong with the processnetwork.
      * @throws IOException
@@ -514,14 +1385,14 @@ class Synthesizer {
      * @throws RuntimeException
      *         When a program error occurs. This most likely indicates a bug.
      */
-    std::string generateProcessNetworkFunctionDefinitionCode()
+    std::string generateProcessNetworkBlockFunctionPrototypeCode()
         throw(InvalidModelException, IOException, RuntimeException);
 
     /**
-     * Generates code for the processnetwork function prototype. This is used for the
-     * header file.
+     * Generates a method description (Java style) for the processnetwork function.
      *
-     * @returns ProcessNetwork function prototype.
+     * @param desc
+     *        Code writer to which the description is written.
      * @throws InvalidModelException
      *         When something is wrong with the processnetwork.
      * @throws IOException
@@ -529,13 +1400,15 @@ class Synthesizer {
      * @throws RuntimeException
      *         When a program error occurs. This most likely indicates a bug.
      */
-    std::string generateProcessNetworkFunctionPrototypeCode()
+    void generateProcessNetworkFunctionDescription(tools::CodeWriter& desc)
         throw(InvalidModelException, IOException, RuntimeException);
 
     /**
-     * Generates a method description (Java style) for the processnetwork function.
+     * Generates a method description (Java style) for the block-processing
+     * function.
      *
-     * @returns ProcessNetwork function description.
+     * @param desc
+     *        Code writer to which the description is written.
      * @throws InvalidModelException
      *         When something is wrong with the processnetwork.
      * @throws IOException
@@ -543,7 +1416,8 @@ class Synthesizer {
      * @throws RuntimeException
      *         When a program error occurs. This most likely indicates a bug.
      */
-    std::string generateProcessNetworkFunctionDescription() 
+    void generateProcessNetworkBlockFunctionDescription(
+        tools::CodeWriter& desc)
         throw(InvalidModelException, IOException, RuntimeException);
 
     /**
@@ -551,13 +1425,23 @@ class Synthesizer {
      * function to the appropriate signals. Input array parameters are ignored
      * (see generateArrayInputOutputsToSignalsAliasingCode()).
      *
-     * @returns Copying code.
+     * @param code
+     *        Code writer to which the code is written.
+     * @param for_block
+     *        Whether to generate code for the block-processing function, in
+     *        which case the input parameters are indexed by the current token.
+     * @param stage
+     *        Pipeline stage for which to generate code, in which case only
+     *        the signals belonging to that stage are considered. A
+     *        negative value means all stages.
      * @throws InvalidModelException
      *         When something is wrong with the processnetwork.
      * @throws RuntimeException
      *         When a program error occurs. This most likely indicates a bug.
      */
-    std::string generateInputsToSignalsCopyingCode()
+    void generateInputsToSignalsCopyingCode(tools::CodeWriter& code,
+                                            bool for_block = false,
+                                            int stage = -1)
         throw(InvalidModelException, RuntimeException);
 
     /**
@@ -566,13 +1450,23 @@ class Synthesizer {
      * output parameters are ignored (see
      * generateArrayInputOutputsToSignalsAliasingCode()).
      *
-     * @returns Copying code.
+     * @param code
+     *        Code writer to which the code is written.
+     * @param for_block
+     *        Whether to generate code for the block-processing function, in
+     *        which case the output parameters are indexed by the current token.
+     * @param stage
+     *        Pipeline stage for which to generate code, in which case only
+     *        the signals belonging to that stage are considered. A
+     *        negative value means all stages.
      * @throws InvalidModelException
      *         When something is wrong with the processnetwork.
      * @throws RuntimeException
      *         When a program error occurs. This most likely indicates a bug.
      */
-    std::string generateSignalsToOutputsCopyingCode()
+    void generateSignalsToOutputsCopyingCode(tools::CodeWriter& code,
+                                             bool for_block = false,
+                                             int stage = -1)
         throw(InvalidModelException, RuntimeException);
 
     /**
@@ -580,13 +1474,23 @@ class Synthesizer {
      * the corresponding signal array variables. This reduces the amount of
      * memory copying needed.
      *
-     * @returns Copying code.
+     * @param code
+     *        Code writer to which the code is written.
+     * @param for_block
+     *        Whether to generate code for the block-processing function, in
+     *        which case the signal variables are aliased with the part of the
+     *        parameter arrays which belongs to the current token.
+     * @param stage
+     *        Pipeline stage for which to generate code, in which case only
+     *        the signals belonging to that stage are considered. A
+     *        negative value means all stages.
      * @throws InvalidModelException
      *         When something is wrong with the processnetwork.
      * @throws RuntimeException
      *         When a program error occurs. This most likely indicates a bug.
      */
-    std::string generateArrayInputOutputsToSignalsAliasingCode()
+    void generateArrayInputOutputsToSignalsAliasingCode(
+        tools::CodeWriter& code, bool for_block = false, int stage = -1)
         throw(InvalidModelException, RuntimeException);
 
     /**
@@ -597,7 +1501,12 @@ class Synthesizer {
      * will simply be declared but not be allocated any memory as its address
      * will be set to the address of the input array.
      *
-     * @returns Variable declarations code.
+     * @param code
+     *        Code writer to which the code is written.
+     * @param stage
+     *        Pipeline stage for which to generate code, in which case only
+     *        the signals belonging to that stage are considered. A
+     *        negative value means all stages.
      * @throws InvalidModelException
      *         When a variable cannot be declared due to lacking information.
      * @throws IOException
@@ -605,16 +1514,42 @@ class Synthesizer {
      * @throws RuntimeException
      *         When a program error occurs. This most likely indicates a bug.
      */
-    std::string generateSignalVariableDeclarationsCode()
+    void generateSignalVariableDeclarationsCode(tools::CodeWriter& code,
+                                                int stage = -1)
         throw(InvalidModelException, IOException, RuntimeException);
 
     /**
      * Generates code for declaring the delay variables. A delay variable is
      * always declared as \c static as they need to retain their values between
      * processnetwork invocations. The variables will also be initialized with the
-     * initial values specified in the processnetwork.
+     * initial values specified in the processnetwork. For reentrant code, the
+     * delay variables are instead members of the state struct, and no code is
+     * generated.
+     *
+     * @param code
+     *        Code writer to which the code is written.
+     * @param stage
+     *        Pipeline stage for which to generate code, in which case only
+     *        the delay leafs belonging to that stage are considered. A
+     *        negative value means all stages.
+     * @throws InvalidModelException
+     *         When a variable cannot be declared due to lacking information.
+     * @throws IOException
+     *         When access to the log file fails.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    void generateDelayVariableDeclarationsCode(tools::CodeWriter& code,
+                                               int stage = -1)
+        throw(InvalidModelException, IOException, RuntimeException);
+
+    /**
+     * Generates the definition of the C struct which holds the delay state of
+     * reentrant code, with one member per delay variable. The struct is
+     * preceded by its description.
      *
-     * @returns Variable declarations code.
+     * @param code
+     *        Code writer to which the code is written.
      * @throws InvalidModelException
      *         When a variable cannot be declared due to lacking information.
      * @throws IOException
@@ -622,11 +1557,46 @@ class Synthesizer {
      * @throws RuntimeException
      *         When a program error occurs. This most likely indicates a bug.
      */
-    std::string generateDelayVariableDeclarationsCode()
+    void generateStateStructDefinitionCode(tools::CodeWriter& code)
         throw(InvalidModelException, IOException, RuntimeException);
 
     /**
-     * Gets the corresponding delay variable and initial value for a leaf.
+     * Generates the prototypes, with descriptions, of the functions which
+     * initialize and reset the delay state of reentrant code.
+     *
+     * @param code
+     *        Code writer to which the code is written.
+     */
+    void generateStateFunctionPrototypesCode(tools::CodeWriter& code) throw();
+
+    /**
+     * Generates the definitions of the functions which initialize and reset
+     * the delay state of reentrant code. Both set every delay variable to the
+     * initial value specified in the processnetwork.
+     *
+     * @param code
+     *        Code writer to which the code is written.
+     * @throws InvalidModelException
+     *         When a variable cannot be declared due to lacking information.
+     * @throws IOException
+     *         When access to the log file fails.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    void generateStateFunctionDefinitionsCode(tools::CodeWriter& code)
+        throw(InvalidModelException, IOException, RuntimeException);
+
+    /**
+     * Gets the declaration of the state parameter of reentrant code.
+     *
+     * @returns Parameter declaration.
+     */
+    std::string getStateParameterDeclarationString() const throw();
+
+    /**
+     * Gets the corresponding delay variable and initial value for a leaf. For
+     * reentrant code, the variable refers to the member of the state struct
+     * accessed through the state parameter.
      *
      * @param leaf
      *        Delay leaf.
@@ -648,13 +1618,19 @@ class Synthesizer {
      * allocated for them (they simply take the address of the array input
      * parameters).
      *
-     * @returns Cleanup code.
+     * @param code
+     *        Code writer to which the code is written.
+     * @param stage
+     *        Pipeline stage for which to generate code, in which case only
+     *        the signals belonging to that stage are considered. A
+     *        negative value means all stages.
      * @throws IOException
      *         When access to the log file fails.
      * @throws RuntimeException
      *         When a program error occurs. This most likely indicates a bug.
      */
-    std::string generateSignalVariableCleanupCode()
+    void generateSignalVariableCleanupCode(tools::CodeWriter& code,
+                                           int stage = -1)
         throw(IOException, RuntimeException);
 
     /**
@@ -664,6 +1640,16 @@ class Synthesizer {
      * All output parameters will be declared as pointers (except arrays, which
      * are already pointers).
      *
+     * For the block-processing function, the parameter list is preceded by
+     * the number of tokens, and every parameter is declared as an array
+     * holding the data of all tokens in the block.
+     *
+     * For reentrant code, the parameter list is preceded by the state
+     * parameter.
+     *
+     * @param for_block
+     *        Whether to generate the parameter list of the block-processing
+     *        function.
      * @returns Function parameter list code.
      * @throws InvalidModelException
      *         When a variable cannot be declared due to lacking information.
@@ -672,7 +1658,8 @@ class Synthesizer {
      * @throws RuntimeException
      *         When a program error occurs. This most likely indicates a bug.
      */
-    std::string generateProcessNetworkFunctionParameterListCode()
+    std::string generateProcessNetworkFunctionParameterListCode(
+        bool for_block = false)
         throw(InvalidModelException, RuntimeException);
 
     /**
@@ -879,7 +1866,9 @@ class Synthesizer {
 
     /**
      * Generates code for copying the contents of a list of non-array variables
-     * to another variable of array type.
+     * to another variable of array type. Source variables which are views
+     * into the destination variable are skipped, as their contents are
+     * already in place.
      *
      * @param to
      *        Destination variable.
@@ -900,7 +1889,9 @@ class Synthesizer {
 
     /**
      * Generates code for copying the content of a variable of array type to a
-     * list of other non-array variables.
+     * list of other non-array variables. Destination variables which are
+     * views into the source variable are skipped, as they already refer to
+     * the source contents.
      *
      * @param to
      *        Destination variables.
@@ -1016,12 +2007,32 @@ class Synthesizer {
      */
     std::string scheduleToString() const throw();
 
+
+    /**
+     * Creates the variable through which a processnetwork parameter is
+     * accessed for the current token in the block-processing function. For
+     * arrays this is the address of the token's part of the array, and for
+     * scalars this is the token's element.
+     *
+     * @param name
+     *        Parameter name.
+     * @param data_type
+     *        Data type of the signal associated with the parameter.
+     * @returns Variable referring to the token's data.
+     * @throws InvalidModelException
+     *         When the array size of \c data_type is not known.
+     */
+    CVariable getBlockParameterTokenVariable(const std::string& name,
+                                             CDataType data_type) const
+        throw(InvalidModelException);
+
     /**
      * Generates code for the kernel config struct definition. The kernel config
      * struct is used for calculating the best kernel configuration of grids and
      * blocks at runtime for optimal performance.
      *
-     * @returns Struct definition code.
+     * @param code
+     *        Code writer to which the code is written.
      * @throws InvalidModelException
      *         When something is wrong with the processnetwork.
      * @throws IOException
@@ -1029,7 +2040,7 @@ class Synthesizer {
      * @throws RuntimeException
      *         When a program error occurs. This most likely indicates a bug.
      */
-    std::string generateKernelConfigStructDefinitionCode()
+    void generateKernelConfigStructDefinitionCode(tools::CodeWriter& code)
         throw(InvalidModelException, IOException, RuntimeException);
 
     /**
@@ -1037,7 +2048,8 @@ class Synthesizer {
      * config function calculates the best kernel configuration of grids and
      * blocks at runtime for optimal performance.
      *
-     * @returns Function definition code.
+     * @param code
+     *        Code writer to which the code is written.
      * @throws InvalidModelException
      *         When something is wrong with the processnetwork.
      * @throws IOException
@@ -1045,7 +2057,7 @@ class Synthesizer {
      * @throws RuntimeException
      *         When a program error occurs. This most likely indicates a bug.
      */
-    std::string generateKernelConfigFunctionDefinitionCode()
+    void generateKernelConfigFunctionDefinitionCode(tools::CodeWriter& code)
         throw(InvalidModelException, IOException, RuntimeException);
 
     /**
@@ -1070,14 +2082,341 @@ class Synthesizer {
      *        Signal whose variable to check.
      * @returns \b true if the data type is an array and it is not written to by
      *          the processnetwork input parameters or read from for the processnetwork output
-     *          parameters.
+     *          parameters, nor is a view into another signal variable or
+     *          points into a delay ring.
      */
     bool dynamicallyAllocateMemoryForSignalVariable(Signal* signal);
 
+    /**
+     * Finds the signal array variables which can be views into other signal
+     * array variables, thereby avoiding the element-by-element copying of the
+     * \c Unzipx and \c Zipx leafs. An array output of an \c Unzipx leaf
+     * becomes a view into the leaf's input, and an array input of a \c Zipx
+     * leaf becomes a view into the leaf's output, which the producing leaf
+     * then writes to directly.
+     *
+     * A signal can only become a view if it would otherwise be allocated
+     * memory of its own, and a signal is never a view into more than one
+     * other signal. An \c Unzipx output is only a view into a \c const input
+     * if it is only read by its consumer, and a \c Zipx input is never a view
+     * into a \c const output. For pipelined code, signals crossing pipeline
+     * stages are never views as they need storage in both stages. The views
+     * are ordered such that a view is aliased after the variable into which it
+     * is a view.
+     *
+     * @throws InvalidModelException
+     *         When something is wrong with the processnetwork.
+     * @throws IOException
+     *         When access to the log file fails.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    void createSignalArrayViews()
+        throw(InvalidModelException, IOException, RuntimeException);
+
+    /**
+     * Checks whether a signal may become a view into another signal.
+     *
+     * @param signal
+     *        Signal to check.
+     * @returns \b true if it may.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    bool canBeSignalArrayView(Signal* signal) throw(RuntimeException);
+
+    /**
+     * Checks whether the leaf consuming a signal only reads the signal
+     * variable, i.e. never writes to it.
+     *
+     * @param signal
+     *        Signal to check.
+     * @returns \b true if it does.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    bool isSignalOnlyReadByConsumer(Signal* signal) throw(RuntimeException);
+
+    /**
+     * Checks whether a variable is the variable of a signal which is a view
+     * into another signal variable.
+     *
+     * @param variable
+     *        Variable to check.
+     * @param viewed
+     *        If not \c NULL, the variable must be a view into this variable.
+     * @returns \b true if it is.
+     */
+    bool isSignalArrayView(const CVariable& variable,
+                           const CVariable* viewed = NULL) const throw();
+
+    /**
+     * Generates code which aliases the signal array variables which are views
+     * with the appropriate part of the signal variable into which they are
+     * views.
+     *
+     * @param code
+     *        Code writer to which the code is written.
+     * @param stage
+     *        Pipeline stage for which to generate code, in which case only
+     *        the views belonging to that stage are considered. A negative
+     *        value means all stages.
+     * @throws InvalidModelException
+     *         When something is wrong with the processnetwork.
+     * @throws IOException
+     *         When access to the log file fails.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    void generateSignalArrayViewsAliasingCode(tools::CodeWriter& code,
+                                              int stage = -1)
+        throw(InvalidModelException, IOException, RuntimeException);
+
+    /**
+     * Plans the memory of the internal signal arrays. Instead of allocating
+     * each array separately, all arrays are placed in a single memory arena,
+     * at offsets aligned to \c kSignalArenaAlignment bytes. The live interval
+     * of each array is derived from the schedule, spanning from the leaf that
+     * writes the array to the leaf that last reads it (including the reads
+     * through views into the array), and arrays whose live intervals do not
+     * overlap may share the same memory. Arrays are placed largest first, each
+     * at the lowest offset which does not collide with an already placed
+     * array that is live at the same time. Arrays of equal size are placed in
+     * signal order, such that the same model always gives the same offsets.
+     *
+     * In reentrant code, the arena is a member of the state struct. In other
+     * code, it is a static array if the processnetwork already has static
+     * state (see hasStaticState()), and otherwise allocated once per
+     * invocation so that the code stays reentrant.
+     *
+     * For pipelined code, each stage gets an arena of its own. Arrays written
+     * by delay leafs or received from another stage are considered live from
+     * the start of the schedule, and arrays read by delay leafs or sent to
+     * another stage are considered live until the end of the schedule.
+     *
+     * @throws InvalidModelException
+     *         When something is wrong with the processnetwork.
+     * @throws IOException
+     *         When access to the log file fails.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    void planSignalMemory()
+        throw(InvalidModelException, IOException, RuntimeException);
+
+    /**
+     * Plans the memory arena of a single pipeline stage.
+     *
+     * @param stage
+     *        Pipeline stage to plan, or a negative value if the code is not
+     *        pipelined.
+     * @param positions
+     *        Position of each leaf in the schedule, starting at 1.
+     * @throws InvalidModelException
+     *         When something is wrong with the processnetwork.
+     * @throws IOException
+     *         When access to the log file fails.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     * @see planSignalMemory()
+     */
+    void planSignalMemory(int stage,
+                          const std::map<const Forsyde::Process*, size_t>&
+                          positions)
+        throw(InvalidModelException, IOException, RuntimeException);
+
+    /**
+     * Gets the live interval of a signal variable within a pipeline stage,
+     * as a pair of the first and last schedule positions at which the
+     * variable is accessed. Position 0 is the start of the schedule and
+     * position <tt>schedule_.size() + 1</tt> is its end.
+     *
+     * @param signal
+     *        Signal whose live interval to get.
+     * @param stage
+     *        Pipeline stage, or a negative value if the code is not pipelined.
+     * @param positions
+     *        Position of each leaf in the schedule, starting at 1.
+     * @returns Live interval.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    std::pair<size_t, size_t> getSignalLiveInterval(
+        Signal* signal, int stage,
+        const std::map<const Forsyde::Process*, size_t>& positions)
+        throw(RuntimeException);
+
+    /**
+     * Gets the signal which actually holds the memory seen through a signal
+     * array view, following views into views.
+     *
+     * @param signal
+     *        Signal to follow.
+     * @returns The signal itself if it is not a view; otherwise the signal
+     *          holding the memory.
+     */
+    Signal* getSignalArrayViewRoot(Signal* signal) const throw();
+
+    /**
+     * Finds the chains of array \c delay leafs which can be executed by
+     * rotating pointers into a ring of buffers instead of copying the arrays.
+     * A chain of \em d \c delay leafs gets a ring of <em>d + 1</em> buffers:
+     * the producer of the chain's input writes directly into the buffer at
+     * the current ring position, the output of the <em>k</em>th leaf in the
+     * chain points to the buffer \em k positions behind it, and the ring
+     * position is advanced once per invocation.
+     *
+     * A chain qualifies only if all of its signals are internal array
+     * signals which are not views into other signal variables, the input is
+     * not produced by a \c delay leaf, and the output is not consumed by
+     * one. For pipelined code, none of the signals may cross pipeline
+     * stages.
+     *
+     * @throws InvalidModelException
+     *         When something is wrong with the processnetwork.
+     * @throws IOException
+     *         When access to the log file fails.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    void createDelayRings()
+        throw(InvalidModelException, IOException, RuntimeException);
+
+    /**
+     * Checks whether all signals of a chain of \c delay leafs allow the
+     * chain to become a delay ring.
+     *
+     * @param chain
+     *        Chain of \c delay leafs, in data flow order.
+     * @returns \b true if they do.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    bool canBeDelayRing(const std::vector<Forsyde::SY::delay*>& chain)
+        throw(RuntimeException);
+
+    /**
+     * Gets the delay ring to which a \c delay leaf belongs.
+     *
+     * @param leaf
+     *        Delay leaf.
+     * @returns Delay ring, or \c NULL if the leaf does not belong to any.
+     */
+    const std::vector<Forsyde::SY::delay*>* getDelayRing(
+        const Forsyde::SY::delay* leaf) const throw();
+
+    /**
+     * Checks whether a signal variable points into a delay ring.
+     *
+     * @param signal
+     *        Signal to check.
+     * @returns \b true if it does.
+     */
+    bool isDelayRingSignal(Signal* signal) const throw();
+
+    /**
+     * Gets the name of the buffer array of a delay ring, which is derived
+     * from the delay variable of the ring's first \c delay leaf. For
+     * reentrant code, the name refers to the member of the state struct.
+     *
+     * @param ring
+     *        Delay ring.
+     * @returns Buffer array name.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    std::string getDelayRingName(const std::vector<Forsyde::SY::delay*>& ring)
+        throw(RuntimeException);
+
+    /**
+     * Gets the declaration of the buffer array of a delay ring, without any
+     * initializer or state struct prefix.
+     *
+     * @param ring
+     *        Delay ring.
+     * @returns Buffer array declaration.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    std::string getDelayRingDeclarationString(
+        const std::vector<Forsyde::SY::delay*>& ring)
+        throw(RuntimeException);
+
+    /**
+     * Generates code which points the signal variables of the delay rings
+     * into their ring buffers. This must precede the aliasing of any views
+     * into those signal variables.
+     *
+     * @param code
+     *        Code writer to which the code is written.
+     * @param stage
+     *        Pipeline stage for which to generate code, in which case only
+     *        the delay rings belonging to that stage are considered. A
+     *        negative value means all stages.
+     * @throws InvalidModelException
+     *         When something is wrong with the processnetwork.
+     * @throws IOException
+     *         When access to the log file fails.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    void generateDelayRingAliasingCode(tools::CodeWriter& code, int stage = -1)
+        throw(InvalidModelException, IOException, RuntimeException);
+
+    /**
+     * Generates code which fails to compile if a data type of an array in a
+     * signal arena is larger on the target platform than the size assumed
+     * when planning the arena (see CDataType::getMaxElementSize()), as the
+     * arrays could then overlap.
+     *
+     * @param code
+     *        Code writer to which the code is written.
+     * @throws IOException
+     *         When access to the log file fails.
+     * @throws RuntimeException
+     *         When a program error occurs. This most likely indicates a bug.
+     */
+    void generateSignalArenaSizeCheckCode(tools::CodeWriter& code)
+        throw(IOException, RuntimeException);
+
+    /**
+     * Gets the name of the state struct member which holds the memory arena
+     * of a pipeline stage in reentrant code.
+     *
+     * @param stage
+     *        Pipeline stage, or a negative value if the code is not pipelined.
+     * @returns Member name.
+     */
+    std::string getSignalArenaMemberName(int stage) const throw();
+
+    /**
+     * Checks whether the generated code keeps the processnetwork state in
+     * static variables, which is the case for non-reentrant code of a
+     * processnetwork with delay leafs, and for non-reentrant task-parallel
+     * code as it keeps its task pool. Only then may the signal arena be
+     * static as well, as the code is non-reentrant anyway.
+     *
+     * @returns \b true if it does.
+     */
+    bool hasStaticState() const throw();
+
+    /**
+     * Checks whether a signal variable has been placed in the memory arena of
+     * a pipeline stage.
+     *
+     * @param signal
+     *        Signal to check.
+     * @param stage
+     *        Pipeline stage, or a negative value if the code is not pipelined.
+     * @returns \b true if it has.
+     */
+    bool isSignalInArena(Signal* signal, int stage) const throw();
+
     /**
      * Generates code which execute the first step of given \c delay
      * leaf. The generated code copies the value from the delay variable to
-     * the out signal.
+     * the out signal. For delay leafs in a delay ring, no code is generated
+     * as the out signal variable already points into the ring.
      *
      * @param leaf
      *        Leaf to execute.
@@ -1096,7 +2435,9 @@ class Synthesizer {
     /**
      * Generates code which execute the second step of given \c delay
      * leaf. The generated code copies the value from the in signal to the
-     * delay variable.
+     * delay variable. For the first delay leaf in a delay ring, the generated
+     * code instead advances the ring position, and for the other delay leafs
+     * in the ring no code is generated.
      *
      * @param leaf
      *        Leaf to execute.
@@ -1243,6 +2584,60 @@ class Synthesizer {
     std::map< Forsyde::SY::delay*, std::pair<CVariable, std::string> >
     delay_variables_;
 
+    /**
+     * List of signals whose variables are views into other signal variables,
+     * in aliasing order. Each entry is a pair of the view signal and a pair
+     * of the signal into which it is a view and the offset into that signal's
+     * array.
+     */
+    std::list< std::pair<Signal*, std::pair<Signal*, size_t> > >
+    signal_array_views_;
+
+    /**
+     * Mapset of offsets into the signal memory arena, in bytes. The key is a
+     * pair of the pipeline stage (negative if the code is not pipelined) and
+     * the signal.
+     */
+    std::map< std::pair<int, Signal*>, size_t > signal_arena_offsets_;
+
+    /**
+     * List of delay rings. Each delay ring is a chain of \c delay leafs in
+     * data flow order.
+     */
+    std::list< std::vector<Forsyde::SY::delay*> > delay_rings_;
+
+    /**
+     * Mapset of signal memory arena sizes, in bytes, with the pipeline stage
+     * (negative if the code is not pipelined) as key. Stages without any
+     * signal arrays in the arena have no entry.
+     */
+    std::map<int, size_t> signal_arena_sizes_;
+
+    /**
+     * Mapset of pipeline stages, with the leaf as key.
+     */
+    std::map<const Forsyde::Process*, int> pipeline_stages_;
+
+    /**
+     * Number of pipeline stages.
+     */
+    int num_pipeline_stages_;
+
+    /**
+     * Leafs executed as tasks, in schedule order.
+     */
+    std::vector<Forsyde::Leaf*> tasks_;
+
+    /**
+     * Indices of the tasks which depend on each task.
+     */
+    std::vector< std::vector<size_t> > task_successors_;
+
+    /**
+     * Number of tasks on which each task depends.
+     */
+    std::vector<size_t> task_num_dependencies_;
+
   private:
     /**
      * @brief Manages data storage between leafs.
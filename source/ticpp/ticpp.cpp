@@ -844,7 +844,21 @@ void Document::SaveFile( const std::string& filename ) const
 
 void Document::Parse( const std::string& xml, bool throwIfParseError, TiXmlEncoding encoding )
 {
-	m_tiXmlPointer->Parse( xml.c_str(), 0, encoding );
+	Parse( xml.c_str(), throwIfParseError, encoding );
+}
+
+void Document::Parse( const char* xml, bool throwIfParseError, TiXmlEncoding encoding )
+{
+	m_tiXmlPointer->Parse( xml, 0, encoding );
+	if( throwIfParseError && m_tiXmlPointer->Error() )
+	{
+		TICPPTHROW( "Error parsing xml." );
+	}
+}
+
+void Document::ParseFragment( const std::string& xml, int row, int col, bool throwIfParseError, TiXmlEncoding encoding )
+{
+	m_tiXmlPointer->ParseFragment( xml.c_str(), row, col, encoding );
 	if( throwIfParseError && m_tiXmlPointer->Error() )
 	{
 		TICPPTHROW( "Error parsing xml." );
@@ -1455,6 +1455,28 @@ namespace ticpp
 		@throws Exception
 		*/
 		void Parse( const std::string& xml, bool throwIfParseError = true, TiXmlEncoding encoding = TIXML_DEFAULT_ENCODING );
+
+		/**
+		Parse the given null terminated xml data without copying it.
+
+		@param xml Xml to parse.
+		@param throwIfParseError [DEF] If true, throws when there is a parse error.
+		@param encoding Sets the documents encoding.
+		@throws Exception
+		*/
+		void Parse( const char* xml, bool throwIfParseError = true, TiXmlEncoding encoding = TIXML_DEFAULT_ENCODING );
+
+		/**
+		Parse the given xml data as a fragment of a larger document.
+
+		@param xml Xml to parse.
+		@param row 0-based row in the larger document at which the fragment starts.
+		@param col 0-based column in the larger document at which the fragment starts.
+		@param throwIfParseError [DEF] If true, throws when there is a parse error.
+		@param encoding Sets the documents encoding.
+		@throws Exception
+		*/
+		void ParseFragment( const std::string& xml, int row, int col, bool throwIfParseError = true, TiXmlEncoding encoding = TIXML_DEFAULT_ENCODING );
 	};
 
 	/** Wrapper around TiXmlElement */
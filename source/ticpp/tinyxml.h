@@ -1522,6 +1522,12 @@ public:
 	*/
 	virtual const char* Parse( const char* p, TiXmlParsingData* data = 0, TiXmlEncoding encoding = TIXML_DEFAULT_ENCODING );
 
+	/** Parse the given null terminated block of xml data as a fragment of a larger
+		document, which starts at the given 0-based row and column. Rows and columns
+		of the parsed nodes are then reported as positions in the larger document.
+	*/
+	const char* ParseFragment( const char* p, int row, int col, TiXmlEncoding encoding = TIXML_DEFAULT_ENCODING );
+
 	/** Get the root element -- the only processnetwork level element -- of the document.
 		In well formed XML, there should only be one. TinyXml is tolerant of
 		multiple elements at the document level.
@@ -701,6 +701,12 @@ void TiXmlDocument::StreamIn( std::istream * in, TIXML_STRING * tag )
 
 #endif
 
+const char* TiXmlDocument::ParseFragment( const char* p, int row, int col, TiXmlEncoding encoding )
+{
+	TiXmlParsingData data( p ? p : "", TabSize(), row, col );
+	return Parse( p, &data, encoding );
+}
+
 const char* TiXmlDocument::Parse( const char* p, TiXmlParsingData* prevData, TiXmlEncoding encoding )
 {
 	ClearError();
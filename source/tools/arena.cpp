@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2011-2013
+ *     Gabriel Hjort Blindell <ghb@kth.se>
+ *     George Ungureanu <ugeorge@kth.se>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OF THIS SOFTWARE NOR THE
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "arena.h"
+
+using namespace f2cc::tools;
+using std::vector;
+using std::bad_alloc;
+using std::nothrow_t;
+
+namespace {
+
+/**
+ * Type with the strictest alignment of the fundamental types.
+ */
+union MaxAlign {
+    long double ld;
+    long long ll;
+    double d;
+    void* p;
+};
+
+/**
+ * Rounds a size up to a multiple of the strictest alignment.
+ */
+size_t alignSize(size_t size) {
+    return (size + sizeof(MaxAlign) - 1) & ~(sizeof(MaxAlign) - 1);
+}
+
+/**
+ * Header preceding each \c ArenaObject, recording the arena it was allocated
+ * from, or \c NULL if it was allocated from the heap.
+ */
+union ObjectHeader {
+    Arena* arena;
+    MaxAlign align;
+};
+
+}
+
+__thread Arena* Arena::active_ = NULL;
+
+Arena::Scope::Scope(Arena* arena) throw() : previous_(active_) {
+    active_ = arena;
+}
+
+Arena::Scope::~Scope() throw() {
+    active_ = previous_;
+}
+
+Arena::Arena(size_t chunk_size) throw()
+        : chunk_size_(alignSize(chunk_size)), next_(NULL), num_free_bytes_(0),
+          num_reserved_bytes_(0) {}
+
+Arena::~Arena() throw() {
+    for (vector<char*>::iterator it = chunks_.begin(); it != chunks_.end();
+         ++it) {
+        ::operator delete(*it);
+    }
+    if (active_ == this) active_ = NULL;
+}
+
+void* Arena::allocate(size_t size) throw(bad_alloc) {
+    size = alignSize(size);
+    if (size > chunk_size_ / 4) {
+        // Large requests get a chunk of their own so that the remainder of the
+        // current chunk is not wasted
+        return allocateChunk(size);
+    }
+    if (size > num_free_bytes_) {
+        next_ = allocateChunk(chunk_size_);
+        num_free_bytes_ = chunk_size_;
+    }
+    void* p = next_;
+    next_ += size;
+    num_free_bytes_ -= size;
+    return p;
+}
+
+size_t Arena::getNumReservedBytes() const throw() {
+    return num_reserved_bytes_;
+}
+
+Arena* Arena::getActive() throw() {
+    return active_;
+}
+
+char* Arena::allocateChunk(size_t size) throw(bad_alloc) {
+    chunks_.reserve(chunks_.size() + 1);
+    char* chunk = static_cast<char*>(::operator new(size));
+    chunks_.push_back(chunk);
+    num_reserved_bytes_ += size;
+    return chunk;
+}
+
+void* ArenaObject::operator new(size_t size) throw(bad_alloc) {
+    Arena* arena = Arena::getActive();
+    size += sizeof(ObjectHeader);
+    ObjectHeader* header = static_cast<ObjectHeader*>(
+        arena ? arena->allocate(size) : ::operator new(size));
+    header->arena = arena;
+    return header + 1;
+}
+
+void* ArenaObject::operator new(size_t size, const nothrow_t&) throw() {
+    try {
+        return operator new(size);
+    }
+    catch (bad_alloc&) {
+        return NULL;
+    }
+}
+
+void ArenaObject::operator delete(void* p) throw() {
+    if (!p) return;
+    ObjectHeader* header = static_cast<ObjectHeader*>(p) - 1;
+    if (!header->arena) ::operator delete(header);
+}
+
+void ArenaObject::operator delete(void* p, const nothrow_t&) throw() {
+    operator delete(p);
+}
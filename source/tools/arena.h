@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2011-2013
+ *     Gabriel Hjort Blindell <ghb@kth.se>
+ *     George Ungureanu <ugeorge@kth.se>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OF THIS SOFTWARE NOR THE
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef F2CC_SOURCE_TOOLS_ARENA_H_
+#define F2CC_SOURCE_TOOLS_ARENA_H_
+
+/**
+ * @file
+ * @version 0.1
+ *
+ * @brief Defines a bump allocator for objects which share the same lifetime.
+ */
+
+#include <vector>
+#include <new>
+#include <cstddef>
+
+namespace f2cc {
+namespace tools {
+
+/**
+ * @brief A bump allocator which frees all its memory in one step.
+ *
+ * The \c Arena hands out memory from large chunks by simply advancing a
+ * pointer, which means that objects allocated one after another end up next to
+ * each other in memory. Individual allocations are never freed; instead, all
+ * chunks are released when the arena is destroyed. Requests larger than a
+ * quarter of the chunk size get a chunk of their own.
+ *
+ * Classes which derive from \c ArenaObject are allocated from the arena
+ * currently activated through an \c Arena::Scope, if any.
+ */
+class Arena {
+  public:
+    /**
+     * @brief Activates an arena for the lifetime of the scope object.
+     *
+     * Scopes may be nested, in which case the previously active arena is
+     * restored when the inner scope ends. The active arena is per thread, so
+     * objects created by other threads are allocated on the heap unless those
+     * threads activate an arena of their own.
+     */
+    class Scope {
+      public:
+        /**
+         * Activates an arena.
+         *
+         * @param arena
+         *        Arena to activate, or \c NULL to allocate from the heap.
+         */
+        explicit Scope(Arena* arena) throw();
+
+        /**
+         * Restores the previously active arena.
+         */
+        ~Scope() throw();
+
+      private:
+        /**
+         * Previously active arena.
+         */
+        Arena* previous_;
+    };
+
+  public:
+    /**
+     * Creates an empty arena.
+     *
+     * @param chunk_size
+     *        Size of each chunk, in bytes.
+     */
+    explicit Arena(size_t chunk_size = 64 * 1024) throw();
+
+    /**
+     * Frees all memory allocated from this arena. No destructors are invoked.
+     */
+    ~Arena() throw();
+
+    /**
+     * Allocates memory from this arena. The memory is suitably aligned for
+     * any fundamental type.
+     *
+     * @param size
+     *        Number of bytes.
+     * @returns Pointer to the memory.
+     * @throws std::bad_alloc
+     *         When a new chunk cannot be allocated.
+     */
+    void* allocate(size_t size) throw(std::bad_alloc);
+
+    /**
+     * Gets the total number of bytes reserved by this arena.
+     *
+     * @returns Number of bytes.
+     */
+    size_t getNumReservedBytes() const throw();
+
+    /**
+     * Gets the currently active arena.
+     *
+     * @returns Active arena, or \c NULL if none.
+     */
+    static Arena* getActive() throw();
+
+  private:
+    /**
+     * Allocates a new chunk and adds it to the chunk list.
+     *
+     * @param size
+     *        Size of the chunk, in bytes.
+     * @returns Pointer to the chunk.
+     * @throws std::bad_alloc
+     *         When out of memory.
+     */
+    char* allocateChunk(size_t size) throw(std::bad_alloc);
+
+    /**
+     * Disallow copying.
+     */
+    Arena(const Arena&);
+
+    /**
+     * Disallow assignment.
+     */
+    Arena& operator=(const Arena&);
+
+  private:
+    /**
+     * Size of each regular chunk.
+     */
+    const size_t chunk_size_;
+
+    /**
+     * All chunks allocated by this arena.
+     */
+    std::vector<char*> chunks_;
+
+    /**
+     * Next free byte in the current chunk.
+     */
+    char* next_;
+
+    /**
+     * Number of bytes left in the current chunk.
+     */
+    size_t num_free_bytes_;
+
+    /**
+     * Total number of bytes reserved.
+     */
+    size_t num_reserved_bytes_;
+
+    /**
+     * Currently active arena of the calling thread.
+     */
+    static __thread Arena* active_;
+};
+
+/**
+ * @brief Base class for objects which may be allocated from an \c Arena.
+ *
+ * Objects of derived classes are allocated from the active arena when created
+ * with \c new, and from the heap otherwise. Each object is preceded by a small
+ * header recording where it came from, so that \c delete still runs the
+ * destructor but only returns heap memory; arena memory is reclaimed when the
+ * arena itself is destroyed. Hence an arena must outlive all objects allocated
+ * from it.
+ */
+class ArenaObject {
+  public:
+    /**
+     * Allocates an object.
+     *
+     * @param size
+     *        Object size.
+     * @returns Pointer to the object memory.
+     * @throws std::bad_alloc
+     *         When out of memory.
+     */
+    static void* operator new(size_t size) throw(std::bad_alloc);
+
+    /**
+     * Same as operator new(size_t) but returns \c NULL when out of memory.
+     *
+     * @param size
+     *        Object size.
+     * @param nothrow
+     *        Tag.
+     * @returns Pointer to the object memory, or \c NULL.
+     */
+    static void* operator new(size_t size, const std::nothrow_t& nothrow)
+        throw();
+
+    /**
+     * Releases an object's memory if it was allocated from the heap.
+     *
+     * @param p
+     *        Pointer to the object memory.
+     */
+    static void operator delete(void* p) throw();
+
+    /**
+     * Same as operator delete(void*).
+     *
+     * @param p
+     *        Pointer to the object memory.
+     * @param nothrow
+     *        Tag.
+     */
+    static void operator delete(void* p, const std::nothrow_t& nothrow)
+        throw();
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2011-2013
+ *     Gabriel Hjort Blindell <ghb@kth.se>
+ *     George Ungureanu <ugeorge@kth.se>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OF THIS SOFTWARE NOR THE
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "codewriter.h"
+#include "tools.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+
+using namespace f2cc::tools;
+using f2cc::IOException;
+using std::string;
+
+namespace {
+
+/**
+ * Size of the buffer through which code is written to a file.
+ */
+const size_t kBufferSize = 1 << 16;
+
+}
+
+CodeWriter::CodeWriter(const string& indents) throw()
+        : indents_(indents), level_(0), is_at_line_start_(true), size_(0),
+          fd_(-1), buffer_size_(0), error_(0) {}
+
+CodeWriter::~CodeWriter() throw() {
+    discard();
+}
+
+void CodeWriter::open(const string& file) throw(IOException) {
+    discard();
+    string temp_file = file + ".tmp" + toString(static_cast<long>(getpid()));
+    int fd = ::open(temp_file.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (fd < 0) {
+        THROW_EXCEPTION(IOException, file, "Failed to open output file");
+    }
+    file_ = file;
+    temp_file_ = temp_file;
+    fd_ = fd;
+    buffer_.resize(kBufferSize);
+    buffer_size_ = 0;
+    error_ = 0;
+}
+
+void CodeWriter::close() throw(IOException) {
+    if (fd_ < 0) return;
+
+    flush();
+    if (::close(fd_) != 0 && error_ == 0) error_ = errno;
+    fd_ = -1;
+    if (error_ == 0 && rename(temp_file_.c_str(), file_.c_str()) != 0) {
+        error_ = errno;
+    }
+    if (error_ != 0) {
+        unlink(temp_file_.c_str());
+        string file(file_);
+        file_.clear();
+        temp_file_.clear();
+        THROW_EXCEPTION(IOException, file, "Failed to write output file");
+    }
+    file_.clear();
+    temp_file_.clear();
+    std::vector<char>().swap(buffer_);
+}
+
+void CodeWriter::write(const char* data, size_t size) throw() {
+    if (indents_.empty() || level_ == 0) {
+        if (size > 0) is_at_line_start_ = data[size - 1] == '\n';
+        append(data, size);
+        return;
+    }
+
+    // Indent each non-empty line as it begins
+    const char* end = data + size;
+    while (data < end) {
+        if (is_at_line_start_ && *data != '\n') {
+            for (int i = 0; i < level_; ++i) {
+                append(indents_.data(), indents_.length());
+            }
+        }
+        const char* line_end = static_cast<const char*>(
+            memchr(data, '\n', end - data));
+        if (line_end) {
+            ++line_end;
+            is_at_line_start_ = true;
+        }
+        else {
+            line_end = end;
+            is_at_line_start_ = false;
+        }
+        append(data, line_end - data);
+        data = line_end;
+    }
+}
+
+CodeWriter& CodeWriter::operator<<(const string& str) throw() {
+    write(str.data(), str.length());
+    return *this;
+}
+
+CodeWriter& CodeWriter::operator<<(const char* str) throw() {
+    write(str, strlen(str));
+    return *this;
+}
+
+CodeWriter& CodeWriter::operator<<(char c) throw() {
+    write(&c, 1);
+    return *this;
+}
+
+CodeWriter& CodeWriter::operator<<(int value) throw() {
+    return *this << static_cast<long>(value);
+}
+
+CodeWriter& CodeWriter::operator<<(unsigned int value) throw() {
+    return *this << static_cast<unsigned long>(value);
+}
+
+CodeWriter& CodeWriter::operator<<(long value) throw() {
+    char buffer[kMaxIntegerLength];
+    write(buffer, formatInteger(value, buffer));
+    return *this;
+}
+
+CodeWriter& CodeWriter::operator<<(unsigned long value) throw() {
+    char buffer[kMaxIntegerLength];
+    write(buffer, formatInteger(value, buffer));
+    return *this;
+}
+
+void CodeWriter::indent() throw() {
+    ++level_;
+}
+
+void CodeWriter::unindent() throw() {
+    if (level_ > 0) --level_;
+}
+
+size_t CodeWriter::getSize() const throw() {
+    return size_;
+}
+
+const string& CodeWriter::getString() const throw() {
+    return string_;
+}
+
+void CodeWriter::append(const char* data, size_t size) throw() {
+    size_ += size;
+    if (fd_ < 0) {
+        string_.append(data, size);
+        return;
+    }
+
+    if (buffer_size_ + size > kBufferSize) {
+        flush();
+        if (size >= kBufferSize) {
+            writeToFile(data, size);
+            return;
+        }
+    }
+    memcpy(&buffer_[buffer_size_], data, size);
+    buffer_size_ += size;
+}
+
+void CodeWriter::flush() throw() {
+    if (buffer_size_ == 0) return;
+    writeToFile(&buffer_[0], buffer_size_);
+    buffer_size_ = 0;
+}
+
+void CodeWriter::writeToFile(const char* data, size_t size) throw() {
+    while (size > 0 && error_ == 0) {
+        ssize_t num_written = ::write(fd_, data, size);
+        if (num_written < 0) {
+            if (errno == EINTR) continue;
+            error_ = errno;
+            return;
+        }
+        data += num_written;
+        size -= static_cast<size_t>(num_written);
+    }
+}
+
+void CodeWriter::discard() throw() {
+    if (fd_ < 0) return;
+    ::close(fd_);
+    fd_ = -1;
+    unlink(temp_file_.c_str());
+    file_.clear();
+    temp_file_.clear();
+    std::vector<char>().swap(buffer_);
+    buffer_size_ = 0;
+}
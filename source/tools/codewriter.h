@@ -0,0 +1,289 @@
+/*
+ * Copyright (c) 2011-2013
+ *     Gabriel Hjort Blindell <ghb@kth.se>
+ *     George Ungureanu <ugeorge@kth.se>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OF THIS SOFTWARE NOR THE
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef F2CC_SOURCE_TOOLS_CODEWRITER_H_
+#define F2CC_SOURCE_TOOLS_CODEWRITER_H_
+
+/**
+ * @file
+ * @version 0.1
+ *
+ * @brief Defines a writer of generated code.
+ */
+
+#include "../exceptions/ioexception.h"
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace f2cc {
+namespace tools {
+
+/**
+ * @brief A writer of generated code.
+ *
+ * The \c CodeWriter appends code either to a string in memory or, once a file
+ * has been opened, to that file through a fixed-size buffer. Code is thus
+ * written as it is generated instead of first being concatenated into one
+ * large string, and integers are formatted directly into the output.
+ *
+ * The writer keeps track of an indentation level. At each level, every
+ * non-empty line written is preceded by one unit of indentation, which allows
+ * code to be nested within a block without having to be indented afterwards.
+ *
+ * A file is written to a temporary file next to it, which replaces the file
+ * only when the writer is closed. Hence a file is never left partially
+ * written, for example when code generation fails midway. Write errors are
+ * remembered and reported when the writer is closed, such that writing code
+ * never throws.
+ */
+class CodeWriter {
+  public:
+    /**
+     * Creates a writer which writes to a string in memory.
+     *
+     * @param indents
+     *        Unit of indentation.
+     */
+    explicit CodeWriter(const std::string& indents = "    ") throw();
+
+    /**
+     * Destroys this writer. If a file is still open, its temporary file is
+     * removed and the file is left unchanged.
+     */
+    ~CodeWriter() throw();
+
+    /**
+     * Opens a file to which all subsequent code is written. Any previously
+     * opened file is discarded.
+     *
+     * @param file
+     *        File to write.
+     * @throws IOException
+     *         When the temporary file cannot be created.
+     */
+    void open(const std::string& file) throw(IOException);
+
+    /**
+     * Flushes the buffered code and replaces the open file with the written
+     * code. Does nothing if no file is open.
+     *
+     * @throws IOException
+     *         When any write to the file failed.
+     */
+    void close() throw(IOException);
+
+    /**
+     * Writes code.
+     *
+     * @param data
+     *        Code to write.
+     * @param size
+     *        Number of characters.
+     */
+    void write(const char* data, size_t size) throw();
+
+    /**
+     * Writes a string.
+     *
+     * @param str
+     *        String to write.
+     * @returns This writer.
+     */
+    CodeWriter& operator<<(const std::string& str) throw();
+
+    /**
+     * Writes a C string.
+     *
+     * @param str
+     *        String to write.
+     * @returns This writer.
+     */
+    CodeWriter& operator<<(const char* str) throw();
+
+    /**
+     * Writes a character.
+     *
+     * @param c
+     *        Character to write.
+     * @returns This writer.
+     */
+    CodeWriter& operator<<(char c) throw();
+
+    /**
+     * Writes an integer in decimal notation.
+     *
+     * @param value
+     *        Integer to write.
+     * @returns This writer.
+     */
+    CodeWriter& operator<<(int value) throw();
+
+    /**
+     * @copydoc operator<<(int)
+     */
+    CodeWriter& operator<<(unsigned int value) throw();
+
+    /**
+     * @copydoc operator<<(int)
+     */
+    CodeWriter& operator<<(long value) throw();
+
+    /**
+     * @copydoc operator<<(int)
+     */
+    CodeWriter& operator<<(unsigned long value) throw();
+
+    /**
+     * Increases the indentation level by one.
+     */
+    void indent() throw();
+
+    /**
+     * Decreases the indentation level by one. Does nothing if the level is
+     * already 0.
+     */
+    void unindent() throw();
+
+    /**
+     * Gets the number of characters written so far, including indentation.
+     * This can be used to find out whether a piece of code was empty.
+     *
+     * @returns Number of characters.
+     */
+    size_t getSize() const throw();
+
+    /**
+     * Gets the code written to memory. Code written to a file is not
+     * included.
+     *
+     * @returns Code.
+     */
+    const std::string& getString() const throw();
+
+  private:
+    /**
+     * Appends code without indenting it.
+     *
+     * @param data
+     *        Code to append.
+     * @param size
+     *        Number of characters.
+     */
+    void append(const char* data, size_t size) throw();
+
+    /**
+     * Writes the buffer to the open file and empties it.
+     */
+    void flush() throw();
+
+    /**
+     * Writes data directly to the open file.
+     *
+     * @param data
+     *        Data to write.
+     * @param size
+     *        Number of bytes.
+     */
+    void writeToFile(const char* data, size_t size) throw();
+
+    /**
+     * Closes and removes the temporary file, if any.
+     */
+    void discard() throw();
+
+    /**
+     * Disallow copying.
+     */
+    CodeWriter(const CodeWriter&);
+
+    /**
+     * Disallow assignment.
+     */
+    CodeWriter& operator=(const CodeWriter&);
+
+  private:
+    /**
+     * Unit of indentation.
+     */
+    const std::string indents_;
+
+    /**
+     * Current indentation level.
+     */
+    int level_;
+
+    /**
+     * Whether the next character written begins a new line.
+     */
+    bool is_at_line_start_;
+
+    /**
+     * Number of characters written so far.
+     */
+    size_t size_;
+
+    /**
+     * Code written to memory.
+     */
+    std::string string_;
+
+    /**
+     * File being written, or an empty string if code is written to memory.
+     */
+    std::string file_;
+
+    /**
+     * Temporary file replacing \c file_ when closed.
+     */
+    std::string temp_file_;
+
+    /**
+     * Descriptor of the temporary file, or -1 if no file is open.
+     */
+    int fd_;
+
+    /**
+     * Code not yet written to the file.
+     */
+    std::vector<char> buffer_;
+
+    /**
+     * Number of characters in \c buffer_.
+     */
+    size_t buffer_size_;
+
+    /**
+     * Value of \c errno of the first failed write, or 0 if no write failed.
+     */
+    int error_;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2011-2013
+ *     Gabriel Hjort Blindell <ghb@kth.se>
+ *     George Ungureanu <ugeorge@kth.se>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OF THIS SOFTWARE NOR THE
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "fileview.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+
+using namespace f2cc::tools;
+using f2cc::FileNotFoundException;
+using f2cc::IOException;
+using std::string;
+
+FileView::FileView() throw()
+        : data_(""), size_(0), mapping_(NULL), mapping_size_(0) {}
+
+FileView::FileView(const string& file)
+    throw(FileNotFoundException, IOException)
+        : data_(""), size_(0), mapping_(NULL), mapping_size_(0) {
+    open(file);
+}
+
+FileView::~FileView() throw() {
+    close();
+}
+
+void FileView::open(const string& file)
+    throw(FileNotFoundException, IOException) {
+    close();
+
+    int fd = ::open(file.c_str(), O_RDONLY);
+    if (fd < 0) {
+        THROW_EXCEPTION(FileNotFoundException, file);
+    }
+
+    // A mapping is only followed by zeros up to the end of its last page, so
+    // files which end exactly on a page boundary are read instead
+    struct stat file_stat;
+    long page_size = sysconf(_SC_PAGESIZE);
+    if (fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode)
+        && file_stat.st_size > 0 && page_size > 0
+        && file_stat.st_size % page_size != 0) {
+        size_t size = static_cast<size_t>(file_stat.st_size);
+        void* mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+            madvise(mapping, size, MADV_SEQUENTIAL);
+            mapping_ = mapping;
+            mapping_size_ = size;
+            data_ = static_cast<const char*>(mapping);
+            size_ = size;
+            ::close(fd);
+            return;
+        }
+    }
+
+    try {
+        readBuffer(file, fd);
+    }
+    catch (...) {
+        ::close(fd);
+        throw;
+    }
+    ::close(fd);
+}
+
+void FileView::readBuffer(const string& file, int fd) throw(IOException) {
+    const size_t block_size = 1 << 16;
+    size_t size = 0;
+    while (true) {
+        buffer_.resize(size + block_size + 1);
+        ssize_t num_read = ::read(fd, &buffer_[size], block_size);
+        if (num_read < 0) {
+            if (errno == EINTR) continue;
+            buffer_.clear();
+            THROW_EXCEPTION(IOException, file);
+        }
+        if (num_read == 0) break;
+        size += static_cast<size_t>(num_read);
+    }
+    buffer_.resize(size + 1);
+    buffer_[size] = '\0';
+    data_ = &buffer_[0];
+    size_ = size;
+}
+
+void FileView::close() throw() {
+    if (mapping_) {
+        munmap(mapping_, mapping_size_);
+        mapping_ = NULL;
+        mapping_size_ = 0;
+    }
+    std::vector<char>().swap(buffer_);
+    data_ = "";
+    size_ = 0;
+}
+
+const char* FileView::getData() const throw() {
+    return data_;
+}
+
+size_t FileView::getSize() const throw() {
+    return size_;
+}
+
+bool FileView::isMapped() const throw() {
+    return mapping_ != NULL;
+}
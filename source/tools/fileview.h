@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2011-2013
+ *     Gabriel Hjort Blindell <ghb@kth.se>
+ *     George Ungureanu <ugeorge@kth.se>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OF THIS SOFTWARE NOR THE
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef F2CC_SOURCE_TOOLS_FILEVIEW_H_
+#define F2CC_SOURCE_TOOLS_FILEVIEW_H_
+
+/**
+ * @file
+ * @version 0.1
+ *
+ * @brief Defines a read-only view of the content of a file.
+ */
+
+#include "../exceptions/filenotfoundexception.h"
+#include "../exceptions/ioexception.h"
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace f2cc {
+namespace tools {
+
+/**
+ * @brief A read-only view of the content of a file.
+ *
+ * Regular files are mapped into memory, such that their content is neither
+ * copied nor kept in memory beyond what the page cache already holds. Files
+ * which cannot be mapped, such as pipes, are read into a buffer instead. In
+ * both cases the content is followed by a \c '\\0' character, which allows it
+ * to be passed to parsers expecting a C string. The view is valid until it is
+ * closed or destroyed.
+ */
+class FileView {
+  public:
+    /**
+     * Creates an empty view.
+     */
+    FileView() throw();
+
+    /**
+     * Creates a view of a file.
+     *
+     * @param file
+     *        File to view.
+     * @throws FileNotFoundException
+     *         When the file cannot be opened.
+     * @throws IOException
+     *         When an I/O error occurs while reading.
+     */
+    explicit FileView(const std::string& file)
+        throw(FileNotFoundException, IOException);
+
+    /**
+     * Closes the view.
+     */
+    ~FileView() throw();
+
+    /**
+     * Makes this a view of a file. Any previously viewed file is closed.
+     *
+     * @param file
+     *        File to view.
+     * @throws FileNotFoundException
+     *         When the file cannot be opened.
+     * @throws IOException
+     *         When an I/O error occurs while reading.
+     */
+    void open(const std::string& file) throw(FileNotFoundException, IOException);
+
+    /**
+     * Closes the view, which then becomes empty.
+     */
+    void close() throw();
+
+    /**
+     * Gets the content of the file, followed by a \c '\\0' character.
+     *
+     * @returns File content.
+     */
+    const char* getData() const throw();
+
+    /**
+     * Gets the size of the file content, excluding the terminating \c '\\0'.
+     *
+     * @returns Number of bytes.
+     */
+    size_t getSize() const throw();
+
+    /**
+     * Checks whether the file is mapped into memory rather than read into a
+     * buffer.
+     *
+     * @returns \b true if the file is mapped.
+     */
+    bool isMapped() const throw();
+
+  private:
+    /**
+     * Reads an open file into the buffer.
+     *
+     * @param file
+     *        File path, used in error messages.
+     * @param fd
+     *        File descriptor.
+     * @throws IOException
+     *         When an I/O error occurs while reading.
+     */
+    void readBuffer(const std::string& file, int fd) throw(IOException);
+
+    /**
+     * Disallow copying.
+     */
+    FileView(const FileView&);
+
+    /**
+     * Disallow assignment.
+     */
+    FileView& operator=(const FileView&);
+
+  private:
+    /**
+     * Start of the file content.
+     */
+    const char* data_;
+
+    /**
+     * Size of the file content.
+     */
+    size_t size_;
+
+    /**
+     * Start of the mapping, or \c NULL if the file is read into \c buffer_.
+     */
+    void* mapping_;
+
+    /**
+     * Size of the mapping.
+     */
+    size_t mapping_size_;
+
+    /**
+     * File content followed by \c '\\0', when the file is not mapped.
+     */
+    std::vector<char> buffer_;
+};
+
+}
+}
+
+#endif
@@ -26,12 +26,17 @@
  */
 
 #include "tools.h"
+#include "fileview.h"
 #include <ctime>
 #include <algorithm>
 #include <sstream>
 #include <fstream>
 #include <istream>
 #include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <sys/types.h>
+#include <sys/stat.h>
 
 using std::string;
 using std::vector;
@@ -81,11 +86,13 @@ static string monthName2Number(const string& name) throw() {
 }
 
 string f2cc::tools::getCurrentTimestamp() throw() {
-    time_t raw_time;
+    return getTimestamp(time(NULL));
+}
+
+string f2cc::tools::getTimestamp(time_t raw_time) throw() {
     tm* timeinfo;
 
     // Get date and time data
-    time(&raw_time);
     timeinfo = localtime(&raw_time);
     string raw_date(asctime(timeinfo));
 
@@ -192,18 +199,111 @@ bool f2cc::tools::existsFile(const string& file) throw() {
 
 void f2cc::tools::readFile(const string& file, string& data)
     throw(FileNotFoundException, IOException) {
-    std::ifstream fs(file.c_str());
-    if (!fs.good()) {
-        THROW_EXCEPTION(FileNotFoundException, file);
+    FileView view(file);
+    data.assign(view.getData(), view.getSize());
+}
+
+void f2cc::tools::createDirectory(const string& directory)
+    throw(IOException) {
+    if (mkdir(directory.c_str(), 0777) != 0 && errno != EEXIST) {
+        THROW_EXCEPTION(IOException, directory, "Failed to create directory");
     }
+}
 
-    std::stringstream ss;
-    if (ss << fs.rdbuf()) {
-        data = ss.str();
+uint64_t f2cc::tools::hash(const char* data, size_t size, uint64_t seed)
+    throw() {
+    const uint64_t m = 0xc6a4a7935bd1e995ULL;
+    const int r = 47;
+    uint64_t h = seed ^ (size * m);
+
+    const char* end = data + (size & ~static_cast<size_t>(7));
+    for (; data != end; data += 8) {
+        uint64_t k;
+        std::memcpy(&k, data, sizeof(k));
+        k *= m;
+        k ^= k >> r;
+        k *= m;
+        h ^= k;
+        h *= m;
     }
-    else {
-        THROW_EXCEPTION(IOException, file);
+
+    switch (size & 7) {
+        case 7: h ^= uint64_t(static_cast<unsigned char>(data[6])) << 48;
+        case 6: h ^= uint64_t(static_cast<unsigned char>(data[5])) << 40;
+        case 5: h ^= uint64_t(static_cast<unsigned char>(data[4])) << 32;
+        case 4: h ^= uint64_t(static_cast<unsigned char>(data[3])) << 24;
+        case 3: h ^= uint64_t(static_cast<unsigned char>(data[2])) << 16;
+        case 2: h ^= uint64_t(static_cast<unsigned char>(data[1])) << 8;
+        case 1: h ^= uint64_t(static_cast<unsigned char>(data[0]));
+                h *= m;
+    }
+
+    h ^= h >> r;
+    h *= m;
+    h ^= h >> r;
+    return h;
+}
+
+uint64_t f2cc::tools::hash(const string& str, uint64_t seed) throw() {
+    return hash(str.data(), str.length(), seed);
+}
+
+uint64_t f2cc::tools::hashFile(const string& file)
+    throw(FileNotFoundException, IOException) {
+    FileView view(file);
+    return hash(view.getData(), view.getSize());
+}
+
+size_t f2cc::tools::formatInteger(unsigned long value, char* buffer) throw() {
+    // Write the digits backwards from the end of a local buffer, as their
+    // number is not known in advance
+    char digits[kMaxIntegerLength];
+    char* first = digits + kMaxIntegerLength;
+    do {
+        *--first = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    size_t length = digits + kMaxIntegerLength - first;
+    std::memcpy(buffer, first, length);
+    return length;
+}
+
+size_t f2cc::tools::formatInteger(long value, char* buffer) throw() {
+    if (value >= 0) {
+        return formatInteger(static_cast<unsigned long>(value), buffer);
+    }
+    // Negate as unsigned, which is also defined for the smallest value
+    *buffer = '-';
+    return formatInteger(0UL - static_cast<unsigned long>(value), buffer + 1)
+        + 1;
+}
+
+string f2cc::tools::toString(int e) throw() {
+    return toString(static_cast<long>(e));
+}
+
+string f2cc::tools::toString(unsigned int e) throw() {
+    return toString(static_cast<unsigned long>(e));
+}
+
+string f2cc::tools::toString(long e) throw() {
+    char buffer[kMaxIntegerLength];
+    return string(buffer, formatInteger(e, buffer));
+}
+
+string f2cc::tools::toString(unsigned long e) throw() {
+    char buffer[kMaxIntegerLength];
+    return string(buffer, formatInteger(e, buffer));
+}
+
+string f2cc::tools::toHexString(uint64_t value) throw() {
+    const char digits[] = "0123456789abcdef";
+    string str(16, '0');
+    for (int i = 15; i >= 0; --i) {
+        str[i] = digits[value & 0xf];
+        value >>= 4;
     }
+    return str;
 }
 
 void f2cc::tools::writeFile(const std::string& file, const std::string& data)
@@ -49,6 +49,9 @@
 #include <sstream>
 #include <list>
 #include <vector>
+#include <ctime>
+#include <cstddef>
+#include <stdint.h>
 
 namespace f2cc {
 
@@ -64,6 +67,15 @@ namespace tools {
  */
 std::string getCurrentTimestamp() throw();
 
+/**
+ * Same as getCurrentTimestamp() but for a given point in time.
+ *
+ * @param time
+ *        Point in time.
+ * @returns Timestamp.
+ */
+std::string getTimestamp(time_t time) throw();
+
 /**
  * Searched a string for another string and replaces it with a third.
  *
@@ -131,6 +143,54 @@ std::string toString(const T& e) throw() {
     return ss.str();
 }
 
+/**
+ * Maximum number of characters written by formatInteger(), which is enough
+ * for any 64-bit integer including its sign.
+ */
+const size_t kMaxIntegerLength = 20;
+
+/**
+ * Formats an integer in decimal notation. This is much faster than going
+ * through a \c std::stringstream.
+ *
+ * @param value
+ *        Integer to format.
+ * @param buffer
+ *        Buffer of at least \c kMaxIntegerLength characters. The digits are
+ *        not followed by a \c '\\0' character.
+ * @returns Number of characters written.
+ */
+size_t formatInteger(long value, char* buffer) throw();
+
+/**
+ * @copydoc formatInteger(long, char*)
+ */
+size_t formatInteger(unsigned long value, char* buffer) throw();
+
+/**
+ * Converts an integer into a string.
+ *
+ * @param e
+ *        Integer to convert.
+ * @returns String representation.
+ */
+std::string toString(int e) throw();
+
+/**
+ * @copydoc toString(int)
+ */
+std::string toString(unsigned int e) throw();
+
+/**
+ * @copydoc toString(int)
+ */
+std::string toString(long e) throw();
+
+/**
+ * @copydoc toString(int)
+ */
+std::string toString(unsigned long e) throw();
+
 /**
  * Checks whether a string is numeric.
  *
@@ -177,7 +237,8 @@ bool existsFile(const std::string& file) throw();
 
 /**
  * Reads the content of a file into a string. The string is given by reference
- * to avoid excessive copying.
+ * to avoid excessive copying. Parsers which only need to read the content
+ * should use a \c FileView instead, which avoids the copy altogether.
  *
  * @param file
  *        File to read.
@@ -205,6 +266,68 @@ void readFile(const std::string& file, std::string& data)
 void writeFile(const std::string& file, const std::string& data)
     throw(IOException);
 
+/**
+ * Creates a directory, unless it already exists. Parent directories are not
+ * created.
+ *
+ * @param directory
+ *        Directory path.
+ * @throws IOException
+ *         When the directory cannot be created.
+ */
+void createDirectory(const std::string& directory) throw(IOException);
+
+/**
+ * Computes a 64-bit hash of a block of data using the MurmurHash64A
+ * algorithm. The hash is not cryptographically secure, but is fast and well
+ * suited for detecting changes in file content.
+ *
+ * @param data
+ *        Data to hash.
+ * @param size
+ *        Number of bytes.
+ * @param seed
+ *        Seed, which allows several hashes to be chained.
+ * @returns Hash value.
+ */
+uint64_t hash(const char* data, size_t size, uint64_t seed = 0) throw();
+
+/**
+ * Computes a 64-bit hash of a string.
+ *
+ * @param str
+ *        String to hash.
+ * @param seed
+ *        Seed, which allows several hashes to be chained.
+ * @returns Hash value.
+ * @see hash(const char*, size_t, uint64_t)
+ */
+uint64_t hash(const std::string& str, uint64_t seed = 0) throw();
+
+/**
+ * Computes a 64-bit hash of the content of a file.
+ *
+ * @param file
+ *        File to hash.
+ * @returns Hash value.
+ * @throws FileNotFoundException
+ *         When the file cannot be found.
+ * @throws IOException
+ *         When an I/O error occurs while reading.
+ * @see hash(const char*, size_t, uint64_t)
+ */
+uint64_t hashFile(const std::string& file)
+    throw(FileNotFoundException, IOException);
+
+/**
+ * Converts a 64-bit value into a string of 16 lowercase hexadecimal digits.
+ *
+ * @param value
+ *        Value to convert.
+ * @returns Hexadecimal string.
+ */
+std::string toHexString(uint64_t value) throw();
+
 /**
  * Gets the file name from a file path. If no file name is found, an empty
  * string is returned.
@@ -0,0 +1,61 @@
+# Copyright (c) 2011-2013
+#     Gabriel Hjort Blindell <ghb@kth.se>
+#     George Ungureanu <ugeorge@kth.se>
+# All rights reserved.
+# 
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#     * Redistributions of source code must retain the above copyright notice,
+#       this list of conditions and the following disclaimer.
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+# 
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OF THIS SOFTWARE NOR THE
+# COPYRIGHT HOLDERS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+# EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+# PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+# OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+# WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+# OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Checks that a delay leaf which is not part of a feedback loop does not
+# prevent the pipeline stages from being balanced, and that the leafs of a
+# feedback loop are still kept within one stage.
+#
+# Usage: checkpipelinestages.sh F2CC MODELDIR
+
+F2CC=$(cd "$(dirname "$1")" && pwd)/$(basename "$1")
+MODELDIR=$(cd "$2" && pwd)
+WORKDIR=$(mktemp -d)
+trap 'rm -rf "$WORKDIR"' EXIT
+cd "$WORKDIR" || exit 1
+
+# Runs f2cc on a model and prints the leafs of each pipeline stage, one stage
+# per line, as "COST: LEAF, LEAF, ..."
+stages() {
+    "$F2CC" -tp c-pipelined -nps $2 -o out.c -lf $1.log -no-lc \
+        "$MODELDIR/$1.graphml" > /dev/null || return 1
+    sed -n 's/.*Pipeline stage [0-9]* (cost \([0-9]*\)): /\1: /p' $1.log
+}
+
+# 11 leafs of cost 1 in a chain, with a delay leaf after the fifth
+STAGES=$(stages feedforwarddelay 3) || { echo "FAILED: f2cc"; exit 1; }
+COSTS=$(echo "$STAGES" | cut -d: -f1 | tr '\n' ' ')
+if [ "$COSTS" != "4 4 3 " ]; then
+    echo "FAILED: feed-forward delay gives stage costs $COSTS"
+    exit 1
+fi
+
+# The loop z -> b1 -> b2 -> d -> z must not be split
+STAGES=$(stages feedbackdelay 4) || { echo "FAILED: f2cc"; exit 1; }
+if ! echo "$STAGES" | grep "z, b1, b2, .*d$" > /dev/null; then
+    echo "FAILED: feedback loop is split:"
+    echo "$STAGES"
+    exit 1
+fi
+echo "PASSED: pipeline stages balanced around delay leafs"
@@ -0,0 +1,50 @@
+# Copyright (c) 2011-2013
+#     Gabriel Hjort Blindell <ghb@kth.se>
+#     George Ungureanu <ugeorge@kth.se>
+# All rights reserved.
+# 
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#     * Redistributions of source code must retain the above copyright notice,
+#       this list of conditions and the following disclaimer.
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+# 
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OF THIS SOFTWARE NOR THE
+# COPYRIGHT HOLDERS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+# EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+# PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+# OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+# WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+# OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Checks that the same model gives the same code, whether it is parsed or
+# loaded from a saved model.
+#
+# Usage: checkreproduciblecode.sh F2CC MODEL
+
+F2CC=$(cd "$(dirname "$1")" && pwd)/$(basename "$1")
+MODEL=$(cd "$(dirname "$2")" && pwd)/$(basename "$2")
+WORKDIR=$(mktemp -d)
+trap 'rm -rf "$WORKDIR"' EXIT
+cd "$WORKDIR" || exit 1
+
+for PLATFORM in c c-multicore c-pipelined c-task-parallel; do
+    mkdir parsed loaded
+    (cd parsed && "$F2CC" -tp $PLATFORM -o out.c -lf run.log -no-lc \
+         -sm ../model.f2ccpn "$MODEL" > /dev/null) \
+        && (cd loaded && "$F2CC" -tp $PLATFORM -o out.c -lf run.log -no-lc \
+                ../model.f2ccpn > /dev/null) \
+        || { echo "FAILED: f2cc on $PLATFORM"; exit 1; }
+    if ! cmp -s parsed/out.c loaded/out.c; then
+        echo "FAILED: code for $PLATFORM differs for the saved model"
+        exit 1
+    fi
+    rm -rf parsed loaded model.f2ccpn
+done
+echo "PASSED: same code for parsed and saved model"
@@ -0,0 +1,49 @@
+# Copyright (c) 2011-2013
+#     Gabriel Hjort Blindell <ghb@kth.se>
+#     George Ungureanu <ugeorge@kth.se>
+# All rights reserved.
+# 
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#     * Redistributions of source code must retain the above copyright notice,
+#       this list of conditions and the following disclaimer.
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+# 
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OF THIS SOFTWARE NOR THE
+# COPYRIGHT HOLDERS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+# EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+# PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+# OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+# WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+# OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Checks that a model snapshot is saved on every run with a code cache, also
+# when the second run finds the code in the cache.
+#
+# Usage: checksnapshotcache.sh F2CC MODEL
+
+F2CC=$(cd "$(dirname "$1")" && pwd)/$(basename "$1")
+MODEL=$(cd "$(dirname "$2")" && pwd)/$(basename "$2")
+WORKDIR=$(mktemp -d)
+trap 'rm -rf "$WORKDIR"' EXIT
+cd "$WORKDIR" || exit 1
+
+for RUN in 1 2; do
+    rm -f model.f2ccpn
+    if ! "$F2CC" -o out.c -lf run$RUN.log -no-lc -cd cache -sm model.f2ccpn \
+         "$MODEL" > /dev/null; then
+        echo "FAILED: run $RUN exited with an error"
+        exit 1
+    fi
+    if [ ! -s model.f2ccpn ]; then
+        echo "FAILED: run $RUN did not save the model snapshot"
+        exit 1
+    fi
+done
+echo "PASSED: model snapshot saved with code cache"
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2011-2013
+ *     Gabriel Hjort Blindell <ghb@kth.se>
+ *     George Ungureanu <ugeorge@kth.se>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OF THIS SOFTWARE NOR THE
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * @author  Gabriel Hjort Blindell <ghb@kth.se>
+ * @version 0.1
+ *
+ * @brief Measures the time needed to generate unique process and composite
+ *        IDs.
+ *
+ * Each generated ID is immediately added to the model, like the frontends and
+ * the model modifier do, so that every call has to find an ID which is not
+ * yet in use. The number of IDs can be given as the first argument and
+ * defaults to 100000.
+ */
+
+#include "../source/forsyde/processnetwork.h"
+#include "../source/forsyde/composite.h"
+#include "../source/forsyde/hierarchy.h"
+#include "../source/forsyde/id.h"
+#include "../source/forsyde/SY/fanoutsy.h"
+#include <iostream>
+#include <cstdlib>
+#include <sys/time.h>
+
+using namespace f2cc;
+using namespace f2cc::Forsyde;
+using std::cout;
+using std::endl;
+
+/**
+ * Gets the current wall-clock time.
+ *
+ * @returns Time in seconds.
+ */
+static double getTime() {
+    timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+/**
+ * Prints the result of a measurement.
+ *
+ * @param what
+ *        Kind of IDs that were generated.
+ * @param num_ids
+ *        Number of generated IDs.
+ * @param seconds
+ *        Time spent.
+ */
+static void printResult(const char* what, int num_ids, double seconds) {
+    cout << what << ": " << num_ids << " IDs in " << seconds << " s ("
+         << seconds * 1e9 / num_ids << " ns/ID)" << endl;
+}
+
+int main(int argc, const char* argv[]) {
+    int num_ids = argc > 1 ? atoi(argv[1]) : 100000;
+    if (num_ids <= 0) {
+        cout << "Usage: " << argv[0] << " [NUMBER OF IDS]" << endl;
+        return 1;
+    }
+
+    ProcessNetwork model;
+
+    double start = getTime();
+    for (int i = 0; i < num_ids; ++i) {
+        model.addProcess(new SY::Fanout(model.getUniqueProcessId("p_")));
+    }
+    printResult("process IDs", num_ids, getTime() - start);
+
+    Hierarchy hierarchy;
+    start = getTime();
+    for (int i = 0; i < num_ids; ++i) {
+        Id id = model.getUniqueCompositeId("c_");
+        model.addComposite(new Composite(id, hierarchy, Id("bench")));
+    }
+    printResult("composite IDs", num_ids, getTime() - start);
+
+    return 0;
+}